@@ -56,7 +56,7 @@ export default class Video extends Component {
   seek = (time, tolerance = 100) => {
     if (isNaN(time)) {throw new Error('Specified time is not a number');}
 
-    if (Platform.OS === 'ios') {
+    if (Platform.OS === 'ios' || Platform.OS === 'windows') {
       this.setNativeProps({
         seek: {
           time,
@@ -80,6 +80,34 @@ export default class Video extends Component {
     return await NativeModules.VideoManager.save(options, findNodeHandle(this._root));
   }
 
+  getPlaybackState = () => {
+    if (Platform.OS !== 'windows' || !NativeModules.VideoPlaybackState) {
+      return null;
+    }
+    return NativeModules.VideoPlaybackState.getPlaybackState(findNodeHandle(this._root));
+  };
+
+  getQoeMetrics = () => {
+    if (Platform.OS !== 'windows' || !NativeModules.VideoMetrics) {
+      return null;
+    }
+    return NativeModules.VideoMetrics.getQoeSnapshot(findNodeHandle(this._root));
+  };
+
+  getPropUpdateStats = () => {
+    if (Platform.OS !== 'windows' || !NativeModules.VideoMetrics) {
+      return null;
+    }
+    return NativeModules.VideoMetrics.getPropUpdateStats(findNodeHandle(this._root));
+  };
+
+  getCacheStats = () => {
+    if (Platform.OS !== 'windows' || !NativeModules.VideoMetrics) {
+      return null;
+    }
+    return NativeModules.VideoMetrics.getCacheStats();
+  };
+
   restoreUserInterfaceForPictureInPictureStopCompleted = (restored) => {
     this.setNativeProps({ restoreUserInterfaceForPIPStopCompletionHandler: restored });
   };
@@ -261,6 +289,12 @@ export default class Video extends Component {
     }
   };
 
+  _onAdCue = (event) => {
+    if (this.props.onAdCue) {
+      this.props.onAdCue(event.nativeEvent);
+    }
+  };
+
   getViewManagerConfig = viewManagerName => {
     if (!NativeModules.UIManager.getViewManagerConfig) {
       return NativeModules.UIManager[viewManagerName];
@@ -337,6 +371,7 @@ export default class Video extends Component {
       onPictureInPictureStatusChanged: this._onPictureInPictureStatusChanged,
       onRestoreUserInterfaceForPictureInPictureStop: this._onRestoreUserInterfaceForPictureInPictureStop,
       onReceiveAdEvent: this._onReceiveAdEvent,
+      onAdCue: this._onAdCue,
     });
 
     const posterStyle = {
@@ -464,6 +499,7 @@ Video.propTypes = {
   paused: PropTypes.bool,
   muted: PropTypes.bool,
   volume: PropTypes.number,
+  viewportOversampling: PropTypes.number,
   bufferConfig: PropTypes.shape({
     minBufferMs: PropTypes.number,
     maxBufferMs: PropTypes.number,
@@ -478,6 +514,7 @@ Video.propTypes = {
   playWhenInactive: PropTypes.bool,
   ignoreSilentSwitch: PropTypes.oneOf(['ignore', 'obey']),
   reportBandwidth: PropTypes.bool,
+  reportAdCues: PropTypes.bool,
   disableFocus: PropTypes.bool,
   controls: PropTypes.bool,
   audioOnly: PropTypes.bool,
@@ -509,6 +546,7 @@ Video.propTypes = {
   needsToRestoreUserInterfaceForPictureInPictureStop: PropTypes.func,
   onExternalPlaybackChange: PropTypes.func,
   onReceiveAdEvents: PropTypes.func,
+  onAdCue: PropTypes.func,
   youbora: PropTypes.shape({
     accountCode: PropTypes.string,
     src: PropTypes.string,
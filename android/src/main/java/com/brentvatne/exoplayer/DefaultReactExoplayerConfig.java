@@ -1,19 +1,49 @@
 package com.brentvatne.exoplayer;
 
 import android.content.Context;
+import android.content.SharedPreferences;
+import android.os.Handler;
+import android.os.Looper;
+import android.os.SystemClock;
 
+import com.google.android.exoplayer2.upstream.BandwidthMeter;
 import com.google.android.exoplayer2.upstream.DefaultBandwidthMeter;
 import com.google.android.exoplayer2.upstream.DefaultLoadErrorHandlingPolicy;
 import com.google.android.exoplayer2.upstream.LoadErrorHandlingPolicy;
 
 public class DefaultReactExoplayerConfig implements ReactExoplayerConfig {
 
+    private static final String BANDWIDTH_PREFERENCES = "RNVideoBandwidth";
+    private static final String BANDWIDTH_ESTIMATE_KEY = "bitrateEstimate";
+    private static final long BANDWIDTH_PERSIST_INTERVAL_MS = 10000;
+
     private final DefaultBandwidthMeter bandwidthMeter;
     private final Context applicationContext;
+    private long lastBandwidthPersistMs = -BANDWIDTH_PERSIST_INTERVAL_MS;
 
     public DefaultReactExoplayerConfig(Context context) {
-        this.bandwidthMeter = new DefaultBandwidthMeter.Builder(context).build();
+        final SharedPreferences preferences =
+                context.getSharedPreferences(BANDWIDTH_PREFERENCES, Context.MODE_PRIVATE);
+
+        // Start from the estimate of the previous session so the first rendition isn't a guess
+        DefaultBandwidthMeter.Builder builder = new DefaultBandwidthMeter.Builder(context);
+        long persistedEstimate = preferences.getLong(BANDWIDTH_ESTIMATE_KEY, 0);
+        if (persistedEstimate > 0) {
+            builder.setInitialBitrateEstimate(persistedEstimate);
+        }
+        this.bandwidthMeter = builder.build();
         this.applicationContext = context;
+
+        bandwidthMeter.addEventListener(new Handler(Looper.getMainLooper()), new BandwidthMeter.EventListener() {
+            @Override
+            public void onBandwidthSample(int elapsedMs, long bytesTransferred, long bitrateEstimate) {
+                long now = SystemClock.elapsedRealtime();
+                if (bitrateEstimate > 0 && now - lastBandwidthPersistMs >= BANDWIDTH_PERSIST_INTERVAL_MS) {
+                    lastBandwidthPersistMs = now;
+                    preferences.edit().putLong(BANDWIDTH_ESTIMATE_KEY, bitrateEstimate).apply();
+                }
+            }
+        });
     }
 
     @Override
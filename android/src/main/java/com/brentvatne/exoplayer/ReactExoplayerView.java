@@ -150,6 +150,7 @@ class ReactExoplayerView extends FrameLayout implements
     private float audioVolume = 1f;
     private int minLoadRetryCount = 3;
     private int maxBitRate = 0;
+    private float viewportOversampling = 1f;
     private long seekTime = C.TIME_UNSET;
 
     private int minBufferMs = DefaultLoadControl.DEFAULT_MIN_BUFFER_MS;
@@ -299,6 +300,12 @@ class ReactExoplayerView extends FrameLayout implements
         initializePlayer();
     }
 
+    @Override
+    protected void onSizeChanged(int width, int height, int oldWidth, int oldHeight) {
+        super.onSizeChanged(width, height, oldWidth, oldHeight);
+        applyVideoSizeConstraints();
+    }
+
     @Override
     protected void onDetachedFromWindow() {
         super.onDetachedFromWindow();
@@ -468,8 +475,7 @@ class ReactExoplayerView extends FrameLayout implements
 
                     ExoTrackSelection.Factory videoTrackSelectionFactory = new AdaptiveTrackSelection.Factory();
                     trackSelector = new DefaultTrackSelector(videoTrackSelectionFactory);
-                    trackSelector.setParameters(trackSelector.buildUponParameters()
-                            .setMaxVideoBitrate(maxBitRate == 0 ? Integer.MAX_VALUE : maxBitRate));
+                    applyVideoSizeConstraints();
 
                     DefaultAllocator allocator = new DefaultAllocator(true, C.DEFAULT_BUFFER_SEGMENT_SIZE);
                     DefaultLoadControl.Builder defaultLoadControlBuilder = new DefaultLoadControl.Builder();
@@ -1405,9 +1411,35 @@ class ReactExoplayerView extends FrameLayout implements
     public void setMaxBitRateModifier(int newMaxBitRate) {
         maxBitRate = newMaxBitRate;
         if (player != null) {
-            trackSelector.setParameters(trackSelector.buildUponParameters()
-                    .setMaxVideoBitrate(maxBitRate == 0 ? Integer.MAX_VALUE : maxBitRate));
+            applyVideoSizeConstraints();
+        }
+    }
+
+    public void setViewportOversampling(float oversampling) {
+        viewportOversampling = oversampling;
+        applyVideoSizeConstraints();
+    }
+
+    /**
+     * Caps the selected rendition to maxBitRate and to the on-screen size of the view (times the
+     * oversampling factor), so a thumbnail-sized player doesn't decode 1080p. The size cap is lifted
+     * in fullscreen or when the oversampling factor is 0.
+     */
+    private void applyVideoSizeConstraints() {
+        if (trackSelector == null) {
+            return;
+        }
+        DefaultTrackSelector.ParametersBuilder parameters = trackSelector.buildUponParameters()
+                .setMaxVideoBitrate(maxBitRate == 0 ? Integer.MAX_VALUE : maxBitRate);
+        if (isFullscreen || viewportOversampling <= 0 || getWidth() == 0 || getHeight() == 0) {
+            parameters.clearViewportSizeConstraints();
+        } else {
+            parameters.setViewportSize(
+                    Math.round(getWidth() * viewportOversampling),
+                    Math.round(getHeight() * viewportOversampling),
+                    false);
         }
+        trackSelector.setParameters(parameters);
     }
 
     public void setMinLoadRetryCountModifier(int newMinLoadRetryCount) {
@@ -1429,6 +1461,7 @@ class ReactExoplayerView extends FrameLayout implements
             return; // Avoid generating events when nothing is changing
         }
         isFullscreen = fullscreen;
+        applyVideoSizeConstraints();
 
         Activity activity = themedReactContext.getCurrentActivity();
         if (activity == null) {
@@ -62,6 +62,7 @@ public class ReactExoplayerViewManager extends ViewGroupManager<ReactExoplayerVi
     private static final String PROP_RATE = "rate";
     private static final String PROP_MIN_LOAD_RETRY_COUNT = "minLoadRetryCount";
     private static final String PROP_MAXIMUM_BIT_RATE = "maxBitRate";
+    private static final String PROP_VIEWPORT_OVERSAMPLING = "viewportOversampling";
     private static final String PROP_PLAY_IN_BACKGROUND = "playInBackground";
     private static final String PROP_DISABLE_FOCUS = "disableFocus";
     private static final String PROP_FULLSCREEN = "fullscreen";
@@ -300,6 +301,11 @@ public class ReactExoplayerViewManager extends ViewGroupManager<ReactExoplayerVi
         videoView.setMaxBitRateModifier(maxBitRate);
     }
 
+    @ReactProp(name = PROP_VIEWPORT_OVERSAMPLING, defaultFloat = 1.0f)
+    public void setViewportOversampling(final ReactExoplayerView videoView, final float viewportOversampling) {
+        videoView.setViewportOversampling(viewportOversampling);
+    }
+
     @ReactProp(name = PROP_MIN_LOAD_RETRY_COUNT)
     public void minLoadRetryCount(final ReactExoplayerView videoView, final int minLoadRetryCount) {
         videoView.setMinLoadRetryCountModifier(minLoadRetryCount);
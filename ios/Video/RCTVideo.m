@@ -20,6 +20,8 @@ static NSString *const timedMetadata = @"timedMetadata";
 static NSString *const externalPlaybackActive = @"externalPlaybackActive";
 
 static int const RCTVideoUnset = -1;
+// Content is released if ad decisioning has not taken over by then (IMA's own VAST load timeout is 8 s).
+static int64_t const RCTVideoAdDecisionTimeoutSeconds = 10;
 
 #ifdef DEBUG
     #define DebugLog(...) NSLog(__VA_ARGS__)
@@ -57,6 +59,8 @@ static int const RCTVideoUnset = -1;
   BOOL _isExternalPlaybackActiveObserverRegistered;
   BOOL _videoLoadStarted;
   BOOL _isRequestAds;
+  BOOL _isAdDecisionPending;
+  NSUInteger _adRequestGeneration;
 
   bool _pendingSeek;
   float _pendingSeekTime;
@@ -133,6 +137,7 @@ static int const RCTVideoUnset = -1;
     _playWhenInactive = false;
     _pictureInPicture = false;
     _isRequestAds = false;
+    _isAdDecisionPending = false;
     _ignoreSilentSwitch = @"inherit"; // inherit, ignore, obey
     _mixWithOthers = @"inherit"; // inherit, mix, duck
 #if TARGET_OS_IOS
@@ -310,10 +315,6 @@ static int const RCTVideoUnset = -1;
   [[NSNotificationCenter defaultCenter] postNotificationName:@"RCTVideo_progress" object:nil userInfo:@{@"progress": [NSNumber numberWithDouble: currentTimeSecs / duration]}];
 
   if( currentTimeSecs >= 0 && self.onVideoProgress) {
-    if(!_isRequestAds && currentTimeSecs >= 0.0001) {
-      [self requestAds];
-      _isRequestAds = true;
-    }
     self.onVideoProgress(@{
                            @"currentTime": [NSNumber numberWithFloat:CMTimeGetSeconds(currentTime)],
                            @"playableDuration": [self calculatePlayableDuration],
@@ -389,6 +390,10 @@ static int const RCTVideoUnset = -1;
 - (void)setSrc:(NSDictionary *)source
 {
   _source = source;
+  // every source gets its own ad request, made once its player and ads loader exist
+  _isRequestAds = false;
+  _isAdDecisionPending = false;
+  self.adsLoader = nil;
   [self removePlayerLayer];
   [self removePlayerTimeObserver];
   [self removePlayerItemObservers];
@@ -419,6 +424,8 @@ static int const RCTVideoUnset = -1;
 
       self.contentPlayhead = [[IMAAVPlayerContentPlayhead alloc] initWithAVPlayer:_player];
       [self setupAdsLoader];
+      // decide on ads while the item loads rather than once content is already playing
+      [self requestAdsIfNeeded];
 
       [self->_player addObserver:self forKeyPath:playbackRate options:0 context:nil];
       self->_playbackRateObserverRegistered = YES;
@@ -975,6 +982,34 @@ static int const RCTVideoUnset = -1;
   self.adsLoader.delegate = self;
 }
 
+- (void)requestAdsIfNeeded {
+  if (_adTagUrl == nil || _isRequestAds || self.adsLoader == nil) {
+    return;
+  }
+  _isRequestAds = true;
+  // hold content, buffering but paused, until the preroll takes over or turns out not to exist
+  _isAdDecisionPending = true;
+  NSUInteger generation = ++_adRequestGeneration;
+  [self requestAds];
+
+  __weak RCTVideo *weakSelf = self;
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, RCTVideoAdDecisionTimeoutSeconds * NSEC_PER_SEC),
+                 dispatch_get_main_queue(), ^{
+    RCTVideo *strongSelf = weakSelf;
+    if (strongSelf != nil && strongSelf->_adRequestGeneration == generation) {
+      [strongSelf releaseContentHold];
+    }
+  });
+}
+
+- (void)releaseContentHold {
+  if (!_isAdDecisionPending) {
+    return;
+  }
+  _isAdDecisionPending = false;
+  [self setPaused:_paused];
+}
+
 - (void)requestAds {
   // Create an ad display container for ad rendering.
   IMAAdDisplayContainer *adDisplayContainer =
@@ -1003,10 +1038,18 @@ static int const RCTVideoUnset = -1;
   // Initialize the ads manager.
   [self.adsManager initializeWithAdsRenderingSettings:adsRenderingSettings];
   _isPlayAds = true;
+
+  // an ad playlist (VMAP) without a cue point at 0 has no preroll to wait for; a plain VAST response has
+  // no cue points and plays as a preroll
+  NSArray<NSNumber *> *cuePoints = self.adsManager.adCuePoints;
+  if (cuePoints.count > 0 && ![cuePoints containsObject:@0]) {
+    [self releaseContentHold];
+  }
 }
 
 - (void)adsLoader:(IMAAdsLoader *)loader failedWithErrorData:(IMAAdLoadingErrorData *)adErrorData {
   _isPlayAds = false;
+  _isAdDecisionPending = false;
   // Something went wrong loading ads. Log the error and play the content.
   NSLog(@"Error loading ads: %@", adErrorData.adError.message);
   [_player play];
@@ -1030,6 +1073,7 @@ static int const RCTVideoUnset = -1;
 
 - (void)adsManager:(IMAAdsManager *)adsManager didReceiveAdError:(IMAAdError *)error {
   _isPlayAds = false;
+  _isAdDecisionPending = false;
   // Something went wrong with the ads manager after ads were loaded. Log the error and play the
   // content.
   NSLog(@"AdsManager error: %@", error.message);
@@ -1038,12 +1082,14 @@ static int const RCTVideoUnset = -1;
 
 - (void)adsManagerDidRequestContentPause:(IMAAdsManager *)adsManager {
   _isPlayAds = true;
+  _isAdDecisionPending = false;
   // The SDK is going to play ads, so pause the content.
   [_player pause];
 }
 
 - (void)adsManagerDidRequestContentResume:(IMAAdsManager *)adsManager {
   _isPlayAds = false;
+  _isAdDecisionPending = false;
   // The SDK is done playing ads (at least for now), so resume the content.
   [_player play];
 }
@@ -1248,6 +1294,15 @@ static int const RCTVideoUnset = -1;
       [session setCategory:session.category withOptions:options error:nil];
     }
 
+    if (_isAdDecisionPending) {
+      // content waits for the ads but fills its buffer meanwhile, so it resumes at once after the preroll
+      if (_player.status == AVPlayerStatusReadyToPlay && _player.rate == 0) {
+        [_player prerollAtRate:_rate completionHandler:nil];
+      }
+      _paused = paused;
+      return;
+    }
+
     if (@available(iOS 10.0, *) && !_automaticallyWaitsToMinimizeStalling) {
       [_player playImmediatelyAtRate:_rate];
     } else {
@@ -1831,6 +1886,8 @@ static int const RCTVideoUnset = -1;
 
 - (void)setAdTagUrl:(NSString *)adTagUrl {
   _adTagUrl = adTagUrl;
+  // the tag may arrive after the source has already been prepared
+  [self requestAdsIfNeeded];
 }
 
 #pragma mark - React View Management
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Portable (WinRT-free) adaptive bitrate selection. The controller keeps the rendition ladder and the
+// JS-side limits (maxBitRate, bufferConfig) and asks a pluggable policy for a rendition whenever a segment
+// finished downloading. The default policy follows throughput while the buffer is short and switches to a
+// BOLA buffer-level policy once the buffer is stable, the same split dash.js uses.
+namespace ReactNativeVideoCPP {
+
+// Mirrors the bufferConfig prop; the defaults are the documented ones.
+struct AbrBufferConfig {
+  double minBufferMs = 15000;
+  double maxBufferMs = 50000;
+  double bufferForPlaybackMs = 2500;
+  double bufferForPlaybackAfterRebufferMs = 5000;
+
+  bool operator==(AbrBufferConfig const &other) const {
+    return minBufferMs == other.minBufferMs && maxBufferMs == other.maxBufferMs &&
+        bufferForPlaybackMs == other.bufferForPlaybackMs &&
+        bufferForPlaybackAfterRebufferMs == other.bufferForPlaybackAfterRebufferMs;
+  }
+};
+
+struct AbrConfig {
+  uint32_t maxBitRate = 0; // bits per second, 0 for no limit
+  AbrBufferConfig buffer;
+  double bandwidthFraction = 0.9; // share of the throughput estimate a rendition may use
+};
+
+struct AbrContext {
+  std::vector<uint32_t> const &bitrates; // ascending, already limited to maxBitRate, never empty
+  size_t current; // index into bitrates of the rendition playing now
+  double bufferSeconds; // buffered media ahead of the playhead
+  uint64_t throughput; // bits per second, 0 when unknown
+  AbrConfig const &config;
+};
+
+class AbrPolicy {
+ public:
+  virtual ~AbrPolicy() = default;
+
+  // Returns an index into context.bitrates.
+  virtual size_t Choose(AbrContext const &context) = 0;
+};
+
+// Highest rendition that fits the throughput estimate; keeps the current one while the estimate is unknown.
+class ThroughputPolicy : public AbrPolicy {
+ public:
+  size_t Choose(AbrContext const &context) override {
+    if (context.throughput == 0) {
+      return context.current;
+    }
+    auto budget = context.throughput * context.config.bandwidthFraction;
+    size_t choice = 0;
+    for (size_t i = 1; i < context.bitrates.size(); ++i) {
+      if (context.bitrates[i] <= budget) {
+        choice = i;
+      }
+    }
+    return choice;
+  }
+};
+
+// BOLA-BASIC (Spiteri et al.) with the dash.js parameterization: the buffer between
+// bufferForPlaybackAfterRebufferMs and minBufferMs (capped at maxBufferMs) is spread across the ladder,
+// so a fuller buffer buys a higher rendition regardless of short throughput dips.
+class BolaPolicy : public AbrPolicy {
+ public:
+  size_t Choose(AbrContext const &context) override {
+    auto const &bitrates = context.bitrates;
+    if (bitrates.size() < 2) {
+      return 0;
+    }
+    auto const &buffer = context.config.buffer;
+    double minimumBuffer = std::max(buffer.bufferForPlaybackAfterRebufferMs / 1000, c_minimumBufferSeconds);
+    double bufferTarget = std::max(
+        std::min(buffer.minBufferMs, buffer.maxBufferMs) / 1000,
+        minimumBuffer + c_bufferPerLevelSeconds * bitrates.size());
+
+    // utilities are log bitrates shifted so the lowest rendition scores 1
+    double lowest = std::log(static_cast<double>(bitrates.front()));
+    double highestUtility = std::log(static_cast<double>(bitrates.back())) - lowest + 1;
+    double gp = (highestUtility - 1) / (bufferTarget / minimumBuffer - 1);
+    double vp = minimumBuffer / gp;
+
+    size_t choice = 0;
+    double bestScore = 0;
+    for (size_t i = 0; i < bitrates.size(); ++i) {
+      double utility = std::log(static_cast<double>(bitrates[i])) - lowest + 1;
+      double score = (vp * (utility + gp) - context.bufferSeconds) / bitrates[i];
+      if (i == 0 || score >= bestScore) {
+        bestScore = score;
+        choice = i;
+      }
+    }
+
+    // BOLA-O: only switch up as far as throughput allows, a full buffer alone must not buy a rendition the
+    // network can't sustain
+    if (choice > context.current && context.throughput > 0) {
+      choice = std::max(context.current, std::min(choice, ThroughputPolicy().Choose(context)));
+    }
+    return choice;
+  }
+
+ private:
+  static constexpr double c_minimumBufferSeconds = 1;
+  static constexpr double c_bufferPerLevelSeconds = 2;
+};
+
+// Throughput-based until the buffer reaches minBufferMs, BOLA from then on until it drains below half of
+// that again. Throughput reacts faster at startup and after a seek, BOLA is steadier once there is a
+// cushion to spend. Without a throughput estimate the rendition the source started with is kept: BOLA on
+// an empty buffer would always answer the lowest one.
+class DynamicPolicy : public AbrPolicy {
+ public:
+  size_t Choose(AbrContext const &context) override {
+    double stableBuffer = context.config.buffer.minBufferMs / 1000;
+    if (m_useBola ? context.bufferSeconds < stableBuffer / 2 : context.bufferSeconds >= stableBuffer) {
+      m_useBola = !m_useBola;
+    }
+    if (context.throughput == 0) {
+      return m_throughput.Choose(context);
+    }
+    return m_useBola ? m_bola.Choose(context) : m_throughput.Choose(context);
+  }
+
+ private:
+  ThroughputPolicy m_throughput;
+  BolaPolicy m_bola;
+  bool m_useBola = false;
+};
+
+class AbrController {
+ public:
+  AbrController() : m_policy(std::make_unique<DynamicPolicy>()) {}
+
+  void SetPolicy(std::unique_ptr<AbrPolicy> policy) {
+    m_policy = std::move(policy);
+  }
+
+  void SetConfig(AbrConfig const &config) {
+    m_config = config;
+  }
+
+  AbrConfig const &Config() const {
+    return m_config;
+  }
+
+  // The renditions of the current source, in any order, and the one it started with (e.g. the pick of
+  // SelectInitial()); 0 for the lowest.
+  void SetBitrates(std::vector<uint32_t> bitrates, uint32_t current = 0) {
+    std::sort(bitrates.begin(), bitrates.end());
+    bitrates.erase(std::unique(bitrates.begin(), bitrates.end()), bitrates.end());
+    m_bitrates = std::move(bitrates);
+    m_current = current;
+  }
+
+  // Forgets the ladder, e.g. when the source changes.
+  void Reset() {
+    m_bitrates.clear();
+    m_current = 0;
+  }
+
+  bool Empty() const {
+    return m_bitrates.empty();
+  }
+
+  // The ladder of the current source, ascending.
+  std::vector<uint32_t> const &Bitrates() const {
+    return m_bitrates;
+  }
+
+  // Bitrate to play next, 0 when there is no ladder.
+  uint32_t Select(double bufferSeconds, uint64_t throughput) {
+    auto allowed = Allowed(m_bitrates, m_config);
+    if (allowed.empty()) {
+      return 0;
+    }
+    // index of the rendition playing now, or of the closest lower one if the limits changed since
+    auto above = std::upper_bound(allowed.begin(), allowed.end(), m_current);
+    size_t current = above == allowed.begin() ? 0 : static_cast<size_t>(above - allowed.begin() - 1);
+    AbrContext context{allowed, current, bufferSeconds, throughput, m_config};
+    m_current = allowed[std::min(m_policy->Choose(context), allowed.size() - 1)];
+    return m_current;
+  }
+
+  // Rendition to start a source with, before any buffer exists. Stateless so it can run off the UI thread.
+  static uint32_t SelectInitial(std::vector<uint32_t> bitrates, uint64_t throughput, AbrConfig const &config) {
+    std::sort(bitrates.begin(), bitrates.end());
+    auto allowed = Allowed(bitrates, config);
+    if (allowed.empty()) {
+      return 0;
+    }
+    AbrContext context{allowed, 0, 0, throughput, config};
+    return allowed[std::min(ThroughputPolicy().Choose(context), allowed.size() - 1)];
+  }
+
+ private:
+  // The sorted ladder limited to maxBitRate; the lowest rendition stays when none fits.
+  static std::vector<uint32_t> Allowed(std::vector<uint32_t> const &bitrates, AbrConfig const &config) {
+    if (config.maxBitRate == 0 || bitrates.empty()) {
+      return bitrates;
+    }
+    auto end = std::upper_bound(bitrates.begin(), bitrates.end(), config.maxBitRate);
+    return std::vector<uint32_t>(bitrates.begin(), std::max(end, bitrates.begin() + 1));
+  }
+
+  std::unique_ptr<AbrPolicy> m_policy;
+  AbrConfig m_config;
+  std::vector<uint32_t> m_bitrates;
+  uint32_t m_current = 0;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+#include "HlsParser.h"
+#include "Scte35.h"
+
+// Portable (WinRT-free) ad break timeline of a server-side stitched stream, built from the cues of its HLS
+// playlist. Out and in cues are paired into breaks with their start and end precomputed in content time,
+// and SCTE-35 payloads fill in what the tags leave out (a duration, whether a bare SCTE35-CMD opens or
+// closes a break). Per progress tick the timeline only reports when playback enters or leaves a break, a
+// binary search over the break starts, so JS no longer has to scan timed metadata itself.
+namespace ReactNativeVideoCPP {
+
+struct AdCueBreak {
+  std::string id; // the EXT-X-DATERANGE ID, else the splice event ID, else the media sequence of the cue
+  double start = 0;
+  double end = NAN; // NaN until an in cue arrives; see End
+  double duration = 0; // the planned length, 0 when unknown
+  uint32_t spliceEventId = 0; // 0 without an SCTE-35 payload
+
+  // Where the break ends: its in cue, else its planned length, else (an open break) never.
+  double End() const {
+    if (!std::isnan(end)) {
+      return end;
+    }
+    return duration > 0 ? start + duration : std::numeric_limits<double>::infinity();
+  }
+};
+
+enum class AdCueEvent { BreakStart, BreakEnd };
+
+class AdCueTimeline {
+ public:
+  static constexpr size_t c_none = static_cast<size_t>(-1);
+
+  void Clear() {
+    m_breaks.clear();
+    m_current = c_none;
+  }
+
+  bool Empty() const {
+    return m_breaks.empty();
+  }
+
+  std::vector<AdCueBreak> const &Breaks() const {
+    return m_breaks;
+  }
+
+  // Folds new playlist cues in. Cues seen again after a playlist reset match their break by ID or start
+  // and only refine it. Returns true when a break was added or changed.
+  bool Add(std::vector<HlsCue> const &cues) {
+    bool changed = false;
+    for (auto const &cue : cues) {
+      SpliceInfo splice;
+      bool hasSplice = !cue.scte35.empty() && DecodeSpliceInfoText(cue.scte35, splice);
+      auto kind = cue.kind;
+      if (kind == HlsCueKind::Command) {
+        if (!hasSplice || !(splice.IsBreakStart() || splice.IsBreakEnd())) {
+          continue; // not about ads
+        }
+        kind = splice.IsBreakStart() ? HlsCueKind::Out : HlsCueKind::In;
+      }
+      changed = (kind == HlsCueKind::Out ? Open(cue, hasSplice ? &splice : nullptr)
+                                         : Close(cue, hasSplice ? &splice : nullptr)) ||
+          changed;
+    }
+    return changed;
+  }
+
+  // The break |position| is in, c_none between breaks.
+  size_t BreakAt(double position) const {
+    auto it = std::upper_bound(m_breaks.begin(), m_breaks.end(), position, [](double time, AdCueBreak const &b) {
+      return time < b.start;
+    });
+    if (it == m_breaks.begin()) {
+      return c_none;
+    }
+    --it;
+    return position < it->End() ? static_cast<size_t>(it - m_breaks.begin()) : c_none;
+  }
+
+  // Moves playback to |position| and calls |onEvent(AdCueEvent, AdCueBreak const &)| for the break it left
+  // and the break it entered, in that order. A seek straight over a break reports nothing for it.
+  template <typename OnEvent>
+  void Advance(double position, OnEvent &&onEvent) {
+    auto next = BreakAt(position);
+    if (next == m_current) {
+      return;
+    }
+    if (m_current != c_none) {
+      onEvent(AdCueEvent::BreakEnd, m_breaks[m_current]);
+    }
+    m_current = next;
+    if (m_current != c_none) {
+      onEvent(AdCueEvent::BreakStart, m_breaks[m_current]);
+    }
+  }
+
+ private:
+  static std::string IdOf(HlsCue const &cue, SpliceInfo const *splice) {
+    if (!cue.id.empty()) {
+      return cue.id;
+    }
+    if (splice != nullptr && splice->command == SpliceCommandType::Insert) {
+      return "splice-" + std::to_string(splice->eventId);
+    }
+    if (splice != nullptr && !splice->segmentations.empty()) {
+      return "splice-" + std::to_string(splice->segmentations.front().eventId);
+    }
+    return "cue-" + std::to_string(cue.sequence);
+  }
+
+  static uint32_t SpliceEventIdOf(SpliceInfo const *splice) {
+    if (splice == nullptr) {
+      return 0;
+    }
+    if (splice->command == SpliceCommandType::Insert || splice->segmentations.empty()) {
+      return splice->eventId;
+    }
+    return splice->segmentations.front().eventId;
+  }
+
+  bool Open(HlsCue const &cue, SpliceInfo const *splice) {
+    auto id = IdOf(cue, splice);
+    auto duration = cue.duration > 0 ? cue.duration : splice != nullptr ? splice->DurationSeconds() : 0;
+    auto it = std::find_if(m_breaks.begin(), m_breaks.end(), [&](AdCueBreak const &b) {
+      return b.id == id || std::abs(b.start - cue.time) < c_sameTime;
+    });
+    if (it != m_breaks.end()) {
+      if (duration <= 0 || it->duration == duration) {
+        return false;
+      }
+      it->duration = duration;
+      return true;
+    }
+
+    AdCueBreak adBreak;
+    adBreak.id = std::move(id);
+    adBreak.start = cue.time;
+    adBreak.duration = duration;
+    adBreak.spliceEventId = SpliceEventIdOf(splice);
+    auto at = std::upper_bound(m_breaks.begin(), m_breaks.end(), adBreak.start, [](double time, AdCueBreak const &b) {
+      return time < b.start;
+    });
+    auto index = static_cast<size_t>(at - m_breaks.begin());
+    // the break before an out cue is over by then, whatever its planned length said
+    if (index > 0 && m_breaks[index - 1].End() > adBreak.start) {
+      m_breaks[index - 1].end = adBreak.start;
+    }
+    m_breaks.insert(at, std::move(adBreak));
+    if (m_current != c_none && m_current >= index) {
+      ++m_current;
+    }
+    return true;
+  }
+
+  bool Close(HlsCue const &cue, SpliceInfo const *splice) {
+    // the break with the same ID, else the last one started before the cue
+    auto it = m_breaks.end();
+    if (!cue.id.empty()) {
+      it = std::find_if(m_breaks.begin(), m_breaks.end(), [&](AdCueBreak const &b) { return b.id == cue.id; });
+    }
+    if (it == m_breaks.end()) {
+      it = std::upper_bound(m_breaks.begin(), m_breaks.end(), cue.time, [](double time, AdCueBreak const &b) {
+        return time < b.start;
+      });
+      if (it == m_breaks.begin() || !std::isnan(std::prev(it)->end)) {
+        return false; // joined mid-break (its out cue slid out of the window before we saw it), or a repeat
+      }
+      --it;
+    }
+    auto spliceEventId = SpliceEventIdOf(splice);
+    if (spliceEventId != 0 && it->spliceEventId != 0 && spliceEventId != it->spliceEventId) {
+      return false; // the return of another avail
+    }
+    if (cue.time < it->start || (!std::isnan(it->end) && std::abs(it->end - cue.time) < c_sameTime)) {
+      return false;
+    }
+    it->end = cue.time;
+    return true;
+  }
+
+  static constexpr double c_sameTime = 0.001; // cue times are sums of segment durations, allow for rounding
+
+  std::vector<AdCueBreak> m_breaks; // sorted by start, non-overlapping
+  size_t m_current = c_none;
+};
+
+} // namespace ReactNativeVideoCPP
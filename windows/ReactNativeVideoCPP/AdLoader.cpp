@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "AdLoader.h"
+#include <chrono>
+#include "BandwidthMeter.h"
+#include "BeaconDispatcher.h"
+#include "MediaCache.h"
+
+using namespace Windows::Foundation;
+using namespace Windows::Storage::Streams;
+using namespace Windows::Web::Http;
+
+using ::ReactNativeVideoCPP::AdBreak;
+using ::ReactNativeVideoCPP::ByteRange;
+using ::ReactNativeVideoCPP::AdPrefetchLedger;
+using ::ReactNativeVideoCPP::VastResolver;
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+namespace {
+
+// ad responses are small, this mostly bounds how much text is buffered ahead of the parser
+constexpr uint32_t c_chunkBytes = 16 * 1024;
+
+// enough of a creative to start it and stay ahead; the rest streams through the cache while it plays
+constexpr uint64_t c_prefetchBytes = 8 * 1024 * 1024;
+
+// a quarter of the measured bandwidth, the content's ABR keeps the rest
+constexpr double c_prefetchShare = 0.25;
+
+} // namespace
+
+AdLoader &AdLoader::Instance() {
+  // intentionally leaked, loads may still be running on the thread pool during shutdown
+  static auto *loader = new AdLoader();
+  return *loader;
+}
+
+AdLoader::AdLoader()
+    : m_resolver(
+          [this](std::string const &url, VastResolver::OnChunk const &onChunk) { return Fetch(url, onChunk); },
+          [](std::string const &url) { BeaconDispatcher::Instance().Send(url); }),
+      m_prefetchPacer(c_prefetchShare) {}
+
+std::vector<AdBreak> AdLoader::Load(hstring const &adTagUrl) {
+  return m_resolver.Load(to_string(adTagUrl));
+}
+
+void AdLoader::Prefetch(void const *owner, std::vector<std::string> const &urls) {
+  std::vector<std::string> pending;
+  for (auto const &url : urls) {
+    if (!url.empty() && m_prefetches.Begin(owner, url)) {
+      pending.push_back(url);
+    }
+  }
+  if (!pending.empty()) {
+    PrefetchCreatives(owner, std::move(pending));
+  }
+}
+
+AdPrefetchLedger &AdLoader::Prefetches() {
+  return m_prefetches;
+}
+
+bool AdLoader::Fetch(std::string const &url, VastResolver::OnChunk const &onChunk) {
+  try {
+    auto response = m_client.GetAsync(Uri(to_hstring(url)), HttpCompletionOption::ResponseHeadersRead).get();
+    if (!response.IsSuccessStatusCode()) {
+      return false;
+    }
+    auto stream = response.Content().ReadAsInputStreamAsync().get();
+    Buffer buffer(c_chunkBytes);
+    while (true) {
+      auto chunk = stream.ReadAsync(buffer, buffer.Capacity(), InputStreamOptions::Partial).get();
+      if (chunk.Length() == 0) {
+        return true;
+      }
+      onChunk(std::string_view(reinterpret_cast<char const *>(chunk.data()), chunk.Length()));
+    }
+  } catch (winrt::hresult_error const &) {
+    // malformed URI or a failed download, the chain just ends here
+    return false;
+  }
+}
+
+fire_and_forget AdLoader::PrefetchCreatives(void const *owner, std::vector<std::string> urls) {
+  co_await resume_background();
+  auto &cache = MediaCache::Instance();
+  // one at a time, so a pod takes no larger a share of the link than a single ad
+  for (auto const &url : urls) {
+    Uri uri{nullptr};
+    try {
+      uri = Uri(to_hstring(url));
+    } catch (winrt::hresult_error const &) {
+      // malformed URI, the ad starts cold
+    }
+    std::vector<ByteRange> ranges;
+    uint64_t fetchedBytes = 0;
+    bool succeeded = uri != nullptr && cache.MissingRanges(RangeCache::AdCreatives, uri, c_prefetchBytes, ranges);
+    auto key = succeeded ? to_string(uri.AbsoluteUri()) : std::string();
+    std::string scratch;
+    for (auto const &range : ranges) {
+      auto size = range.end - range.start;
+      auto started = std::chrono::steady_clock::now();
+      if (!cache.ReadRange(RangeCache::AdCreatives, uri, key, range.start, static_cast<uint32_t>(size), scratch)) {
+        succeeded = false;
+        break;
+      }
+      fetchedBytes += size;
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+      auto delay = m_prefetchPacer.DelayMs(size, elapsed.count(), BandwidthMeter::Instance().Estimate());
+      if (delay > 0) {
+        // the pause is a timer, not a thread-pool thread held asleep
+        co_await resume_after(std::chrono::milliseconds(delay));
+      }
+    }
+    m_prefetches.Completed(owner, url, fetchedBytes, succeeded);
+  }
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "AdPrefetch.h"
+#include "AdSchedule.h"
+#include "VastResolver.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// Loads VAST / VMAP ad tags into ad schedules and fetches ad creatives into the media cache ahead of their
+// breaks; tracking and Error URLs go through the BeaconDispatcher. Responses are parsed as they stream in,
+// and the wrappers of a pod are resolved in parallel on the thread pool.
+class AdLoader {
+ public:
+  static AdLoader &Instance();
+
+  // Blocks on the network, call it off the UI thread. The breaks of |adTagUrl|, empty on any failure.
+  std::vector<::ReactNativeVideoCPP::AdBreak> Load(hstring const &adTagUrl);
+
+  // Downloads the start of each creative of |urls| into the ad creative cache for the player |owner|, one
+  // after the other and paced to a share of the bandwidth. Creatives |owner| already prefetched or has on
+  // their way, empty URLs and streaming creatives are skipped.
+  void Prefetch(void const *owner, std::vector<std::string> const &urls);
+
+  // Where each prefetched creative ended up, played or wasted, per player.
+  ::ReactNativeVideoCPP::AdPrefetchLedger &Prefetches();
+
+ private:
+  AdLoader();
+
+  bool Fetch(std::string const &url, ::ReactNativeVideoCPP::VastResolver::OnChunk const &onChunk);
+  fire_and_forget PrefetchCreatives(void const *owner, std::vector<std::string> urls);
+
+  Windows::Web::Http::HttpClient m_client;
+  ::ReactNativeVideoCPP::VastResolver m_resolver;
+  ::ReactNativeVideoCPP::AdPrefetchLedger m_prefetches;
+  ::ReactNativeVideoCPP::TransferPacer m_prefetchPacer;
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <map>
+#include <string>
+#include <utility>
+
+// Portable (WinRT-free) bookkeeping for fetching ad creatives into the cache ahead of their breaks, so a
+// midroll starts from disk instead of behind a spinner. The ledger follows each creative from prefetch to
+// play (a hit) or to its break being dropped unplayed (its bytes were wasted), per player, so one player
+// seeking past a break does not count as waste the creative another is about to play; the pacer keeps the
+// prefetch to a share of the measured bandwidth so the content's own downloads keep the link.
+namespace ReactNativeVideoCPP {
+
+struct AdPrefetchStats {
+  uint64_t prefetches = 0; // creatives prefetched
+  uint64_t prefetchedBytes = 0; // bytes downloaded ahead of their break
+  uint64_t hits = 0; // ads that started from a prefetched creative
+  uint64_t misses = 0; // ads that started cold, or before their prefetch finished
+  uint64_t wastedBytes = 0; // prefetched bytes of ads that never played
+};
+
+// Creatives are tracked per |owner|, the player that prefetches them; it is only compared, never dereferenced.
+class AdPrefetchLedger {
+ public:
+  // False when |owner| already has |url| prefetched or on its way.
+  bool Begin(void const *owner, std::string const &url) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_creatives.try_emplace(Key(owner, url)).second;
+  }
+
+  // The prefetch of |url| ended, with |bytes| downloaded; a failed one is forgotten so it can be retried.
+  void Completed(void const *owner, std::string const &url, uint64_t bytes, bool succeeded) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.prefetchedBytes += bytes;
+    auto it = m_creatives.find(Key(owner, url));
+    if (it == m_creatives.end()) {
+      return; // already played or abandoned
+    }
+    if (it->second.abandoned) {
+      m_stats.wastedBytes += bytes;
+      m_creatives.erase(it);
+      return;
+    }
+    if (!succeeded) {
+      m_creatives.erase(it);
+      return;
+    }
+    ++m_stats.prefetches;
+    it->second.ready = true;
+    it->second.bytes = bytes;
+  }
+
+  // The ad with creative |url| starts playing in |owner|.
+  void Played(void const *owner, std::string const &url) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_creatives.find(Key(owner, url));
+    if (it != m_creatives.end() && it->second.ready) {
+      ++m_stats.hits;
+    } else {
+      ++m_stats.misses;
+    }
+    if (it != m_creatives.end()) {
+      m_creatives.erase(it);
+    }
+  }
+
+  // The break of |url| will not play in |owner| (seeked over, or the content changed).
+  void Abandon(void const *owner, std::string const &url) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_creatives.find(Key(owner, url));
+    if (it == m_creatives.end()) {
+      return;
+    }
+    if (!it->second.ready) {
+      it->second.abandoned = true; // counted once its bytes are known
+      return;
+    }
+    m_stats.wastedBytes += it->second.bytes;
+    m_creatives.erase(it);
+  }
+
+  AdPrefetchStats Stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+
+ private:
+  struct Creative {
+    bool ready = false;
+    bool abandoned = false;
+    uint64_t bytes = 0;
+  };
+  using CreativeKey = std::pair<void const *, std::string>;
+
+  static CreativeKey Key(void const *owner, std::string const &url) {
+    return {owner, url};
+  }
+
+  mutable std::mutex m_mutex;
+  std::map<CreativeKey, Creative> m_creatives;
+  AdPrefetchStats m_stats;
+};
+
+// Spaces a background transfer so it averages at most |share| of the link.
+class TransferPacer {
+ public:
+  explicit TransferPacer(double share) : m_share(share) {}
+
+  // How long to wait after moving |bytes| in |elapsedMs| on a link of |bandwidth| bits per second (0 when
+  // unknown, which is taken as a slow link).
+  int64_t DelayMs(uint64_t bytes, int64_t elapsedMs, uint64_t bandwidth) const {
+    constexpr uint64_t c_unknownBandwidth = 1000000;
+    auto rate = m_share * static_cast<double>(bandwidth != 0 ? bandwidth : c_unknownBandwidth);
+    auto targetMs = static_cast<int64_t>(static_cast<double>(bytes) * 8 * 1000 / rate);
+    return std::max<int64_t>(targetMs - elapsedMs, 0);
+  }
+
+ private:
+  double m_share;
+};
+
+} // namespace ReactNativeVideoCPP
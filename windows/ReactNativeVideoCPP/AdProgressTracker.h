@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "VastParser.h"
+
+// Portable (WinRT-free) bookkeeping of the playing ad's VAST milestones: start, the three quartiles and
+// complete, plus any progress offsets the ad asks to be told about. Each is reported once however often
+// the position is sampled, and one a coarse sample skipped over is still reported.
+namespace ReactNativeVideoCPP {
+
+enum class AdMilestone { Start, FirstQuartile, Midpoint, ThirdQuartile, Complete, Count };
+
+// The VAST tracking event of a milestone.
+inline std::string_view TrackingEventOf(AdMilestone milestone) {
+  constexpr std::string_view c_events[] = {"start", "firstQuartile", "midpoint", "thirdQuartile", "complete"};
+  return c_events[static_cast<int>(milestone)];
+}
+
+class AdProgressTracker {
+ public:
+  void Start(VastAd ad) {
+    m_ad = std::move(ad);
+    m_next = AdMilestone::Start;
+    m_progressFired.assign(m_ad.linear.tracking.size(), false);
+    m_active = true;
+  }
+
+  void Stop() {
+    m_active = false;
+  }
+
+  bool Active() const {
+    return m_active;
+  }
+
+  VastAd const &Ad() const {
+    return m_ad;
+  }
+
+  // Calls |onMilestone(AdMilestone)| for every milestone up to |position| seconds into the ad not yet
+  // reported, and |onUrl(std::string const &)| for the tracking URLs they and any progress offsets fire.
+  template <typename OnMilestone, typename OnUrl>
+  void Advance(double position, OnMilestone &&onMilestone, OnUrl &&onUrl) {
+    if (!m_active) {
+      return;
+    }
+    auto duration = m_ad.linear.duration;
+    while (m_next < AdMilestone::Complete &&
+           (m_next == AdMilestone::Start || position >= duration * static_cast<int>(m_next) / 4)) {
+      Fire(m_next, onMilestone, onUrl);
+      m_next = static_cast<AdMilestone>(static_cast<int>(m_next) + 1);
+    }
+    auto const &tracking = m_ad.linear.tracking;
+    for (size_t i = 0; i < tracking.size(); ++i) {
+      if (!m_progressFired[i] && tracking[i].event == "progress" && tracking[i].offset >= 0 &&
+          position >= tracking[i].offset) {
+        m_progressFired[i] = true;
+        onUrl(tracking[i].url);
+      }
+    }
+  }
+
+  // The ad played to its end: reports what is left, complete last, and stops.
+  template <typename OnMilestone, typename OnUrl>
+  void Complete(OnMilestone &&onMilestone, OnUrl &&onUrl) {
+    if (!m_active) {
+      return;
+    }
+    Advance(m_ad.linear.duration, onMilestone, onUrl);
+    Fire(AdMilestone::Complete, onMilestone, onUrl);
+    m_active = false;
+  }
+
+  // Fires the tracking URLs of a one-off event such as "skip" or "pause".
+  template <typename OnUrl>
+  void Track(std::string_view event, OnUrl &&onUrl) const {
+    for (auto const &tracking : m_ad.linear.tracking) {
+      if (tracking.event == event) {
+        onUrl(tracking.url);
+      }
+    }
+  }
+
+ private:
+  template <typename OnMilestone, typename OnUrl>
+  void Fire(AdMilestone milestone, OnMilestone &onMilestone, OnUrl &onUrl) {
+    onMilestone(milestone);
+    Track(TrackingEventOf(milestone), onUrl);
+  }
+
+  VastAd m_ad;
+  AdMilestone m_next = AdMilestone::Start;
+  std::vector<bool> m_progressFired;
+  bool m_active = false;
+};
+
+} // namespace ReactNativeVideoCPP
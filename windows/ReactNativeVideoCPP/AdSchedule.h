@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "VastParser.h"
+
+// Portable (WinRT-free) index of the ad breaks of one piece of content. Cue points are kept sorted in their
+// own array, so the per-progress-tick question "did playback cross a break since the last tick?" is a
+// binary search rather than a walk over every break. Breaks placed by percentage or at the end of the
+// content are only placed once the content duration is known.
+namespace ReactNativeVideoCPP {
+
+struct AdBreak {
+  std::string id;
+  VmapTimeOffset timeOffset;
+  std::vector<VastAd> ads; // resolved inline ads, in pod order
+  bool played = false;
+};
+
+class AdSchedule {
+ public:
+  static constexpr size_t c_none = static_cast<size_t>(-1);
+
+  void Assign(std::vector<AdBreak> breaks) {
+    m_breaks = std::move(breaks);
+    Index();
+  }
+
+  void Clear() {
+    m_breaks.clear();
+    m_times.clear();
+    m_order.clear();
+    m_contentDuration = 0;
+  }
+
+  // Places the breaks that depend on the content duration.
+  void SetContentDuration(double duration) {
+    if (duration > 0 && duration != m_contentDuration) {
+      m_contentDuration = duration;
+      Index();
+    }
+  }
+
+  bool Empty() const {
+    return m_breaks.empty();
+  }
+
+  size_t Size() const {
+    return m_breaks.size();
+  }
+
+  AdBreak const &Break(size_t index) const {
+    return m_breaks[index];
+  }
+
+  // Seconds into the content at which break |index| plays: its cue point, or the content duration for a
+  // post-roll. NaN while it cannot be placed yet.
+  double TimeOf(size_t index) const {
+    if (m_breaks[index].timeOffset.kind == VmapTimeOffset::Kind::End) {
+      return m_contentDuration > 0 ? m_contentDuration : std::numeric_limits<double>::quiet_NaN();
+    }
+    return CueOf(m_breaks[index]);
+  }
+
+  // The unplayed breaks whose cue point playback crossed going from |from| to |to| seconds, in content
+  // order. A pre-roll is crossed by starting from a negative position. Costs O(log n) plus the breaks found.
+  std::vector<size_t> Due(double from, double to) const {
+    std::vector<size_t> due;
+    if (!(to > from)) {
+      return due;
+    }
+    auto first = std::upper_bound(m_times.begin(), m_times.end(), from);
+    auto last = std::upper_bound(first, m_times.end(), to);
+    for (auto it = first; it != last; ++it) {
+      auto index = m_order[it - m_times.begin()];
+      if (!m_breaks[index].played) {
+        due.push_back(index);
+      }
+    }
+    return due;
+  }
+
+  // The first unplayed break with its cue point after |position|, or c_none.
+  size_t Next(double position) const {
+    for (auto it = std::upper_bound(m_times.begin(), m_times.end(), position); it != m_times.end(); ++it) {
+      auto index = m_order[it - m_times.begin()];
+      if (!m_breaks[index].played) {
+        return index;
+      }
+    }
+    return c_none;
+  }
+
+  // The break that plays next after |position|: Next(position), or the post-roll once no other is left.
+  size_t Upcoming(double position) const {
+    auto next = Next(position);
+    return next != c_none ? next : PostRoll();
+  }
+
+  // The break whose creatives should be downloading at |position|: Upcoming(position), a post-roll
+  // included, once it plays within |leadSeconds|. c_none otherwise, e.g. for a post-roll while the content
+  // duration is unknown.
+  size_t PrefetchDue(double position, double leadSeconds) const {
+    auto next = Upcoming(position);
+    return next != c_none && TimeOf(next) - position <= leadSeconds ? next : c_none;
+  }
+
+  // The post-roll, once the content has ended.
+  size_t PostRoll() const {
+    for (size_t i = 0; i < m_breaks.size(); ++i) {
+      if (m_breaks[i].timeOffset.kind == VmapTimeOffset::Kind::End && !m_breaks[i].played) {
+        return i;
+      }
+    }
+    return c_none;
+  }
+
+  void MarkPlayed(size_t index) {
+    m_breaks[index].played = true;
+  }
+
+ private:
+  // Seconds into the content, NaN while a break cannot be placed yet. Post-rolls are not on the timeline:
+  // they play when the content ends, not when playback gets close to its duration.
+  double CueOf(AdBreak const &adBreak) const {
+    constexpr auto c_unplaced = std::numeric_limits<double>::quiet_NaN();
+    switch (adBreak.timeOffset.kind) {
+      case VmapTimeOffset::Kind::Start:
+        return 0;
+      case VmapTimeOffset::Kind::Seconds:
+        return adBreak.timeOffset.value;
+      case VmapTimeOffset::Kind::Percent:
+        return m_contentDuration > 0 ? m_contentDuration * adBreak.timeOffset.value / 100 : c_unplaced;
+      case VmapTimeOffset::Kind::End:
+      case VmapTimeOffset::Kind::Position: // positional breaks need opportunities this player does not have
+        return c_unplaced;
+    }
+    return c_unplaced;
+  }
+
+  void Index() {
+    m_order.clear();
+    for (size_t i = 0; i < m_breaks.size(); ++i) {
+      if (!std::isnan(CueOf(m_breaks[i]))) {
+        m_order.push_back(i);
+      }
+    }
+    std::stable_sort(m_order.begin(), m_order.end(), [this](size_t a, size_t b) {
+      return CueOf(m_breaks[a]) < CueOf(m_breaks[b]);
+    });
+    m_times.clear();
+    for (auto index : m_order) {
+      m_times.push_back(CueOf(m_breaks[index]));
+    }
+  }
+
+  std::vector<AdBreak> m_breaks;
+  std::vector<double> m_times; // sorted cue points
+  std::vector<size_t> m_order; // m_order[i] is the break cued at m_times[i]
+  double m_contentDuration = 0;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// Portable (WinRT-free) network throughput estimate shared by every player in the process. Each finished
+// download is one sample; the estimate is the lower of a weighted sliding-window median (robust against a
+// single outlier transfer) and an EWMA over transfer time (quick to follow a drop). Until enough data has
+// been seen the estimate is the prior, e.g. the estimate persisted by the previous app session.
+namespace ReactNativeVideoCPP {
+
+// Transfers without a measurable duration carry no throughput information.
+constexpr int64_t c_minSampleElapsedMs = 1;
+// The prior is trusted until this much has been observed, same thresholds as ExoPlayer.
+constexpr int64_t c_priorElapsedMs = 2000;
+constexpr uint64_t c_priorBytes = 512 * 1024;
+// Sliding window size in sqrt(bytes) units, so large transfers weigh more without drowning small ones.
+constexpr double c_defaultMaxWindowWeight = 2000;
+constexpr double c_defaultHalfLifeMs = 4000;
+
+class BandwidthEstimator {
+ public:
+  explicit BandwidthEstimator(
+      double maxWindowWeight = c_defaultMaxWindowWeight,
+      double halfLifeMs = c_defaultHalfLifeMs)
+      : m_maxWindowWeight(maxWindowWeight), m_halfLifeMs(halfLifeMs) {}
+
+  // Bits per second to report until enough samples arrived; 0 means unknown.
+  void SetPrior(uint64_t bitsPerSecond) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_prior = bitsPerSecond;
+  }
+
+  // Records one finished transfer and returns the updated estimate. Safe to call from any thread.
+  uint64_t AddSample(uint64_t bytes, int64_t elapsedMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (bytes == 0 || elapsedMs < c_minSampleElapsedMs) {
+      return EstimateLocked();
+    }
+    double bitsPerSecond = bytes * 8000.0 / elapsedMs;
+    m_totalBytes += bytes;
+    m_totalElapsedMs += elapsedMs;
+
+    AddToWindow(std::sqrt(static_cast<double>(bytes)), bitsPerSecond);
+
+    // weight each sample by how long it took, so one long transfer moves the average more than a short one
+    double alpha = std::pow(0.5, elapsedMs / m_halfLifeMs);
+    m_ewma = m_ewma * alpha + bitsPerSecond * (1 - alpha);
+    m_ewmaWeight = m_ewmaWeight * alpha + (1 - alpha);
+
+    return EstimateLocked();
+  }
+
+  // Bits per second, 0 when there is neither data nor a prior.
+  uint64_t Estimate() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return EstimateLocked();
+  }
+
+  // Drops all samples but keeps the prior.
+  void Reset() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_window.clear();
+    m_windowWeight = 0;
+    m_ewma = 0;
+    m_ewmaWeight = 0;
+    m_totalBytes = 0;
+    m_totalElapsedMs = 0;
+  }
+
+ private:
+  struct WindowSample {
+    double weight;
+    double value;
+  };
+
+  void AddToWindow(double weight, double value) {
+    m_window.push_back(WindowSample{weight, value});
+    m_windowWeight += weight;
+    // evict the oldest samples, trimming the last one partially so the window holds exactly the max weight
+    while (m_windowWeight > m_maxWindowWeight && !m_window.empty()) {
+      auto excess = m_windowWeight - m_maxWindowWeight;
+      auto &oldest = m_window.front();
+      if (oldest.weight <= excess) {
+        m_windowWeight -= oldest.weight;
+        m_window.pop_front();
+      } else {
+        oldest.weight -= excess;
+        m_windowWeight -= excess;
+      }
+    }
+  }
+
+  double WindowMedian() const {
+    std::vector<WindowSample> sorted(m_window.begin(), m_window.end());
+    std::sort(sorted.begin(), sorted.end(), [](WindowSample const &a, WindowSample const &b) {
+      return a.value < b.value;
+    });
+    double half = m_windowWeight / 2;
+    double accumulated = 0;
+    for (auto const &sample : sorted) {
+      accumulated += sample.weight;
+      if (accumulated >= half) {
+        return sample.value;
+      }
+    }
+    return sorted.empty() ? 0 : sorted.back().value;
+  }
+
+  uint64_t EstimateLocked() const {
+    if (m_window.empty()) {
+      return m_prior;
+    }
+    if (m_prior > 0 && m_totalElapsedMs < c_priorElapsedMs && m_totalBytes < c_priorBytes) {
+      return m_prior;
+    }
+    double ewma = m_ewmaWeight > 0 ? m_ewma / m_ewmaWeight : 0; // bias corrected
+    return static_cast<uint64_t>(std::min(WindowMedian(), ewma));
+  }
+
+  double const m_maxWindowWeight;
+  double const m_halfLifeMs;
+
+  mutable std::mutex m_mutex;
+  uint64_t m_prior = 0;
+  std::deque<WindowSample> m_window;
+  double m_windowWeight = 0;
+  double m_ewma = 0;
+  double m_ewmaWeight = 0;
+  uint64_t m_totalBytes = 0;
+  int64_t m_totalElapsedMs = 0;
+};
+
+} // namespace ReactNativeVideoCPP
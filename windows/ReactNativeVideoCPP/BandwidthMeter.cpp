@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "BandwidthMeter.h"
+#include <chrono>
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+namespace {
+
+constexpr wchar_t c_estimateSettingKey[] = L"ReactNativeVideo.BandwidthEstimate";
+constexpr int64_t c_persistIntervalMs = 10000;
+
+int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+BandwidthMeter &BandwidthMeter::Instance() {
+  // intentionally leaked, download callbacks may still arrive during shutdown
+  static auto *meter = new BandwidthMeter();
+  return *meter;
+}
+
+BandwidthMeter::BandwidthMeter() {
+  try {
+    auto values = Windows::Storage::ApplicationData::Current().LocalSettings().Values();
+    m_estimator.SetPrior(winrt::unbox_value_or<uint64_t>(values.TryLookup(c_estimateSettingKey), 0));
+  } catch (winrt::hresult_error const &) {
+    // no app data (e.g. unpackaged host), start without a prior
+  }
+}
+
+uint64_t BandwidthMeter::AddSample(uint64_t bytes, int64_t elapsedMs) {
+  auto estimate = m_estimator.AddSample(bytes, elapsedMs);
+  PersistThrottled(estimate);
+  return estimate;
+}
+
+uint64_t BandwidthMeter::Estimate() const {
+  return m_estimator.Estimate();
+}
+
+void BandwidthMeter::PersistThrottled(uint64_t estimate) {
+  auto now = NowMs();
+  auto last = m_lastPersistMs.load(std::memory_order_relaxed);
+  // the exchange lets only one download thread write per interval
+  if (estimate == 0 || now - last < c_persistIntervalMs ||
+      !m_lastPersistMs.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+    return;
+  }
+  try {
+    Windows::Storage::ApplicationData::Current().LocalSettings().Values().Insert(
+        c_estimateSettingKey, winrt::box_value(estimate));
+  } catch (winrt::hresult_error const &) {
+    // best effort, the estimate is only a hint for the next launch
+  }
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
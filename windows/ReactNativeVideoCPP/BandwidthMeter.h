@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include "BandwidthEstimator.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// The process-wide throughput estimate every ReactVideoView feeds with its segment downloads. The estimate
+// is saved to the app's local settings so the next launch starts from it instead of from nothing.
+class BandwidthMeter {
+ public:
+  static BandwidthMeter &Instance();
+
+  // Safe to call from any thread. Returns the updated estimate in bits per second.
+  uint64_t AddSample(uint64_t bytes, int64_t elapsedMs);
+
+  // Bits per second, 0 when unknown.
+  uint64_t Estimate() const;
+
+ private:
+  BandwidthMeter();
+
+  void PersistThrottled(uint64_t estimate);
+
+  ::ReactNativeVideoCPP::BandwidthEstimator m_estimator;
+  std::atomic<int64_t> m_lastPersistMs{0};
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
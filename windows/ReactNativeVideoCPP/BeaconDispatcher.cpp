@@ -0,0 +1,109 @@
+#include "pch.h"
+#include "BeaconDispatcher.h"
+#include "PlaybackStateBlock.h"
+
+#include <random>
+
+using namespace Windows::Foundation;
+using namespace Windows::System::Threading;
+using namespace Windows::Web::Http;
+
+using ::ReactNativeVideoCPP::Beacon;
+using ::ReactNativeVideoCPP::BeaconQueue;
+using ::ReactNativeVideoCPP::BeaconQueueStats;
+using ::ReactNativeVideoCPP::PlaybackStateBlock;
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+BeaconDispatcher &BeaconDispatcher::Instance() {
+  // intentionally leaked, sends may still be completing on the thread pool during shutdown
+  static auto *dispatcher = new BeaconDispatcher();
+  return *dispatcher;
+}
+
+BeaconDispatcher::BeaconDispatcher() {
+  std::filesystem::path folder;
+  try {
+    auto root = Windows::Storage::ApplicationData::Current().LocalFolder().Path();
+    folder = std::filesystem::path{std::wstring_view{root}} / L"Beacons";
+  } catch (winrt::hresult_error const &) {
+    // no app data (e.g. unpackaged host), beacons are kept in memory and lost with the process
+  }
+  m_queue = std::make_unique<BeaconQueue>(folder, ::ReactNativeVideoCPP::BeaconQueuePolicy{}, std::random_device{}());
+  Schedule(); // beacons recovered from the log are due now
+}
+
+void BeaconDispatcher::Send(std::string url) {
+  Enqueue(std::move(url), PlaybackStateBlock::NowMs());
+}
+
+BeaconQueueStats BeaconDispatcher::Stats() const {
+  return m_queue->Stats();
+}
+
+void BeaconDispatcher::Schedule() {
+  auto wakeMs = m_queue->NextWakeMs();
+  std::lock_guard<std::mutex> lock(m_timerMutex);
+  if (wakeMs == BeaconQueue::c_never || wakeMs >= m_timerDueMs) {
+    return;
+  }
+  if (m_timer) {
+    m_timer.Cancel();
+  }
+  m_timerDueMs = wakeMs;
+  auto delayMs = std::max<int64_t>(wakeMs - PlaybackStateBlock::NowMs(), 0);
+  m_timer = ThreadPoolTimer::CreateTimer(
+      [this](ThreadPoolTimer const &) {
+        {
+          std::lock_guard<std::mutex> lock(m_timerMutex);
+          m_timer = nullptr;
+          m_timerDueMs = BeaconQueue::c_never;
+        }
+        Flush();
+      },
+      std::chrono::milliseconds(delayMs));
+}
+
+fire_and_forget BeaconDispatcher::Enqueue(std::string url, int64_t nowMs) {
+  co_await resume_background();
+  if (m_queue->Enqueue(std::move(url), nowMs)) {
+    Schedule();
+  }
+}
+
+void BeaconDispatcher::Flush() {
+  for (auto &beacon : m_queue->TakeBurst(PlaybackStateBlock::NowMs())) {
+    Deliver(std::move(beacon));
+  }
+  Schedule(); // for the next beacon not due yet, those held back by the limits wait for a send to complete
+}
+
+fire_and_forget BeaconDispatcher::Deliver(Beacon beacon) {
+  Uri uri{nullptr};
+  try {
+    uri = Uri(to_hstring(beacon.url));
+  } catch (winrt::hresult_error const &) {
+    // malformed URI, no retry will parse it
+  }
+  if (uri == nullptr) {
+    m_queue->Discard(beacon.id);
+    Schedule();
+    co_return;
+  }
+  bool delivered = false;
+  try {
+    auto response = co_await m_client.GetAsync(uri);
+    // a 4xx will not get any better by asking again
+    delivered = static_cast<int32_t>(response.StatusCode()) < 500;
+  } catch (winrt::hresult_error const &) {
+    // offline, retried with backoff
+  }
+  if (delivered) {
+    m_queue->Delivered(beacon.id);
+  } else {
+    m_queue->Failed(beacon.id, PlaybackStateBlock::NowMs());
+  }
+  Schedule();
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
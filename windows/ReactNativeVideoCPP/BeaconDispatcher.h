@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include "BeaconQueue.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// Delivers ad tracking beacons from a BeaconQueue kept in the app's local folder: a thread pool timer wakes
+// for each burst, and every response is fed back to the queue so failures are retried and delivered beacons
+// leave the log. Beacons left over from the previous run go out shortly after the first use.
+class BeaconDispatcher {
+ public:
+  static BeaconDispatcher &Instance();
+
+  // Queues an impression, tracking or error URL for delivery. Safe from any thread; the log write happens
+  // on the thread pool, so it costs the caller (usually the UI thread) nothing.
+  void Send(std::string url);
+
+  ::ReactNativeVideoCPP::BeaconQueueStats Stats() const;
+
+ private:
+  BeaconDispatcher();
+
+  // Arms the timer for the queue's next wakeup, unless it is already armed for an earlier one.
+  void Schedule();
+  fire_and_forget Enqueue(std::string url, int64_t nowMs);
+  void Flush();
+  fire_and_forget Deliver(::ReactNativeVideoCPP::Beacon beacon);
+
+  Windows::Web::Http::HttpClient m_client;
+  std::unique_ptr<::ReactNativeVideoCPP::BeaconQueue> m_queue;
+  std::mutex m_timerMutex;
+  Windows::System::Threading::ThreadPoolTimer m_timer{nullptr};
+  int64_t m_timerDueMs = ::ReactNativeVideoCPP::BeaconQueue::c_never;
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
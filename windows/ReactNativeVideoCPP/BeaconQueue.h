@@ -0,0 +1,377 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "MappedFile.h"
+
+// Portable (WinRT-free) queue of ad tracking beacons (impression, quartile, click and error pixels) that
+// must reach their servers even when the network drops out. Beacons are held back briefly and sent in
+// bursts, so a quartile and the impressions raised around it cost one radio wakeup instead of several.
+// Failed sends are retried with jittered exponential backoff, no host gets more than a few requests at a
+// time, and every beacon is written to an append-only log until it is delivered, so what is still queued
+// when the app is killed goes out on the next launch. Failed attempts are logged too, so a beacon that
+// never gets through is given up on across launches rather than retried afresh by each one. A torn last
+// record is dropped on open, as in CacheJournal.
+namespace ReactNativeVideoCPP {
+
+struct Beacon {
+  uint64_t id = 0;
+  std::string url;
+};
+
+struct BeaconQueueStats {
+  uint64_t queued = 0; // beacons enqueued, plus those recovered from the log
+  uint64_t delivered = 0;
+  uint64_t retries = 0; // sends that failed and were rescheduled
+  uint64_t dropped = 0; // beacons given up on after too many attempts, or that cannot be sent at all
+  uint64_t bursts = 0; // TakeBurst calls that sent something
+  uint64_t pending = 0; // beacons not delivered yet
+};
+
+struct BeaconQueuePolicy {
+  int64_t burstDelayMs = 2000; // how long a new beacon waits for others to go out with it
+  uint32_t maxPerHost = 2; // requests in flight to one host
+  uint32_t maxInFlight = 8; // requests in flight overall
+  int64_t initialBackoffMs = 1000;
+  int64_t maxBackoffMs = 10 * 60 * 1000;
+  uint32_t maxAttempts = 8;
+};
+
+// The host (and port) of |url|, empty if it has none.
+inline std::string_view BeaconHostOf(std::string_view url) {
+  auto scheme = url.find("://");
+  if (scheme == std::string_view::npos) {
+    return {};
+  }
+  url.remove_prefix(scheme + 3);
+  url = url.substr(0, url.find_first_of("/?#"));
+  auto at = url.rfind('@');
+  return at == std::string_view::npos ? url : url.substr(at + 1);
+}
+
+class BeaconQueue {
+ public:
+  static constexpr int64_t c_never = std::numeric_limits<int64_t>::max();
+
+  // Recovers the beacons left in |folder|'s log, due right away. An empty |folder| keeps them in memory.
+  explicit BeaconQueue(std::filesystem::path const &folder, BeaconQueuePolicy policy = {}, uint64_t seed = 0)
+      : m_policy(policy), m_random(seed) {
+    if (folder.empty()) {
+      return;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+    m_logPath = folder / "beacons.log";
+    Recover();
+  }
+
+  BeaconQueue(BeaconQueue const &) = delete;
+  BeaconQueue &operator=(BeaconQueue const &) = delete;
+
+  // Writes to the log, keep it off the UI thread. False (and dropped) when |url| has no host to send it to.
+  bool Enqueue(std::string url, int64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (BeaconHostOf(url).empty()) {
+      ++m_stats.dropped;
+      return false;
+    }
+    auto id = m_nextId++;
+    AppendLocked(Op::Add, id, url);
+    m_pending.push_back(Entry{id, std::move(url), nowMs + m_policy.burstDelayMs, 0, false});
+    ++m_stats.queued;
+    return true;
+  }
+
+  // The beacons to send now, marked in flight: every beacon that is due, plus those that would be due
+  // within the burst delay so they ride the same wakeup, as far as the concurrency limits allow. Report
+  // each one back with Delivered or Failed.
+  std::vector<Beacon> TakeBurst(int64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Beacon> burst;
+    bool due = std::any_of(m_pending.begin(), m_pending.end(), [nowMs](Entry const &entry) {
+      return !entry.inFlight && entry.dueMs <= nowMs;
+    });
+    if (!due) {
+      return burst;
+    }
+    for (auto &entry : m_pending) {
+      if (m_inFlight >= m_policy.maxInFlight) {
+        break;
+      }
+      if (entry.inFlight || entry.dueMs > nowMs + m_policy.burstDelayMs) {
+        continue;
+      }
+      auto &hostCount = m_hostsInFlight[std::string(BeaconHostOf(entry.url))];
+      if (hostCount >= m_policy.maxPerHost) {
+        continue;
+      }
+      ++hostCount;
+      ++m_inFlight;
+      entry.inFlight = true;
+      burst.push_back(Beacon{entry.id, entry.url});
+    }
+    if (!burst.empty()) {
+      ++m_stats.bursts;
+    }
+    return burst;
+  }
+
+  void Delivered(uint64_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = FindLocked(id);
+    if (it == m_pending.end()) {
+      return;
+    }
+    ReleaseLocked(*it);
+    ++m_stats.delivered;
+    RemoveLocked(it);
+  }
+
+  // The send of |id| failed in a way worth retrying (no connection, a server error).
+  void Failed(uint64_t id, int64_t nowMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = FindLocked(id);
+    if (it == m_pending.end()) {
+      return;
+    }
+    ReleaseLocked(*it);
+    if (++it->attempts >= m_policy.maxAttempts) {
+      ++m_stats.dropped;
+      RemoveLocked(it);
+      return;
+    }
+    // "equal jitter": half the exponential delay, plus a random share of the other half, so beacons that
+    // failed together don't all come back together
+    auto exponent = std::min<uint32_t>(it->attempts - 1, 30);
+    auto ceiling = std::min(m_policy.initialBackoffMs << exponent, m_policy.maxBackoffMs);
+    std::uniform_int_distribution<int64_t> jitter(0, ceiling / 2);
+    it->dueMs = nowMs + ceiling - ceiling / 2 + jitter(m_random);
+    ++m_stats.retries;
+    AppendLocked(Op::Failed, it->id, {}, it->attempts);
+  }
+
+  // The send of |id| can never succeed (its URL does not parse), so it is dropped without a retry.
+  void Discard(uint64_t id) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = FindLocked(id);
+    if (it == m_pending.end()) {
+      return;
+    }
+    ReleaseLocked(*it);
+    ++m_stats.dropped;
+    RemoveLocked(it);
+  }
+
+  // When TakeBurst will next have something to send, c_never when nothing is waiting. Beacons held back
+  // only by the concurrency limits are left out: a Delivered or Failed report frees their slot.
+  int64_t NextWakeMs() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_inFlight >= m_policy.maxInFlight) {
+      return c_never;
+    }
+    auto wake = c_never;
+    for (auto const &entry : m_pending) {
+      if (entry.inFlight || entry.dueMs >= wake) {
+        continue;
+      }
+      auto host = m_hostsInFlight.find(std::string(BeaconHostOf(entry.url)));
+      if (host == m_hostsInFlight.end() || host->second < m_policy.maxPerHost) {
+        wake = entry.dueMs;
+      }
+    }
+    return wake;
+  }
+
+  BeaconQueueStats Stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto stats = m_stats;
+    stats.pending = m_pending.size();
+    return stats;
+  }
+
+ private:
+  enum class Op : uint8_t { Add = 1, Done = 2, Failed = 3 };
+
+  struct Entry {
+    uint64_t id;
+    std::string url;
+    int64_t dueMs;
+    uint32_t attempts;
+    bool inFlight;
+  };
+
+  struct LogHeader {
+    char magic[4];
+    uint32_t reserved;
+  };
+
+  // followed by |length| bytes of URL
+  struct Record {
+    uint32_t checksum;
+    uint8_t op;
+    uint8_t reserved[3];
+    uint32_t length;
+    uint32_t attempts; // Add, Failed: the failed sends so far
+    uint64_t id;
+  };
+
+  static constexpr char c_logMagic[4] = {'R', 'N', 'V', 'B'};
+  static constexpr uint64_t c_minCompactRecords = 1024;
+
+  // FNV-1a over the record after its checksum, and the URL.
+  static uint32_t Checksum(Record const &record, std::string_view url) {
+    uint32_t hash = 2166136261u;
+    auto add = [&hash](uint8_t const *bytes, size_t size) {
+      for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+      }
+    };
+    add(reinterpret_cast<uint8_t const *>(&record) + sizeof(record.checksum), sizeof(record) - sizeof(record.checksum));
+    add(reinterpret_cast<uint8_t const *>(url.data()), url.size());
+    return hash;
+  }
+
+  static std::string Serialize(Op op, uint64_t id, std::string_view url, uint32_t attempts) {
+    Record record{};
+    record.op = static_cast<uint8_t>(op);
+    record.length = static_cast<uint32_t>(url.size());
+    record.attempts = attempts;
+    record.id = id;
+    record.checksum = Checksum(record, url);
+    std::string bytes(reinterpret_cast<char const *>(&record), sizeof(record));
+    bytes.append(url);
+    return bytes;
+  }
+
+  void Recover() {
+    MappedFile log;
+    uint64_t validBytes = 0;
+    if (log.Open(m_logPath) && log.Size() >= sizeof(LogHeader) &&
+        std::memcmp(log.Data(), c_logMagic, sizeof(c_logMagic)) == 0) {
+      validBytes = sizeof(LogHeader);
+      std::unordered_map<uint64_t, size_t> positions; // id -> index in m_pending
+      while (log.Size() - validBytes >= sizeof(Record)) {
+        Record record;
+        std::memcpy(&record, log.Data() + validBytes, sizeof(record));
+        if (log.Size() - validBytes - sizeof(record) < record.length) {
+          break; // torn by a crash
+        }
+        std::string_view url(reinterpret_cast<char const *>(log.Data()) + validBytes + sizeof(record), record.length);
+        if (record.checksum != Checksum(record, url)) {
+          break;
+        }
+        validBytes += sizeof(record) + record.length;
+        ++m_records;
+        m_nextId = std::max(m_nextId, record.id + 1);
+        auto op = static_cast<Op>(record.op);
+        if (op == Op::Add) {
+          positions[record.id] = m_pending.size();
+          m_pending.push_back(Entry{record.id, std::string(url), 0, record.attempts, false});
+        } else if (auto it = positions.find(record.id); it == positions.end()) {
+          continue;
+        } else if (op == Op::Failed) {
+          m_pending[it->second].attempts = record.attempts;
+        } else {
+          m_pending[it->second].id = 0; // delivered or dropped, swept below
+        }
+      }
+    }
+    log.Close();
+    // beacons already past a maxAttempts lowered since they were logged
+    auto exhausted = [this](Entry const &entry) { return entry.id != 0 && entry.attempts >= m_policy.maxAttempts; };
+    m_stats.dropped = static_cast<uint64_t>(std::count_if(m_pending.begin(), m_pending.end(), exhausted));
+    m_pending.erase(
+        std::remove_if(
+            m_pending.begin(),
+            m_pending.end(),
+            [&exhausted](Entry const &entry) { return entry.id == 0 || exhausted(entry); }),
+        m_pending.end());
+    m_stats.queued = m_pending.size();
+
+    if (validBytes == 0 || m_stats.dropped != 0 || ShouldCompactLocked()) {
+      CompactLocked();
+    } else {
+      std::error_code error;
+      std::filesystem::resize_file(m_logPath, validBytes, error);
+      m_log.open(m_logPath, std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+    }
+  }
+
+  void AppendLocked(Op op, uint64_t id, std::string_view url, uint32_t attempts = 0) {
+    if (!m_log.is_open()) {
+      return;
+    }
+    auto bytes = Serialize(op, id, url, attempts);
+    m_log.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    m_log.flush();
+    ++m_records;
+  }
+
+  bool ShouldCompactLocked() const {
+    return m_records > c_minCompactRecords && m_records > 2 * static_cast<uint64_t>(m_pending.size());
+  }
+
+  // Rewrites the log with just the beacons still pending.
+  void CompactLocked() {
+    LogHeader header{};
+    std::memcpy(header.magic, c_logMagic, sizeof(c_logMagic));
+    std::string bytes(reinterpret_cast<char const *>(&header), sizeof(header));
+    for (auto const &entry : m_pending) {
+      bytes.append(Serialize(Op::Add, entry.id, entry.url, entry.attempts));
+    }
+    m_log.close();
+    if (WriteFileAtomically(m_logPath, bytes)) {
+      m_records = m_pending.size();
+    }
+    m_log.open(m_logPath, std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+  }
+
+  std::vector<Entry>::iterator FindLocked(uint64_t id) {
+    return std::find_if(m_pending.begin(), m_pending.end(), [id](Entry const &entry) { return entry.id == id; });
+  }
+
+  void ReleaseLocked(Entry &entry) {
+    if (!entry.inFlight) {
+      return;
+    }
+    entry.inFlight = false;
+    --m_inFlight;
+    auto host = m_hostsInFlight.find(std::string(BeaconHostOf(entry.url)));
+    if (host != m_hostsInFlight.end() && --host->second == 0) {
+      m_hostsInFlight.erase(host);
+    }
+  }
+
+  void RemoveLocked(std::vector<Entry>::iterator it) {
+    AppendLocked(Op::Done, it->id, {});
+    m_pending.erase(it);
+    if (m_log.is_open() && ShouldCompactLocked()) {
+      CompactLocked();
+    }
+  }
+
+  BeaconQueuePolicy const m_policy;
+  mutable std::mutex m_mutex;
+  std::mt19937_64 m_random;
+  std::filesystem::path m_logPath; // empty when kept in memory
+  std::fstream m_log;
+  uint64_t m_records = 0; // in the log
+  uint64_t m_nextId = 1;
+  std::vector<Entry> m_pending; // in the order they were queued
+  std::unordered_map<std::string, uint32_t> m_hostsInFlight;
+  uint32_t m_inFlight = 0;
+  BeaconQueueStats m_stats;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Portable (WinRT-free) thread-safe pool of reusable objects with an upper bound on how many idle
+// objects are retained. Callers reset an object to a neutral state before handing it back.
+namespace ReactNativeVideoCPP {
+
+struct PoolStats {
+  uint64_t created = 0;
+  uint64_t reused = 0;
+  uint64_t returned = 0;
+  uint64_t dropped = 0;
+};
+
+template <typename T>
+class BoundedPool {
+ public:
+  explicit BoundedPool(size_t maxSize) : m_maxSize(maxSize) {}
+
+  BoundedPool(BoundedPool const &) = delete;
+  BoundedPool &operator=(BoundedPool const &) = delete;
+
+  // Hands out an idle object, or a new one from |factory| when none is available.
+  template <typename Factory>
+  T Acquire(Factory &&factory) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_idle.empty()) {
+        T item = std::move(m_idle.back());
+        m_idle.pop_back();
+        ++m_stats.reused;
+        return item;
+      }
+      ++m_stats.created;
+    }
+    return factory();
+  }
+
+  // Returns an object to the pool. Returns false when the pool is full and the object was dropped.
+  bool Release(T &&item) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_idle.size() >= m_maxSize) {
+      ++m_stats.dropped;
+      return false;
+    }
+    m_idle.push_back(std::move(item));
+    ++m_stats.returned;
+    return true;
+  }
+
+  // Creates objects until |count| (capped at the max size) are idle.
+  template <typename Factory>
+  void Prewarm(size_t count, Factory &&factory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto target = count < m_maxSize ? count : m_maxSize;
+    while (m_idle.size() < target) {
+      m_idle.push_back(factory());
+      ++m_stats.created;
+    }
+  }
+
+  void SetMaxSize(size_t maxSize) {
+    std::vector<T> trimmed;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_maxSize = maxSize;
+      while (m_idle.size() > m_maxSize) {
+        trimmed.push_back(std::move(m_idle.back()));
+        m_idle.pop_back();
+        ++m_stats.dropped;
+      }
+    }
+    // |trimmed| is destroyed outside the lock
+  }
+
+  size_t MaxSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxSize;
+  }
+
+  size_t IdleCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_idle.size();
+  }
+
+  PoolStats Stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+
+ private:
+  mutable std::mutex m_mutex;
+  size_t m_maxSize;
+  std::vector<T> m_idle;
+  PoolStats m_stats;
+};
+
+} // namespace ReactNativeVideoCPP
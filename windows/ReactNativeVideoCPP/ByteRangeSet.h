@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Portable (WinRT-free) sorted set of disjoint [start, end) byte ranges, the interval index of which parts
+// of a resource a sparse cache holds. Lookups are O(log n); gaps come out in order so a reader can fetch
+// exactly the bytes that are missing.
+namespace ReactNativeVideoCPP {
+
+struct ByteRange {
+  uint64_t start = 0;
+  uint64_t end = 0;
+};
+
+class ByteRangeSet {
+ public:
+  // Adds [start, end), merging it with any range it overlaps or touches.
+  void Add(uint64_t start, uint64_t end) {
+    if (end <= start) {
+      return;
+    }
+    auto first = std::lower_bound(
+        m_ranges.begin(), m_ranges.end(), start, [](ByteRange const &range, uint64_t b) { return range.end < b; });
+    auto last = first;
+    while (last != m_ranges.end() && last->start <= end) {
+      start = std::min(start, last->start);
+      end = std::max(end, last->end);
+      ++last;
+    }
+    first = m_ranges.erase(first, last);
+    m_ranges.insert(first, ByteRange{start, end});
+  }
+
+  void Clear() {
+    m_ranges.clear();
+  }
+
+  bool Empty() const {
+    return m_ranges.empty();
+  }
+
+  std::vector<ByteRange> const &Ranges() const {
+    return m_ranges;
+  }
+
+  // True when all of [start, end) is present.
+  bool Contains(uint64_t start, uint64_t end) const {
+    if (end <= start) {
+      return true;
+    }
+    auto it = std::upper_bound(
+        m_ranges.begin(), m_ranges.end(), start, [](uint64_t b, ByteRange const &range) { return b < range.end; });
+    return it != m_ranges.end() && it->start <= start && end <= it->end;
+  }
+
+  // The missing parts of [start, end), in order.
+  std::vector<ByteRange> Gaps(uint64_t start, uint64_t end) const {
+    std::vector<ByteRange> gaps;
+    auto it = std::upper_bound(
+        m_ranges.begin(), m_ranges.end(), start, [](uint64_t b, ByteRange const &range) { return b < range.end; });
+    for (; start < end && it != m_ranges.end() && it->start < end; ++it) {
+      if (start < it->start) {
+        gaps.push_back(ByteRange{start, it->start});
+      }
+      start = std::max(start, it->end);
+    }
+    if (start < end) {
+      gaps.push_back(ByteRange{start, end});
+    }
+    return gaps;
+  }
+
+  // Total bytes present.
+  uint64_t Size() const {
+    uint64_t size = 0;
+    for (auto const &range : m_ranges) {
+      size += range.end - range.start;
+    }
+    return size;
+  }
+
+ private:
+  std::vector<ByteRange> m_ranges;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "MappedFile.h"
+
+// Portable (WinRT-free) crash-safe index of a cache folder: a compacted snapshot of the entries plus an
+// append-only journal of what changed since. Opening reads the snapshot and replays the journal, so cold
+// start costs one sequential read instead of a directory scan. Every record carries a checksum and is
+// handed to the OS as soon as it is appended; a process killed mid-write leaves at most a torn last
+// record, which is dropped (and cut off) on the next open. Snapshot and journal share a generation
+// number, so a journal that was already folded into a newer snapshot is never replayed twice.
+//
+// Compaction is split so the snapshot can be written without holding up appends: Rotate closes the
+// journal and starts the next generation's in a second file, and WriteSnapshot then writes the entries
+// as they were at the rotation. Killed in between, the next open replays both journals on top of the
+// older snapshot. Appends and rotations may come from any thread; the journal serializes them itself.
+namespace ReactNativeVideoCPP {
+
+struct CacheJournalEntry {
+  uint64_t hash = 0;
+  uint64_t size = 0;
+  uint32_t frequency = 1; // times the entry was used
+  uint64_t version = 0; // of the entry's file, see SegmentCache
+};
+
+class CacheJournal {
+ public:
+  enum class Op : uint8_t { Insert = 1, Remove = 2, Touch = 3 };
+
+  // Creates |folder| if needed; nothing is read until Open.
+  explicit CacheJournal(std::filesystem::path const &folder) : m_folder(folder) {
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+  }
+
+  CacheJournal(CacheJournal const &) = delete;
+  CacheJournal &operator=(CacheJournal const &) = delete;
+
+  // The recovered entries, least recently used first, and opens the journal for appending. Null when there
+  // is nothing to recover: the folder has no journal yet (e.g. a cache from before the journal), or its
+  // snapshot or journals are damaged. The caller then rebuilds the entries from the files and Compacts.
+  std::optional<std::vector<CacheJournalEntry>> Open() {
+    MappedFile snapshot;
+    SnapshotHeader snapshotHeader;
+    if (!snapshot.Open(SnapshotPath()) || snapshot.Size() < sizeof(snapshotHeader)) {
+      return std::nullopt;
+    }
+    std::memcpy(&snapshotHeader, snapshot.Data(), sizeof(snapshotHeader));
+    if (std::memcmp(snapshotHeader.magic, c_snapshotMagic, 4) != 0 || snapshotHeader.generation == 0 ||
+        snapshot.Size() != sizeof(snapshotHeader) + snapshotHeader.count * sizeof(SnapshotEntry)) {
+      return std::nullopt;
+    }
+    auto generation = snapshotHeader.generation;
+    auto count = snapshotHeader.count;
+
+    // the snapshot's own journal, and the next generation's if a compaction was cut short
+    MappedFile logs[2];
+    uint64_t records[2] = {0, 0};
+    bool present[2] = {false, false};
+    for (uint64_t i = 0; i < 2; ++i) {
+      LogHeader logHeader;
+      if (!logs[i].Open(LogPath(generation + i))) {
+        continue;
+      }
+      if (logs[i].Size() < sizeof(logHeader)) {
+        return std::nullopt;
+      }
+      std::memcpy(&logHeader, logs[i].Data(), sizeof(logHeader));
+      if (std::memcmp(logHeader.magic, c_logMagic, 4) != 0) {
+        return std::nullopt;
+      }
+      if (logHeader.generation != generation + i) {
+        if (i == 1 && logHeader.generation + 1 == generation) {
+          continue; // the journal the snapshot folded in, left by a process killed before deleting it
+        }
+        return std::nullopt;
+      }
+      present[i] = true;
+      records[i] = (logs[i].Size() - sizeof(logHeader)) / sizeof(Record);
+    }
+    if (!present[0]) {
+      return std::nullopt; // written before its snapshot, so it can only have been lost
+    }
+
+    // Every version of an entry is appended in the order it was last used and superseded ones are marked
+    // dead, so the survivors come out already ordered. The table maps a hash to its latest version; keys
+    // are never taken out of it, so open addressing needs no tombstones.
+    auto total = count + records[0] + records[1];
+    std::vector<CacheJournalEntry> versions;
+    std::vector<bool> alive;
+    versions.reserve(static_cast<size_t>(total));
+    alive.reserve(static_cast<size_t>(total));
+    size_t mask = 1;
+    while (mask < 2 * total) {
+      mask <<= 1;
+    }
+    --mask;
+    std::vector<uint32_t> table(mask + 1, c_empty);
+    auto slotOf = [&table, &versions, mask](uint64_t hash) -> uint32_t & {
+      for (auto i = static_cast<size_t>(hash) & mask;; i = (i + 1) & mask) {
+        if (table[i] == c_empty || versions[table[i]].hash == hash) {
+          return table[i];
+        }
+      }
+    };
+    auto add = [&](CacheJournalEntry const &entry) {
+      auto &slot = slotOf(entry.hash);
+      if (slot != c_empty) {
+        alive[slot] = false;
+      }
+      slot = static_cast<uint32_t>(versions.size());
+      versions.push_back(entry);
+      alive.push_back(true);
+    };
+
+    for (uint64_t i = 0; i < count; ++i) {
+      SnapshotEntry stored;
+      std::memcpy(&stored, snapshot.Data() + sizeof(snapshotHeader) + i * sizeof(stored), sizeof(stored));
+      add(CacheJournalEntry{stored.hash, stored.size, stored.frequency, stored.version});
+    }
+
+    uint64_t validBytes = 0;
+    uint64_t replayed = 0;
+    for (size_t log = 0; log < 2 && present[log]; ++log) {
+      validBytes = sizeof(LogHeader);
+      m_records = 0;
+      for (uint64_t i = 0; i < records[log]; ++i) {
+        Record record;
+        std::memcpy(&record, logs[log].Data() + validBytes, sizeof(record));
+        if (record.checksum != Checksum(record)) {
+          break; // torn by a crash, nothing after it was acknowledged
+        }
+        validBytes += sizeof(record);
+        ++m_records;
+        auto slot = slotOf(record.hash);
+        bool live = slot != c_empty && alive[slot];
+        switch (static_cast<Op>(record.op)) {
+          case Op::Insert:
+            add(CacheJournalEntry{record.hash, record.size, 1, record.version});
+            break;
+          case Op::Remove:
+            if (live) {
+              alive[slot] = false;
+            }
+            break;
+          case Op::Touch:
+            if (live) {
+              auto touched = versions[slot];
+              ++touched.frequency;
+              add(touched);
+            }
+            break;
+        }
+      }
+      replayed = log;
+    }
+    snapshot.Close();
+    logs[0].Close();
+    logs[1].Close();
+
+    // appends continue the newest journal; a cut-short compaction is redone by the next one
+    m_generation = generation + replayed;
+    m_unfolded = replayed != 0;
+    std::error_code error;
+    std::filesystem::resize_file(LogPath(m_generation), validBytes, error);
+    m_log.open(LogPath(m_generation), std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+
+    std::vector<CacheJournalEntry> entries;
+    entries.reserve(versions.size());
+    for (size_t i = 0; i < versions.size(); ++i) {
+      if (alive[i]) {
+        entries.push_back(versions[i]);
+      }
+    }
+    return entries;
+  }
+
+  void Append(Op op, uint64_t hash, uint64_t size = 0, uint64_t version = 0) {
+    Record record{};
+    record.op = static_cast<uint8_t>(op);
+    record.hash = hash;
+    record.size = size;
+    record.version = version;
+    record.checksum = Checksum(record);
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    // flushed right away: the record survives the process being killed, though not a power loss
+    m_log.write(reinterpret_cast<char const *>(&record), sizeof(record));
+    m_log.flush();
+    ++m_records;
+  }
+
+  // One |op| record per hash, in order, handed to the OS in a single write.
+  void Append(Op op, std::vector<uint64_t> const &hashes) {
+    std::vector<Record> records(hashes.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+      records[i].op = static_cast<uint8_t>(op);
+      records[i].hash = hashes[i];
+      records[i].checksum = Checksum(records[i]);
+    }
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    m_log.write(reinterpret_cast<char const *>(records.data()), records.size() * sizeof(Record));
+    m_log.flush();
+    m_records += records.size();
+  }
+
+  // True once the journal has grown well past the state it describes, or two journals were replayed.
+  bool ShouldCompact(size_t entries) const {
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    return m_unfolded || (m_records > c_minCompactRecords && m_records > 2 * static_cast<uint64_t>(entries));
+  }
+
+  // Closes the journal and starts an empty one of the next generation, which later appends go to. Returns
+  // the generation to pass WriteSnapshot with the entries as they are at this point.
+  uint64_t Rotate() {
+    std::lock_guard<std::mutex> lock(m_logMutex);
+    ++m_generation;
+    m_unfolded = false;
+    StartLog();
+    return m_generation;
+  }
+
+  // Replaces the snapshot with |entries| (least recently used first) as of Rotate() returning
+  // |generation|, then deletes the journal it folds in. Touches neither the open journal nor its state,
+  // so it can run while other threads Append; only one may run at a time.
+  bool WriteSnapshot(uint64_t generation, std::vector<CacheJournalEntry> const &entries) const {
+    SnapshotHeader header{};
+    std::memcpy(header.magic, c_snapshotMagic, 4);
+    header.generation = generation;
+    header.count = entries.size();
+    std::string bytes;
+    bytes.reserve(sizeof(header) + entries.size() * sizeof(SnapshotEntry));
+    bytes.append(reinterpret_cast<char const *>(&header), sizeof(header));
+    for (auto const &entry : entries) {
+      SnapshotEntry stored{entry.hash, entry.size, entry.version, entry.frequency, 0};
+      bytes.append(reinterpret_cast<char const *>(&stored), sizeof(stored));
+    }
+    if (!WriteFileAtomically(SnapshotPath(), bytes)) {
+      return false;
+    }
+    // killed here, the old journal is skipped on open because its generation is behind the snapshot's
+    std::error_code error;
+    std::filesystem::remove(LogPath(generation - 1), error);
+    return true;
+  }
+
+  // Rotate and WriteSnapshot in one go.
+  bool Compact(std::vector<CacheJournalEntry> const &entries) {
+    return WriteSnapshot(Rotate(), entries);
+  }
+
+ private:
+  struct SnapshotHeader {
+    char magic[4];
+    uint32_t reserved;
+    uint64_t generation;
+    uint64_t count;
+  };
+
+  struct SnapshotEntry {
+    uint64_t hash;
+    uint64_t size;
+    uint64_t version;
+    uint32_t frequency;
+    uint32_t reserved;
+  };
+
+  struct LogHeader {
+    char magic[4];
+    uint32_t reserved;
+    uint64_t generation;
+  };
+
+  struct Record {
+    uint32_t checksum;
+    uint8_t op;
+    uint8_t reserved[3];
+    uint64_t hash;
+    uint64_t size;
+    uint64_t version;
+  };
+
+  static constexpr char c_snapshotMagic[4] = {'R', 'N', 'V', 'J'};
+  static constexpr char c_logMagic[4] = {'R', 'N', 'V', 'L'};
+  static constexpr uint64_t c_minCompactRecords = 4096;
+  static constexpr uint32_t c_empty = UINT32_MAX;
+
+  // FNV-1a over everything but the checksum itself.
+  static uint32_t Checksum(Record const &record) {
+    auto bytes = reinterpret_cast<uint8_t const *>(&record) + sizeof(record.checksum);
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(record) - sizeof(record.checksum); ++i) {
+      hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+  }
+
+  std::filesystem::path SnapshotPath() const {
+    return m_folder / "journal.snap";
+  }
+
+  // Consecutive generations alternate between two files, so a rotation never overwrites the journal the
+  // pending snapshot has yet to fold in.
+  std::filesystem::path LogPath(uint64_t generation) const {
+    return m_folder / (generation % 2 == 0 ? "journal.0.log" : "journal.1.log");
+  }
+
+  void StartLog() {
+    LogHeader header{};
+    std::memcpy(header.magic, c_logMagic, 4);
+    header.generation = m_generation;
+    m_log.close();
+    WriteFileAtomically(
+        LogPath(m_generation), std::string_view(reinterpret_cast<char const *>(&header), sizeof(header)));
+    m_log.open(LogPath(m_generation), std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+    m_records = 0;
+  }
+
+  std::filesystem::path const m_folder;
+  mutable std::mutex m_logMutex; // guards the open journal and the state below
+  std::fstream m_log;
+  uint64_t m_generation = 0;
+  uint64_t m_records = 0; // in the open journal
+  bool m_unfolded = false; // Open replayed a journal the snapshot has not folded in yet
+};
+
+} // namespace ReactNativeVideoCPP
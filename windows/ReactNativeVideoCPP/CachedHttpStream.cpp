@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "CachedHttpStream.h"
+#include "MediaCache.h"
+
+using namespace Windows::Foundation;
+using namespace Windows::Storage::Streams;
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+CachedHttpStream::CachedHttpStream(Uri uri, std::string key, RangeCache cache, uint64_t size, uint64_t position)
+    : m_uri(std::move(uri)), m_key(std::move(key)), m_cache(cache), m_size(size), m_position(position) {}
+
+uint64_t CachedHttpStream::Size() const {
+  return m_size;
+}
+
+void CachedHttpStream::Size(uint64_t) {
+  throw hresult_not_implemented();
+}
+
+uint64_t CachedHttpStream::Position() const {
+  return m_position;
+}
+
+void CachedHttpStream::Seek(uint64_t position) {
+  m_position = position;
+}
+
+bool CachedHttpStream::CanRead() const {
+  return true;
+}
+
+bool CachedHttpStream::CanWrite() const {
+  return false;
+}
+
+IInputStream CachedHttpStream::GetInputStreamAt(uint64_t position) const {
+  return make<CachedHttpStream>(m_uri, m_key, m_cache, m_size, position);
+}
+
+IOutputStream CachedHttpStream::GetOutputStreamAt(uint64_t) const {
+  throw hresult_not_implemented();
+}
+
+IRandomAccessStream CachedHttpStream::CloneStream() const {
+  return make<CachedHttpStream>(m_uri, m_key, m_cache, m_size);
+}
+
+IAsyncOperationWithProgress<IBuffer, uint32_t>
+CachedHttpStream::ReadAsync(IBuffer buffer, uint32_t count, InputStreamOptions) {
+  // taken before the first suspension, so back-to-back reads see the position the previous one left
+  auto strong = get_strong();
+  auto offset = m_position;
+  auto remaining = offset < m_size ? m_size - offset : 0;
+  count = static_cast<uint32_t>(std::min<uint64_t>({count, buffer.Capacity(), remaining}));
+  m_position = offset + count;
+  co_await resume_background();
+
+  std::string bytes;
+  if (count != 0 && !MediaCache::Instance().ReadRange(m_cache, m_uri, m_key, offset, count, bytes) && bytes.empty()) {
+    m_position = offset;
+    throw hresult_error(HRESULT_FROM_WIN32(ERROR_READ_FAULT));
+  }
+  std::memcpy(buffer.data(), bytes.data(), bytes.size());
+  buffer.Length(static_cast<uint32_t>(bytes.size()));
+  m_position = offset + bytes.size();
+  co_return buffer;
+}
+
+IAsyncOperationWithProgress<uint32_t, uint32_t> CachedHttpStream::WriteAsync(IBuffer const &) {
+  throw hresult_not_implemented();
+}
+
+IAsyncOperation<bool> CachedHttpStream::FlushAsync() {
+  throw hresult_not_implemented();
+}
+
+void CachedHttpStream::Close() {
+  // nothing is held open between reads
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
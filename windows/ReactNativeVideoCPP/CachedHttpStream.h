@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include "MediaCache.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// Read-only random access stream over a progressive http(s) resource whose bytes go through one of the
+// sparse range caches of MediaCache: reads are served from the ranges already on disk and only the gaps are
+// requested, so resuming or re-seeking a partially watched clip touches the network just for what is
+// missing. Handed to the player directly or through a MediaBinder; the server must support byte ranges.
+struct CachedHttpStream : implements<
+                              CachedHttpStream,
+                              Windows::Storage::Streams::IRandomAccessStream,
+                              Windows::Storage::Streams::IInputStream,
+                              Windows::Storage::Streams::IOutputStream,
+                              Windows::Foundation::IClosable> {
+  CachedHttpStream(
+      Windows::Foundation::Uri uri,
+      std::string key,
+      RangeCache cache,
+      uint64_t size,
+      uint64_t position = 0);
+
+  // IRandomAccessStream
+  uint64_t Size() const;
+  void Size(uint64_t value);
+  uint64_t Position() const;
+  void Seek(uint64_t position);
+  bool CanRead() const;
+  bool CanWrite() const;
+  Windows::Storage::Streams::IInputStream GetInputStreamAt(uint64_t position) const;
+  Windows::Storage::Streams::IOutputStream GetOutputStreamAt(uint64_t position) const;
+  Windows::Storage::Streams::IRandomAccessStream CloneStream() const;
+
+  // IInputStream
+  Windows::Foundation::IAsyncOperationWithProgress<Windows::Storage::Streams::IBuffer, uint32_t> ReadAsync(
+      Windows::Storage::Streams::IBuffer buffer,
+      uint32_t count,
+      Windows::Storage::Streams::InputStreamOptions options);
+
+  // IOutputStream
+  Windows::Foundation::IAsyncOperationWithProgress<uint32_t, uint32_t> WriteAsync(
+      Windows::Storage::Streams::IBuffer const &buffer);
+  Windows::Foundation::IAsyncOperation<bool> FlushAsync();
+
+  // IClosable
+  void Close();
+
+ private:
+  Windows::Foundation::Uri const m_uri;
+  std::string const m_key;
+  RangeCache const m_cache;
+  uint64_t const m_size;
+  uint64_t m_position;
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,752 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "ManifestText.h"
+#include "XmlScanner.h"
+
+// Portable (WinRT-free) streaming DASH MPD parser. The manifest is fed in chunks through XmlScanner and
+// built into a Period / AdaptationSet / Representation tree as the tags go by; the text is never held in
+// full. SegmentTimelines are kept as their <S> runs and expanded lazily, so a multi-hour live timeline
+// costs one entry per run rather than one per segment, and representations that inherit the same
+// SegmentTemplate share it. SegmentBase / SegmentList addressing is not modelled.
+namespace ReactNativeVideoCPP {
+
+// ISO 8601 duration ("PT1H2M3.5S", "P1DT2H") in seconds. Years and months count as 365 and 30 days.
+inline bool ParseIsoDuration(std::string_view text, double &seconds) {
+  seconds = 0;
+  if (text.empty() || text.front() != 'P') {
+    return false;
+  }
+  text.remove_prefix(1);
+  bool time = false;
+  while (!text.empty()) {
+    if (text.front() == 'T') {
+      time = true;
+      text.remove_prefix(1);
+      continue;
+    }
+    double value = 0;
+    if (!ParseManifestDecimal(text, value)) {
+      return false;
+    }
+    auto unit = text.find_first_not_of("0123456789.");
+    if (unit == std::string_view::npos) {
+      return false;
+    }
+    switch (text[unit]) {
+      case 'Y':
+        seconds += value * 365 * 86400;
+        break;
+      case 'M':
+        seconds += time ? value * 60 : value * 30 * 86400;
+        break;
+      case 'W':
+        seconds += value * 7 * 86400;
+        break;
+      case 'D':
+        seconds += value * 86400;
+        break;
+      case 'H':
+        seconds += value * 3600;
+        break;
+      case 'S':
+        seconds += value;
+        break;
+      default:
+        return false;
+    }
+    text.remove_prefix(unit + 1);
+  }
+  return true;
+}
+
+// Resolves |reference| against the BaseURL |base|.
+inline std::string ResolveDashUrl(std::string_view base, std::string_view reference) {
+  if (base.empty() || reference.find("://") != std::string_view::npos) {
+    return std::string(reference);
+  }
+  if (!reference.empty() && reference.front() == '/') {
+    auto scheme = base.find("://");
+    auto path = scheme == std::string_view::npos ? 0 : base.find('/', scheme + 3);
+    return std::string(base.substr(0, path)).append(reference);
+  }
+  auto slash = base.rfind('/');
+  return std::string(base.substr(0, slash == std::string_view::npos ? 0 : slash + 1)).append(reference);
+}
+
+// Substitutes $RepresentationID$, $Number$, $Bandwidth$ and $Time$ (with optional %0<width>d formats) in a
+// SegmentTemplate media or initialization pattern.
+inline std::string ExpandDashTemplate(
+    std::string_view pattern,
+    std::string_view representationId,
+    uint64_t bandwidth,
+    uint64_t number,
+    uint64_t time) {
+  std::string url;
+  url.reserve(pattern.size() + 16);
+  while (!pattern.empty()) {
+    auto open = pattern.find('$');
+    auto close = open == std::string_view::npos ? open : pattern.find('$', open + 1);
+    if (close == std::string_view::npos) {
+      url.append(pattern);
+      break;
+    }
+    url.append(pattern.substr(0, open));
+    auto identifier = pattern.substr(open + 1, close - open - 1);
+    pattern.remove_prefix(close + 1);
+    if (identifier.empty()) {
+      url.push_back('$');
+      continue;
+    }
+    auto percent = identifier.find('%');
+    auto name = identifier.substr(0, percent);
+    uint64_t width = 0;
+    if (percent != std::string_view::npos) {
+      ParseManifestUnsigned(identifier.substr(percent + 1 + (identifier.substr(percent + 1, 1) == "0")), width);
+    }
+    if (name == "RepresentationID") {
+      url.append(representationId);
+      continue;
+    }
+    uint64_t value = name == "Number" ? number : name == "Bandwidth" ? bandwidth : name == "Time" ? time : 0;
+    if (value == 0 && name != "Number" && name != "Bandwidth" && name != "Time") {
+      url.append("$").append(identifier).append("$"); // unknown identifier, leave it alone
+      continue;
+    }
+    auto digits = std::to_string(value);
+    if (digits.size() < width) {
+      url.append(static_cast<size_t>(width) - digits.size(), '0');
+    }
+    url.append(digits);
+  }
+  return url;
+}
+
+struct DashSegment {
+  uint64_t number = 0; // $Number$
+  uint64_t time = 0; // $Time$, in timescale units
+  uint64_t duration = 0; // in timescale units
+  double start = 0; // seconds from the start of the period
+  double durationSeconds = 0;
+};
+
+// The <S> runs of a SegmentTimeline. Segment lookups binary-search the runs, nothing is expanded.
+class DashSegmentTimeline {
+ public:
+  // One <S t d r> element; |start| < 0 continues from the previous run, |repeat| < 0 repeats until the
+  // next run or, for the last one, until Close. Until then an open last run is counted as one segment
+  // but reaches any index or time past it.
+  void Append(int64_t start, uint64_t duration, int64_t repeat) {
+    if (duration == 0) {
+      return;
+    }
+    uint64_t time = start >= 0 ? static_cast<uint64_t>(start) : End();
+    if (m_open) {
+      CloseOpenRun(time);
+    }
+    uint64_t first = m_runs.empty() ? 0 : m_runs.back().firstIndex + m_runs.back().count;
+    m_runs.push_back(Run{time, duration, repeat >= 0 ? static_cast<uint64_t>(repeat) + 1 : 1, first});
+    m_open = repeat < 0;
+  }
+
+  // Resolves an open-ended last run against the end of its period or, for a live period, the live edge
+  // (timescale units): it then holds the segments starting before |endTime|.
+  void Close(uint64_t endTime) {
+    if (m_open) {
+      CloseOpenRun(endTime);
+    }
+  }
+
+  // Whether the last run repeats up to a time the manifest did not give, e.g. the live edge of a dynamic
+  // period parsed without a clock.
+  bool Open() const {
+    return m_open;
+  }
+
+  uint64_t Count() const {
+    return m_runs.empty() ? 0 : m_runs.back().firstIndex + m_runs.back().count;
+  }
+
+  // Count() with an open last run extended to the segments starting before |endTime|.
+  uint64_t CountUntil(uint64_t endTime) const {
+    if (!m_open) {
+      return Count();
+    }
+    auto const &run = m_runs.back();
+    return run.firstIndex + std::max<uint64_t>(RunCount(run, endTime), 1);
+  }
+
+  size_t RunCount() const {
+    return m_runs.size();
+  }
+
+  // Time and duration of the |index|th segment.
+  bool Segment(uint64_t index, uint64_t &time, uint64_t &duration) const {
+    if (index >= Count() && !m_open) {
+      return false;
+    }
+    auto run = std::upper_bound(m_runs.begin(), m_runs.end(), index, [](uint64_t i, Run const &r) {
+                 return i < r.firstIndex;
+               }) -
+        1;
+    time = run->start + (index - run->firstIndex) * run->duration;
+    duration = run->duration;
+    return true;
+  }
+
+  // Index of the segment covering |time|, clamped to the timeline.
+  uint64_t IndexAt(uint64_t time) const {
+    if (m_runs.empty() || time <= m_runs.front().start) {
+      return 0;
+    }
+    auto run = std::upper_bound(m_runs.begin(), m_runs.end(), time, [](uint64_t t, Run const &r) {
+                 return t < r.start;
+               }) -
+        1;
+    auto offset = (time - run->start) / run->duration;
+    if (m_open && run + 1 == m_runs.end()) {
+      return run->firstIndex + offset;
+    }
+    return std::min(run->firstIndex + std::min(offset, run->count - 1), Count() - 1);
+  }
+
+  uint64_t End() const {
+    return m_runs.empty() ? 0 : m_runs.back().start + m_runs.back().count * m_runs.back().duration;
+  }
+
+ private:
+  struct Run {
+    uint64_t start;
+    uint64_t duration;
+    uint64_t count;
+    uint64_t firstIndex;
+  };
+
+  static uint64_t RunCount(Run const &run, uint64_t endTime) {
+    return endTime > run.start ? (endTime - run.start + run.duration - 1) / run.duration : 0;
+  }
+
+  void CloseOpenRun(uint64_t endTime) {
+    auto &run = m_runs.back();
+    if (endTime > run.start) {
+      run.count = RunCount(run, endTime);
+    }
+    m_open = false;
+  }
+
+  std::vector<Run> m_runs;
+  bool m_open = false;
+};
+
+struct DashSegmentTemplate {
+  enum Field : uint32_t {
+    Timescale = 1,
+    Duration = 2,
+    StartNumber = 4,
+    PresentationTimeOffset = 8,
+    Media = 16,
+    Initialization = 32,
+    Timeline = 64,
+  };
+
+  uint64_t timescale = 1;
+  uint64_t duration = 0; // per segment, in timescale units; 0 when a timeline is used
+  uint64_t startNumber = 1;
+  uint64_t presentationTimeOffset = 0;
+  std::string media;
+  std::string initialization;
+  std::shared_ptr<DashSegmentTimeline> timeline;
+  uint32_t fields = 0; // which of the above the element set itself, the rest are inherited
+
+  // Number of segments in a period of |periodDuration| seconds (for a live period, pass the time elapsed
+  // since the period started).
+  uint64_t SegmentCount(double periodDuration) const {
+    if (timeline) {
+      return periodDuration > 0 ? timeline->CountUntil(TimeAt(periodDuration)) : timeline->Count();
+    }
+    if (duration == 0 || periodDuration <= 0) {
+      return 0;
+    }
+    return static_cast<uint64_t>(
+        std::ceil(periodDuration * static_cast<double>(timescale) / static_cast<double>(duration) - 1e-9));
+  }
+
+  // Timescale units of |seconds| from the start of the period.
+  uint64_t TimeAt(double seconds) const {
+    return static_cast<uint64_t>(std::max(seconds, 0.0) * static_cast<double>(timescale)) + presentationTimeOffset;
+  }
+
+  DashSegment Segment(uint64_t index) const {
+    DashSegment segment;
+    segment.number = startNumber + index;
+    if (timeline) {
+      timeline->Segment(index, segment.time, segment.duration);
+    } else {
+      segment.time = presentationTimeOffset + index * duration;
+      segment.duration = duration;
+    }
+    auto scale = static_cast<double>(timescale);
+    segment.start = (static_cast<double>(segment.time) - static_cast<double>(presentationTimeOffset)) / scale;
+    segment.durationSeconds = static_cast<double>(segment.duration) / scale;
+    return segment;
+  }
+
+  // Index of the segment covering |seconds| from the start of the period.
+  uint64_t IndexAt(double seconds) const {
+    auto time = TimeAt(seconds);
+    if (timeline) {
+      return timeline->IndexAt(time);
+    }
+    return duration == 0 ? 0 : (time - presentationTimeOffset) / duration;
+  }
+
+  // |inner| overrides the fields it sets itself.
+  static std::shared_ptr<DashSegmentTemplate const> Merge(
+      std::shared_ptr<DashSegmentTemplate const> const &outer,
+      std::shared_ptr<DashSegmentTemplate const> const &inner) {
+    if (!outer || !inner || inner->fields == 0) {
+      return inner && inner->fields != 0 ? inner : outer;
+    }
+    auto merged = std::make_shared<DashSegmentTemplate>(*outer);
+    merged->fields |= inner->fields;
+    if (inner->fields & Timescale) {
+      merged->timescale = inner->timescale;
+    }
+    if (inner->fields & Duration) {
+      merged->duration = inner->duration;
+    }
+    if (inner->fields & StartNumber) {
+      merged->startNumber = inner->startNumber;
+    }
+    if (inner->fields & PresentationTimeOffset) {
+      merged->presentationTimeOffset = inner->presentationTimeOffset;
+    }
+    if (inner->fields & Media) {
+      merged->media = inner->media;
+    }
+    if (inner->fields & Initialization) {
+      merged->initialization = inner->initialization;
+    }
+    if (inner->fields & Timeline) {
+      merged->timeline = inner->timeline;
+    }
+    return merged;
+  }
+};
+
+struct DashRepresentation {
+  std::string id;
+  uint64_t bandwidth = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::string codecs;
+  std::string mimeType; // inherited from the adaptation set when not set
+  std::string baseUrl; // fully resolved
+  std::shared_ptr<DashSegmentTemplate const> segmentTemplate; // effective, possibly shared
+
+  std::string MediaUrl(DashSegment const &segment) const {
+    if (!segmentTemplate) {
+      return baseUrl;
+    }
+    return ResolveDashUrl(
+        baseUrl, ExpandDashTemplate(segmentTemplate->media, id, bandwidth, segment.number, segment.time));
+  }
+
+  std::string InitializationUrl() const {
+    return segmentTemplate && !segmentTemplate->initialization.empty()
+        ? ResolveDashUrl(baseUrl, ExpandDashTemplate(segmentTemplate->initialization, id, bandwidth, 0, 0))
+        : std::string();
+  }
+};
+
+struct DashAdaptationSet {
+  std::string id;
+  std::string contentType; // from contentType, else derived from mimeType
+  std::string mimeType;
+  std::string language;
+  std::vector<DashRepresentation> representations;
+};
+
+struct DashPeriod {
+  std::string id;
+  double start = 0; // seconds from the presentation start
+  double duration = 0; // seconds, 0 when open-ended (the live edge)
+  std::vector<DashAdaptationSet> adaptationSets;
+};
+
+struct DashManifest {
+  bool dynamic = false; // type="dynamic", i.e. live
+  double mediaPresentationDuration = 0;
+  double minimumUpdatePeriod = 0;
+  double timeShiftBufferDepth = 0;
+  double minBufferTime = 0;
+  std::string availabilityStartTime; // raw xs:dateTime
+  double availabilityStart = NAN; // availabilityStartTime in seconds since 1970, NaN when absent
+  std::vector<DashPeriod> periods;
+};
+
+class DashMpdParser {
+ public:
+  // Feeds the next chunk of the MPD text, which may end anywhere.
+  void Feed(std::string_view chunk) {
+    m_scanner.Feed(chunk, [this](XmlEvent const &event) { OnEvent(event); });
+  }
+
+  // Completes the manifest: resolves period timing, BaseURLs, inherited templates and open-ended
+  // timelines. A dynamic MPD's open-ended last period runs up to the live edge at |wallClock| (seconds
+  // since 1970); without a clock or an availabilityStartTime its open timeline run stays open. Returns
+  // false if the text was not a complete MPD; the parser is reset either way.
+  bool Finish(DashManifest &manifest, double wallClock = NAN) {
+    bool complete = m_scanner.Finish([this](XmlEvent const &event) { OnEvent(event); });
+    complete = complete && m_sawMpd && m_stack.empty();
+    if (complete) {
+      Resolve(wallClock);
+      manifest = std::move(m_manifest);
+    }
+    *this = DashMpdParser();
+    return complete;
+  }
+
+ private:
+  enum class Element { Mpd, Period, AdaptationSet, Representation, SegmentTemplate, SegmentTimeline, BaseUrl, Other };
+
+  // Parse-time state that the finished manifest no longer needs.
+  struct PendingTemplates {
+    std::shared_ptr<DashSegmentTemplate const> period;
+    std::vector<std::shared_ptr<DashSegmentTemplate const>> adaptationSets;
+    std::vector<std::vector<std::shared_ptr<DashSegmentTemplate const>>> representations;
+  };
+
+  struct PendingBaseUrls {
+    std::string period;
+    std::vector<std::string> adaptationSets;
+  };
+
+  static Element Classify(std::string_view name) {
+    name = XmlLocalName(name);
+    if (name == "S") {
+      return Element::Other; // handled by the SegmentTimeline itself
+    }
+    if (name == "SegmentTemplate") {
+      return Element::SegmentTemplate;
+    }
+    if (name == "Representation") {
+      return Element::Representation;
+    }
+    if (name == "AdaptationSet") {
+      return Element::AdaptationSet;
+    }
+    if (name == "SegmentTimeline") {
+      return Element::SegmentTimeline;
+    }
+    if (name == "BaseURL") {
+      return Element::BaseUrl;
+    }
+    if (name == "Period") {
+      return Element::Period;
+    }
+    if (name == "MPD") {
+      return Element::Mpd;
+    }
+    return Element::Other;
+  }
+
+  Element Parent() const {
+    return m_stack.size() < 2 ? Element::Other : m_stack[m_stack.size() - 2];
+  }
+
+  void OnEvent(XmlEvent const &event) {
+    switch (event.type) {
+      case XmlEventType::StartElement:
+        if (!m_stack.empty() && m_stack.back() == Element::SegmentTimeline && XmlLocalName(event.name) == "S") {
+          OnTimelineEntry(event.attributes);
+        }
+        m_stack.push_back(Classify(event.name));
+        OnStart(event.attributes);
+        break;
+      case XmlEventType::EndElement:
+        if (!m_stack.empty()) {
+          OnEnd();
+          m_stack.pop_back();
+        }
+        break;
+      case XmlEventType::Text:
+        if (!m_stack.empty() && m_stack.back() == Element::BaseUrl) {
+          m_text.append(event.text);
+        }
+        break;
+    }
+  }
+
+  void OnStart(std::string_view attributes) {
+    switch (m_stack.back()) {
+      case Element::Mpd:
+        m_sawMpd = true;
+        ForEachXmlAttribute(attributes, [this](std::string_view name, std::string_view value) {
+          if (name == "type") {
+            m_manifest.dynamic = value == "dynamic";
+          } else if (name == "mediaPresentationDuration") {
+            ParseIsoDuration(value, m_manifest.mediaPresentationDuration);
+          } else if (name == "minimumUpdatePeriod") {
+            ParseIsoDuration(value, m_manifest.minimumUpdatePeriod);
+          } else if (name == "timeShiftBufferDepth") {
+            ParseIsoDuration(value, m_manifest.timeShiftBufferDepth);
+          } else if (name == "minBufferTime") {
+            ParseIsoDuration(value, m_manifest.minBufferTime);
+          } else if (name == "availabilityStartTime") {
+            m_manifest.availabilityStartTime = std::string(value);
+            ParseManifestDateTime(value, m_manifest.availabilityStart);
+          }
+        });
+        break;
+      case Element::Period: {
+        auto &period = m_manifest.periods.emplace_back();
+        period.start = -1; // resolved from the previous period unless given
+        ForEachXmlAttribute(attributes, [&period](std::string_view name, std::string_view value) {
+          if (name == "id") {
+            period.id = DecodeXmlText(value);
+          } else if (name == "start") {
+            ParseIsoDuration(value, period.start);
+          } else if (name == "duration") {
+            ParseIsoDuration(value, period.duration);
+          }
+        });
+        m_templates.emplace_back();
+        m_baseUrls.emplace_back();
+        break;
+      }
+      case Element::AdaptationSet: {
+        if (m_manifest.periods.empty()) {
+          break;
+        }
+        auto &set = m_manifest.periods.back().adaptationSets.emplace_back();
+        ForEachXmlAttribute(attributes, [&set](std::string_view name, std::string_view value) {
+          if (name == "id") {
+            set.id = DecodeXmlText(value);
+          } else if (name == "contentType") {
+            set.contentType = DecodeXmlText(value);
+          } else if (name == "mimeType") {
+            set.mimeType = DecodeXmlText(value);
+          } else if (name == "lang") {
+            set.language = DecodeXmlText(value);
+          }
+        });
+        m_templates.back().adaptationSets.emplace_back();
+        m_templates.back().representations.emplace_back();
+        m_baseUrls.back().adaptationSets.emplace_back();
+        break;
+      }
+      case Element::Representation: {
+        if (m_manifest.periods.empty() || m_manifest.periods.back().adaptationSets.empty()) {
+          break;
+        }
+        auto &representation = m_manifest.periods.back().adaptationSets.back().representations.emplace_back();
+        ForEachXmlAttribute(attributes, [&representation](std::string_view name, std::string_view value) {
+          uint64_t number = 0;
+          if (name == "id") {
+            representation.id = DecodeXmlText(value);
+          } else if (name == "bandwidth") {
+            ParseManifestUnsigned(value, representation.bandwidth);
+          } else if (name == "width" && ParseManifestUnsigned(value, number)) {
+            representation.width = static_cast<uint32_t>(number);
+          } else if (name == "height" && ParseManifestUnsigned(value, number)) {
+            representation.height = static_cast<uint32_t>(number);
+          } else if (name == "codecs") {
+            representation.codecs = DecodeXmlText(value);
+          } else if (name == "mimeType") {
+            representation.mimeType = DecodeXmlText(value);
+          }
+        });
+        m_templates.back().representations.back().emplace_back();
+        break;
+      }
+      case Element::SegmentTemplate: {
+        m_template = std::make_shared<DashSegmentTemplate>();
+        auto &segmentTemplate = *m_template;
+        ForEachXmlAttribute(attributes, [&segmentTemplate](std::string_view name, std::string_view value) {
+          uint64_t number = 0;
+          if (name == "timescale" && ParseManifestUnsigned(value, number) && number != 0) {
+            segmentTemplate.timescale = number;
+            segmentTemplate.fields |= DashSegmentTemplate::Timescale;
+          } else if (name == "duration" && ParseManifestUnsigned(value, segmentTemplate.duration)) {
+            segmentTemplate.fields |= DashSegmentTemplate::Duration;
+          } else if (name == "startNumber" && ParseManifestUnsigned(value, segmentTemplate.startNumber)) {
+            segmentTemplate.fields |= DashSegmentTemplate::StartNumber;
+          } else if (
+              name == "presentationTimeOffset" &&
+              ParseManifestUnsigned(value, segmentTemplate.presentationTimeOffset)) {
+            segmentTemplate.fields |= DashSegmentTemplate::PresentationTimeOffset;
+          } else if (name == "media") {
+            segmentTemplate.media = DecodeXmlText(value);
+            segmentTemplate.fields |= DashSegmentTemplate::Media;
+          } else if (name == "initialization") {
+            segmentTemplate.initialization = DecodeXmlText(value);
+            segmentTemplate.fields |= DashSegmentTemplate::Initialization;
+          }
+        });
+        break;
+      }
+      case Element::SegmentTimeline:
+        if (m_template) {
+          m_template->timeline = std::make_shared<DashSegmentTimeline>();
+          m_template->fields |= DashSegmentTemplate::Timeline;
+        }
+        break;
+      case Element::BaseUrl:
+        m_text.clear();
+        break;
+      case Element::Other:
+        break;
+    }
+  }
+
+  void OnTimelineEntry(std::string_view attributes) {
+    if (!m_template || !m_template->timeline) {
+      return;
+    }
+    int64_t start = -1;
+    int64_t repeat = 0;
+    uint64_t duration = 0;
+    ForEachXmlAttribute(attributes, [&](std::string_view name, std::string_view value) {
+      uint64_t number = 0;
+      if (name == "t" && ParseManifestUnsigned(value, number)) {
+        start = static_cast<int64_t>(number);
+      } else if (name == "d") {
+        ParseManifestUnsigned(value, duration);
+      } else if (name == "r") {
+        bool negative = !value.empty() && value.front() == '-';
+        if (ParseManifestUnsigned(value.substr(negative ? 1 : 0), number)) {
+          repeat = negative ? -1 : static_cast<int64_t>(number);
+        }
+      }
+    });
+    m_template->timeline->Append(start, duration, repeat);
+  }
+
+  void OnEnd() {
+    switch (m_stack.back()) {
+      case Element::SegmentTemplate:
+        if (m_template && !m_templates.empty()) {
+          auto &pending = m_templates.back();
+          switch (Parent()) {
+            case Element::Period:
+              pending.period = m_template;
+              break;
+            case Element::AdaptationSet:
+              if (!pending.adaptationSets.empty()) {
+                pending.adaptationSets.back() = m_template;
+              }
+              break;
+            case Element::Representation:
+              if (!pending.representations.empty() && !pending.representations.back().empty()) {
+                pending.representations.back().back() = m_template;
+              }
+              break;
+            default:
+              break;
+          }
+        }
+        m_template.reset();
+        break;
+      case Element::BaseUrl: {
+        auto url = DecodeXmlText(TrimManifestText(m_text));
+        switch (Parent()) {
+          case Element::Mpd:
+            m_mpdBaseUrl = std::move(url);
+            break;
+          case Element::Period:
+            if (!m_baseUrls.empty()) {
+              m_baseUrls.back().period = std::move(url);
+            }
+            break;
+          case Element::AdaptationSet:
+            if (!m_baseUrls.empty() && !m_baseUrls.back().adaptationSets.empty()) {
+              m_baseUrls.back().adaptationSets.back() = std::move(url);
+            }
+            break;
+          case Element::Representation:
+            if (!m_manifest.periods.empty() && !m_manifest.periods.back().adaptationSets.empty() &&
+                !m_manifest.periods.back().adaptationSets.back().representations.empty()) {
+              m_manifest.periods.back().adaptationSets.back().representations.back().baseUrl = std::move(url);
+            }
+            break;
+          default:
+            break;
+        }
+        m_text.clear();
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  void Resolve(double wallClock) {
+    auto &periods = m_manifest.periods;
+    for (size_t p = 0; p < periods.size(); ++p) {
+      auto &period = periods[p];
+      if (period.start < 0) {
+        period.start = p == 0 ? 0 : periods[p - 1].start + periods[p - 1].duration;
+      }
+    }
+    for (size_t p = 0; p < periods.size(); ++p) {
+      auto &period = periods[p];
+      if (period.duration <= 0) {
+        double end = p + 1 < periods.size() ? periods[p + 1].start : m_manifest.mediaPresentationDuration;
+        period.duration = std::max(end - period.start, 0.0);
+      }
+      // the live period stays open-ended (duration 0), its timelines are cut at the live edge
+      double timelineEnd = period.duration;
+      if (timelineEnd <= 0 && m_manifest.dynamic && !std::isnan(m_manifest.availabilityStart)) {
+        timelineEnd = std::max(wallClock - m_manifest.availabilityStart - period.start, 0.0);
+      }
+      auto periodBase = ResolveDashUrl(m_mpdBaseUrl, m_baseUrls[p].period);
+      auto &templates = m_templates[p];
+      for (size_t a = 0; a < period.adaptationSets.size(); ++a) {
+        auto &set = period.adaptationSets[a];
+        auto setBase = ResolveDashUrl(periodBase, m_baseUrls[p].adaptationSets[a]);
+        auto setTemplate = DashSegmentTemplate::Merge(templates.period, templates.adaptationSets[a]);
+        for (size_t r = 0; r < set.representations.size(); ++r) {
+          auto &representation = set.representations[r];
+          representation.baseUrl = ResolveDashUrl(setBase, representation.baseUrl);
+          representation.segmentTemplate = DashSegmentTemplate::Merge(setTemplate, templates.representations[a][r]);
+          if (representation.mimeType.empty()) {
+            representation.mimeType = set.mimeType;
+          }
+          CloseTimeline(representation.segmentTemplate, timelineEnd);
+        }
+        if (set.contentType.empty()) {
+          auto mimeType = set.mimeType.empty() && !set.representations.empty() ? set.representations.front().mimeType
+                                                                               : set.mimeType;
+          set.contentType = mimeType.substr(0, mimeType.find('/'));
+        }
+      }
+    }
+  }
+
+  // An end of 0 (or NaN, for a missing clock) is unknown and leaves an open run open.
+  static void CloseTimeline(std::shared_ptr<DashSegmentTemplate const> const &segmentTemplate, double end) {
+    if (segmentTemplate && segmentTemplate->timeline && end > 0) {
+      segmentTemplate->timeline->Close(segmentTemplate->TimeAt(end));
+    }
+  }
+
+  XmlScanner m_scanner;
+  DashManifest m_manifest;
+  std::vector<Element> m_stack;
+  std::vector<PendingTemplates> m_templates; // per period
+  std::vector<PendingBaseUrls> m_baseUrls; // per period
+  std::string m_mpdBaseUrl;
+  std::shared_ptr<DashSegmentTemplate> m_template; // the SegmentTemplate being parsed
+  std::string m_text;
+  bool m_sawMpd = false;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Portable (WinRT-free) multi-producer / single-consumer queue used to hand media callbacks over to the
+// UI thread in batches. Producers push without locking; the consumer takes everything queued so far in
+// one exchange and delivers it in arrival order.
+//
+// Nodes come from a preallocated pool that the consumer refills as it drains, so a steady stream of
+// events does not allocate; only a burst larger than the pool falls back to the heap.
+//
+// Event must be default constructible and expose `source`, `kind` and `collapsible` members. Of several
+// collapsible events with the same source and kind in one batch only the latest is delivered, since it
+// supersedes the earlier ones.
+namespace ReactNativeVideoCPP {
+
+template <typename Event>
+class EventBatchQueue {
+ public:
+  static constexpr size_t c_defaultPoolSize = 256;
+
+  explicit EventBatchQueue(size_t poolSize = c_defaultPoolSize)
+      : m_pool(poolSize > 0 ? std::make_unique<Node[]>(poolSize) : nullptr) {
+    for (size_t i = 0; i < poolSize; ++i) {
+      m_pool[i].pooled = true;
+      Recycle(&m_pool[i]);
+    }
+  }
+
+  EventBatchQueue(EventBatchQueue const &) = delete;
+  EventBatchQueue &operator=(EventBatchQueue const &) = delete;
+
+  ~EventBatchQueue() {
+    auto *node = m_head.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+      auto *next = node->next;
+      if (!node->pooled) {
+        delete node;
+      }
+      node = next;
+    }
+  }
+
+  // Safe to call from any thread. Returns true when the caller must schedule a Drain(), i.e. no drain
+  // was pending when the event was queued.
+  bool Push(Event event) {
+    auto *node = TakeFree();
+    if (node == nullptr) {
+      node = new Node();
+      m_heapNodes.fetch_add(1, std::memory_order_relaxed);
+    }
+    node->event = std::move(event);
+    node->next = m_head.load(std::memory_order_relaxed);
+    while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return !m_drainPending.exchange(true, std::memory_order_acq_rel);
+  }
+
+  // Consumer thread only. Delivers every queued event that was not superseded and returns the number of
+  // events delivered.
+  template <typename Deliver>
+  size_t Drain(Deliver &&deliver) {
+    // clear the flag before taking the list so a push racing with this drain schedules another one
+    m_drainPending.store(false, std::memory_order_release);
+    auto *node = m_head.exchange(nullptr, std::memory_order_acquire);
+
+    // the list is newest first; walking it marks superseded events before restoring arrival order
+    m_batch.clear();
+    for (; node != nullptr; node = node->next) {
+      m_batch.push_back(node);
+    }
+
+    size_t delivered = 0;
+    m_latest.clear();
+    for (auto *entry : m_batch) {
+      entry->superseded = entry->event.collapsible && !RememberLatest(entry->event);
+    }
+    for (auto it = m_batch.rbegin(); it != m_batch.rend(); ++it) {
+      if (!(*it)->superseded) {
+        deliver((*it)->event);
+        ++delivered;
+      }
+    }
+    for (auto *entry : m_batch) {
+      Release(entry);
+    }
+    m_batch.clear();
+    return delivered;
+  }
+
+  // Events that did not fit the pool and were allocated, a sign the pool is too small for the burst.
+  uint64_t HeapNodes() const {
+    return m_heapNodes.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Node {
+    Event event;
+    Node *next = nullptr;
+    bool superseded = false;
+    bool pooled = false;
+    std::atomic<uint32_t> nextFree{0}; // pool index + 1 of the next free node, 0 for none
+  };
+
+  // The free list head packs a pool index + 1 (0 when empty) with a tag bumped on every change, so a
+  // producer that stalls between reading the head and swapping it can't pop a node that was taken and
+  // returned in the meantime (the ABA problem of a plain lock-free stack).
+  static constexpr uint64_t c_indexMask = 0xffffffffu;
+
+  Node *TakeFree() {
+    auto head = m_free.load(std::memory_order_acquire);
+    while ((head & c_indexMask) != 0) {
+      auto index = (head & c_indexMask) - 1;
+      auto next = m_pool[index].nextFree.load(std::memory_order_relaxed);
+      auto replacement = ((head >> 32) + 1) << 32 | next;
+      if (m_free.compare_exchange_weak(head, replacement, std::memory_order_acquire, std::memory_order_acquire)) {
+        return &m_pool[index];
+      }
+    }
+    return nullptr;
+  }
+
+  void Recycle(Node *node) {
+    auto index = static_cast<uint64_t>(node - m_pool.get()) + 1;
+    auto head = m_free.load(std::memory_order_relaxed);
+    do {
+      node->nextFree.store(static_cast<uint32_t>(head & c_indexMask), std::memory_order_relaxed);
+    } while (!m_free.compare_exchange_weak(
+        head, ((head >> 32) + 1) << 32 | index, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  void Release(Node *node) {
+    if (!node->pooled) {
+      delete node;
+      return;
+    }
+    node->event = Event{}; // drop whatever the event holds on to, e.g. a view reference
+    node->superseded = false;
+    Recycle(node);
+  }
+
+  // Returns true when |event| is the newest collapsible event for its source and kind seen so far.
+  bool RememberLatest(Event const &event) {
+    for (auto const *latest : m_latest) {
+      if (latest->source == event.source && latest->kind == event.kind) {
+        return false;
+      }
+    }
+    m_latest.push_back(&event);
+    return true;
+  }
+
+  std::unique_ptr<Node[]> m_pool;
+  std::atomic<uint64_t> m_free{0};
+  std::atomic<Node *> m_head{nullptr};
+  std::atomic<bool> m_drainPending{false};
+  std::atomic<uint64_t> m_heapNodes{0};
+  std::vector<Node *> m_batch;
+  std::vector<Event const *> m_latest;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Portable (WinRT-free) description of event payloads. A payload struct gets a schema by specializing
+// EventSchemaOf<Payload> with a tuple of EventFields; EventWriter then serializes it with keys created
+// once up front and fields always written in schema order. Fields whose type has a schema of its own are
+// written as nested objects.
+//
+// The Writer passed to EventWriter::Write needs BeginObject(), EndObject(), Key(Key const &) and Value(T)
+// for the field types in use.
+namespace ReactNativeVideoCPP {
+
+template <typename Payload>
+struct EventSchemaOf;
+
+template <typename Payload, typename Member>
+struct EventField {
+  std::wstring_view name;
+  Member Payload::*member;
+};
+
+template <typename Payload, typename Member>
+constexpr EventField<Payload, Member> Field(std::wstring_view name, Member Payload::*member) {
+  return {name, member};
+}
+
+template <typename T, typename = void>
+struct HasEventSchema : std::false_type {};
+
+template <typename T>
+struct HasEventSchema<T, std::void_t<decltype(EventSchemaOf<T>::Fields)>> : std::true_type {};
+
+template <typename Payload, typename Key>
+class EventWriter {
+  using FieldsType = std::remove_cv_t<decltype(EventSchemaOf<Payload>::Fields)>;
+  static constexpr size_t FieldCount = std::tuple_size_v<FieldsType>;
+
+  template <size_t I>
+  using MemberType = std::remove_cv_t<std::remove_reference_t<
+      decltype(std::declval<Payload const &>().*(std::get<I>(EventSchemaOf<Payload>::Fields).member))>>;
+
+  struct NoNestedWriter {
+    template <typename MakeKey>
+    explicit NoNestedWriter(MakeKey &) {}
+  };
+
+  template <size_t I>
+  using NestedWriter =
+      std::conditional_t<HasEventSchema<MemberType<I>>::value, EventWriter<MemberType<I>, Key>, NoNestedWriter>;
+
+  template <size_t... I>
+  static auto NestedWritersType(std::index_sequence<I...>) -> std::tuple<NestedWriter<I>...>;
+
+ public:
+  // |makeKey| turns each schema name into the writer's key type; it is only called here.
+  template <typename MakeKey>
+  explicit EventWriter(MakeKey &&makeKey)
+      : EventWriter(makeKey, std::make_index_sequence<FieldCount>{}) {}
+
+  template <typename Writer>
+  void Write(Writer &writer, Payload const &payload) const {
+    writer.BeginObject();
+    WriteFields(writer, payload, std::make_index_sequence<FieldCount>{});
+    writer.EndObject();
+  }
+
+ private:
+  template <typename MakeKey, size_t... I>
+  EventWriter(MakeKey &makeKey, std::index_sequence<I...>)
+      : m_keys{makeKey(std::get<I>(EventSchemaOf<Payload>::Fields).name)...}, m_nested{NestedWriter<I>(makeKey)...} {}
+
+  template <typename Writer, size_t... I>
+  void WriteFields(Writer &writer, Payload const &payload, std::index_sequence<I...>) const {
+    (WriteField<I>(writer, payload), ...);
+  }
+
+  template <size_t I, typename Writer>
+  void WriteField(Writer &writer, Payload const &payload) const {
+    writer.Key(m_keys[I]);
+    auto const &value = payload.*(std::get<I>(EventSchemaOf<Payload>::Fields).member);
+    if constexpr (HasEventSchema<MemberType<I>>::value) {
+      std::get<I>(m_nested).Write(writer, value);
+    } else {
+      writer.Value(value);
+    }
+  }
+
+  Key m_keys[FieldCount];
+  decltype(NestedWritersType(std::make_index_sequence<FieldCount>{})) m_nested;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,595 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "ManifestText.h"
+
+// Portable (WinRT-free) HLS playlist parser. Lines are scanned as string_views into the caller's text and
+// nothing is allocated per line: master playlist entries point straight into the text, media playlist
+// segments live in one packed table whose URIs are appended to a single arena. A live media playlist is
+// refreshed incrementally: segments that slid out of the window are dropped, the ones still listed are
+// kept as they are and only the appended tail of the new text is parsed. Ad cue tags (EXT-X-CUE-OUT /
+// EXT-X-CUE-IN and EXT-X-DATERANGE) are collected along the way and placed on the segment timeline.
+namespace ReactNativeVideoCPP {
+
+// Calls |onAttribute(name, value)| for each NAME=VALUE pair of an HLS attribute list; quotes are stripped
+// from quoted-string values.
+template <typename OnAttribute>
+void ForEachHlsAttribute(std::string_view list, OnAttribute &&onAttribute) {
+  while (!list.empty()) {
+    auto equals = list.find('=');
+    if (equals == std::string_view::npos) {
+      return;
+    }
+    auto name = TrimManifestText(list.substr(0, equals));
+    list.remove_prefix(equals + 1);
+    std::string_view value;
+    if (!list.empty() && list.front() == '"') {
+      auto close = list.find('"', 1);
+      value = list.substr(1, close == std::string_view::npos ? std::string_view::npos : close - 1);
+      list.remove_prefix(close == std::string_view::npos ? list.size() : close + 1);
+    } else {
+      value = list.substr(0, list.find(','));
+      list.remove_prefix(value.size());
+    }
+    onAttribute(name, value);
+    auto comma = list.find(',');
+    list.remove_prefix(comma == std::string_view::npos ? list.size() : comma + 1);
+  }
+}
+
+inline bool StartsWith(std::string_view text, std::string_view prefix) {
+  return text.substr(0, prefix.size()) == prefix;
+}
+
+struct HlsVariant {
+  uint64_t bandwidth = 0;
+  uint64_t averageBandwidth = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  double frameRate = 0;
+  std::string_view codecs;
+  std::string_view audioGroup;
+  std::string_view subtitlesGroup;
+  std::string_view uri;
+};
+
+struct HlsRendition {
+  std::string_view type; // AUDIO, VIDEO, SUBTITLES or CLOSED-CAPTIONS
+  std::string_view groupId;
+  std::string_view name;
+  std::string_view language;
+  std::string_view uri; // empty when muxed into the variant
+  bool isDefault = false;
+};
+
+// Entries point into the parsed text, which must outlive the playlist.
+struct HlsMasterPlaylist {
+  std::vector<HlsVariant> variants;
+  std::vector<HlsRendition> renditions;
+};
+
+// Returns false when |text| is not an HLS playlist.
+inline bool ParseHlsMasterPlaylist(std::string_view text, HlsMasterPlaylist &playlist) {
+  playlist.variants.clear();
+  playlist.renditions.clear();
+  std::string_view line;
+  if (!NextManifestLine(text, line) || !StartsWith(TrimManifestText(line), "#EXTM3U")) {
+    return false;
+  }
+  HlsVariant pending;
+  bool hasPending = false;
+  while (NextManifestLine(text, line)) {
+    line = TrimManifestText(line);
+    if (line.empty()) {
+      continue;
+    }
+    if (StartsWith(line, "#EXT-X-STREAM-INF:")) {
+      pending = HlsVariant{};
+      hasPending = true;
+      ForEachHlsAttribute(line.substr(18), [&](std::string_view name, std::string_view value) {
+        uint64_t number = 0;
+        if (name == "BANDWIDTH") {
+          ParseManifestUnsigned(value, pending.bandwidth);
+        } else if (name == "AVERAGE-BANDWIDTH") {
+          ParseManifestUnsigned(value, pending.averageBandwidth);
+        } else if (name == "RESOLUTION") {
+          auto x = value.find('x');
+          if (x != std::string_view::npos && ParseManifestUnsigned(value.substr(0, x), number)) {
+            pending.width = static_cast<uint32_t>(number);
+            if (ParseManifestUnsigned(value.substr(x + 1), number)) {
+              pending.height = static_cast<uint32_t>(number);
+            }
+          }
+        } else if (name == "FRAME-RATE") {
+          ParseManifestDecimal(value, pending.frameRate);
+        } else if (name == "CODECS") {
+          pending.codecs = value;
+        } else if (name == "AUDIO") {
+          pending.audioGroup = value;
+        } else if (name == "SUBTITLES") {
+          pending.subtitlesGroup = value;
+        }
+      });
+    } else if (StartsWith(line, "#EXT-X-MEDIA:")) {
+      HlsRendition rendition;
+      ForEachHlsAttribute(line.substr(13), [&](std::string_view name, std::string_view value) {
+        if (name == "TYPE") {
+          rendition.type = value;
+        } else if (name == "GROUP-ID") {
+          rendition.groupId = value;
+        } else if (name == "NAME") {
+          rendition.name = value;
+        } else if (name == "LANGUAGE") {
+          rendition.language = value;
+        } else if (name == "URI") {
+          rendition.uri = value;
+        } else if (name == "DEFAULT") {
+          rendition.isDefault = value == "YES";
+        }
+      });
+      playlist.renditions.push_back(rendition);
+    } else if (line.front() != '#' && hasPending) {
+      pending.uri = line;
+      playlist.variants.push_back(pending);
+      hasPending = false;
+    }
+  }
+  return true;
+}
+
+enum class HlsPlaylistType { Live, Event, Vod };
+
+struct HlsByteRange {
+  uint64_t offset = 0;
+  uint64_t length = 0; // 0 for the whole resource
+};
+
+struct HlsSegment {
+  uint64_t sequence = 0; // media sequence number
+  double start = 0; // seconds since the first segment this playlist object has seen, across window jumps
+  double duration = 0;
+  HlsByteRange byteRange;
+  uint32_t discontinuitySequence = 0;
+  uint32_t uriOffset = 0; // into the playlist's URI arena, see HlsMediaPlaylist::Uri
+  uint32_t uriLength = 0;
+  bool discontinuity = false; // an EXT-X-DISCONTINUITY precedes this segment
+};
+
+enum class HlsCueKind {
+  Out, // EXT-X-CUE-OUT, or an EXT-X-DATERANGE with SCTE35-OUT: a break starts
+  In, // EXT-X-CUE-IN, or an EXT-X-DATERANGE with SCTE35-IN: the content resumes
+  Command, // an EXT-X-DATERANGE with only SCTE35-CMD, whose splice_info_section says what it is
+};
+
+struct HlsCue {
+  HlsCueKind kind = HlsCueKind::Out;
+  uint64_t sequence = 0; // the segment the tag precedes
+  // Seconds on the segment timeline: the start of that segment or, for an EXT-X-DATERANGE in a playlist
+  // with EXT-X-PROGRAM-DATE-TIME, its START-DATE (plus DURATION for SCTE35-IN) mapped onto it.
+  double time = 0;
+  double duration = 0; // the planned break length, 0 when the tag does not give one
+  double date = NAN; // the EXT-X-DATERANGE date behind |time|, in seconds since 1970; NaN for other tags
+  std::string id; // EXT-X-DATERANGE ID, empty for EXT-X-CUE-OUT / EXT-X-CUE-IN
+  std::string scte35; // splice_info_section as hex (EXT-X-DATERANGE) or base64 (EXT-OATCLS-SCTE35), or empty
+};
+
+struct HlsUpdateResult {
+  bool valid = false; // false for text that is not a media playlist or a refresh cut short; table untouched
+  bool reset = false; // the table was rebuilt from scratch (first parse or the window jumped)
+  size_t removed = 0; // segments dropped from the front
+  size_t appended = 0; // segments added at the back
+  size_t cues = 0; // cues added at the back of Cues(), not counting those seen before after the last segment
+};
+
+class HlsMediaPlaylist {
+ public:
+  // Parses a media playlist, or refreshes the table from a newer version of the same live playlist.
+  HlsUpdateResult Update(std::string_view text) {
+    HlsUpdateResult result;
+    Header header;
+    auto body = text;
+    if (!ParseHeader(body, header)) {
+      return result;
+    }
+    result.valid = true;
+
+    auto lastSequence = m_segments.empty() ? 0 : m_segments.back().sequence;
+    bool incremental = !m_segments.empty() && header.mediaSequence >= m_segments.front().sequence &&
+        header.mediaSequence <= lastSequence + 1;
+    size_t trailingCues = 0;
+    if (incremental) {
+      // the new text still lists everything from mediaSequence up to our last segment, skip those. A live
+      // playlist only ever grows at the back, so one that ends before our last segment was cut short in
+      // transit (or is a stale copy) and is not taken.
+      if (!SkipSegments(body, static_cast<size_t>(lastSequence + 1 - header.mediaSequence))) {
+        result.valid = false;
+        return result;
+      }
+      result.removed = DropBefore(header.mediaSequence);
+      // tags after our last URI were taken as cues of the segment to come; the tail parsed below lists them
+      // again, so they are dropped rather than added twice
+      auto trailing = std::find_if(m_cues.begin(), m_cues.end(), [lastSequence](HlsCue const &cue) {
+        return cue.sequence > lastSequence;
+      });
+      trailingCues = static_cast<size_t>(m_cues.end() - trailing);
+      m_cues.erase(trailing, m_cues.end());
+    }
+    DateAnchor previousAnchor;
+    if (!incremental) {
+      body = text;
+      ParseHeader(body, header);
+      result.reset = true;
+      // a jump in the window keeps the timeline going rather than restarting it at 0; the segments a jump
+      // forward skipped are counted at the average length of those seen, unless dates place it (below)
+      auto nextStart = m_nextStart;
+      if (!m_segments.empty() && header.mediaSequence > lastSequence + 1) {
+        auto skipped = static_cast<double>(header.mediaSequence - lastSequence - 1);
+        nextStart += skipped * Duration() / static_cast<double>(m_segments.size());
+      }
+      result.removed += m_segments.size();
+      previousAnchor = m_dateAnchor;
+      Clear();
+      m_nextStart = nextStart;
+      m_dateAnchor = previousAnchor; // dates of the new window map onto the old timeline until it has its own
+      // one segment takes at least two lines, reserving up front keeps the table from regrowing
+      m_segments.reserve(static_cast<size_t>(std::count(body.begin(), body.end(), '\n') / 2 + 1));
+    }
+
+    m_targetDuration = header.targetDuration;
+    m_type = header.type;
+    m_version = header.version;
+    auto before = m_segments.size();
+    auto cuesBefore = m_cues.size() + trailingCues;
+    ParseSegments(body, header);
+    if (previousAnchor.valid &&
+        (m_dateAnchor.date != previousAnchor.date || m_dateAnchor.start != previousAnchor.start)) {
+      // the new window's own EXT-X-PROGRAM-DATE-TIME says exactly how far it moved
+      Shift(previousAnchor.start + (m_dateAnchor.date - previousAnchor.date) - m_dateAnchor.start);
+    }
+    result.appended = m_segments.size() - before;
+    result.cues = m_cues.size() > cuesBefore ? m_cues.size() - cuesBefore : 0;
+    return result;
+  }
+
+  void Clear() {
+    m_segments.clear();
+    m_uris.clear();
+    m_deadUriBytes = 0;
+    m_nextStart = 0;
+    m_endList = false;
+    m_cues.clear();
+    m_dateAnchor = DateAnchor{};
+  }
+
+  std::vector<HlsSegment> const &Segments() const {
+    return m_segments;
+  }
+
+  // Ad cues of the segments currently listed, in playlist order.
+  std::vector<HlsCue> const &Cues() const {
+    return m_cues;
+  }
+
+  std::string_view Uri(HlsSegment const &segment) const {
+    return std::string_view(m_uris).substr(segment.uriOffset, segment.uriLength);
+  }
+
+  double TargetDuration() const {
+    return m_targetDuration;
+  }
+
+  HlsPlaylistType Type() const {
+    return m_endList ? HlsPlaylistType::Vod : m_type;
+  }
+
+  bool EndList() const {
+    return m_endList;
+  }
+
+  uint32_t Version() const {
+    return m_version;
+  }
+
+  // Where |date| (seconds since 1970) falls on the segment timeline, going by the last
+  // EXT-X-PROGRAM-DATE-TIME; NaN when the playlist has none.
+  double TimeOfDate(double date) const {
+    return m_dateAnchor.valid ? m_dateAnchor.start + (date - m_dateAnchor.date) : NAN;
+  }
+
+  // Total duration of the segments currently listed.
+  double Duration() const {
+    return m_segments.empty() ? 0 : m_segments.back().start + m_segments.back().duration - m_segments.front().start;
+  }
+
+ private:
+  struct Header {
+    uint64_t mediaSequence = 0;
+    uint64_t discontinuitySequence = 0;
+    double targetDuration = 0;
+    uint32_t version = 1;
+    HlsPlaylistType type = HlsPlaylistType::Live;
+  };
+
+  // A segment start whose EXT-X-PROGRAM-DATE-TIME is known, which places dates on the segment timeline.
+  struct DateAnchor {
+    bool valid = false;
+    double date = 0; // seconds since 1970
+    double start = 0;
+  };
+
+  // Tags that belong to the segment they precede rather than to the header.
+  static bool IsSegmentTag(std::string_view line) {
+    return StartsWith(line, "#EXT-X-CUE") || StartsWith(line, "#EXT-X-DATERANGE:") ||
+        StartsWith(line, "#EXT-X-PROGRAM-DATE-TIME:") || StartsWith(line, "#EXT-OATCLS-SCTE35:");
+  }
+
+  // Reads the playlist tags up to the first segment tag and leaves |text| positioned there.
+  static bool ParseHeader(std::string_view &text, Header &header) {
+    std::string_view line;
+    if (!NextManifestLine(text, line) || !StartsWith(TrimManifestText(line), "#EXTM3U")) {
+      return false;
+    }
+    bool isMediaPlaylist = false;
+    // segment tags may come before the header is complete; segments are parsed from the first of them
+    std::string_view segmentText;
+    bool hasSegmentText = false;
+    for (auto rest = text; NextManifestLine(rest, line);) {
+      line = TrimManifestText(line);
+      uint64_t number = 0;
+      if (StartsWith(line, "#EXT-X-TARGETDURATION:")) {
+        isMediaPlaylist = true;
+        ParseManifestDecimal(line.substr(22), header.targetDuration);
+      } else if (StartsWith(line, "#EXT-X-MEDIA-SEQUENCE:")) {
+        ParseManifestUnsigned(line.substr(22), header.mediaSequence);
+      } else if (StartsWith(line, "#EXT-X-DISCONTINUITY-SEQUENCE:")) {
+        ParseManifestUnsigned(line.substr(30), header.discontinuitySequence);
+      } else if (StartsWith(line, "#EXT-X-VERSION:")) {
+        if (ParseManifestUnsigned(line.substr(15), number)) {
+          header.version = static_cast<uint32_t>(number);
+        }
+      } else if (StartsWith(line, "#EXT-X-PLAYLIST-TYPE:")) {
+        auto type = line.substr(21);
+        header.type = type == "VOD" ? HlsPlaylistType::Vod
+            : type == "EVENT"       ? HlsPlaylistType::Event
+                                    : HlsPlaylistType::Live;
+      } else if (StartsWith(line, "#EXTINF:") || StartsWith(line, "#EXT-X-BYTERANGE:") ||
+                 StartsWith(line, "#EXT-X-DISCONTINUITY") || StartsWith(line, "#EXT-X-STREAM-INF:") ||
+                 (!line.empty() && line.front() != '#')) {
+        isMediaPlaylist = isMediaPlaylist || StartsWith(line, "#EXTINF:");
+        break;
+      } else if (IsSegmentTag(line) && !hasSegmentText) {
+        segmentText = text;
+        hasSegmentText = true;
+      }
+      text = rest;
+    }
+    if (hasSegmentText) {
+      text = segmentText;
+    }
+    return isMediaPlaylist;
+  }
+
+  // Skips |count| segments (URI lines) of |text|. Returns false if the text lists fewer.
+  static bool SkipSegments(std::string_view &text, size_t count) {
+    std::string_view line;
+    while (count > 0 && NextManifestLine(text, line)) {
+      line = TrimManifestText(line);
+      if (!line.empty() && line.front() != '#') {
+        --count;
+      }
+    }
+    return count == 0;
+  }
+
+  void ParseSegments(std::string_view text, Header const &header) {
+    // continue from the last retained segment so refreshed tails line up with the existing timeline
+    uint64_t sequence = m_segments.empty() ? header.mediaSequence : m_segments.back().sequence + 1;
+    double start = m_segments.empty() ? m_nextStart : m_segments.back().start + m_segments.back().duration;
+    uint32_t discontinuitySequence = m_segments.empty() ? static_cast<uint32_t>(header.discontinuitySequence)
+                                                     : m_segments.back().discontinuitySequence;
+    uint64_t nextByteOffset =
+        m_segments.empty() ? 0 : m_segments.back().byteRange.offset + m_segments.back().byteRange.length;
+
+    HlsSegment pending;
+    bool discontinuity = false;
+    std::string_view oatclsScte35; // applies to the EXT-X-CUE-OUT that follows it
+    auto firstCue = m_cues.size();
+    std::string_view line;
+    while (NextManifestLine(text, line)) {
+      line = TrimManifestText(line);
+      if (line.empty()) {
+        continue;
+      }
+      if (line.front() != '#') {
+        pending.sequence = sequence++;
+        pending.start = start;
+        pending.discontinuity = discontinuity;
+        pending.discontinuitySequence = discontinuitySequence;
+        pending.uriOffset = static_cast<uint32_t>(m_uris.size());
+        pending.uriLength = static_cast<uint32_t>(line.size());
+        m_uris.append(line);
+        m_segments.push_back(pending);
+        start += pending.duration;
+        nextByteOffset = pending.byteRange.offset + pending.byteRange.length;
+        pending = HlsSegment{};
+        discontinuity = false;
+      } else if (StartsWith(line, "#EXTINF:")) {
+        ParseManifestDecimal(line.substr(8), pending.duration);
+      } else if (StartsWith(line, "#EXT-X-BYTERANGE:")) {
+        // length[@offset], without an offset the range continues where the previous one ended
+        auto range = line.substr(17);
+        auto at = range.find('@');
+        ParseManifestUnsigned(range.substr(0, at), pending.byteRange.length);
+        pending.byteRange.offset = nextByteOffset;
+        if (at != std::string_view::npos) {
+          ParseManifestUnsigned(range.substr(at + 1), pending.byteRange.offset);
+        }
+      } else if (line == "#EXT-X-DISCONTINUITY") {
+        discontinuity = true;
+        ++discontinuitySequence;
+      } else if (line == "#EXT-X-ENDLIST") {
+        m_endList = true;
+      } else if (StartsWith(line, "#EXT-X-PROGRAM-DATE-TIME:")) {
+        DateAnchor anchor;
+        anchor.valid = ParseManifestDateTime(line.substr(25), anchor.date);
+        anchor.start = start;
+        if (anchor.valid) {
+          m_dateAnchor = anchor;
+        }
+      } else if (StartsWith(line, "#EXT-OATCLS-SCTE35:")) {
+        oatclsScte35 = line.substr(19);
+      } else if (StartsWith(line, "#EXT-X-CUE-OUT-CONT")) {
+        // repeats an open break for late joiners, whose EXT-X-CUE-OUT slid out of the window
+      } else if (StartsWith(line, "#EXT-X-CUE-OUT")) {
+        HlsCue cue;
+        cue.kind = HlsCueKind::Out;
+        cue.sequence = sequence;
+        cue.time = start;
+        // "#EXT-X-CUE-OUT:30", "#EXT-X-CUE-OUT:DURATION=30" or a bare "#EXT-X-CUE-OUT"
+        auto duration = line.substr(std::min(line.size(), size_t{15}));
+        if (StartsWith(duration, "DURATION=")) {
+          duration.remove_prefix(9);
+        }
+        ParseManifestDecimal(duration, cue.duration);
+        cue.scte35 = std::string(std::exchange(oatclsScte35, {}));
+        m_cues.push_back(std::move(cue));
+      } else if (StartsWith(line, "#EXT-X-CUE-IN")) {
+        HlsCue cue;
+        cue.kind = HlsCueKind::In;
+        cue.sequence = sequence;
+        cue.time = start;
+        m_cues.push_back(std::move(cue));
+      } else if (StartsWith(line, "#EXT-X-DATERANGE:")) {
+        ParseDateRange(line.substr(17), sequence, start);
+      }
+    }
+    if (!m_segments.empty()) {
+      m_nextStart = m_segments.back().start + m_segments.back().duration;
+    }
+    // dates can only be placed once the playlist's EXT-X-PROGRAM-DATE-TIME has been seen, which may be
+    // after the EXT-X-DATERANGE
+    if (m_dateAnchor.valid) {
+      for (auto i = firstCue; i < m_cues.size(); ++i) {
+        if (!std::isnan(m_cues[i].date)) {
+          m_cues[i].time = TimeOfDate(m_cues[i].date);
+        }
+      }
+    }
+  }
+
+  // Moves everything on the segment timeline by |seconds|.
+  void Shift(double seconds) {
+    for (auto &segment : m_segments) {
+      segment.start += seconds;
+    }
+    for (auto &cue : m_cues) {
+      cue.time += seconds;
+    }
+    m_nextStart += seconds;
+    m_dateAnchor.start += seconds;
+  }
+
+  // Adds the cue of one EXT-X-DATERANGE, if it carries an SCTE-35 signal; other date ranges (e.g.
+  // interstitials or chapter metadata) are not ad cues.
+  void ParseDateRange(std::string_view attributes, uint64_t sequence, double start) {
+    HlsCue cue;
+    cue.sequence = sequence;
+    cue.time = start;
+    double startDate = NAN;
+    double endDate = NAN;
+    double duration = 0;
+    double plannedDuration = 0;
+    std::string_view out, in, command;
+    ForEachHlsAttribute(attributes, [&](std::string_view name, std::string_view value) {
+      if (name == "ID") {
+        cue.id = std::string(value);
+      } else if (name == "START-DATE") {
+        ParseManifestDateTime(value, startDate);
+      } else if (name == "END-DATE") {
+        ParseManifestDateTime(value, endDate);
+      } else if (name == "DURATION") {
+        ParseManifestDecimal(value, duration);
+      } else if (name == "PLANNED-DURATION") {
+        ParseManifestDecimal(value, plannedDuration);
+      } else if (name == "SCTE35-OUT") {
+        out = value;
+      } else if (name == "SCTE35-IN") {
+        in = value;
+      } else if (name == "SCTE35-CMD") {
+        command = value;
+      }
+    });
+    if (duration == 0 && !std::isnan(startDate) && !std::isnan(endDate)) {
+      duration = endDate - startDate;
+    }
+    cue.date = startDate;
+    if (!out.empty()) {
+      cue.kind = HlsCueKind::Out;
+      cue.duration = duration > 0 ? duration : plannedDuration;
+      cue.scte35 = std::string(out);
+    } else if (!in.empty()) {
+      // the closing tag repeats the opening one's ID and START-DATE and says how long the break ran
+      cue.kind = HlsCueKind::In;
+      cue.scte35 = std::string(in);
+      cue.date = duration > 0 ? startDate + duration : NAN;
+    } else if (!command.empty()) {
+      cue.kind = HlsCueKind::Command;
+      cue.duration = duration > 0 ? duration : plannedDuration;
+      cue.scte35 = std::string(command);
+    } else {
+      return;
+    }
+    m_cues.push_back(std::move(cue));
+  }
+
+  // Drops segments older than |sequence|. URI bytes are reclaimed once at least half the arena is dead.
+  size_t DropBefore(uint64_t sequence) {
+    auto keep = std::find_if(m_segments.begin(), m_segments.end(), [sequence](HlsSegment const &segment) {
+      return segment.sequence >= sequence;
+    });
+    auto removed = static_cast<size_t>(keep - m_segments.begin());
+    for (auto it = m_segments.begin(); it != keep; ++it) {
+      m_deadUriBytes += it->uriLength;
+    }
+    m_segments.erase(m_segments.begin(), keep);
+    m_cues.erase(
+        m_cues.begin(),
+        std::find_if(m_cues.begin(), m_cues.end(), [sequence](HlsCue const &cue) { return cue.sequence >= sequence; }));
+    if (m_deadUriBytes * 2 > m_uris.size()) {
+      CompactUris();
+    }
+    return removed;
+  }
+
+  void CompactUris() {
+    std::string compacted;
+    compacted.reserve(m_uris.size() - m_deadUriBytes);
+    for (auto &segment : m_segments) {
+      auto uri = Uri(segment);
+      segment.uriOffset = static_cast<uint32_t>(compacted.size());
+      compacted.append(uri);
+    }
+    m_uris.swap(compacted);
+    m_deadUriBytes = 0;
+  }
+
+  std::vector<HlsSegment> m_segments;
+  std::string m_uris;
+  size_t m_deadUriBytes = 0;
+  double m_nextStart = 0;
+  double m_targetDuration = 0;
+  uint32_t m_version = 1;
+  HlsPlaylistType m_type = HlsPlaylistType::Live;
+  bool m_endList = false;
+  std::vector<HlsCue> m_cues;
+  DateAnchor m_dateAnchor;
+};
+
+} // namespace ReactNativeVideoCPP
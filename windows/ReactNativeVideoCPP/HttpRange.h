@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Portable (WinRT-free) rules for the ranged requests of the segment and progressive caches.
+namespace ReactNativeVideoCPP {
+
+constexpr int c_httpPartialContent = 206;
+
+// Value of a Range header asking for |length| (> 0) bytes from |offset|.
+inline std::string HttpRangeValue(uint64_t offset, uint64_t length) {
+  return "bytes=" + std::to_string(offset) + "-" + std::to_string(offset + length - 1);
+}
+
+// Whether a response with |status| carries what was asked for. With a Range header only 206 Partial
+// Content does: a server that ignores the header answers 200 with the resource from its start, which must
+// not be stored as the range. Without one any 2xx does.
+inline bool IsExpectedHttpStatus(int status, bool rangeRequested) {
+  return rangeRequested ? status == c_httpPartialContent : status >= 200 && status < 300;
+}
+
+// What a resource is revalidated with in If-Range, from the ETag and Last-Modified of its response: the
+// ETag unless it is a weak one ("W/..."), which If-Range does not accept, else the date. Empty when there
+// is neither, and the resource cannot be revalidated.
+inline std::string HttpRangeValidator(std::string_view etag, std::string_view lastModified) {
+  if (!etag.empty() && etag.substr(0, 2) != "W/") {
+    return std::string(etag);
+  }
+  return std::string(lastModified);
+}
+
+} // namespace ReactNativeVideoCPP
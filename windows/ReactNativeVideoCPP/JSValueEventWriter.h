@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string_view>
+#include "EventSchema.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// Adapts IJSValueWriter to the writer interface EventWriter expects.
+struct JSValueEventWriter {
+  Microsoft::ReactNative::IJSValueWriter const &writer;
+
+  void BeginObject() {
+    writer.WriteObjectBegin();
+  }
+
+  void EndObject() {
+    writer.WriteObjectEnd();
+  }
+
+  void Key(hstring const &key) {
+    writer.WritePropertyName(key);
+  }
+
+  void Value(bool value) {
+    writer.WriteBoolean(value);
+  }
+
+  void Value(int64_t value) {
+    writer.WriteInt64(value);
+  }
+
+  void Value(double value) {
+    writer.WriteDouble(value);
+  }
+
+  void Value(std::wstring_view value) {
+    writer.WriteString(value);
+  }
+};
+
+// Dispatches |payload| as |eventName| on |view|. Property names of each payload type are turned into
+// hstrings once per process and reused for every event.
+template <typename Payload>
+void DispatchVideoEvent(
+    Microsoft::ReactNative::IReactContext const &reactContext,
+    Windows::UI::Xaml::FrameworkElement const &view,
+    wchar_t const *eventName,
+    Payload const &payload) {
+  static const ::ReactNativeVideoCPP::EventWriter<Payload, hstring> s_writer{
+      [](std::wstring_view name) { return hstring{name}; }};
+
+  reactContext.DispatchEvent(
+      view, eventName, [&payload](Microsoft::ReactNative::IJSValueWriter const &eventDataWriter) noexcept {
+        JSValueEventWriter writer{eventDataWriter};
+        s_writer.Write(writer, payload);
+      });
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// Portable (WinRT-free) allocation-free scanning helpers shared by the manifest parsers. Everything works
+// on string_views into the caller's text and reports malformed input by returning false / a default.
+namespace ReactNativeVideoCPP {
+
+// Pops the next line off |text| (without its CR / LF) into |line|. Returns false at the end of the text.
+inline bool NextManifestLine(std::string_view &text, std::string_view &line) {
+  if (text.empty()) {
+    return false;
+  }
+  auto end = text.find('\n');
+  line = text.substr(0, end);
+  text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  return true;
+}
+
+inline std::string_view TrimManifestText(std::string_view text) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+// Decimal integer; stops at the first non-digit. Returns false when there is no digit.
+inline bool ParseManifestUnsigned(std::string_view text, uint64_t &value) {
+  value = 0;
+  size_t i = 0;
+  for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+    value = value * 10 + static_cast<uint64_t>(text[i] - '0');
+  }
+  return i > 0;
+}
+
+// Decimal number with an optional sign and fraction ("-12.345"). Exponents are not used by HLS / DASH
+// numbers and are not supported. Returns false when there is no digit.
+inline bool ParseManifestDecimal(std::string_view text, double &value) {
+  bool negative = !text.empty() && text.front() == '-';
+  if (negative || (!text.empty() && text.front() == '+')) {
+    text.remove_prefix(1);
+  }
+  uint64_t whole = 0;
+  size_t i = 0;
+  for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+    whole = whole * 10 + static_cast<uint64_t>(text[i] - '0');
+  }
+  bool digits = i > 0;
+  double fraction = 0;
+  if (i < text.size() && text[i] == '.') {
+    double scale = 0.1;
+    for (++i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+      fraction += (text[i] - '0') * scale;
+      scale /= 10;
+      digits = true;
+    }
+  }
+  value = (negative ? -1.0 : 1.0) * (static_cast<double>(whole) + fraction);
+  return digits;
+}
+
+// Seconds since 1970 of an ISO 8601 date-time ("2024-05-01T12:00:00.500Z", "...+02:00"), as written by
+// HLS EXT-X-PROGRAM-DATE-TIME / EXT-X-DATERANGE and the DASH availabilityStartTime. Returns false when
+// |text| is not one.
+inline bool ParseManifestDateTime(std::string_view text, double &seconds) {
+  auto number = [&text](size_t digits, int64_t &value) {
+    if (text.size() < digits) {
+      return false;
+    }
+    int64_t parsed = 0;
+    for (size_t i = 0; i < digits; ++i) {
+      if (text[i] < '0' || text[i] > '9') {
+        return false;
+      }
+      parsed = parsed * 10 + (text[i] - '0');
+    }
+    value = parsed;
+    text.remove_prefix(digits);
+    return true;
+  };
+  auto separator = [&text](char c) {
+    if (text.empty() || (text.front() != c && !(c == 'T' && (text.front() == 't' || text.front() == ' ')))) {
+      return false;
+    }
+    text.remove_prefix(1);
+    return true;
+  };
+  int64_t year, month, day, hour, minute, second;
+  if (!number(4, year) || !separator('-') || !number(2, month) || !separator('-') || !number(2, day) ||
+      !separator('T') || !number(2, hour) || !separator(':') || !number(2, minute) || !separator(':') ||
+      !number(2, second)) {
+    return false;
+  }
+  double fraction = 0;
+  if (!text.empty() && text.front() == '.') {
+    size_t digits = 1;
+    while (digits < text.size() && text[digits] >= '0' && text[digits] <= '9') {
+      ++digits;
+    }
+    ParseManifestDecimal(text.substr(0, digits), fraction);
+    text.remove_prefix(digits);
+  }
+  int64_t offsetSeconds = 0;
+  if (!text.empty() && (text.front() == '+' || text.front() == '-')) {
+    auto sign = text.front() == '-' ? -1 : 1;
+    text.remove_prefix(1);
+    int64_t offsetHours = 0;
+    int64_t offsetMinutes = 0;
+    if (!number(2, offsetHours)) {
+      return false;
+    }
+    separator(':');
+    number(2, offsetMinutes); // "+02" alone is allowed
+    offsetSeconds = sign * (offsetHours * 3600 + offsetMinutes * 60);
+  }
+  // days from civil, proleptic Gregorian
+  year -= month <= 2;
+  auto era = (year >= 0 ? year : year - 399) / 400;
+  auto yearOfEra = year - era * 400;
+  auto dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  auto dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+  auto days = era * 146097 + dayOfEra - 719468;
+  seconds = static_cast<double>(days * 86400 + hour * 3600 + minute * 60 + second - offsetSeconds) + fraction;
+  return true;
+}
+
+} // namespace ReactNativeVideoCPP
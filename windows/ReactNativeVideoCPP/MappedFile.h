@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Portable (WinRT-free) read-only memory mapping of a whole file, plus the matching atomic write. Only the
+// OS calls differ between platforms: the UWP-safe *FromApp mapping functions on Windows, mmap elsewhere.
+namespace ReactNativeVideoCPP {
+
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+  }
+
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      Close();
+      m_data = std::exchange(other.m_data, nullptr);
+      m_size = std::exchange(other.m_size, 0);
+#ifdef _WIN32
+      m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+  }
+
+  ~MappedFile() {
+    Close();
+  }
+
+  // Maps |path|. Returns false if it doesn't exist, is empty or can't be mapped.
+  bool Open(std::filesystem::path const &path) {
+    Close();
+#ifdef _WIN32
+    HANDLE file = CreateFile2(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, OPEN_EXISTING, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      return false;
+    }
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+      m_mapping = CreateFileMappingFromApp(file, nullptr, PAGE_READONLY, 0, nullptr);
+      if (m_mapping != nullptr) {
+        m_data = static_cast<uint8_t const *>(MapViewOfFileFromApp(m_mapping, FILE_MAP_READ, 0, 0));
+        m_size = static_cast<size_t>(size.QuadPart);
+      }
+    }
+    CloseHandle(file);
+#else
+    int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+      return false;
+    }
+    struct stat status {};
+    if (fstat(file, &status) == 0 && status.st_size > 0) {
+      auto data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+      if (data != MAP_FAILED) {
+        m_data = static_cast<uint8_t const *>(data);
+        m_size = static_cast<size_t>(status.st_size);
+      }
+    }
+    close(file);
+#endif
+    if (m_data == nullptr) {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  void Close() {
+#ifdef _WIN32
+    if (m_data != nullptr) {
+      UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+      CloseHandle(m_mapping);
+      m_mapping = nullptr;
+    }
+#else
+    if (m_data != nullptr) {
+      munmap(const_cast<uint8_t *>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+  }
+
+  uint8_t const *Data() const {
+    return m_data;
+  }
+
+  size_t Size() const {
+    return m_size;
+  }
+
+  explicit operator bool() const {
+    return m_data != nullptr;
+  }
+
+ private:
+  uint8_t const *m_data = nullptr;
+  size_t m_size = 0;
+#ifdef _WIN32
+  HANDLE m_mapping = nullptr;
+#endif
+};
+
+// Writes |bytes| to a temporary sibling, flushes it to the disk and renames it over |path|, so readers
+// (and a crash or power loss) only ever see the old or the complete new file. Without the flush the
+// rename can reach the disk before the data and leave a renamed but empty or torn file behind.
+inline bool WriteFileAtomically(std::filesystem::path const &path, std::string_view bytes) {
+  auto temporary = path;
+  temporary += ".tmp";
+  bool written = true;
+#ifdef _WIN32
+  HANDLE file = CreateFile2(temporary.c_str(), GENERIC_WRITE, 0, CREATE_ALWAYS, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  for (auto rest = bytes; written && !rest.empty();) {
+    DWORD wrote = 0;
+    auto chunk = static_cast<DWORD>(std::min<size_t>(rest.size(), 1u << 30));
+    written = WriteFile(file, rest.data(), chunk, &wrote, nullptr) != FALSE;
+    rest.remove_prefix(wrote);
+  }
+  written = written && FlushFileBuffers(file) != FALSE;
+  CloseHandle(file);
+#else
+  int file = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (file < 0) {
+    return false;
+  }
+  for (auto rest = bytes; written && !rest.empty();) {
+    auto wrote = write(file, rest.data(), rest.size());
+    written = wrote > 0;
+    rest.remove_prefix(written ? static_cast<size_t>(wrote) : 0);
+  }
+  written = written && fsync(file) == 0;
+  written = close(file) == 0 && written;
+#endif
+  std::error_code error;
+  if (!written) {
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+    return false;
+  }
+#ifndef _WIN32
+  // the rename itself is only durable once the directory is
+  int directory = open(path.parent_path().empty() ? "." : path.parent_path().c_str(), O_RDONLY | O_CLOEXEC);
+  if (directory >= 0) {
+    fsync(directory);
+    close(directory);
+  }
+#endif
+  return true;
+}
+
+} // namespace ReactNativeVideoCPP
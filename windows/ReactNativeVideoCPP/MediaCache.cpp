@@ -0,0 +1,324 @@
+#include "pch.h"
+#include "MediaCache.h"
+#include <chrono>
+#include <cwctype>
+#include "BandwidthMeter.h"
+#include "CachedHttpStream.h"
+#include "HttpRange.h"
+
+using namespace Windows::Foundation;
+using namespace Windows::Media::Core;
+using namespace Windows::Media::Streaming::Adaptive;
+using namespace Windows::Storage::Streams;
+using namespace Windows::Web::Http;
+
+using ::ReactNativeVideoCPP::ByteRange;
+using ::ReactNativeVideoCPP::IsExpectedHttpStatus;
+using ::ReactNativeVideoCPP::SegmentCache;
+using ::ReactNativeVideoCPP::SingleFlight;
+using ::ReactNativeVideoCPP::SparseCache;
+using ::ReactNativeVideoCPP::SparseResource;
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+namespace {
+
+// same as sizeConstraintBytes of the iOS RCTVideoCache
+constexpr uint64_t c_capacityBytes = 100 * 1024 * 1024;
+
+// a few breaks' worth of prefetched creatives, on top of the content's budget rather than out of it
+constexpr uint64_t c_creativeCapacityBytes = 48 * 1024 * 1024;
+
+// gaps are fetched at least this far, so the player's small sequential reads don't each become a request
+constexpr uint64_t c_minimumFetchBytes = 256 * 1024;
+
+bool IsProgressive(Uri const &uri) {
+  auto scheme = uri.SchemeName();
+  if (scheme != L"http" && scheme != L"https") {
+    return false;
+  }
+  std::wstring path{uri.Path()};
+  for (auto &c : path) {
+    c = static_cast<wchar_t>(std::towlower(c));
+  }
+  auto endsWith = [&path](std::wstring_view suffix) {
+    return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+  };
+  return !endsWith(L".m3u8") && !endsWith(L".mpd");
+}
+
+hstring RangeHeader(uint64_t offset, uint64_t length) {
+  return to_hstring(::ReactNativeVideoCPP::HttpRangeValue(offset, length));
+}
+
+template <typename Headers>
+std::string HeaderText(Headers const &headers, wchar_t const *name) {
+  return headers.HasKey(name) ? to_string(headers.Lookup(name)) : std::string();
+}
+
+// What the HEAD response says about a resource the server serves byte ranges of; length 0 otherwise.
+SparseResource RangeableResource(HttpResponseMessage const &response) {
+  SparseResource resource;
+  auto headers = response.Headers();
+  if (!response.IsSuccessStatusCode() || HeaderText(headers, L"Accept-Ranges") != "bytes") {
+    return resource;
+  }
+  auto contentHeaders = response.Content().Headers();
+  if (auto type = contentHeaders.ContentType()) {
+    resource.contentType = to_string(type.MediaType());
+  }
+  auto contentLength = contentHeaders.ContentLength();
+  resource.length = contentLength ? contentLength.Value() : 0;
+  resource.validator = ::ReactNativeVideoCPP::HttpRangeValidator(
+      HeaderText(headers, L"ETag"), HeaderText(contentHeaders, L"Last-Modified"));
+  return resource;
+}
+
+// A resource seen before with a validator needs no HEAD: FetchRange revalidates it with If-Range.
+bool IsRevalidatable(SparseResource const &resource) {
+  return resource.length != 0 && !resource.validator.empty();
+}
+
+IBuffer ToBuffer(std::string_view bytes) {
+  Buffer buffer(static_cast<uint32_t>(bytes.size()));
+  std::memcpy(buffer.data(), bytes.data(), bytes.size());
+  buffer.Length(static_cast<uint32_t>(bytes.size()));
+  return buffer;
+}
+
+} // namespace
+
+MediaCache &MediaCache::Instance() {
+  // intentionally leaked, download callbacks may still arrive during shutdown
+  static auto *cache = new MediaCache();
+  return *cache;
+}
+
+MediaCache::MediaCache() {
+  try {
+    auto root = Windows::Storage::ApplicationData::Current().LocalCacheFolder().Path();
+    std::filesystem::path folder{std::wstring_view{root}};
+    m_segments = std::make_unique<SegmentCache>(folder / L"Segments", c_capacityBytes);
+    m_ranges = std::make_unique<SparseCache>(folder / L"Progressive", c_capacityBytes);
+    m_creatives = std::make_unique<SparseCache>(folder / L"AdCreatives", c_creativeCapacityBytes);
+  } catch (winrt::hresult_error const &) {
+    // no app data (e.g. unpackaged host), sources download as usual
+  }
+}
+
+void MediaCache::Attach(AdaptiveMediaSource const &source) {
+  if (m_segments == nullptr) {
+    return;
+  }
+  source.DownloadRequested([this](auto const &, AdaptiveMediaSourceDownloadRequestedEventArgs const &args) {
+    auto type = args.ResourceType();
+    if (type != AdaptiveMediaSourceResourceType::MediaSegment &&
+        type != AdaptiveMediaSourceResourceType::InitializationSegment) {
+      return;
+    }
+    auto offset = args.ResourceByteRangeOffset();
+    auto length = args.ResourceByteRangeLength();
+    auto key = SegmentCache::Key(
+        to_string(args.ResourceUri().AbsoluteUri()),
+        offset ? offset.Value() : 0,
+        length ? length.Value() : 0);
+    if (auto item = m_segments->Get(key)) {
+      args.Result().Buffer(ToBuffer(item.Data()));
+      return;
+    }
+    Download(args, std::move(key));
+  });
+}
+
+MediaSource MediaCache::CreateProgressiveSource(Uri const &uri, RangeCache cache) {
+  auto *ranges = Ranges(cache);
+  if (ranges == nullptr || !IsProgressive(uri)) {
+    return nullptr;
+  }
+  auto key = to_string(uri.AbsoluteUri());
+  auto resource = ranges->Resource(key);
+  if (IsRevalidatable(resource)) {
+    // nothing to ask the server before the first read, e.g. a prefetched ad creative starts from disk
+    return MediaSource::CreateFromStream(
+        make<CachedHttpStream>(uri, key, cache, resource.length), to_hstring(resource.contentType));
+  }
+  MediaBinder binder;
+  binder.Token(uri.AbsoluteUri());
+  binder.Binding([this, cache](auto const &, MediaBindingEventArgs const &args) { Bind(args, cache); });
+  return MediaSource::CreateFromMediaBinder(binder);
+}
+
+bool MediaCache::ReadRange(
+    RangeCache cache,
+    Uri const &uri,
+    std::string const &key,
+    uint64_t offset,
+    uint32_t length,
+    std::string &out) {
+  auto &ranges = *Ranges(cache);
+  return ranges.Read(
+      key,
+      offset,
+      length,
+      out,
+      [this, &ranges, &uri](uint64_t start, uint64_t size) { return FetchRange(ranges, uri, start, size); },
+      c_minimumFetchBytes);
+}
+
+bool MediaCache::MissingRanges(RangeCache cache, Uri const &uri, uint64_t maxBytes, std::vector<ByteRange> &ranges) {
+  ranges.clear();
+  auto *kept = Ranges(cache);
+  if (kept == nullptr || !IsProgressive(uri)) {
+    return false;
+  }
+  auto key = to_string(uri.AbsoluteUri());
+  auto resource = kept->Resource(key);
+  if (!IsRevalidatable(resource)) {
+    try {
+      resource = RangeableResource(m_client.SendRequestAsync(HttpRequestMessage(HttpMethod::Head(), uri)).get());
+    } catch (winrt::hresult_error const &) {
+      // offline, there is nothing to get ahead of
+      return false;
+    }
+    if (resource.length == 0) {
+      return false;
+    }
+    kept->Adopt(key, resource);
+  }
+  for (auto const &gap : kept->Present(key).Gaps(0, std::min(resource.length, maxBytes))) {
+    for (auto offset = gap.start; offset < gap.end; offset += c_minimumFetchBytes) {
+      ranges.push_back(ByteRange{offset, std::min(offset + c_minimumFetchBytes, gap.end)});
+    }
+  }
+  return true;
+}
+
+::ReactNativeVideoCPP::SegmentCacheStats MediaCache::Stats() const {
+  return m_segments != nullptr ? m_segments->Stats() : ::ReactNativeVideoCPP::SegmentCacheStats{};
+}
+
+::ReactNativeVideoCPP::SparseCacheStats MediaCache::ProgressiveStats(RangeCache cache) const {
+  auto *ranges = Ranges(cache);
+  return ranges != nullptr ? ranges->Stats() : ::ReactNativeVideoCPP::SparseCacheStats{};
+}
+
+SingleFlight &MediaCache::Flights() {
+  return m_flights;
+}
+
+SparseCache *MediaCache::Ranges(RangeCache cache) const {
+  return cache == RangeCache::AdCreatives ? m_creatives.get() : m_ranges.get();
+}
+
+fire_and_forget MediaCache::Bind(MediaBindingEventArgs args, RangeCache cache) {
+  auto deferral = args.GetDeferral();
+  Uri uri{args.MediaBinder().Token()};
+  auto key = to_string(uri.AbsoluteUri());
+  auto *ranges = Ranges(cache);
+  auto resource = ranges->Resource(key);
+  if (!IsRevalidatable(resource)) {
+    try {
+      auto response = co_await m_client.SendRequestAsync(HttpRequestMessage(HttpMethod::Head(), uri));
+      resource = RangeableResource(response);
+      if (resource.length != 0) {
+        // drops the kept ranges if the resource changed on the server since
+        ranges->Adopt(key, resource);
+      }
+    } catch (winrt::hresult_error const &) {
+      // offline, a resource seen before still plays as far as it is cached
+    }
+  }
+  if (resource.length == 0) {
+    args.SetUri(uri);
+    deferral.Complete();
+    co_return;
+  }
+  args.SetStream(make<CachedHttpStream>(uri, key, cache, resource.length), to_hstring(resource.contentType));
+  deferral.Complete();
+}
+
+std::string MediaCache::FetchRange(SparseCache &ranges, Uri const &uri, uint64_t offset, uint64_t length) {
+  // players reading the same clip from the same spot share one request
+  auto resourceKey = to_string(uri.AbsoluteUri());
+  auto key = SegmentCache::Key(resourceKey, offset, length);
+  auto bytes = m_flights.Run(key, [&]() -> SingleFlight::Bytes {
+    try {
+      HttpRequestMessage request(HttpMethod::Get(), uri);
+      request.Headers().TryAppendWithoutValidation(L"Range", RangeHeader(offset, length));
+      auto validator = ranges.Resource(resourceKey).validator;
+      if (!validator.empty()) {
+        request.Headers().TryAppendWithoutValidation(L"If-Range", to_hstring(validator));
+      }
+      auto started = std::chrono::steady_clock::now();
+      auto response = m_client.SendRequestAsync(request).get();
+      auto status = static_cast<int>(response.StatusCode());
+      if (!IsExpectedHttpStatus(status, true)) {
+        if (status == static_cast<int>(HttpStatusCode::Ok) && !validator.empty()) {
+          // If-Range failed: the resource changed since its ranges were kept, so they go and the next
+          // open asks the server again
+          ranges.Remove(resourceKey);
+        }
+        return nullptr;
+      }
+      auto buffer = response.Content().ReadAsBufferAsync().get();
+      BandwidthMeter::Instance().AddSample(
+          buffer.Length(),
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count());
+      return std::make_shared<std::string const>(reinterpret_cast<char const *>(buffer.data()), buffer.Length());
+    } catch (winrt::hresult_error const &) {
+      // read as a short fetch, the stream reports the failure
+    }
+    return nullptr;
+  });
+  return bytes != nullptr ? *bytes : std::string();
+}
+
+fire_and_forget MediaCache::Download(AdaptiveMediaSourceDownloadRequestedEventArgs args, std::string key) {
+  auto deferral = args.GetDeferral();
+  if (!m_flights.Join(key, [args, deferral](SingleFlight::Bytes const &bytes) {
+        // another source is downloading the same segment; on failure the result stays empty as below
+        if (bytes != nullptr) {
+          args.Result().Buffer(ToBuffer(*bytes));
+        }
+        deferral.Complete();
+      })) {
+    co_return;
+  }
+  SingleFlight::Bytes bytes;
+  try {
+    HttpRequestMessage request(HttpMethod::Get(), args.ResourceUri());
+    auto offset = args.ResourceByteRangeOffset();
+    auto length = args.ResourceByteRangeLength();
+    uint64_t rangeLength = offset && length ? length.Value() : 0;
+    if (rangeLength != 0) {
+      request.Headers().TryAppendWithoutValidation(L"Range", RangeHeader(offset.Value(), rangeLength));
+    }
+    auto started = std::chrono::steady_clock::now();
+    auto response = co_await m_client.SendRequestAsync(request);
+    if (IsExpectedHttpStatus(static_cast<int>(response.StatusCode()), rangeLength != 0)) {
+      auto buffer = co_await response.Content().ReadAsBufferAsync();
+      // a segment is stored whole, a byte range segment must arrive exactly as long as it was asked for
+      if (rangeLength != 0 && buffer.Length() != rangeLength) {
+        throw hresult_error(E_FAIL);
+      }
+      // the source only measures what it downloads itself, so the sample is taken here
+      BandwidthMeter::Instance().AddSample(
+          buffer.Length(),
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count());
+      args.Result().Buffer(buffer);
+      bytes = std::make_shared<std::string const>(reinterpret_cast<char const *>(buffer.data()), buffer.Length());
+    }
+    // on an error status, or a 200 to a ranged request, the result stays empty and the source downloads
+    // (and reports) the segment itself
+  } catch (winrt::hresult_error const &) {
+    // same fallback for network failures and short ranges
+  }
+  // hand the segment over, here and to the sources that joined, before the disk write
+  deferral.Complete();
+  m_flights.Complete(key, bytes);
+  if (bytes != nullptr) {
+    m_segments->Put(key, *bytes);
+  }
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "SegmentCache.h"
+#include "SingleFlight.h"
+#include "SparseCache.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// Which byte-range cache a progressive resource is kept in. Ad creatives have a budget of their own, so
+// prefetching them cannot evict the content being watched.
+enum class RangeCache { Content, AdCreatives };
+
+// The process-wide on-disk cache of HLS / DASH segments, kept in the app's local cache folder under the
+// same 100 MB budget the iOS cache uses. Attached adaptive sources ask it for every segment: hits are
+// served from disk, misses are downloaded here rather than by the source so the bytes can be kept.
+// Progressive http(s) resources get a sparse cache of their byte ranges with a budget of its own, and ad
+// creatives another. Misses of any kind that several players request at once are downloaded once and shared.
+class MediaCache {
+ public:
+  static MediaCache &Instance();
+
+  // Routes the segment downloads of |source| through the cache. Call it from OpenOperationCompleted;
+  // the handler lives as long as the source.
+  void Attach(Windows::Media::Streaming::Adaptive::AdaptiveMediaSource const &source);
+
+  // A source reading |uri| through a CachedHttpStream over |cache|, or null when |uri| is not a progressive
+  // http(s) resource or the cache is unavailable. A resource already cached with a validator is read from
+  // disk right away; others are bound when the player opens the source, after a HEAD, and servers without
+  // byte-range support fall back to a plain uri source then.
+  Windows::Media::Core::MediaSource CreateProgressiveSource(
+      Windows::Foundation::Uri const &uri,
+      RangeCache cache = RangeCache::Content);
+
+  // Fills |out| with [offset, offset + length) of the resource kept in |cache| under |key|, requesting the
+  // missing ranges of |uri|. Blocks on the network, call it off the UI thread. False if the bytes came back
+  // short.
+  bool ReadRange(
+      RangeCache cache,
+      Windows::Foundation::Uri const &uri,
+      std::string const &key,
+      uint64_t offset,
+      uint32_t length,
+      std::string &out);
+
+  // The pieces of the first |maxBytes| of the progressive resource at |uri| that |cache| is missing, for
+  // the caller to read (and pace) one by one. Asks the server first unless the resource is known. Blocks
+  // on the network, call it off the UI thread. False if the resource cannot be cached.
+  bool MissingRanges(
+      RangeCache cache,
+      Windows::Foundation::Uri const &uri,
+      uint64_t maxBytes,
+      std::vector<::ReactNativeVideoCPP::ByteRange> &ranges);
+
+  ::ReactNativeVideoCPP::SegmentCacheStats Stats() const;
+  ::ReactNativeVideoCPP::SparseCacheStats ProgressiveStats(RangeCache cache = RangeCache::Content) const;
+
+  // Merges concurrent fetches of the same URL and byte range across every player of the process.
+  ::ReactNativeVideoCPP::SingleFlight &Flights();
+
+ private:
+  MediaCache();
+
+  fire_and_forget Download(
+      Windows::Media::Streaming::Adaptive::AdaptiveMediaSourceDownloadRequestedEventArgs args,
+      std::string key);
+  ::ReactNativeVideoCPP::SparseCache *Ranges(RangeCache cache) const;
+  fire_and_forget Bind(Windows::Media::Core::MediaBindingEventArgs args, RangeCache cache);
+  std::string FetchRange(
+      ::ReactNativeVideoCPP::SparseCache &ranges,
+      Windows::Foundation::Uri const &uri,
+      uint64_t offset,
+      uint64_t length);
+
+  Windows::Web::Http::HttpClient m_client;
+  ::ReactNativeVideoCPP::SingleFlight m_flights;
+  std::unique_ptr<::ReactNativeVideoCPP::SegmentCache> m_segments; // null without app data
+  std::unique_ptr<::ReactNativeVideoCPP::SparseCache> m_ranges; // null without app data
+  std::unique_ptr<::ReactNativeVideoCPP::SparseCache> m_creatives; // null without app data
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,30 @@
+#include "pch.h"
+#include "MediaEventQueue.h"
+#include "ReactVideoView.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+MediaEventQueue &MediaEventQueue::ForCurrentThread() {
+  // intentionally leaked, media threads may still post to it while the UI thread shuts down
+  thread_local MediaEventQueue *queue =
+      new MediaEventQueue(Windows::UI::Core::CoreWindow::GetForCurrentThread().Dispatcher());
+  return *queue;
+}
+
+MediaEventQueue::MediaEventQueue(Windows::UI::Core::CoreDispatcher const &dispatcher) : m_dispatcher(dispatcher) {}
+
+void MediaEventQueue::Post(MediaEvent event) {
+  if (m_events.Push(std::move(event))) {
+    m_dispatcher.RunAsync(Windows::UI::Core::CoreDispatcherPriority::Normal, [this]() { Drain(); });
+  }
+}
+
+void MediaEventQueue::Drain() {
+  m_events.Drain([](MediaEvent const &event) {
+    if (auto view = event.view.get()) {
+      view->OnMediaEvent(event);
+    }
+  });
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
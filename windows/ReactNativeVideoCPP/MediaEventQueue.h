@@ -0,0 +1,58 @@
+#pragma once
+
+#include "EventBatchQueue.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+struct ReactVideoView;
+
+enum class MediaEventKind {
+  Opened,
+  Ended,
+  SeekCompleted,
+  PlaybackStateChanged,
+  BufferedRangesChanged,
+  SeekableRangesChanged,
+  BufferingStarted,
+  BufferingEnded,
+  Failed,
+  BandwidthSample,
+  AdaptiveSourceOpened,
+  NaturalVideoSizeChanged,
+  AdBreakStarted,
+  AdStarted,
+  AdBreakEnded,
+  AdBreakSkipped,
+  AdFailed,
+};
+
+struct MediaEvent {
+  ReactVideoView const *source;
+  MediaEventKind kind;
+  bool collapsible;
+  int64_t timeMs; // when the player raised it, so batching doesn't skew measured durations
+  winrt::weak_ref<ReactVideoView> view;
+  // PlaybackStateChanged only: the state the player changed to, since it may have moved on by the drain
+  Windows::Media::Playback::MediaPlaybackState state = Windows::Media::Playback::MediaPlaybackState::None;
+  uint32_t item = 0; // AdFailed only: the ad of the break whose media failed
+};
+
+// Collects MediaPlayer callbacks raised on media threads for every ReactVideoView of one UI thread and
+// delivers them in a single dispatcher pass, rather than one RunAsync per callback.
+class MediaEventQueue {
+ public:
+  static MediaEventQueue &ForCurrentThread();
+
+  // Safe to call from any thread.
+  void Post(MediaEvent event);
+
+ private:
+  explicit MediaEventQueue(Windows::UI::Core::CoreDispatcher const &dispatcher);
+
+  void Drain();
+
+  Windows::UI::Core::CoreDispatcher m_dispatcher{nullptr};
+  ::ReactNativeVideoCPP::EventBatchQueue<MediaEvent> m_events;
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "ViewRegistry.h"
+
+// Portable (WinRT-free) playback state shared between a view (single writer, UI thread) and readers on
+// any thread, so JS can poll the current position at frame rate instead of waiting for progress events.
+// The block is a seqlock: readers never block the writer and retry if they raced with a publish.
+namespace ReactNativeVideoCPP {
+
+enum class PlaybackStatus : uint32_t { None, Opening, Buffering, Playing, Paused };
+
+inline char const *PlaybackStatusName(PlaybackStatus status) noexcept {
+  switch (status) {
+    case PlaybackStatus::Opening:
+      return "opening";
+    case PlaybackStatus::Buffering:
+      return "buffering";
+    case PlaybackStatus::Playing:
+      return "playing";
+    case PlaybackStatus::Paused:
+      return "paused";
+    default:
+      return "none";
+  }
+}
+
+struct PlaybackState {
+  double position = 0; // seconds, as of updatedAtMs
+  double bufferedEnd = 0; // seconds
+  double rate = 0;
+  PlaybackStatus status = PlaybackStatus::None;
+  uint64_t bitrate = 0; // bits per second, 0 when unknown
+  int64_t updatedAtMs = 0; // PlaybackStateBlock::NowMs() at publish time
+
+  // Position extrapolated to |nowMs| while playing, so readers between publishes see a moving clock.
+  double PositionAt(int64_t nowMs) const noexcept {
+    if (status != PlaybackStatus::Playing || nowMs <= updatedAtMs) {
+      return position;
+    }
+    return position + (nowMs - updatedAtMs) / 1000.0 * rate;
+  }
+};
+
+class PlaybackStateBlock {
+ public:
+  static int64_t NowMs() noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // Single writer only.
+  void Publish(PlaybackState const &state) noexcept {
+    auto sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_position.store(state.position, std::memory_order_relaxed);
+    m_bufferedEnd.store(state.bufferedEnd, std::memory_order_relaxed);
+    m_rate.store(state.rate, std::memory_order_relaxed);
+    m_status.store(static_cast<uint32_t>(state.status), std::memory_order_relaxed);
+    m_bitrate.store(state.bitrate, std::memory_order_relaxed);
+    m_updatedAtMs.store(state.updatedAtMs, std::memory_order_relaxed);
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  // Any thread.
+  PlaybackState Read() const noexcept {
+    PlaybackState state;
+    for (;;) {
+      auto before = m_sequence.load(std::memory_order_acquire);
+      if (before & 1) {
+        continue; // publish in progress
+      }
+      state.position = m_position.load(std::memory_order_relaxed);
+      state.bufferedEnd = m_bufferedEnd.load(std::memory_order_relaxed);
+      state.rate = m_rate.load(std::memory_order_relaxed);
+      state.status = static_cast<PlaybackStatus>(m_status.load(std::memory_order_relaxed));
+      state.bitrate = m_bitrate.load(std::memory_order_relaxed);
+      state.updatedAtMs = m_updatedAtMs.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (m_sequence.load(std::memory_order_relaxed) == before) {
+        return state;
+      }
+    }
+  }
+
+ private:
+  std::atomic<uint64_t> m_sequence{0};
+  std::atomic<double> m_position{0};
+  std::atomic<double> m_bufferedEnd{0};
+  std::atomic<double> m_rate{0};
+  std::atomic<uint32_t> m_status{0};
+  std::atomic<uint64_t> m_bitrate{0};
+  std::atomic<int64_t> m_updatedAtMs{0};
+};
+
+using PlaybackStateRegistry = ViewRegistry<PlaybackStateBlock>;
+
+} // namespace ReactNativeVideoCPP
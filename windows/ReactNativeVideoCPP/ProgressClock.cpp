@@ -0,0 +1,82 @@
+#include "pch.h"
+#include "ProgressClock.h"
+#include <chrono>
+#include "ReactVideoView.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+namespace {
+
+int64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+ProgressClock &ProgressClock::ForCurrentThread() {
+  // intentionally leaked, the timer must not be torn down after the thread's dispatcher is gone
+  thread_local ProgressClock *clock = new ProgressClock();
+  return *clock;
+}
+
+void ProgressClock::Subscribe(ReactVideoView *view, int64_t intervalMs) {
+  // a new view may reuse the address of one that was released elsewhere, so the reference is always replaced
+  m_views[view] = view->get_weak();
+  m_scheduler.Subscribe(view, intervalMs, NowMs());
+  // restarting a running timer would push back the next tick of every view already on it, so it is only
+  // re-armed when idle or when the new view is due before the armed tick
+  auto nextDue = m_scheduler.NextDueMs();
+  if (!m_armedDueMs || (nextDue && *nextDue < *m_armedDueMs)) {
+    Rearm();
+  }
+}
+
+void ProgressClock::Unsubscribe(ReactVideoView *view) {
+  m_views.erase(view);
+  // an armed tick with nothing due just re-arms for the next deadline, only an empty clock stops early
+  if (m_scheduler.Unsubscribe(view) && m_scheduler.Empty()) {
+    Rearm();
+  }
+}
+
+void ProgressClock::OnTick() {
+  m_released.clear();
+  m_scheduler.Advance(NowMs(), [this](ReactVideoView *view) {
+    auto it = m_views.find(view);
+    if (it != m_views.end()) {
+      if (auto self = it->second.get()) {
+        self->OnProgressTick();
+        return;
+      }
+    }
+    m_released.push_back(view);
+  });
+  for (auto view : m_released) {
+    m_views.erase(view);
+    m_scheduler.Unsubscribe(view);
+  }
+  Rearm();
+}
+
+void ProgressClock::Rearm() {
+  auto nextDue = m_scheduler.NextDueMs();
+  if (!nextDue) {
+    if (m_timer != nullptr) {
+      m_timer.Stop();
+    }
+    m_armedDueMs.reset();
+    return;
+  }
+
+  if (m_timer == nullptr) {
+    m_timer = Windows::UI::Xaml::DispatcherTimer();
+    m_timer.Tick([this](auto const &, auto const &) { OnTick(); });
+  }
+  m_timer.Stop();
+  m_timer.Interval(std::chrono::milliseconds{std::max<int64_t>(*nextDue - NowMs(), 1)});
+  m_timer.Start();
+  m_armedDueMs = nextDue;
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
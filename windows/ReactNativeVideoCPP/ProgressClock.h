@@ -0,0 +1,43 @@
+#pragma once
+
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "TickScheduler.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+struct ReactVideoView;
+
+// One DispatcherTimer per UI thread drives the progress updates of every playing ReactVideoView on
+// that thread. Views subscribe while playing and are grouped by progressUpdateInterval; the timer is
+// re-armed for the earliest due group and stopped as soon as nothing is playing. Views are ticked through
+// weak references, so a view released on another thread is dropped at its next tick instead of dangling.
+class ProgressClock {
+ public:
+  static ProgressClock &ForCurrentThread();
+
+  // Both must be called on the clock's own thread.
+  void Subscribe(ReactVideoView *view, int64_t intervalMs);
+  void Unsubscribe(ReactVideoView *view);
+
+  bool IsCurrentThread() const {
+    return std::this_thread::get_id() == m_thread;
+  }
+
+ private:
+  ProgressClock() = default;
+
+  void OnTick();
+  void Rearm();
+
+  std::thread::id const m_thread = std::this_thread::get_id();
+  ::ReactNativeVideoCPP::TickScheduler<ReactVideoView *> m_scheduler;
+  std::unordered_map<ReactVideoView *, winrt::weak_ref<ReactVideoView>> m_views;
+  std::vector<ReactVideoView *> m_released; // views found gone during a tick
+  Windows::UI::Xaml::DispatcherTimer m_timer{nullptr};
+  std::optional<int64_t> m_armedDueMs; // the deadline the running timer fires for, empty while stopped
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+// Portable (WinRT-free) name -> handler table used to dispatch view manager property updates.
+// The table is built at compile time with a seed chosen so that every registered name lands in its own
+// slot, so a lookup is one hash of the incoming name plus a single string compare.
+namespace ReactNativeVideoCPP {
+
+template <typename CharT>
+constexpr uint32_t HashPropertyName(std::basic_string_view<CharT> name, uint32_t seed) noexcept {
+  // FNV-1a over code units; property names are ASCII so narrow and wide spellings hash the same.
+  uint32_t hash = 2166136261u ^ seed;
+  for (auto ch : name) {
+    hash ^= static_cast<uint32_t>(ch);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+template <typename CharT>
+constexpr bool PropertyNameEquals(std::string_view name, std::basic_string_view<CharT> other) noexcept {
+  if (name.size() != other.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (static_cast<uint32_t>(static_cast<unsigned char>(name[i])) != static_cast<uint32_t>(other[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename Handler>
+struct PropertyEntry {
+  std::string_view name;
+  Handler handler;
+};
+
+template <typename Handler, size_t N>
+class PropertyDispatcher {
+ public:
+  static constexpr size_t TableSize = [] {
+    size_t size = 1;
+    while (size < N * 2) {
+      size <<= 1;
+    }
+    return size;
+  }();
+
+  constexpr explicit PropertyDispatcher(const PropertyEntry<Handler> (&entries)[N]) : m_seed(FindSeed(entries)) {
+    for (size_t i = 0; i < N; ++i) {
+      m_slots[Slot(entries[i].name)] = entries[i];
+    }
+  }
+
+  // Returns the handler registered for |name|, or nullptr when the name is unknown.
+  template <typename CharT>
+  constexpr Handler Find(std::basic_string_view<CharT> name) const noexcept {
+    auto const &slot = m_slots[Slot(name)];
+    if (slot.handler != nullptr && PropertyNameEquals(slot.name, name)) {
+      return slot.handler;
+    }
+    return nullptr;
+  }
+
+  template <typename CharT>
+  constexpr size_t Slot(std::basic_string_view<CharT> name) const noexcept {
+    return HashPropertyName(name, m_seed) & (TableSize - 1);
+  }
+
+  constexpr uint32_t Seed() const noexcept {
+    return m_seed;
+  }
+
+ private:
+  static constexpr uint32_t FindSeed(const PropertyEntry<Handler> (&entries)[N]) {
+    for (uint32_t seed = 0; seed < (1u << 16); ++seed) {
+      std::array<bool, TableSize> used{};
+      bool collision = false;
+      for (size_t i = 0; i < N && !collision; ++i) {
+        auto slot = HashPropertyName(entries[i].name, seed) & (TableSize - 1);
+        collision = used[slot];
+        used[slot] = true;
+      }
+      if (!collision) {
+        return seed;
+      }
+    }
+    throw std::logic_error("PropertyDispatcher: no collision-free seed for the registered names");
+  }
+
+  uint32_t m_seed = 0;
+  std::array<PropertyEntry<Handler>, TableSize> m_slots{};
+};
+
+template <typename Handler, size_t N>
+constexpr PropertyDispatcher<Handler, N> MakePropertyDispatcher(const PropertyEntry<Handler> (&entries)[N]) {
+  return PropertyDispatcher<Handler, N>(entries);
+}
+
+} // namespace ReactNativeVideoCPP
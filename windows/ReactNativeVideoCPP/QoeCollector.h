@@ -0,0 +1,243 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "PlaybackStateBlock.h"
+#include "ViewRegistry.h"
+
+// Portable (WinRT-free) quality-of-experience metrics for one view. The view's UI thread is the only
+// writer and feeds player transitions with explicit timestamps, so the collector can be driven from a
+// simulated clock. Results live in relaxed atomics and can be snapshotted from any thread.
+namespace ReactNativeVideoCPP {
+
+// Upper bounds (inclusive, milliseconds) of the stall duration histogram buckets; the last bucket takes
+// everything longer.
+constexpr std::array<int64_t, 7> c_stallBucketBoundsMs = {100, 250, 500, 1000, 2000, 5000, 10000};
+constexpr size_t c_stallBucketCount = c_stallBucketBoundsMs.size() + 1;
+
+struct QoeSnapshot {
+  int64_t timeToFirstFrameMs = -1; // -1 until the first frame was rendered
+  uint64_t rebufferCount = 0;
+  int64_t rebufferMs = 0;
+  int64_t playMs = 0;
+  double rebufferRatio = 0; // rebufferMs / (playMs + rebufferMs)
+  uint64_t seekCount = 0;
+  int64_t seekLatencyAvgMs = 0;
+  int64_t seekLatencyMaxMs = 0;
+  uint64_t errorCount = 0;
+  std::array<uint64_t, c_stallBucketCount> stallHistogram{};
+  uint64_t droppedFrameSamples = 0; // 0 when the platform doesn't report frame statistics
+  double droppedFramesP50 = 0; // percent of frames dropped per sample
+  double droppedFramesP95 = 0;
+  double droppedFramesP99 = 0;
+};
+
+class QoeCollector {
+ public:
+  // Starts a new playback session, e.g. when the source changes.
+  void OnLoadStart(int64_t nowMs) {
+    m_loadStarted = true;
+    m_startupMs = 0;
+    m_startupSinceMs = nowMs;
+    m_playingSinceMs.store(-1, std::memory_order_relaxed);
+    m_bufferingSinceMs.store(-1, std::memory_order_relaxed);
+    m_seekStartMs = -1;
+    m_firstFrameSeen = false;
+    m_timeToFirstFrameMs.store(-1, std::memory_order_relaxed);
+  }
+
+  // Feeds every player status change, in order; time spent Playing is accumulated and the first
+  // transition to Playing after OnLoadStart marks the first rendered frame. The startup clock stops while
+  // the player sits Paused before that frame, e.g. a paused view opened its source and waits for the
+  // user, and runs again once playback is asked for.
+  void OnStatus(PlaybackStatus status, int64_t nowMs) {
+    if (m_loadStarted && !m_firstFrameSeen) {
+      Startup(status, nowMs);
+    }
+    auto playingSince = m_playingSinceMs.load(std::memory_order_relaxed);
+    if (status == PlaybackStatus::Playing) {
+      if (playingSince < 0) {
+        m_playingSinceMs.store(nowMs, std::memory_order_relaxed);
+      }
+    } else if (playingSince >= 0) {
+      Add(m_playMs, nowMs - playingSince);
+      m_playingSinceMs.store(-1, std::memory_order_relaxed);
+    }
+  }
+
+  // Buffering before the first frame or while a seek is in flight is startup / seek cost, not a stall.
+  void OnBufferingStarted(int64_t nowMs) {
+    if (m_firstFrameSeen && m_seekStartMs < 0 && m_bufferingSinceMs.load(std::memory_order_relaxed) < 0) {
+      m_bufferingSinceMs.store(nowMs, std::memory_order_relaxed);
+    }
+  }
+
+  void OnBufferingEnded(int64_t nowMs) {
+    auto bufferingSince = m_bufferingSinceMs.load(std::memory_order_relaxed);
+    if (bufferingSince < 0) {
+      return;
+    }
+    auto stallMs = nowMs - bufferingSince;
+    m_bufferingSinceMs.store(-1, std::memory_order_relaxed);
+    Add(m_rebufferCount, 1);
+    Add(m_rebufferMs, stallMs);
+    Add(m_stallHistogram[StallBucket(stallMs)], 1);
+  }
+
+  void OnSeekStarted(int64_t nowMs) {
+    if (m_seekStartMs < 0) {
+      m_seekStartMs = nowMs;
+    }
+  }
+
+  void OnSeekCompleted(int64_t nowMs) {
+    if (m_seekStartMs < 0) {
+      return;
+    }
+    auto latencyMs = nowMs - m_seekStartMs;
+    m_seekStartMs = -1;
+    Add(m_seekCount, 1);
+    Add(m_seekLatencyTotalMs, latencyMs);
+    if (latencyMs > m_seekLatencyMaxMs.load(std::memory_order_relaxed)) {
+      m_seekLatencyMaxMs.store(latencyMs, std::memory_order_relaxed);
+    }
+  }
+
+  void OnError() {
+    Add(m_errorCount, 1);
+  }
+
+  // One sample of frame counters over an interval, e.g. a progress tick: |decodedFrames| presented and
+  // |droppedFrames| the renderer skipped. Fed wherever the platform counts frames.
+  void OnFrameSample(uint64_t decodedFrames, uint64_t droppedFrames) {
+    auto total = decodedFrames + droppedFrames;
+    if (total == 0) {
+      return;
+    }
+    Add(m_droppedFrameHistogram[static_cast<size_t>(droppedFrames * 100 / total)], 1);
+  }
+
+  // Any thread. Time still running (the current play period or stall) is included up to |nowMs|; a running
+  // stall is not counted in rebufferCount or the histogram until it ends.
+  QoeSnapshot Snapshot(int64_t nowMs) const {
+    QoeSnapshot snapshot;
+    snapshot.timeToFirstFrameMs = m_timeToFirstFrameMs.load(std::memory_order_relaxed);
+    snapshot.rebufferCount = m_rebufferCount.load(std::memory_order_relaxed);
+    snapshot.rebufferMs = m_rebufferMs.load(std::memory_order_relaxed);
+    snapshot.playMs = m_playMs.load(std::memory_order_relaxed);
+    snapshot.seekCount = m_seekCount.load(std::memory_order_relaxed);
+    snapshot.seekLatencyMaxMs = m_seekLatencyMaxMs.load(std::memory_order_relaxed);
+    snapshot.errorCount = m_errorCount.load(std::memory_order_relaxed);
+    if (snapshot.seekCount > 0) {
+      snapshot.seekLatencyAvgMs =
+          m_seekLatencyTotalMs.load(std::memory_order_relaxed) / static_cast<int64_t>(snapshot.seekCount);
+    }
+
+    // the running periods are read separately from the totals; a period that ends in between only skews
+    // this snapshot's running part
+    auto playingSince = m_playingSinceMs.load(std::memory_order_relaxed);
+    if (playingSince >= 0 && nowMs > playingSince) {
+      snapshot.playMs += nowMs - playingSince;
+    }
+    auto bufferingSince = m_bufferingSinceMs.load(std::memory_order_relaxed);
+    if (bufferingSince >= 0 && nowMs > bufferingSince) {
+      snapshot.rebufferMs += nowMs - bufferingSince;
+    }
+    auto total = snapshot.playMs + snapshot.rebufferMs;
+    snapshot.rebufferRatio = total > 0 ? static_cast<double>(snapshot.rebufferMs) / total : 0;
+
+    for (size_t i = 0; i < c_stallBucketCount; ++i) {
+      snapshot.stallHistogram[i] = m_stallHistogram[i].load(std::memory_order_relaxed);
+    }
+
+    std::array<uint64_t, c_percentBuckets> dropped{};
+    for (size_t i = 0; i < dropped.size(); ++i) {
+      dropped[i] = m_droppedFrameHistogram[i].load(std::memory_order_relaxed);
+      snapshot.droppedFrameSamples += dropped[i];
+    }
+    snapshot.droppedFramesP50 = Percentile(dropped, snapshot.droppedFrameSamples, 0.50);
+    snapshot.droppedFramesP95 = Percentile(dropped, snapshot.droppedFrameSamples, 0.95);
+    snapshot.droppedFramesP99 = Percentile(dropped, snapshot.droppedFrameSamples, 0.99);
+    return snapshot;
+  }
+
+ private:
+  static constexpr size_t c_percentBuckets = 101; // one per whole percent, 0 to 100
+
+  template <typename T, typename V>
+  static void Add(std::atomic<T> &counter, V value) {
+    // single writer, so a relaxed load/store pair is enough and avoids a locked RMW
+    counter.store(counter.load(std::memory_order_relaxed) + static_cast<T>(value), std::memory_order_relaxed);
+  }
+
+  static size_t StallBucket(int64_t stallMs) {
+    for (size_t i = 0; i < c_stallBucketBoundsMs.size(); ++i) {
+      if (stallMs <= c_stallBucketBoundsMs[i]) {
+        return i;
+      }
+    }
+    return c_stallBucketBoundsMs.size();
+  }
+
+  // The smallest whole percent at or below which |quantile| of the samples fall.
+  static double Percentile(std::array<uint64_t, c_percentBuckets> const &histogram, uint64_t samples, double quantile) {
+    if (samples == 0) {
+      return 0;
+    }
+    auto rank = static_cast<uint64_t>(quantile * static_cast<double>(samples - 1));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < histogram.size(); ++i) {
+      seen += histogram[i];
+      if (seen > rank) {
+        return static_cast<double>(i);
+      }
+    }
+    return 100;
+  }
+
+  void Startup(PlaybackStatus status, int64_t nowMs) {
+    // paused before the first frame, or the player was handed back while the view is unloaded
+    if (status == PlaybackStatus::Paused || status == PlaybackStatus::None) {
+      if (m_startupSinceMs >= 0) {
+        m_startupMs += nowMs - m_startupSinceMs;
+        m_startupSinceMs = -1;
+      }
+      return;
+    }
+    if (m_startupSinceMs < 0) {
+      m_startupSinceMs = nowMs;
+    }
+    if (status == PlaybackStatus::Playing) {
+      m_firstFrameSeen = true;
+      m_timeToFirstFrameMs.store(m_startupMs + nowMs - m_startupSinceMs, std::memory_order_relaxed);
+    }
+  }
+
+  // writer-only state
+  bool m_loadStarted = false;
+  int64_t m_startupMs = 0; // startup time before the current startup period
+  int64_t m_startupSinceMs = -1; // -1 while startup is not running
+  int64_t m_seekStartMs = -1;
+  bool m_firstFrameSeen = false;
+
+  // written on the UI thread, read by Snapshot() on any thread
+  std::atomic<int64_t> m_playingSinceMs{-1};
+  std::atomic<int64_t> m_bufferingSinceMs{-1};
+
+  std::atomic<int64_t> m_timeToFirstFrameMs{-1};
+  std::atomic<uint64_t> m_rebufferCount{0};
+  std::atomic<int64_t> m_rebufferMs{0};
+  std::atomic<int64_t> m_playMs{0};
+  std::atomic<uint64_t> m_seekCount{0};
+  std::atomic<int64_t> m_seekLatencyTotalMs{0};
+  std::atomic<int64_t> m_seekLatencyMaxMs{0};
+  std::atomic<uint64_t> m_errorCount{0};
+  std::array<std::atomic<uint64_t>, c_stallBucketCount> m_stallHistogram{};
+  std::array<std::atomic<uint64_t>, c_percentBuckets> m_droppedFrameHistogram{};
+};
+
+using QoeRegistry = ViewRegistry<QoeCollector>;
+
+} // namespace ReactNativeVideoCPP
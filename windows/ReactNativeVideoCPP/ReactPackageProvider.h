@@ -1,20 +1,20 @@
-#pragma once
-#include "ReactPackageProvider.g.h"
-
-using namespace winrt::Microsoft::ReactNative;
-
-namespace winrt::ReactNativeVideoCPP::implementation {
-
-struct ReactPackageProvider : ReactPackageProviderT<ReactPackageProvider> {
-  ReactPackageProvider() = default;
-
-  void CreatePackage(IReactPackageBuilder const &packageBuilder) noexcept;
-};
-
-} // namespace winrt::ReactNativeVideoCPP::implementation
-
-namespace winrt::ReactNativeVideoCPP::factory_implementation {
-
-struct ReactPackageProvider : ReactPackageProviderT<ReactPackageProvider, implementation::ReactPackageProvider> {};
-
-} // namespace winrt::ReactNativeVideoCPP::factory_implementation
+#pragma once
+#include "ReactPackageProvider.g.h"
+
+using namespace winrt::Microsoft::ReactNative;
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+struct ReactPackageProvider : ReactPackageProviderT<ReactPackageProvider> {
+  ReactPackageProvider() = default;
+
+  void CreatePackage(IReactPackageBuilder const &packageBuilder) noexcept;
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
+
+namespace winrt::ReactNativeVideoCPP::factory_implementation {
+
+struct ReactPackageProvider : ReactPackageProviderT<ReactPackageProvider, implementation::ReactPackageProvider> {};
+
+} // namespace winrt::ReactNativeVideoCPP::factory_implementation
@@ -1,248 +1,1479 @@
-#include "pch.h"
-#include "ReactVideoView.h"
-#include "ReactVideoView.g.cpp"
-#include "NativeModules.h"
-
-using namespace winrt;
-using namespace Windows::Foundation;
-using namespace Windows::Foundation::Collections;
-
-using namespace Windows::UI::Xaml;
-using namespace Windows::UI::Xaml::Media;
-using namespace Windows::UI::Xaml::Controls;
-using namespace Windows::UI::Core;
-using namespace Windows::Media::Core;
-using namespace Windows::Media::Playback;
-
-namespace winrt::ReactNativeVideoCPP::implementation {
-
-ReactVideoView::ReactVideoView(winrt::Microsoft::ReactNative::IReactContext const &reactContext)
-    : m_reactContext(reactContext) {
-  // always create and set the player here instead of depending on auto-create logic
-  // in the MediaPlayerElement (only when auto play is on or URI is set)
-  m_player = winrt::Windows::Media::Playback::MediaPlayer();
-  SetMediaPlayer(m_player);
-  m_uiDispatcher = CoreWindow::GetForCurrentThread().Dispatcher();
-
-  m_mediaOpenedToken =
-      m_player.MediaOpened(winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
-        if (auto self = ref.get()) {
-          self->OnMediaOpened(sender, args);
-        }
-      });
-  m_mediaFailedToken =
-      m_player.MediaFailed(winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
-        if (auto self = ref.get()) {
-          self->OnMediaFailed(sender, args);
-        }
-      });
-
-  m_mediaEndedToken = m_player.MediaEnded(winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
-    if (auto self = ref.get()) {
-      self->OnMediaEnded(sender, args);
-    }
-  });
-
-  m_bufferingStartedToken = m_player.PlaybackSession().BufferingStarted(
-      winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
-        if (auto self = ref.get()) {
-          self->OnBufferingStarted(sender, args);
-        }
-      });
-
-  m_bufferingEndedToken = m_player.PlaybackSession().BufferingEnded(
-      winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
-        if (auto self = ref.get()) {
-          self->OnBufferingEnded(sender, args);
-        }
-      });
-
-  m_seekCompletedToken = m_player.PlaybackSession().SeekCompleted(
-      winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
-        if (auto self = ref.get()) {
-          self->OnSeekCompleted(sender, args);
-        }
-      });
-
-  m_timer = Windows::UI::Xaml::DispatcherTimer();
-  m_timer.Interval(std::chrono::milliseconds{250});
-  m_timer.Start();
-  auto token = m_timer.Tick([ref = get_weak()](auto const &, auto const &) {
-    if (auto self = ref.get()) {
-      if (auto mediaPlayer = self->m_player) {
-        if (mediaPlayer.PlaybackSession().PlaybackState() ==
-            winrt::Windows::Media::Playback::MediaPlaybackState::Playing) {
-          auto currentTimeInSeconds = mediaPlayer.PlaybackSession().Position().count() / 10000000;
-          self->m_reactContext.DispatchEvent(
-              *self,
-              L"topProgress",
-              [&](winrt::Microsoft::ReactNative::IJSValueWriter const &eventDataWriter) noexcept {
-                eventDataWriter.WriteObjectBegin();
-                {
-                  WriteProperty(eventDataWriter, L"currentTime", currentTimeInSeconds);
-                  WriteProperty(eventDataWriter, L"playableDuration", 0.0);
-                }
-                eventDataWriter.WriteObjectEnd();
-              });
-        }
-      }
-    }
-  });
-}
-
-void ReactVideoView::OnMediaOpened(IInspectable const &, IInspectable const &) {
-  runOnQueue([weak_this{get_weak()}]() {
-    if (auto strong_this{weak_this.get()}) {
-      if (auto mediaPlayer = strong_this->m_player) {
-        auto width = mediaPlayer.PlaybackSession().NaturalVideoWidth();
-        auto height = mediaPlayer.PlaybackSession().NaturalVideoHeight();
-        auto orientation = (width > height) ? L"landscape" : L"portrait";
-        auto durationInSeconds = mediaPlayer.PlaybackSession().NaturalDuration().count() / 10000000;
-        auto currentTimeInSeconds = mediaPlayer.PlaybackSession().Position().count() / 10000000;
-
-        strong_this->m_reactContext.DispatchEvent(
-            *strong_this,
-            L"topLoad",
-            [&](winrt::Microsoft::ReactNative::IJSValueWriter const &eventDataWriter) noexcept {
-              eventDataWriter.WriteObjectBegin();
-              {
-                WriteProperty(eventDataWriter, L"duration", durationInSeconds);
-                WriteProperty(eventDataWriter, L"currentTime", currentTimeInSeconds);
-
-                eventDataWriter.WritePropertyName(L"naturalSize");
-                {
-                  eventDataWriter.WriteObjectBegin();
-                  WriteProperty(eventDataWriter, L"width", width);
-                  WriteProperty(eventDataWriter, L"height", height);
-                  WriteProperty(eventDataWriter, L"orientation", orientation);
-                  WriteProperty(eventDataWriter, L"orientation", orientation);
-                  eventDataWriter.WriteObjectEnd();
-                }
-
-                WriteProperty(eventDataWriter, L"canPlayFastForward", false);
-                WriteProperty(eventDataWriter, L"canPlaySlowForward", false);
-                WriteProperty(eventDataWriter, L"canPlaySlow", false);
-                WriteProperty(eventDataWriter, L"canStepBackward", false);
-                WriteProperty(eventDataWriter, L"canStepForward", false);
-              }
-              eventDataWriter.WriteObjectEnd();
-            });
-      }
-    }
-  });
-}
-
-void ReactVideoView::OnMediaFailed(IInspectable const &, IInspectable const &) {}
-
-void ReactVideoView::OnMediaEnded(IInspectable const &, IInspectable const &) {
-  runOnQueue([weak_this{get_weak()}]() {
-    if (auto strong_this{weak_this.get()}) {
-      strong_this->m_reactContext.DispatchEvent(*strong_this, L"topEnd", nullptr);
-    }
-  });
-}
-
-void ReactVideoView::OnBufferingStarted(IInspectable const &, IInspectable const &) {}
-
-void ReactVideoView::OnBufferingEnded(IInspectable const &, IInspectable const &) {}
-
-void ReactVideoView::OnSeekCompleted(IInspectable const &, IInspectable const &) {
-  runOnQueue([weak_this{get_weak()}]() {
-    if (auto strong_this{weak_this.get()}) {
-      strong_this->m_reactContext.DispatchEvent(*strong_this, L"topSeek", nullptr);
-    }
-  });
-}
-
-void ReactVideoView::Set_ProgressUpdateInterval(int64_t interval) {
-  m_timer.Interval(std::chrono::milliseconds{interval});
-}
-
-void ReactVideoView::Set_IsLoopingEnabled(bool value) {
-  m_isLoopingEnabled = value;
-  if (m_player != nullptr) {
-    m_player.IsLoopingEnabled(m_isLoopingEnabled);
-  }
-}
-
-void ReactVideoView::Set_UriString(hstring const &value) {
-  m_uriString = value;
-  if (m_player != nullptr) {
-    auto uri = Uri(m_uriString);
-    m_player.Source(MediaSource::CreateFromUri(uri));
-  }
-}
-
-void ReactVideoView::Set_Paused(bool value) {
-  m_isPaused = value;
-  if (m_player != nullptr) {
-    if (m_isPaused) {
-      if (IsPlaying(m_player.PlaybackSession().PlaybackState())) {
-        m_player.Pause();
-      }
-    } else {
-      if (!IsPlaying(m_player.PlaybackSession().PlaybackState())) {
-        m_player.Play();
-      }
-    }
-  }
-}
-
-void ReactVideoView::Set_AutoPlay(bool autoPlay) {
-  m_player.AutoPlay(autoPlay);
-}
-
-void ReactVideoView::Set_Muted(bool isMuted) {
-  m_isMuted = isMuted;
-  if (m_player != nullptr) {
-    m_player.IsMuted(m_isMuted);
-  }
-}
-
-void ReactVideoView::Set_Controls(bool useControls) {
-  m_useControls = useControls;
-  AreTransportControlsEnabled(m_useControls);
-}
-
-void ReactVideoView::Set_FullScreen(bool fullScreen) {
-  m_fullScreen = fullScreen;
-  IsFullWindow(m_fullScreen);
-
-  if (m_fullScreen) {
-    Set_Controls(true); // full window will always have transport control enabled
-  }
-}
-
-void ReactVideoView::Set_Volume(double volume) {
-  m_volume = volume;
-  if (m_player != nullptr) {
-    m_player.Volume(m_volume);
-  }
-}
-
-void ReactVideoView::Set_Position(double position) {
-  m_position = position;
-  if (m_player != nullptr) {
-    std::chrono::seconds duration(static_cast<int>(m_position));
-    m_player.PlaybackSession().Position(duration);
-  }
-}
-
-void ReactVideoView::Set_PlaybackRate(double rate) {
-  if (m_player != nullptr) {
-    m_player.PlaybackSession().PlaybackRate(rate);
-  }
-}
-
-bool ReactVideoView::IsPlaying(MediaPlaybackState currentState) {
-  return (
-      currentState == MediaPlaybackState::Buffering || currentState == MediaPlaybackState::Opening ||
-      currentState == MediaPlaybackState::Playing);
-}
-
-void ReactVideoView::runOnQueue(std::function<void()> &&func) {
-  m_uiDispatcher.RunAsync(
-      winrt::Windows::UI::Core::CoreDispatcherPriority::Normal, [func = std::move(func)]() { func(); });
-}
-
-} // namespace winrt::ReactNativeVideoCPP::implementation
+#include "pch.h"
+#include "ReactVideoView.h"
+#include "ReactVideoView.g.cpp"
+#include "NativeModules.h"
+#include "AdLoader.h"
+#include "BandwidthMeter.h"
+#include "BeaconDispatcher.h"
+#include "BoundedPool.h"
+#include "JSValueEventWriter.h"
+#include "MediaCache.h"
+#include "MediaEventQueue.h"
+#include "PlaybackStateBlock.h"
+#include "ProgressClock.h"
+#include "SegmentIndexStore.h"
+#include "VideoEvents.h"
+
+using namespace winrt;
+using namespace Windows::Foundation;
+using namespace Windows::Foundation::Collections;
+
+using namespace Windows::UI::Xaml;
+using namespace Windows::UI::Xaml::Media;
+using namespace Windows::UI::Xaml::Controls;
+using namespace Windows::UI::Core;
+using namespace Windows::Media::Core;
+using namespace Windows::Media::Playback;
+using namespace Windows::Media::Streaming::Adaptive;
+
+using ::ReactNativeVideoCPP::AdMilestone;
+using ::ReactNativeVideoCPP::AdSchedule;
+using ::ReactNativeVideoCPP::PlaybackStateBlock;
+using ::ReactNativeVideoCPP::PlaybackStateRegistry;
+using ::ReactNativeVideoCPP::PlaybackStatus;
+using ::ReactNativeVideoCPP::PropUpdateRegistry;
+using ::ReactNativeVideoCPP::QoeRegistry;
+using ::ReactNativeVideoCPP::VastError;
+using ::ReactNativeVideoCPP::VideoProp;
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+namespace {
+
+constexpr size_t c_defaultPlayerPoolSize = 4;
+constexpr int64_t c_defaultProgressUpdateInterval = 250;
+
+// how long a seek may stay in flight before the pending one behind it is issued anyway
+constexpr std::chrono::milliseconds c_seekTimeout{3000};
+
+// how far ahead of its cue point a break's creatives start downloading
+constexpr double c_adPrefetchLeadSeconds = 60;
+
+::ReactNativeVideoCPP::BoundedPool<MediaPlayer> &PlayerPool() {
+  // intentionally leaked so pooled players are never released during static destruction
+  static auto *pool = new ::ReactNativeVideoCPP::BoundedPool<MediaPlayer>(c_defaultPlayerPoolSize);
+  return *pool;
+}
+
+double ToSeconds(TimeSpan const &time) {
+  return std::chrono::duration<double>(time).count();
+}
+
+// BufferedRangesChanged / SeekableRangesChanged and the range getters need Windows 10 1803.
+bool HasRangeChangedEvents() {
+  static const bool present = Windows::Foundation::Metadata::ApiInformation::IsApiContractPresent(
+      L"Windows.Foundation.UniversalApiContract", 6);
+  return present;
+}
+
+// AdaptiveMediaSource download statistics need Windows 10 1709.
+bool HasDownloadStatistics() {
+  static const bool present = Windows::Foundation::Metadata::ApiInformation::IsApiContractPresent(
+      L"Windows.Foundation.UniversalApiContract", 5);
+  return present;
+}
+
+// AdaptiveMediaSource::GetCorrelatedTimes needs Windows 10 1703.
+bool HasCorrelatedTimes() {
+  static const bool present = Windows::Foundation::Metadata::ApiInformation::IsApiContractPresent(
+      L"Windows.Foundation.UniversalApiContract", 4);
+  return present;
+}
+
+// VideoTrack::GetEncodingProperties, for the frame rate behind the dropped-frame samples, needs Windows 10 1703.
+bool HasVideoTrackProperties() {
+  static const bool present = Windows::Foundation::Metadata::ApiInformation::IsApiContractPresent(
+      L"Windows.Foundation.UniversalApiContract", 4);
+  return present;
+}
+
+// MediaBreak and MediaBreakManager need Windows 10 1607.
+bool HasMediaBreaks() {
+  static const bool present = Windows::Foundation::Metadata::ApiInformation::IsApiContractPresent(
+      L"Windows.Foundation.UniversalApiContract", 3);
+  return present;
+}
+
+// onReceiveAdEvent names, as the IMA SDKs report the same milestones
+std::wstring_view AdEventOf(AdMilestone milestone) {
+  constexpr std::wstring_view c_events[] = {L"STARTED", L"FIRST_QUARTILE", L"MIDPOINT", L"THIRD_QUARTILE", L"COMPLETE"};
+  return c_events[static_cast<int>(milestone)];
+}
+
+// Seconds since 1970, as HLS dates are parsed.
+double ToUnixSeconds(DateTime const &time) {
+  return std::chrono::duration<double>(winrt::clock::to_sys(time).time_since_epoch()).count();
+}
+
+std::vector<uint32_t> ToVector(IVectorView<uint32_t> const &values) {
+  std::vector<uint32_t> result(values.Size());
+  values.GetMany(0, result);
+  return result;
+}
+
+PlaybackStatus ToPlaybackStatus(MediaPlaybackState state) {
+  switch (state) {
+    case MediaPlaybackState::Opening:
+      return PlaybackStatus::Opening;
+    case MediaPlaybackState::Buffering:
+      return PlaybackStatus::Buffering;
+    case MediaPlaybackState::Playing:
+      return PlaybackStatus::Playing;
+    case MediaPlaybackState::Paused:
+      return PlaybackStatus::Paused;
+    default:
+      return PlaybackStatus::None;
+  }
+}
+
+void CopyRanges(
+    IVectorView<Windows::Media::MediaTimeRange> const &ranges,
+    ::ReactNativeVideoCPP::TimeRangeSet &rangeSet) {
+  rangeSet.Clear();
+  for (auto const &range : ranges) {
+    rangeSet.Add(ToSeconds(range.Start), ToSeconds(range.End));
+  }
+}
+
+} // namespace
+
+ReactVideoView::ReactVideoView(winrt::Microsoft::ReactNative::IReactContext const &reactContext)
+    : m_reactContext(reactContext) {
+  m_mediaEvents = &MediaEventQueue::ForCurrentThread();
+  m_progressClock = &ProgressClock::ForCurrentThread();
+
+  // always check out and set the player here instead of depending on auto-create logic
+  // in the MediaPlayerElement (only when auto play is on or URI is set)
+  AttachPlayer();
+
+  // hand the player back to the shared pool while unmounted, and take one again if remounted
+  m_loadedToken = Loaded(winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+    if (auto self = ref.get()) {
+      self->AttachPlayer();
+      self->RegisterPlaybackState();
+      self->ResumeAdCueWatch();
+    }
+  });
+  m_unloadedToken = Unloaded(winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+    if (auto self = ref.get()) {
+      self->DetachPlayer();
+      self->UnregisterPlaybackState();
+    }
+  });
+  m_sizeChangedToken = SizeChanged(winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+    if (auto self = ref.get()) {
+      self->UpdateViewport();
+    }
+  });
+}
+
+ReactVideoView::~ReactVideoView() {
+  // the last reference may go on a media or thread pool thread; the clock of the UI thread then drops the
+  // view at its next tick, as its weak reference no longer resolves
+  if (m_progressClock->IsCurrentThread()) {
+    m_progressClock->Unsubscribe(this);
+  }
+  UnregisterPlaybackState();
+  // a view dropped without ever being unloaded still hands its player back; MediaPlayer is agile, so this
+  // is safe on whichever thread released the last reference
+  if (auto player = std::exchange(m_player, nullptr)) {
+    ResetPlayer(player);
+    PlayerPool().Release(std::move(player));
+  }
+}
+
+void ReactVideoView::RegisterPlaybackState() {
+  // the React tag is only assigned after CreateView, so the block is keyed once the view is in the tree
+  auto tag = winrt::unbox_value_or<int64_t>(Tag(), -1);
+  if (tag == m_playbackStateTag) {
+    return;
+  }
+  UnregisterPlaybackState();
+  if (tag != -1) {
+    PlaybackStateRegistry::Instance().Register(tag, m_playbackState);
+    QoeRegistry::Instance().Register(tag, m_qoe);
+    PropUpdateRegistry::Instance().Register(tag, m_props.Counters());
+    m_playbackStateTag = tag;
+  }
+}
+
+void ReactVideoView::UnregisterPlaybackState() {
+  if (m_playbackStateTag != -1) {
+    PlaybackStateRegistry::Instance().Unregister(m_playbackStateTag, m_playbackState.get());
+    QoeRegistry::Instance().Unregister(m_playbackStateTag, m_qoe.get());
+    PropUpdateRegistry::Instance().Unregister(m_playbackStateTag, m_props.Counters().get());
+    m_playbackStateTag = -1;
+  }
+}
+
+void ReactVideoView::PublishPlaybackState() {
+  ::ReactNativeVideoCPP::PlaybackState state;
+  if (m_player != nullptr) {
+    auto session = m_player.PlaybackSession();
+    state.position = ToSeconds(session.Position());
+    state.bufferedEnd = m_bufferedRanges.EndOfRangeContaining(state.position);
+    state.rate = session.PlaybackRate();
+    state.status = ToPlaybackStatus(session.PlaybackState());
+    state.bitrate = m_pinnedBitrate;
+  }
+  state.updatedAtMs = PlaybackStateBlock::NowMs();
+  m_playbackState->Publish(state);
+}
+
+void ReactVideoView::AttachPlayer() {
+  if (m_player != nullptr) {
+    return;
+  }
+  m_player = PlayerPool().Acquire([]() { return MediaPlayer(); });
+  SetMediaPlayer(m_player);
+
+  m_mediaOpenedToken =
+      m_player.MediaOpened(winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
+        if (auto self = ref.get()) {
+          self->OnMediaOpened(sender, args);
+        }
+      });
+  m_mediaFailedToken =
+      m_player.MediaFailed(winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
+        if (auto self = ref.get()) {
+          self->OnMediaFailed(sender, args);
+        }
+      });
+
+  m_mediaEndedToken = m_player.MediaEnded(winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
+    if (auto self = ref.get()) {
+      self->OnMediaEnded(sender, args);
+    }
+  });
+
+  m_bufferingStartedToken = m_player.PlaybackSession().BufferingStarted(
+      winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
+        if (auto self = ref.get()) {
+          self->OnBufferingStarted(sender, args);
+        }
+      });
+
+  m_bufferingEndedToken = m_player.PlaybackSession().BufferingEnded(
+      winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
+        if (auto self = ref.get()) {
+          self->OnBufferingEnded(sender, args);
+        }
+      });
+
+  m_seekCompletedToken = m_player.PlaybackSession().SeekCompleted(
+      winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
+        if (auto self = ref.get()) {
+          self->OnSeekCompleted(sender, args);
+        }
+      });
+
+  m_playbackStateChangedToken = m_player.PlaybackSession().PlaybackStateChanged(
+      winrt::auto_revoke, [ref = get_weak()](auto const &sender, auto const &args) {
+        if (auto self = ref.get()) {
+          self->OnPlaybackStateChanged(sender, args);
+        }
+      });
+
+  m_naturalVideoSizeChangedToken = m_player.PlaybackSession().NaturalVideoSizeChanged(
+      winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+        if (auto self = ref.get()) {
+          self->PostMediaEvent(MediaEventKind::NaturalVideoSizeChanged);
+        }
+      });
+
+  // raised only in frame server mode, for every frame the app gets to draw; counted on the raising thread
+  m_videoFrameAvailableToken =
+      m_player.VideoFrameAvailable(winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+        if (auto self = ref.get()) {
+          self->m_presentedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+
+  if (HasRangeChangedEvents()) {
+    m_bufferedRangesChangedToken = m_player.PlaybackSession().BufferedRangesChanged(
+        winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+          if (auto self = ref.get()) {
+            self->PostMediaEvent(MediaEventKind::BufferedRangesChanged);
+          }
+        });
+
+    m_seekableRangesChangedToken = m_player.PlaybackSession().SeekableRangesChanged(
+        winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+          if (auto self = ref.get()) {
+            self->PostMediaEvent(MediaEventKind::SeekableRangesChanged);
+          }
+        });
+  }
+
+  if (HasMediaBreaks()) {
+    auto breakManager = m_player.BreakManager();
+    m_breakStartedToken = breakManager.BreakStarted(winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+      if (auto self = ref.get()) {
+        self->PostMediaEvent(MediaEventKind::AdBreakStarted);
+      }
+    });
+    m_breakEndedToken = breakManager.BreakEnded(winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+      if (auto self = ref.get()) {
+        self->PostMediaEvent(MediaEventKind::AdBreakEnded);
+      }
+    });
+    m_breakSkippedToken = breakManager.BreakSkipped(winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+      if (auto self = ref.get()) {
+        self->PostMediaEvent(MediaEventKind::AdBreakSkipped);
+      }
+    });
+  }
+
+  ApplyPropsToPlayer();
+}
+
+void ReactVideoView::DetachPlayer() {
+  if (m_player == nullptr) {
+    return;
+  }
+  m_mediaOpenedToken.revoke();
+  m_mediaFailedToken.revoke();
+  m_mediaEndedToken.revoke();
+  m_bufferingStartedToken.revoke();
+  m_bufferingEndedToken.revoke();
+  m_seekCompletedToken.revoke();
+  m_playbackStateChangedToken.revoke();
+  m_naturalVideoSizeChangedToken.revoke();
+  m_videoFrameAvailableToken.revoke();
+  m_bufferedRangesChangedToken.revoke();
+  m_seekableRangesChangedToken.revoke();
+  m_breakStartedToken.revoke();
+  m_breakEndedToken.revoke();
+  m_breakSkippedToken.revoke();
+  m_progressClock->Unsubscribe(this);
+  SetMediaPlayer(nullptr);
+
+  m_seeks.Reset();
+  m_bufferedRanges.Clear();
+  m_seekableRanges.Clear();
+  DetachAdaptiveSource();
+  EndAdBreak(); // dropping the source ends it
+  m_qoe->OnStatus(PlaybackStatus::None, PlaybackStateBlock::NowMs());
+  auto player = std::exchange(m_player, nullptr);
+  // keep the source, where it was and whether it played, so a remount resumes instead of starting over
+  if (auto source = player.Source()) {
+    auto session = player.PlaybackSession();
+    m_parkedSource = source;
+    m_resumePosition = session.Position();
+    m_resumePaused = !IsPlaying(session.PlaybackState());
+  }
+  ResetPlayer(player);
+  PlayerPool().Release(std::move(player));
+  PublishPlaybackState();
+}
+
+void ReactVideoView::ApplyPropsToPlayer() {
+  // a pooled player arrives in its reset state, so replay whatever props this view already applied
+  if (m_props.IsApplied(VideoProp::IsLoopingEnabled)) {
+    m_player.IsLoopingEnabled(m_isLoopingEnabled);
+  }
+  if (m_props.IsApplied(VideoProp::Muted)) {
+    m_player.IsMuted(m_isMuted);
+  }
+  if (m_props.IsApplied(VideoProp::Volume)) {
+    m_player.Volume(m_volume);
+  }
+  if (m_props.IsApplied(VideoProp::AutoPlay)) {
+    m_player.AutoPlay(m_autoPlay);
+  }
+  if (auto parked = std::exchange(m_parkedSource, nullptr)) {
+    m_player.Source(parked); // position and paused state are restored once it has opened again
+  } else if (m_props.IsApplied(VideoProp::Uri)) {
+    m_player.Source(CreatePlaybackSource());
+  }
+  if (m_props.IsApplied(VideoProp::PlaybackRate)) {
+    m_player.PlaybackSession().PlaybackRate(m_playbackRate);
+  }
+}
+
+MediaSource ReactVideoView::CreateMediaSource() {
+  // progressive clips read through the range cache, so a partially watched one resumes from disk
+  MediaSource source{nullptr};
+  if (m_shouldCache) {
+    source = MediaCache::Instance().CreateProgressiveSource(Uri(m_uriString));
+  }
+  if (source == nullptr) {
+    source = MediaSource::CreateFromUri(Uri(m_uriString));
+  }
+  if (!HasDownloadStatistics()) {
+    return source;
+  }
+
+  // the adaptive source behind HLS / DASH content only exists once the open completes; the handlers die
+  // with the source, so they are not revoked explicitly. A parked source opens again on remount, and an
+  // adaptive source it already hooked is not hooked twice.
+  auto hooked = std::make_shared<winrt::weak_ref<AdaptiveMediaSource>>();
+  source.OpenOperationCompleted([ref = get_weak(),
+                                 config = m_abr.Config(),
+                                 shouldCache = m_shouldCache,
+                                 hooked,
+                                 playerSegment = m_playerSegment](MediaSource const &sender, auto const &) {
+    auto adaptive = sender.AdaptiveMediaSource();
+    if (adaptive == nullptr) {
+      return;
+    }
+    if (hooked->get() == adaptive) {
+      if (auto self = ref.get()) {
+        self->PostMediaEvent(MediaEventKind::AdaptiveSourceOpened);
+      }
+      return;
+    }
+    *hooked = winrt::make_weak(adaptive);
+    // picked here rather than on the UI thread so it is in place before the first segment request
+    if (auto initial = ::ReactNativeVideoCPP::AbrController::SelectInitial(
+            ToVector(adaptive.AvailableBitrates()), BandwidthMeter::Instance().Estimate(), config)) {
+      adaptive.InitialBitrate(initial);
+    }
+    if (shouldCache) {
+      MediaCache::Instance().Attach(adaptive);
+    }
+    if (auto self = ref.get()) {
+      self->PostMediaEvent(MediaEventKind::AdaptiveSourceOpened);
+    }
+    adaptive.DownloadCompleted([ref, playerSegment](
+                                   auto const &, AdaptiveMediaSourceDownloadCompletedEventArgs const &args) {
+      if (args.ResourceType() != AdaptiveMediaSourceResourceType::MediaSegment) {
+        return;
+      }
+      if (auto position = args.Position()) {
+        std::lock_guard<std::mutex> lock(playerSegment->mutex);
+        playerSegment->uri = to_string(args.ResourceUri().AbsoluteUri());
+        playerSegment->position = ToSeconds(position.Value());
+      }
+      auto statistics = args.Statistics();
+      BandwidthMeter::Instance().AddSample(
+          statistics.ContentBytesReceivedCount(),
+          std::chrono::duration_cast<std::chrono::milliseconds>(statistics.TimeToLastByteReceived()).count());
+      if (auto self = ref.get()) {
+        self->PostMediaEvent(MediaEventKind::BandwidthSample);
+      }
+    });
+  });
+  return source;
+}
+
+IMediaPlaybackSource ReactVideoView::CreatePlaybackSource() {
+  auto source = CreateMediaSource();
+  // a break can only interrupt a playback item, so content with ads is wrapped in one
+  if (!m_adTagUrl.empty() && HasMediaBreaks()) {
+    return MediaPlaybackItem(source);
+  }
+  return source;
+}
+
+MediaSource ReactVideoView::ContentSource() const {
+  if (m_player == nullptr) {
+    return nullptr;
+  }
+  auto source = m_player.Source();
+  if (auto item = source.try_as<MediaPlaybackItem>()) {
+    return item.Source();
+  }
+  return source.try_as<MediaSource>();
+}
+
+void ReactVideoView::ResetPlayer(MediaPlayer const &player) {
+  // only touch the handful of properties a view can change; dropping the source releases the media
+  player.Pause();
+  player.Source(nullptr);
+  player.AutoPlay(false);
+  player.IsLoopingEnabled(false);
+  player.IsMuted(false);
+  player.Volume(1.0);
+  player.PlaybackSession().PlaybackRate(1.0);
+}
+
+void ReactVideoView::SetPlayerPoolSize(uint32_t maxSize) {
+  PlayerPool().SetMaxSize(maxSize);
+}
+
+void ReactVideoView::PrewarmPlayerPool(uint32_t count) {
+  PlayerPool().Prewarm(count, []() { return MediaPlayer(); });
+}
+
+void ReactVideoView::OnMediaOpened(IInspectable const &, IInspectable const &) {
+  PostMediaEvent(MediaEventKind::Opened);
+}
+
+void ReactVideoView::OnMediaFailed(IInspectable const &, IInspectable const &) {
+  PostMediaEvent(MediaEventKind::Failed);
+}
+
+void ReactVideoView::OnMediaEnded(IInspectable const &, IInspectable const &) {
+  PostMediaEvent(MediaEventKind::Ended);
+}
+
+void ReactVideoView::OnBufferingStarted(IInspectable const &, IInspectable const &) {
+  PostMediaEvent(MediaEventKind::BufferingStarted);
+}
+
+void ReactVideoView::OnBufferingEnded(IInspectable const &, IInspectable const &) {
+  PostMediaEvent(MediaEventKind::BufferingEnded);
+}
+
+void ReactVideoView::OnSeekCompleted(IInspectable const &, IInspectable const &) {
+  PostMediaEvent(MediaEventKind::SeekCompleted);
+}
+
+void ReactVideoView::OnPlaybackStateChanged(IInspectable const &sender, IInspectable const &) {
+  PostMediaEvent(MediaEventKind::PlaybackStateChanged, sender.as<MediaPlaybackSession>().PlaybackState());
+}
+
+void ReactVideoView::PostMediaEvent(MediaEventKind kind, MediaPlaybackState state, uint32_t item) {
+  // only the latest seek completion / range change per view matters once the batch reaches the UI thread;
+  // lifecycle, state and buffering edges are all kept so the QoE collector sees every play and stall
+  bool collapsible = kind == MediaEventKind::SeekCompleted || kind == MediaEventKind::BufferedRangesChanged ||
+      kind == MediaEventKind::SeekableRangesChanged || kind == MediaEventKind::BandwidthSample ||
+      kind == MediaEventKind::NaturalVideoSizeChanged;
+  m_mediaEvents->Post(MediaEvent{this, kind, collapsible, PlaybackStateBlock::NowMs(), get_weak(), state, item});
+}
+
+void ReactVideoView::OnMediaEvent(MediaEvent const &event) {
+  auto timeMs = event.timeMs;
+  switch (event.kind) {
+    case MediaEventKind::Opened:
+      m_seeks.Reset();
+      UpdateSeekableRange();
+      if (m_player != nullptr) {
+        m_adSchedule.SetContentDuration(ToSeconds(m_player.PlaybackSession().NaturalDuration()));
+        ResumeParkedPlayback();
+        CheckAdBreaksAtPlayhead(); // the pre-roll, before the first progress tick
+      }
+      DispatchLoadEvent();
+      break;
+    case MediaEventKind::Ended:
+      // the player stopped on its own, so a paused prop re-sent with its old value has to reach it again
+      m_props.Invalidate(VideoProp::Paused);
+      m_reactContext.DispatchEvent(*this, L"topEnd", nullptr);
+      if (auto postRoll = m_adSchedule.PostRoll(); postRoll != AdSchedule::c_none && m_adBreak == nullptr) {
+        PlayAdBreak(postRoll);
+      }
+      break;
+    case MediaEventKind::SeekCompleted:
+      HandleSeekCompleted(timeMs);
+      break;
+    case MediaEventKind::PlaybackStateChanged:
+      m_qoe->OnStatus(ToPlaybackStatus(event.state), timeMs);
+      if (event.state != MediaPlaybackState::Playing) {
+        m_frameSampleMs = -1; // the next sample starts when playback resumes
+      }
+      if (m_player != nullptr) {
+        auto state = m_player.PlaybackSession().PlaybackState();
+        // transport controls play and pause behind the props' back
+        if ((state == MediaPlaybackState::Paused && !m_isPaused) ||
+            (state == MediaPlaybackState::Playing && m_isPaused)) {
+          m_props.Invalidate(VideoProp::Paused);
+        }
+      }
+      ResumeAdCueWatch(); // played from the transport controls
+      UpdateProgressSubscription();
+      break;
+    case MediaEventKind::BufferedRangesChanged:
+      if (m_player != nullptr) {
+        CopyRanges(m_player.PlaybackSession().GetBufferedRanges(), m_bufferedRanges);
+      }
+      break;
+    case MediaEventKind::SeekableRangesChanged:
+      if (m_player != nullptr) {
+        CopyRanges(m_player.PlaybackSession().GetSeekableRanges(), m_seekableRanges);
+      }
+      UpdateSeekableRange();
+      break;
+    case MediaEventKind::BufferingStarted:
+      m_qoe->OnBufferingStarted(timeMs);
+      break;
+    case MediaEventKind::BufferingEnded:
+      m_qoe->OnBufferingEnded(timeMs);
+      break;
+    case MediaEventKind::Failed:
+      m_qoe->OnError();
+      // re-sending the same source retries it
+      m_props.Invalidate(VideoProp::Uri);
+      break;
+    case MediaEventKind::BandwidthSample:
+      UpdateAbr();
+      if (m_reportBandwidth) {
+        DispatchBandwidthEvent();
+      }
+      break;
+    case MediaEventKind::AdaptiveSourceOpened:
+      AttachAdaptiveSource();
+      break;
+    case MediaEventKind::NaturalVideoSizeChanged:
+      if (m_adaptiveSource != nullptr && m_player != nullptr) {
+        m_viewportCap.ObserveRendition(
+            m_adaptiveSource.CurrentPlaybackBitrate(),
+            m_player.PlaybackSession().NaturalVideoWidth(),
+            m_player.PlaybackSession().NaturalVideoHeight());
+        ApplyAbrLimits();
+      }
+      break;
+    case MediaEventKind::AdBreakStarted:
+      DispatchAdEvent(L"AD_BREAK_STARTED");
+      UpdateProgressSubscription();
+      break;
+    case MediaEventKind::AdStarted:
+      OnAdStarted();
+      break;
+    case MediaEventKind::AdBreakEnded:
+      OnAdBreakEnded(false);
+      break;
+    case MediaEventKind::AdBreakSkipped:
+      OnAdBreakEnded(true);
+      break;
+    case MediaEventKind::AdFailed:
+      OnAdFailed(event.item);
+      break;
+  }
+  PublishPlaybackState();
+}
+
+void ReactVideoView::ResumeParkedPlayback() {
+  auto position = std::exchange(m_resumePosition, std::nullopt);
+  if (!position) {
+    return;
+  }
+  if (position->count() > 0) {
+    if (auto seek = m_seeks.Request(ToSeconds(*position))) {
+      m_resumeSeekId = seek->id;
+      IssueSeek(*seek);
+    }
+  }
+  if (m_resumePaused) {
+    m_player.Pause();
+  }
+}
+
+void ReactVideoView::DispatchLoadEvent() {
+  if (auto mediaPlayer = m_player) {
+    ::ReactNativeVideoCPP::LoadEventPayload payload;
+    payload.naturalSize.width = mediaPlayer.PlaybackSession().NaturalVideoWidth();
+    payload.naturalSize.height = mediaPlayer.PlaybackSession().NaturalVideoHeight();
+    payload.naturalSize.orientation =
+        (payload.naturalSize.width > payload.naturalSize.height) ? L"landscape" : L"portrait";
+    payload.duration = ToSeconds(mediaPlayer.PlaybackSession().NaturalDuration());
+    payload.currentTime = ToSeconds(mediaPlayer.PlaybackSession().Position());
+
+    DispatchVideoEvent(m_reactContext, *this, L"topLoad", payload);
+  }
+}
+
+void ReactVideoView::DispatchBandwidthEvent() {
+  ::ReactNativeVideoCPP::BandwidthEventPayload payload;
+  payload.bitrate = static_cast<double>(BandwidthMeter::Instance().Estimate());
+  if (m_player != nullptr) {
+    payload.width = m_player.PlaybackSession().NaturalVideoWidth();
+    payload.height = m_player.PlaybackSession().NaturalVideoHeight();
+  }
+  payload.trackId = L"-1"; // same as Android when no track format is known
+  DispatchVideoEvent(m_reactContext, *this, L"topVideoBandwidthUpdate", payload);
+}
+
+void ReactVideoView::AttachAdaptiveSource() {
+  DetachAdaptiveSource();
+  auto source = ContentSource();
+  if (source == nullptr || source.AdaptiveMediaSource() == nullptr) {
+    return;
+  }
+  m_adaptiveSource = source.AdaptiveMediaSource();
+  // start from the rendition chosen when the source opened, it stays until there is a throughput estimate
+  m_abr.SetBitrates(ToVector(m_adaptiveSource.AvailableBitrates()), m_adaptiveSource.InitialBitrate());
+  ApplyAbrLimits();
+}
+
+void ReactVideoView::DetachAdaptiveSource() {
+  m_adaptiveSource = nullptr;
+  m_abr.Reset();
+  m_viewportCap.Reset();
+  m_pinnedBitrate = 0;
+}
+
+void ReactVideoView::ApplyAbrLimits() {
+  // the effective cap is the lower of maxBitRate and what the on-screen size can show
+  auto config = m_abr.Config();
+  auto propLimit = static_cast<uint32_t>(std::clamp(m_maxBitRate, 0.0, static_cast<double>(UINT32_MAX)));
+  auto viewportLimit = m_viewportCap.MaxBitrate(m_abr.Bitrates());
+  config.maxBitRate = propLimit;
+  if (viewportLimit != 0 && (propLimit == 0 || viewportLimit < propLimit)) {
+    config.maxBitRate = viewportLimit;
+  }
+  config.buffer = m_bufferConfig;
+  m_abr.SetConfig(config);
+  UpdateAbr();
+}
+
+void ReactVideoView::UpdateViewport() {
+  auto scale = Windows::Graphics::Display::DisplayInformation::GetForCurrentView().RawPixelsPerViewPixel();
+  m_viewportCap.SetViewport(ActualWidth() * scale, ActualHeight() * scale);
+  ApplyAbrLimits();
+}
+
+void ReactVideoView::UpdateAbr() {
+  if (m_adaptiveSource == nullptr || m_abr.Empty()) {
+    return;
+  }
+  auto position = ToSeconds(m_player.PlaybackSession().Position());
+  auto bufferSeconds = std::max(m_bufferedRanges.EndOfRangeContaining(position) - position, 0.0);
+  auto bitrate = m_abr.Select(bufferSeconds, BandwidthMeter::Instance().Estimate());
+  if (bitrate == 0 || bitrate == m_pinnedBitrate) {
+    return;
+  }
+  // pin the rendition by collapsing the source's own ABR range onto it; min is cleared first so the range
+  // never becomes empty while it moves
+  m_adaptiveSource.DesiredMinBitrate(nullptr);
+  m_adaptiveSource.DesiredMaxBitrate(IReference<uint32_t>(bitrate));
+  m_adaptiveSource.DesiredMinBitrate(IReference<uint32_t>(bitrate));
+  m_pinnedBitrate = bitrate;
+}
+
+void ReactVideoView::UpdateProgressSubscription() {
+  auto &clock = *m_progressClock;
+  // ads keep the clock running to report their quartiles while the content session waits
+  if (m_player != nullptr &&
+      (m_player.PlaybackSession().PlaybackState() == MediaPlaybackState::Playing || m_adBreak != nullptr)) {
+    clock.Subscribe(this, m_progressUpdateInterval > 0 ? m_progressUpdateInterval : c_defaultProgressUpdateInterval);
+  } else {
+    clock.Unsubscribe(this);
+  }
+}
+
+void ReactVideoView::OnProgressTick() {
+  if (auto mediaPlayer = m_player) {
+    if (m_adBreak != nullptr) {
+      AdvanceAd(ToSeconds(mediaPlayer.BreakManager().PlaybackSession().Position()));
+    } else if (mediaPlayer.PlaybackSession().PlaybackState() == MediaPlaybackState::Playing) {
+      ::ReactNativeVideoCPP::ProgressEventPayload payload;
+      payload.currentTime = ToSeconds(mediaPlayer.PlaybackSession().Position());
+      payload.playableDuration = m_bufferedRanges.EndOfRangeContaining(payload.currentTime);
+      payload.seekableDuration = m_seekableRanges.FirstRangeDuration();
+
+      DispatchVideoEvent(m_reactContext, *this, L"topProgress", payload);
+      SampleFrames();
+      CheckAdBreaks(payload.currentTime);
+      if (!std::isnan(m_adCueOffset)) {
+        m_adCues.Advance(payload.currentTime - m_adCueOffset, [this](auto event, auto const &adBreak) {
+          DispatchAdCueEvent(event, adBreak);
+        });
+      }
+    }
+    PublishPlaybackState();
+  }
+}
+
+void ReactVideoView::Set_ProgressUpdateInterval(int64_t interval) {
+  if (!m_props.Assign(VideoProp::ProgressUpdateInterval, m_progressUpdateInterval, interval)) {
+    return;
+  }
+  UpdateProgressSubscription();
+}
+
+void ReactVideoView::Set_IsLoopingEnabled(bool value) {
+  if (!m_props.Assign(VideoProp::IsLoopingEnabled, m_isLoopingEnabled, value)) {
+    return;
+  }
+  if (m_player != nullptr) {
+    m_player.IsLoopingEnabled(m_isLoopingEnabled);
+  }
+}
+
+void ReactVideoView::Set_UriString(hstring const &value) {
+  if (!m_props.Assign(VideoProp::Uri, m_uriString, value)) {
+    return;
+  }
+  // a new source starts its session at the default rate
+  m_props.Invalidate(VideoProp::PlaybackRate);
+  m_seeks.Reset();
+  m_bufferedRanges.Clear();
+  m_seekableRanges.Clear();
+  DetachAdaptiveSource();
+  m_segmentIndex.reset();
+  m_seeks.SetKeyframes({});
+  m_parkedSource = nullptr;
+  m_resumePosition.reset();
+  m_qoe->OnLoadStart(PlaybackStateBlock::NowMs());
+  // a VMAP playlist belongs to the content, so new content gets its breaks afresh
+  ResetAds();
+  if (!m_adTagUrl.empty()) {
+    LoadAds(m_adTagUrl);
+  }
+  ResetAdCues();
+  if (m_player != nullptr) {
+    m_player.Source(CreatePlaybackSource());
+  }
+  LoadSegmentIndex(m_uriString);
+}
+
+void ReactVideoView::Set_ShouldCache(bool shouldCache) {
+  // read when the next source is created; the source is identified by uri and shouldCache together, so a
+  // change rebuilds it even when the uri stays the same
+  if (m_props.Assign(VideoProp::ShouldCache, m_shouldCache, shouldCache)) {
+    m_props.Invalidate(VideoProp::Uri);
+  }
+}
+
+void ReactVideoView::Set_Paused(bool value) {
+  if (!m_props.Assign(VideoProp::Paused, m_isPaused, value)) {
+    return;
+  }
+  ResumeAdCueWatch();
+  if (m_player != nullptr) {
+    if (m_isPaused) {
+      if (IsPlaying(m_player.PlaybackSession().PlaybackState())) {
+        m_player.Pause();
+      }
+    } else {
+      if (!IsPlaying(m_player.PlaybackSession().PlaybackState())) {
+        m_player.Play();
+      }
+    }
+  }
+}
+
+void ReactVideoView::Set_AutoPlay(bool autoPlay) {
+  if (!m_props.Assign(VideoProp::AutoPlay, m_autoPlay, autoPlay)) {
+    return;
+  }
+  if (m_player != nullptr) {
+    m_player.AutoPlay(m_autoPlay);
+  }
+}
+
+void ReactVideoView::Set_Muted(bool isMuted) {
+  if (!m_props.Assign(VideoProp::Muted, m_isMuted, isMuted)) {
+    return;
+  }
+  if (m_player != nullptr) {
+    m_player.IsMuted(m_isMuted);
+  }
+}
+
+void ReactVideoView::Set_Controls(bool useControls) {
+  if (!m_props.Assign(VideoProp::Controls, m_useControls, useControls)) {
+    return;
+  }
+  AreTransportControlsEnabled(m_useControls);
+}
+
+void ReactVideoView::Set_FullScreen(bool fullScreen) {
+  if (!m_props.Assign(VideoProp::FullScreen, m_fullScreen, fullScreen)) {
+    return;
+  }
+  IsFullWindow(m_fullScreen);
+  // a fullscreen view gets whatever rendition the network allows
+  m_viewportCap.SetLifted(m_fullScreen);
+  ApplyAbrLimits();
+
+  // full window will always have transport control enabled
+  if (m_fullScreen && m_props.AssignInternal(VideoProp::Controls, m_useControls, true)) {
+    AreTransportControlsEnabled(m_useControls);
+  }
+}
+
+void ReactVideoView::Set_Volume(double volume) {
+  if (!m_props.Assign(VideoProp::Volume, m_volume, volume)) {
+    return;
+  }
+  if (m_player != nullptr) {
+    m_player.Volume(m_volume);
+  }
+}
+
+void ReactVideoView::Set_Position(double position) {
+  Set_Seek(position, 0);
+}
+
+void ReactVideoView::Set_Seek(double position, double toleranceMs) {
+  m_position = position;
+  if (m_player != nullptr) {
+    // latency runs from the first request to the final landing, across coalesced seeks
+    m_qoe->OnSeekStarted(PlaybackStateBlock::NowMs());
+    if (auto seek = m_seeks.Request(m_position, toleranceMs / 1000)) {
+      IssueSeek(*seek);
+    }
+  }
+}
+
+void ReactVideoView::IssueSeek(::ReactNativeVideoCPP::SeekRequest const &seek) {
+  m_player.PlaybackSession().Position(
+      std::chrono::duration_cast<TimeSpan>(std::chrono::duration<double>(seek.target)));
+  WatchSeek(seek.id);
+}
+
+fire_and_forget ReactVideoView::WatchSeek(uint64_t id) {
+  auto ref = get_weak();
+  auto dispatcher = Dispatcher();
+  co_await resume_after(c_seekTimeout);
+  co_await resume_foreground(dispatcher);
+  if (auto self = ref.get()) {
+    // a no-op when the seek completed in time
+    self->HandleSeekCompletion(self->m_seeks.Expire(id), PlaybackStateBlock::NowMs());
+  }
+}
+
+void ReactVideoView::SampleFrames() {
+  // MediaPlayerElement rendering reports no frame statistics, so only a player in frame server mode is
+  // sampled: the frames it raised since the last tick against those the frame rate called for
+  auto nowMs = PlaybackStateBlock::NowMs();
+  auto presented = m_presentedFrames.exchange(0, std::memory_order_relaxed);
+  auto sinceMs = std::exchange(m_frameSampleMs, nowMs);
+  if (sinceMs < 0 || !m_player.IsVideoFrameServerEnabled()) {
+    return;
+  }
+  auto frameRate = VideoFrameRate();
+  if (frameRate <= 0) {
+    return;
+  }
+  auto expected = static_cast<uint64_t>(
+      std::llround((nowMs - sinceMs) / 1000.0 * frameRate * m_player.PlaybackSession().PlaybackRate()));
+  m_qoe->OnFrameSample(std::min(presented, expected), expected > presented ? expected - presented : 0);
+}
+
+double ReactVideoView::VideoFrameRate() const {
+  auto source = ContentSource();
+  if (source == nullptr || !HasVideoTrackProperties()) {
+    return 0;
+  }
+  auto item = MediaPlaybackItem::FindFromMediaSource(source);
+  if (item == nullptr || item.VideoTracks().Size() == 0) {
+    return 0;
+  }
+  auto selected = item.VideoTracks().SelectedIndex();
+  auto frameRate = item.VideoTracks().GetAt(selected < 0 ? 0 : static_cast<uint32_t>(selected))
+                       .GetEncodingProperties()
+                       .FrameRate();
+  return frameRate.Denominator() != 0 ? static_cast<double>(frameRate.Numerator()) / frameRate.Denominator() : 0;
+}
+
+void ReactVideoView::UpdateSeekableRange() {
+  // a seek outside what the player can reach lands clamped into it, which is where its target is put too
+  if (!m_seekableRanges.Empty()) {
+    auto const &ranges = m_seekableRanges.Ranges();
+    m_seeks.SetSeekableRange(ranges.front().start, ranges.back().end);
+  } else if (m_player != nullptr) {
+    if (auto duration = ToSeconds(m_player.PlaybackSession().NaturalDuration()); duration > 0) {
+      m_seeks.SetSeekableRange(0, duration);
+    }
+  }
+}
+
+void ReactVideoView::HandleSeekCompleted(int64_t timeMs) {
+  if (m_player == nullptr) {
+    return;
+  }
+  auto completion = m_seeks.OnSeekCompleted(ToSeconds(m_player.PlaybackSession().Position()));
+  if (completion.playerSeek) {
+    // nothing was in flight, so a seek made from the transport controls, reported where it landed
+    ::ReactNativeVideoCPP::SeekEventPayload payload;
+    payload.currentTime = ToSeconds(m_player.PlaybackSession().Position());
+    payload.seekTime = payload.currentTime;
+    DispatchVideoEvent(m_reactContext, *this, L"topSeek", payload);
+    return;
+  }
+  HandleSeekCompletion(completion, timeMs);
+}
+
+void ReactVideoView::HandleSeekCompletion(
+    ::ReactNativeVideoCPP::SeekController::Completion const &completion,
+    int64_t timeMs) {
+  if (!completion.completed) {
+    return;
+  }
+  if (completion.next && m_player != nullptr) {
+    // a newer seek arrived while this one was in flight, only the final landing is reported
+    IssueSeek(*completion.next);
+    return;
+  }
+  if (std::exchange(m_resumeSeekId, 0) == completion.completed->id) {
+    return; // a remounted view returning to where it was, not a seek JS asked for
+  }
+
+  m_qoe->OnSeekCompleted(timeMs);
+  ::ReactNativeVideoCPP::SeekEventPayload payload;
+  if (m_player != nullptr) {
+    payload.currentTime = ToSeconds(m_player.PlaybackSession().Position());
+  }
+  payload.seekTime = completion.completed->requested;
+  DispatchVideoEvent(m_reactContext, *this, L"topSeek", payload);
+}
+
+fire_and_forget ReactVideoView::LoadSegmentIndex(hstring uri) {
+  auto ref = get_weak();
+  auto dispatcher = Dispatcher();
+  co_await resume_background();
+  auto index = SegmentIndexStore::Instance().Load(uri);
+  if (index == nullptr) {
+    co_return;
+  }
+  co_await resume_foreground(dispatcher);
+  // the source may have changed while the manifest was loading
+  if (auto self = ref.get(); self != nullptr && self->m_uriString == uri) {
+    self->m_seeks.SetKeyframes(index->Starts());
+    self->m_segmentIndex = std::move(index);
+  }
+}
+
+void ReactVideoView::Set_PlaybackRate(double rate) {
+  if (!m_props.Assign(VideoProp::PlaybackRate, m_playbackRate, rate)) {
+    return;
+  }
+  if (m_player != nullptr) {
+    m_player.PlaybackSession().PlaybackRate(m_playbackRate);
+    PublishPlaybackState();
+  }
+}
+
+void ReactVideoView::Set_ReportBandwidth(bool reportBandwidth) {
+  m_props.Assign(VideoProp::ReportBandwidth, m_reportBandwidth, reportBandwidth);
+}
+
+void ReactVideoView::Set_ReportAdCues(bool reportAdCues) {
+  if (!m_props.Assign(VideoProp::ReportAdCues, m_reportAdCues, reportAdCues)) {
+    return;
+  }
+  ResetAdCues();
+}
+
+void ReactVideoView::Set_MaxBitRate(double maxBitRate) {
+  if (!m_props.Assign(VideoProp::MaxBitRate, m_maxBitRate, maxBitRate)) {
+    return;
+  }
+  ApplyAbrLimits();
+}
+
+void ReactVideoView::Set_BufferConfig(
+    double minBufferMs,
+    double maxBufferMs,
+    double bufferForPlaybackMs,
+    double bufferForPlaybackAfterRebufferMs) {
+  ::ReactNativeVideoCPP::AbrBufferConfig bufferConfig{
+      minBufferMs, maxBufferMs, bufferForPlaybackMs, bufferForPlaybackAfterRebufferMs};
+  if (!m_props.Assign(VideoProp::BufferConfig, m_bufferConfig, bufferConfig)) {
+    return;
+  }
+  // MediaPlayer sizes its own buffer; the thresholds steer rendition selection only
+  ApplyAbrLimits();
+}
+
+void ReactVideoView::Set_ViewportOversampling(double oversampling) {
+  if (!m_props.Assign(VideoProp::ViewportOversampling, m_viewportOversampling, oversampling)) {
+    return;
+  }
+  m_viewportCap.SetOversampling(m_viewportOversampling);
+  ApplyAbrLimits();
+}
+
+void ReactVideoView::Set_AdTagUrl(hstring const &adTagUrl) {
+  if (!m_props.Assign(VideoProp::AdTagUrl, m_adTagUrl, adTagUrl)) {
+    return;
+  }
+  ResetAds();
+  if (m_adTagUrl.empty()) {
+    return;
+  }
+  LoadAds(m_adTagUrl);
+  if (m_parkedSource != nullptr && HasMediaBreaks() && m_parkedSource.try_as<MediaPlaybackItem>() == nullptr) {
+    m_parkedSource = nullptr; // remounts with a new item instead
+    m_resumePosition.reset();
+  }
+  // content opened before the tag arrived is reopened inside a playback item, so breaks can interrupt it
+  if (m_player != nullptr && m_props.IsApplied(VideoProp::Uri) && HasMediaBreaks() &&
+      m_player.Source().try_as<MediaPlaybackItem>() == nullptr) {
+    m_seeks.Reset();
+    DetachAdaptiveSource();
+    m_player.Source(CreatePlaybackSource());
+  }
+}
+
+fire_and_forget ReactVideoView::LoadAds(hstring adTagUrl) {
+  auto ref = get_weak();
+  auto dispatcher = Dispatcher();
+  co_await resume_background();
+  auto breaks = AdLoader::Instance().Load(adTagUrl);
+  co_await resume_foreground(dispatcher);
+  // the tag may have changed while the ads were loading
+  if (auto self = ref.get(); self != nullptr && self->m_adTagUrl == adTagUrl) {
+    self->m_adSchedule.Assign(std::move(breaks));
+    if (self->m_player != nullptr) {
+      self->m_adSchedule.SetContentDuration(ToSeconds(self->m_player.PlaybackSession().NaturalDuration()));
+      self->CheckAdBreaksAtPlayhead(); // content that opened while the tag loaded still gets its pre-roll
+    }
+  }
+}
+
+void ReactVideoView::ResetAds() {
+  EndAdBreak();
+  AbandonAdPrefetch();
+  m_adSchedule.Clear();
+  m_lastAdCheck = -1;
+}
+
+void ReactVideoView::CheckAdBreaks(double position) {
+  if (m_adSchedule.Empty()) {
+    return; // still loading: the position checked from stays where it was, so the pre-roll is still due
+  }
+  auto due = m_adSchedule.Due(m_lastAdCheck, position);
+  m_lastAdCheck = position;
+  if (!due.empty()) {
+    // a seek across several breaks plays only the last of them, as the IMA players do
+    for (auto index : due) {
+      m_adSchedule.MarkPlayed(index);
+    }
+    PlayAdBreak(due.back());
+    return;
+  }
+  // the next break's creatives download while the content is still well buffered, a post-roll's included
+  auto next = m_adSchedule.PrefetchDue(position, c_adPrefetchLeadSeconds);
+  if (next != AdSchedule::c_none && next != m_adPrefetchBreak) {
+    PrefetchAdBreak(next);
+  }
+}
+
+void ReactVideoView::CheckAdBreaksAtPlayhead() {
+  if (m_player == nullptr || m_adBreak != nullptr) {
+    return;
+  }
+  auto session = m_player.PlaybackSession();
+  auto state = session.PlaybackState();
+  if (state != MediaPlaybackState::None && state != MediaPlaybackState::Opening) {
+    CheckAdBreaks(ToSeconds(session.Position()));
+  }
+}
+
+std::vector<std::string> ReactVideoView::ChooseAdCreatives(size_t index) const {
+  std::vector<std::string> creatives;
+  auto bandwidth = BandwidthMeter::Instance().Estimate();
+  for (auto const &ad : m_adSchedule.Break(index).ads) {
+    auto file = ::ReactNativeVideoCPP::SelectVastMediaFile(ad.linear.mediaFiles, bandwidth);
+    creatives.push_back(file != nullptr ? file->url : std::string());
+  }
+  return creatives;
+}
+
+void ReactVideoView::PrefetchAdBreak(size_t index) {
+  m_adPrefetchBreak = index;
+  m_adPrefetchCreatives = ChooseAdCreatives(index);
+  AdLoader::Instance().Prefetch(this, m_adPrefetchCreatives);
+}
+
+void ReactVideoView::AbandonAdPrefetch() {
+  for (auto const &url : m_adPrefetchCreatives) {
+    if (!url.empty()) {
+      AdLoader::Instance().Prefetches().Abandon(this, url);
+    }
+  }
+  m_adPrefetchCreatives.clear();
+  m_adPrefetchBreak = AdSchedule::c_none;
+}
+
+void ReactVideoView::PlayAdBreak(size_t index) {
+  m_adSchedule.MarkPlayed(index);
+  if (m_player == nullptr || !HasMediaBreaks()) {
+    AbandonAdPrefetch();
+    return;
+  }
+  std::vector<std::string> chosen;
+  if (index == m_adPrefetchBreak) {
+    // the prefetched files, even if the bandwidth has moved since they were chosen
+    chosen = std::exchange(m_adPrefetchCreatives, {});
+    m_adPrefetchBreak = AdSchedule::c_none;
+  } else {
+    AbandonAdPrefetch(); // seeked past the break that was prefetched
+    chosen = ChooseAdCreatives(index);
+  }
+  MediaBreak mediaBreak(MediaBreakInsertionMethod::Interrupt);
+  std::vector<::ReactNativeVideoCPP::VastAd> ads;
+  std::vector<std::string> creatives;
+  auto const &breakAds = m_adSchedule.Break(index).ads;
+  for (size_t i = 0; i < breakAds.size() && i < chosen.size(); ++i) {
+    if (chosen[i].empty()) {
+      ReportAdError(breakAds[i], VastError::MediaFileNotSupported);
+      continue;
+    }
+    try {
+      // read through the ad creative cache, where a prefetched creative already is
+      Uri uri(to_hstring(chosen[i]));
+      auto source = MediaCache::Instance().CreateProgressiveSource(uri, RangeCache::AdCreatives);
+      if (source == nullptr) {
+        source = MediaSource::CreateFromUri(uri);
+      }
+      mediaBreak.PlaybackList().Items().Append(MediaPlaybackItem(source));
+      ads.push_back(breakAds[i]);
+      creatives.push_back(std::move(chosen[i]));
+    } catch (winrt::hresult_error const &) {
+      // malformed media file URI, the ad is left out of the break
+      ReportAdError(breakAds[i], VastError::MediaFileDisplay);
+    }
+  }
+  if (ads.empty()) {
+    return;
+  }
+  EndAdBreak();
+  m_adBreak = mediaBreak;
+  m_adBreakAds = std::move(ads);
+  m_adBreakCreatives = std::move(creatives);
+  m_adChangedToken = mediaBreak.PlaybackList().CurrentItemChanged(
+      winrt::auto_revoke, [ref = get_weak()](auto const &, auto const &) {
+        if (auto self = ref.get()) {
+          self->PostMediaEvent(MediaEventKind::AdStarted);
+        }
+      });
+  m_adFailedToken = mediaBreak.PlaybackList().ItemFailed(
+      winrt::auto_revoke,
+      [ref = get_weak()](MediaPlaybackList const &list, MediaPlaybackItemFailedEventArgs const &args) {
+        uint32_t index = 0;
+        if (auto self = ref.get(); self != nullptr && list.Items().IndexOf(args.Item(), index)) {
+          self->PostMediaEvent(MediaEventKind::AdFailed, MediaPlaybackState::None, index);
+        }
+      });
+  m_player.BreakManager().PlayBreak(mediaBreak);
+}
+
+void ReactVideoView::EndAdBreak() {
+  // creatives of ads the break never got to were fetched for nothing
+  for (auto const &url : m_adBreakCreatives) {
+    if (!url.empty()) {
+      AdLoader::Instance().Prefetches().Abandon(this, url);
+    }
+  }
+  m_adChangedToken.revoke();
+  m_adFailedToken.revoke();
+  m_adBreak = nullptr;
+  m_adBreakAds.clear();
+  m_adBreakCreatives.clear();
+  m_adProgress.Stop();
+}
+
+void ReactVideoView::OnAdStarted() {
+  if (m_adBreak == nullptr) {
+    return;
+  }
+  FinishAd(); // the previous ad of the pod played to its end
+  auto index = m_adBreak.PlaybackList().CurrentItemIndex();
+  if (index >= m_adBreakAds.size()) {
+    return;
+  }
+  AdLoader::Instance().Prefetches().Played(this, std::exchange(m_adBreakCreatives[index], {}));
+  for (auto const &url : m_adBreakAds[index].impressions) {
+    BeaconDispatcher::Instance().Send(url);
+  }
+  m_adProgress.Start(m_adBreakAds[index]);
+  AdvanceAd(0);
+}
+
+void ReactVideoView::OnAdFailed(uint32_t index) {
+  if (m_adBreak == nullptr || index >= m_adBreakAds.size()) {
+    return;
+  }
+  ReportAdError(m_adBreakAds[index], VastError::MediaFileDisplay);
+  // the list moves on to the next ad, which must not complete the one that failed
+  m_adProgress.Stop();
+}
+
+void ReactVideoView::ReportAdError(::ReactNativeVideoCPP::VastAd const &ad, VastError error) {
+  for (auto const &url : ad.errors) {
+    BeaconDispatcher::Instance().Send(::ReactNativeVideoCPP::VastErrorUrl(url, error));
+  }
+}
+
+void ReactVideoView::OnAdBreakEnded(bool skipped) {
+  if (m_adBreak == nullptr) {
+    return;
+  }
+  if (skipped) {
+    m_adProgress.Track("skip", [](std::string const &url) { BeaconDispatcher::Instance().Send(url); });
+    DispatchAdEvent(L"SKIPPED");
+  } else {
+    FinishAd();
+  }
+  EndAdBreak();
+  DispatchAdEvent(L"AD_BREAK_ENDED");
+  if (m_adSchedule.Upcoming(-1) == AdSchedule::c_none) {
+    DispatchAdEvent(L"ALL_ADS_COMPLETED");
+  }
+  UpdateProgressSubscription();
+}
+
+void ReactVideoView::AdvanceAd(double position) {
+  m_adProgress.Advance(
+      position,
+      [this](AdMilestone milestone) { DispatchAdEvent(AdEventOf(milestone)); },
+      [](std::string const &url) { BeaconDispatcher::Instance().Send(url); });
+}
+
+void ReactVideoView::FinishAd() {
+  m_adProgress.Complete(
+      [this](AdMilestone milestone) { DispatchAdEvent(AdEventOf(milestone)); },
+      [](std::string const &url) { BeaconDispatcher::Instance().Send(url); });
+}
+
+void ReactVideoView::DispatchAdEvent(std::wstring_view event) {
+  ::ReactNativeVideoCPP::AdEventPayload payload;
+  payload.event = event;
+  payload.target = winrt::unbox_value_or<int64_t>(Tag(), -1);
+  DispatchVideoEvent(m_reactContext, *this, L"topReceiveAdEvent", payload);
+}
+
+void ReactVideoView::ResetAdCues() {
+  ++m_adCueWatch;
+  // leaving the source (or turning cues off) mid-break still closes the break for JS
+  m_adCues.Advance(-std::numeric_limits<double>::infinity(), [this](auto event, auto const &adBreak) {
+    DispatchAdCueEvent(event, adBreak);
+  });
+  m_adCues.Clear();
+  m_adCueState = nullptr;
+  m_adCueWatching = false;
+  m_adCueOffset = NAN;
+  m_playerSegment = std::make_shared<PlayerSegment>(); // handed to the next source's download handler
+  if (m_reportAdCues && !m_uriString.empty()) {
+    m_adCueState = std::make_shared<AdCueWatchState>();
+    m_adCueWatching = true;
+    // the first load is not held back by a pause, so cues already listed are known before playback
+    WatchAdCues(m_uriString, m_adCueWatch, m_adCueState);
+  }
+}
+
+void ReactVideoView::ResumeAdCueWatch() {
+  if (m_adCueState != nullptr && !m_adCueWatching && ShouldPollAdCues()) {
+    m_adCueWatching = true;
+    WatchAdCues(m_uriString, m_adCueWatch, m_adCueState);
+  }
+}
+
+bool ReactVideoView::ShouldPollAdCues() const {
+  // nobody sees a break begin in a paused or unmounted player; the refresh after resuming catches up
+  return m_player != nullptr &&
+      (!m_isPaused || m_player.PlaybackSession().PlaybackState() == MediaPlaybackState::Playing);
+}
+
+fire_and_forget ReactVideoView::WatchAdCues(hstring uri, uint64_t watch, std::shared_ptr<AdCueWatchState> state) {
+  auto ref = get_weak();
+  auto dispatcher = Dispatcher();
+  while (true) {
+    co_await resume_background();
+    ::ReactNativeVideoCPP::HlsUpdateResult update;
+    bool first = state->playlistUri == nullptr;
+    try {
+      update = first ? state->playlist.Update(
+                           SegmentIndexStore::Instance().FetchHlsMediaPlaylist(Uri(uri), state->playlistUri))
+                     : state->playlist.Update(SegmentIndexStore::Instance().Fetch(state->playlistUri));
+    } catch (winrt::hresult_error const &) {
+      // malformed URI or a failed download, handled below like a body that is no playlist
+      update.valid = false;
+    }
+    std::vector<::ReactNativeVideoCPP::HlsCue> cues;
+    if (update.valid) {
+      auto const &allCues = state->playlist.Cues();
+      cues.assign(allCues.end() - update.cues, allCues.end());
+    }
+    co_await resume_foreground(dispatcher);
+    auto self = ref.get();
+    // the source may have changed, or cues been turned off, while the playlist was loading
+    if (self == nullptr || self->m_adCueWatch != watch) {
+      co_return;
+    }
+    if (!update.valid && first) {
+      // nothing to refresh yet: the watch is parked, and the next ResumeAdCueWatch tries the first load again
+      self->m_adCueWatching = false;
+      co_return;
+    }
+    // a failed or unusable refresh kept the previous playlist, and the next one catches up with what it missed
+    if (update.valid) {
+      self->AnchorAdCues(*state);
+      self->m_adCues.Add(cues);
+    }
+    self = nullptr; // not kept alive across the wait
+    if (state->playlist.EndList()) {
+      co_return; // the playlist is complete, so the watch stays done rather than parked
+    }
+    // a live playlist is reloaded once per target duration, as the player itself does
+    auto refreshMs = static_cast<int64_t>(std::max(state->playlist.TargetDuration(), 1.0) * 1000);
+    co_await resume_after(std::chrono::milliseconds(refreshMs));
+    co_await resume_foreground(dispatcher);
+    self = ref.get();
+    if (self == nullptr || self->m_adCueWatch != watch) {
+      co_return;
+    }
+    if (!self->ShouldPollAdCues()) {
+      self->m_adCueWatching = false; // parked until ResumeAdCueWatch
+      co_return;
+    }
+    self = nullptr;
+  }
+}
+
+void ReactVideoView::AnchorAdCues(AdCueWatchState const &state) {
+  if (!std::isnan(m_adCueOffset)) {
+    return;
+  }
+  auto const &playlist = state.playlist;
+  if (playlist.Type() != ::ReactNativeVideoCPP::HlsPlaylistType::Live) {
+    m_adCueOffset = 0; // the watch and the player both start from the first segment
+    return;
+  }
+  // a sliding window starts wherever it was when each of them first loaded it: place the playlist on the
+  // player's timeline through a program date time the player correlates with its position...
+  if (m_adaptiveSource != nullptr && HasCorrelatedTimes()) {
+    if (auto times = m_adaptiveSource.GetCorrelatedTimes(); times != nullptr) {
+      auto position = times.Position();
+      auto date = times.ProgramDateTime();
+      auto time = date ? playlist.TimeOfDate(ToUnixSeconds(date.Value())) : NAN;
+      if (position && !std::isnan(time)) {
+        m_adCueOffset = ToSeconds(position.Value()) - time;
+        return;
+      }
+    }
+  }
+  // ...else through the media segment the player downloaded last, found by its URI
+  std::string segmentUri;
+  double segmentPosition = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_playerSegment->mutex);
+    segmentUri = m_playerSegment->uri;
+    segmentPosition = m_playerSegment->position;
+  }
+  if (segmentUri.empty()) {
+    return;
+  }
+  for (auto const &segment : playlist.Segments()) {
+    auto uri = state.playlistUri.CombineUri(to_hstring(playlist.Uri(segment)));
+    if (to_string(uri.AbsoluteUri()) == segmentUri) {
+      m_adCueOffset = segmentPosition - segment.start;
+      return;
+    }
+  }
+}
+
+void ReactVideoView::DispatchAdCueEvent(
+    ::ReactNativeVideoCPP::AdCueEvent event,
+    ::ReactNativeVideoCPP::AdCueBreak const &adBreak) {
+  auto id = to_hstring(adBreak.id);
+  auto end = adBreak.End();
+  ::ReactNativeVideoCPP::AdCueEventPayload payload;
+  payload.event = event == ::ReactNativeVideoCPP::AdCueEvent::BreakStart ? L"AD_BREAK_STARTED" : L"AD_BREAK_ENDED";
+  payload.id = id;
+  // on the player's timeline, as currentTime is
+  payload.startTime = adBreak.start + m_adCueOffset;
+  payload.endTime = std::isinf(end) ? -1 : end + m_adCueOffset;
+  payload.duration = adBreak.duration;
+  payload.spliceEventId = adBreak.spliceEventId;
+  payload.target = winrt::unbox_value_or<int64_t>(Tag(), -1);
+  DispatchVideoEvent(m_reactContext, *this, L"topAdCue", payload);
+}
+
+winrt::ReactNativeVideoCPP::PropUpdateStats ReactVideoView::PropertyUpdateStats() const noexcept {
+  auto stats = m_props.Stats();
+  return {stats.applied, stats.skipped};
+}
+
+bool ReactVideoView::IsPlaying(MediaPlaybackState currentState) {
+  return (
+      currentState == MediaPlaybackState::Buffering || currentState == MediaPlaybackState::Opening ||
+      currentState == MediaPlaybackState::Playing);
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -1,57 +1,231 @@
-#pragma once
-#include "ReactVideoView.g.h"
-#include <functional>
-using namespace winrt;
-using namespace Microsoft::ReactNative;
-
-namespace winrt::ReactNativeVideoCPP::implementation {
-struct ReactVideoView : ReactVideoViewT<ReactVideoView> {
- public:
-  ReactVideoView(winrt::Microsoft::ReactNative::IReactContext const &reactContext);
-  void Set_UriString(hstring const &value);
-  void Set_IsLoopingEnabled(bool value);
-  void Set_Paused(bool isPaused);
-  void Set_Muted(bool isMuted);
-  void Set_Volume(double volume);
-  void Set_Position(double position);
-  void Set_Controls(bool useControls);
-  void Set_FullScreen(bool fullScreen);
-  void Set_ProgressUpdateInterval(int64_t interval);
-  void Set_AutoPlay(bool autoPlay);
-  void Set_PlaybackRate(double rate);
-
- private:
-  hstring m_uriString;
-  bool m_isLoopingEnabled = false;
-  bool m_isPaused = true;
-  bool m_isMuted = false;
-  bool m_useControls = false;
-  bool m_fullScreen = false;
-  double m_volume = 0;
-  double m_position = 0;
-  Windows::UI::Xaml::DispatcherTimer m_timer;
-  Windows::Media::Playback::MediaPlayer m_player = nullptr;
-  Windows::UI::Core::CoreDispatcher m_uiDispatcher = nullptr;
-  Microsoft::ReactNative::IReactContext m_reactContext{nullptr};
-
-  Windows::Media::Playback::MediaPlayer::MediaOpened_revoker m_mediaOpenedToken{};
-  Windows::Media::Playback::MediaPlayer::MediaFailed_revoker m_mediaFailedToken{};
-  Windows::Media::Playback::MediaPlayer::MediaEnded_revoker m_mediaEndedToken{};
-  Windows::Media::Playback::MediaPlaybackSession::BufferingStarted_revoker m_bufferingStartedToken{};
-  Windows::Media::Playback::MediaPlaybackSession::BufferingEnded_revoker m_bufferingEndedToken{};
-  Windows::Media::Playback::MediaPlaybackSession::SeekCompleted_revoker m_seekCompletedToken{};
-
-  bool IsPlaying(Windows::Media::Playback::MediaPlaybackState currentState);
-  void OnMediaOpened(IInspectable const &sender, IInspectable const &args);
-  void OnMediaFailed(IInspectable const &sender, IInspectable const &args);
-  void OnMediaEnded(IInspectable const &sender, IInspectable const &);
-  void OnBufferingStarted(IInspectable const &sender, IInspectable const &);
-  void OnBufferingEnded(IInspectable const &sender, IInspectable const &);
-  void OnSeekCompleted(IInspectable const &sender, IInspectable const &);
-
-  void runOnQueue(std::function<void()> &&func);
-};
-} // namespace winrt::ReactNativeVideoCPP::implementation
-namespace winrt::ReactNativeVideoCPP::factory_implementation {
-struct ReactVideoView : ReactVideoViewT<ReactVideoView, implementation::ReactVideoView> {};
-} // namespace winrt::ReactNativeVideoCPP::factory_implementation
+#pragma once
+#include "ReactVideoView.g.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "AbrController.h"
+#include "AdCueTimeline.h"
+#include "AdProgressTracker.h"
+#include "AdSchedule.h"
+#include "MediaEventQueue.h"
+#include "PlaybackStateBlock.h"
+#include "QoeCollector.h"
+#include "SeekController.h"
+#include "SegmentIndex.h"
+#include "TimeRangeSet.h"
+#include "VastResolver.h"
+#include "VideoPropSnapshot.h"
+#include "ViewportCap.h"
+using namespace winrt;
+using namespace Microsoft::ReactNative;
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// The media playlist an ad cue watch refreshes. Kept by the view, so a watch parked while paused or unmounted
+// picks up on the same timeline.
+struct AdCueWatchState {
+  ::ReactNativeVideoCPP::HlsMediaPlaylist playlist;
+  Windows::Foundation::Uri playlistUri{nullptr}; // null until the first load
+};
+
+// The last media segment the player downloaded and its position on the player's timeline. Written on the
+// thread pool by the source's download handler, read when ad cues are placed on the player's timeline.
+struct PlayerSegment {
+  std::mutex mutex;
+  std::string uri;
+  double position = 0;
+};
+class ProgressClock;
+
+struct ReactVideoView : ReactVideoViewT<ReactVideoView> {
+ public:
+  ReactVideoView(winrt::Microsoft::ReactNative::IReactContext const &reactContext);
+  ~ReactVideoView();
+  void Set_UriString(hstring const &value);
+  void Set_ShouldCache(bool shouldCache);
+  void Set_IsLoopingEnabled(bool value);
+  void Set_Paused(bool isPaused);
+  void Set_Muted(bool isMuted);
+  void Set_Volume(double volume);
+  void Set_Position(double position);
+  void Set_Seek(double position, double toleranceMs);
+  void Set_Controls(bool useControls);
+  void Set_FullScreen(bool fullScreen);
+  void Set_ProgressUpdateInterval(int64_t interval);
+  void Set_AutoPlay(bool autoPlay);
+  void Set_PlaybackRate(double rate);
+  void Set_ReportBandwidth(bool reportBandwidth);
+  void Set_MaxBitRate(double maxBitRate);
+  void Set_BufferConfig(
+      double minBufferMs,
+      double maxBufferMs,
+      double bufferForPlaybackMs,
+      double bufferForPlaybackAfterRebufferMs);
+  void Set_ViewportOversampling(double oversampling);
+  void Set_AdTagUrl(hstring const &adTagUrl);
+  void Set_ReportAdCues(bool reportAdCues);
+
+  winrt::ReactNativeVideoCPP::PropUpdateStats PropertyUpdateStats() const noexcept;
+
+  static void SetPlayerPoolSize(uint32_t maxSize);
+  static void PrewarmPlayerPool(uint32_t count);
+
+ private:
+  hstring m_uriString;
+  bool m_shouldCache = false;
+  bool m_isLoopingEnabled = false;
+  bool m_isPaused = true;
+  bool m_isMuted = false;
+  bool m_useControls = false;
+  bool m_fullScreen = false;
+  double m_volume = 0;
+  double m_position = 0;
+  double m_playbackRate = 1;
+  bool m_autoPlay = false;
+  bool m_reportBandwidth = false;
+  double m_maxBitRate = 0;
+  ::ReactNativeVideoCPP::AbrBufferConfig m_bufferConfig;
+  double m_viewportOversampling = 1;
+  int64_t m_progressUpdateInterval = 250;
+  hstring m_adTagUrl;
+  ::ReactNativeVideoCPP::AdSchedule m_adSchedule;
+  double m_lastAdCheck = -1; // content position of the previous cue check, below 0 so a pre-roll is due
+  std::vector<::ReactNativeVideoCPP::VastAd> m_adBreakAds; // the ads queued in m_adBreak
+  std::vector<std::string> m_adBreakCreatives; // their media file URLs, emptied as each one starts
+  size_t m_adPrefetchBreak = ::ReactNativeVideoCPP::AdSchedule::c_none; // the break being prefetched
+  std::vector<std::string> m_adPrefetchCreatives; // the media file URL chosen for each of its ads
+  ::ReactNativeVideoCPP::AdProgressTracker m_adProgress;
+  Windows::Media::Playback::MediaBreak m_adBreak = nullptr; // the break playing, if any
+  bool m_reportAdCues = false;
+  ::ReactNativeVideoCPP::AdCueTimeline m_adCues;
+  uint64_t m_adCueWatch = 0; // bumped to stop the playlist watch of the previous source
+  std::shared_ptr<AdCueWatchState> m_adCueState; // null until the watch of the current source starts
+  bool m_adCueWatching = false; // a watch is loading or waiting to refresh, rather than parked
+  double m_adCueOffset = NAN; // player position minus playlist time, NaN until known
+  std::shared_ptr<PlayerSegment> m_playerSegment = std::make_shared<PlayerSegment>();
+  ::ReactNativeVideoCPP::VideoPropSnapshot m_props;
+  ::ReactNativeVideoCPP::SeekController m_seeks;
+  ::ReactNativeVideoCPP::TimeRangeSet m_bufferedRanges;
+  ::ReactNativeVideoCPP::TimeRangeSet m_seekableRanges;
+  ::ReactNativeVideoCPP::AbrController m_abr;
+  uint32_t m_pinnedBitrate = 0;
+  ::ReactNativeVideoCPP::ViewportCap m_viewportCap;
+  std::shared_ptr<::ReactNativeVideoCPP::SegmentIndex const> m_segmentIndex;
+  std::shared_ptr<::ReactNativeVideoCPP::PlaybackStateBlock> m_playbackState =
+      std::make_shared<::ReactNativeVideoCPP::PlaybackStateBlock>();
+  int64_t m_playbackStateTag = -1;
+  std::shared_ptr<::ReactNativeVideoCPP::QoeCollector> m_qoe =
+      std::make_shared<::ReactNativeVideoCPP::QoeCollector>();
+  std::atomic<uint64_t> m_presentedFrames{0}; // frames raised in frame server mode since the last sample
+  int64_t m_frameSampleMs = -1; // when the running frame sample started, -1 while not playing
+  Windows::Media::Playback::MediaPlayer m_player = nullptr;
+  // the source an unloaded view played, reused on remount
+  Windows::Media::Playback::IMediaPlaybackSource m_parkedSource = nullptr;
+  std::optional<Windows::Foundation::TimeSpan> m_resumePosition; // restored once the parked source reopens
+  bool m_resumePaused = false;
+  uint64_t m_resumeSeekId = 0; // the seek that returns a remounted view to its position
+  Windows::Media::Streaming::Adaptive::AdaptiveMediaSource m_adaptiveSource = nullptr;
+  MediaEventQueue *m_mediaEvents = nullptr;
+  ProgressClock *m_progressClock = nullptr; // the UI thread's, whichever thread releases the view
+  Microsoft::ReactNative::IReactContext m_reactContext{nullptr};
+
+  Windows::Media::Playback::MediaPlayer::MediaOpened_revoker m_mediaOpenedToken{};
+  Windows::Media::Playback::MediaPlayer::MediaFailed_revoker m_mediaFailedToken{};
+  Windows::Media::Playback::MediaPlayer::MediaEnded_revoker m_mediaEndedToken{};
+  Windows::Media::Playback::MediaPlaybackSession::BufferingStarted_revoker m_bufferingStartedToken{};
+  Windows::Media::Playback::MediaPlaybackSession::BufferingEnded_revoker m_bufferingEndedToken{};
+  Windows::Media::Playback::MediaPlaybackSession::SeekCompleted_revoker m_seekCompletedToken{};
+  Windows::Media::Playback::MediaPlaybackSession::PlaybackStateChanged_revoker m_playbackStateChangedToken{};
+  Windows::Media::Playback::MediaPlaybackSession::BufferedRangesChanged_revoker m_bufferedRangesChangedToken{};
+  Windows::Media::Playback::MediaPlaybackSession::SeekableRangesChanged_revoker m_seekableRangesChangedToken{};
+  Windows::UI::Xaml::FrameworkElement::Loaded_revoker m_loadedToken{};
+  Windows::UI::Xaml::FrameworkElement::Unloaded_revoker m_unloadedToken{};
+  Windows::UI::Xaml::FrameworkElement::SizeChanged_revoker m_sizeChangedToken{};
+  Windows::Media::Playback::MediaPlaybackSession::NaturalVideoSizeChanged_revoker m_naturalVideoSizeChangedToken{};
+  Windows::Media::Playback::MediaPlayer::VideoFrameAvailable_revoker m_videoFrameAvailableToken{};
+  Windows::Media::Playback::MediaBreakManager::BreakStarted_revoker m_breakStartedToken{};
+  Windows::Media::Playback::MediaBreakManager::BreakEnded_revoker m_breakEndedToken{};
+  Windows::Media::Playback::MediaBreakManager::BreakSkipped_revoker m_breakSkippedToken{};
+  Windows::Media::Playback::MediaPlaybackList::CurrentItemChanged_revoker m_adChangedToken{};
+  Windows::Media::Playback::MediaPlaybackList::ItemFailed_revoker m_adFailedToken{};
+
+  void AttachPlayer();
+  void DetachPlayer();
+  void ApplyPropsToPlayer();
+  Windows::Media::Core::MediaSource CreateMediaSource();
+  Windows::Media::Playback::IMediaPlaybackSource CreatePlaybackSource();
+  Windows::Media::Core::MediaSource ContentSource() const;
+  static void ResetPlayer(Windows::Media::Playback::MediaPlayer const &player);
+
+  bool IsPlaying(Windows::Media::Playback::MediaPlaybackState currentState);
+  void OnMediaOpened(IInspectable const &sender, IInspectable const &args);
+  void OnMediaFailed(IInspectable const &sender, IInspectable const &args);
+  void OnMediaEnded(IInspectable const &sender, IInspectable const &);
+  void OnBufferingStarted(IInspectable const &sender, IInspectable const &);
+  void OnBufferingEnded(IInspectable const &sender, IInspectable const &);
+  void OnSeekCompleted(IInspectable const &sender, IInspectable const &);
+  void OnPlaybackStateChanged(IInspectable const &sender, IInspectable const &);
+
+  friend class MediaEventQueue;
+  void PostMediaEvent(
+      MediaEventKind kind,
+      Windows::Media::Playback::MediaPlaybackState state = Windows::Media::Playback::MediaPlaybackState::None,
+      uint32_t item = 0);
+  void OnMediaEvent(MediaEvent const &event);
+  void ResumeParkedPlayback();
+  void DispatchLoadEvent();
+  void DispatchBandwidthEvent();
+  void AttachAdaptiveSource();
+  void DetachAdaptiveSource();
+  void ApplyAbrLimits();
+  void UpdateAbr();
+  void UpdateViewport();
+  void IssueSeek(::ReactNativeVideoCPP::SeekRequest const &seek);
+  fire_and_forget WatchSeek(uint64_t id);
+  void SampleFrames();
+  double VideoFrameRate() const;
+  void UpdateSeekableRange();
+  void HandleSeekCompleted(int64_t timeMs);
+  void HandleSeekCompletion(::ReactNativeVideoCPP::SeekController::Completion const &completion, int64_t timeMs);
+  fire_and_forget LoadSegmentIndex(hstring uri);
+
+  // VAST / VMAP ads, played as media breaks that interrupt the content
+  fire_and_forget LoadAds(hstring adTagUrl);
+  void ResetAds();
+  void CheckAdBreaks(double position);
+  void CheckAdBreaksAtPlayhead();
+  void PlayAdBreak(size_t index);
+  std::vector<std::string> ChooseAdCreatives(size_t index) const;
+  void PrefetchAdBreak(size_t index);
+  void AbandonAdPrefetch();
+  void EndAdBreak();
+  void OnAdStarted();
+  void OnAdFailed(uint32_t index);
+  void ReportAdError(::ReactNativeVideoCPP::VastAd const &ad, ::ReactNativeVideoCPP::VastError error);
+  void OnAdBreakEnded(bool skipped);
+  void AdvanceAd(double position);
+  void FinishAd();
+  void DispatchAdEvent(std::wstring_view event);
+
+  // server-side inserted ad breaks, read from the cues of the stream's HLS playlist
+  void ResetAdCues();
+  void ResumeAdCueWatch();
+  bool ShouldPollAdCues() const;
+  fire_and_forget WatchAdCues(hstring uri, uint64_t watch, std::shared_ptr<AdCueWatchState> state);
+  void AnchorAdCues(AdCueWatchState const &state);
+  void DispatchAdCueEvent(::ReactNativeVideoCPP::AdCueEvent event, ::ReactNativeVideoCPP::AdCueBreak const &adBreak);
+
+  // registers the playback state block and QoE collector under the view's React tag
+  void RegisterPlaybackState();
+  void UnregisterPlaybackState();
+  void PublishPlaybackState();
+
+  friend class ProgressClock;
+  void UpdateProgressSubscription();
+  void OnProgressTick();
+};
+} // namespace winrt::ReactNativeVideoCPP::implementation
+namespace winrt::ReactNativeVideoCPP::factory_implementation {
+struct ReactVideoView : ReactVideoViewT<ReactVideoView, implementation::ReactVideoView> {};
+} // namespace winrt::ReactNativeVideoCPP::factory_implementation
@@ -1,113 +1,286 @@
-#include "pch.h"
-#include "ReactVideoViewManager.h"
-#include "NativeModules.h"
-#include "ReactVideoView.h"
-
-namespace winrt::ReactNativeVideoCPP::implementation {
-
-ReactVideoViewManager::ReactVideoViewManager() {}
-
-// IViewManager
-hstring ReactVideoViewManager::Name() noexcept {
-  return L"RCTVideo";
-}
-
-FrameworkElement ReactVideoViewManager::CreateView() noexcept {
-  auto reactVideoView = winrt::ReactNativeVideoCPP::ReactVideoView(m_reactContext);
-  return reactVideoView;
-}
-
-// IViewManagerWithReactContext
-IReactContext ReactVideoViewManager::ReactContext() noexcept {
-  return m_reactContext;
-}
-
-void ReactVideoViewManager::ReactContext(IReactContext reactContext) noexcept {
-  m_reactContext = reactContext;
-}
-
-// IViewManagerWithExportedViewConstants
-winrt::Microsoft::ReactNative::ConstantProviderDelegate ReactVideoViewManager::ExportedViewConstants() noexcept {
-  return [](winrt::Microsoft::ReactNative::IJSValueWriter const &constantWriter) {
-    WriteProperty(constantWriter, L"ScaleNone", to_hstring(std::to_string((int)Stretch::None)));
-    WriteProperty(constantWriter, L"ScaleToFill", to_hstring(std::to_string((int)Stretch::UniformToFill)));
-    WriteProperty(constantWriter, L"ScaleAspectFit", to_hstring(std::to_string((int)Stretch::Uniform)));
-    WriteProperty(constantWriter, L"ScaleAspectFill", to_hstring(std::to_string((int)Stretch::Fill)));
-  };
-}
-
-// IViewManagerWithNativeProperties
-IMapView<hstring, ViewManagerPropertyType> ReactVideoViewManager::NativeProps() noexcept {
-  auto nativeProps = winrt::single_threaded_map<hstring, ViewManagerPropertyType>();
-  nativeProps.Insert(L"src", ViewManagerPropertyType::Map);
-  nativeProps.Insert(L"resizeMode", ViewManagerPropertyType::String);
-  nativeProps.Insert(L"repeat", ViewManagerPropertyType::Boolean);
-  nativeProps.Insert(L"paused", ViewManagerPropertyType::Boolean);
-  nativeProps.Insert(L"muted", ViewManagerPropertyType::Boolean);
-  nativeProps.Insert(L"volume", ViewManagerPropertyType::Number);
-  nativeProps.Insert(L"seek", ViewManagerPropertyType::Number);
-  nativeProps.Insert(L"controls", ViewManagerPropertyType::Boolean);
-  nativeProps.Insert(L"fullscreen", ViewManagerPropertyType::Boolean);
-  nativeProps.Insert(L"progressUpdateInterval", ViewManagerPropertyType::Number);
-  nativeProps.Insert(L"rate", ViewManagerPropertyType::Number);
-
-  return nativeProps.GetView();
-}
-
-void ReactVideoViewManager::UpdateProperties(
-    FrameworkElement const &view,
-    IJSValueReader const &propertyMapReader) noexcept {
-  if (auto reactVideoView = view.try_as<winrt::ReactNativeVideoCPP::ReactVideoView>()) {
-    const JSValueObject &propertyMap = JSValue::ReadObjectFrom(propertyMapReader);
-
-    for (auto const &pair : propertyMap) {
-      auto const &propertyName = pair.first;
-      auto const &propertyValue = pair.second;
-      if (!propertyValue.IsNull()) {
-        if (propertyName == "src") {
-          auto const &srcMap = propertyValue.AsObject();
-          auto const &uri = srcMap.at("uri");
-          reactVideoView.Set_UriString(to_hstring(uri.AsString()));
-        } else if (propertyName == "resizeMode") {
-          reactVideoView.Stretch(static_cast<Stretch>(std::stoul(propertyValue.AsString())));
-        } else if (propertyName == "repeat") {
-          reactVideoView.Set_IsLoopingEnabled(propertyValue.AsBoolean());
-        } else if (propertyName == "paused") {
-          m_paused = propertyValue.AsBoolean();
-          reactVideoView.Set_Paused(m_paused);
-        } else if (propertyName == "muted") {
-          reactVideoView.Set_Muted(propertyValue.AsBoolean());
-        } else if (propertyName == "volume") {
-          reactVideoView.Set_Volume(propertyValue.AsDouble());
-        } else if (propertyName == "seek") {
-          reactVideoView.Set_Position(propertyValue.AsDouble());
-        } else if (propertyName == "controls") {
-          reactVideoView.Set_Controls(propertyValue.AsBoolean());
-        } else if (propertyName == "fullscreen") {
-          reactVideoView.Set_FullScreen(propertyValue.AsBoolean());
-        } else if (propertyName == "progressUpdateInterval") {
-          reactVideoView.Set_ProgressUpdateInterval(propertyValue.AsInt64());
-        } else if (propertyName == "rate") {
-          reactVideoView.Set_PlaybackRate(propertyValue.AsDouble());
-        }
-      }
-    }
-    reactVideoView.Set_AutoPlay(!m_paused); // auto play on pause false or not set.
-  }
-}
-
-// IViewManagerWithExportedEventTypeConstants
-ConstantProviderDelegate ReactVideoViewManager::ExportedCustomBubblingEventTypeConstants() noexcept {
-  return nullptr;
-}
-
-ConstantProviderDelegate ReactVideoViewManager::ExportedCustomDirectEventTypeConstants() noexcept {
-  return [](winrt::Microsoft::ReactNative::IJSValueWriter const &constantWriter) {
-    WriteCustomDirectEventTypeConstant(constantWriter, "Load");
-    WriteCustomDirectEventTypeConstant(constantWriter, "End");
-    WriteCustomDirectEventTypeConstant(constantWriter, "Seek");
-    WriteCustomDirectEventTypeConstant(constantWriter, "Progress");
-  };
-}
-
-} // namespace winrt::ReactNativeVideoCPP::implementation
+#include "pch.h"
+#include "ReactVideoViewManager.h"
+#include <charconv>
+#include "NativeModules.h"
+#include "AbrController.h"
+#include "PropertyDispatcher.h"
+#include "ReactVideoView.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+using ::ReactNativeVideoCPP::MakePropertyDispatcher;
+using ::ReactNativeVideoCPP::PropertyEntry;
+
+ReactVideoViewManager::ReactVideoViewManager() {}
+
+// IViewManager
+hstring ReactVideoViewManager::Name() noexcept {
+  return L"RCTVideo";
+}
+
+FrameworkElement ReactVideoViewManager::CreateView() noexcept {
+  auto reactVideoView = winrt::ReactNativeVideoCPP::ReactVideoView(m_reactContext);
+  return reactVideoView;
+}
+
+// IViewManagerWithReactContext
+IReactContext ReactVideoViewManager::ReactContext() noexcept {
+  return m_reactContext;
+}
+
+void ReactVideoViewManager::ReactContext(IReactContext reactContext) noexcept {
+  m_reactContext = reactContext;
+}
+
+// IViewManagerWithExportedViewConstants
+winrt::Microsoft::ReactNative::ConstantProviderDelegate ReactVideoViewManager::ExportedViewConstants() noexcept {
+  return [](winrt::Microsoft::ReactNative::IJSValueWriter const &constantWriter) {
+    WriteProperty(constantWriter, L"ScaleNone", to_hstring(std::to_string((int)Stretch::None)));
+    WriteProperty(constantWriter, L"ScaleToFill", to_hstring(std::to_string((int)Stretch::UniformToFill)));
+    WriteProperty(constantWriter, L"ScaleAspectFit", to_hstring(std::to_string((int)Stretch::Uniform)));
+    WriteProperty(constantWriter, L"ScaleAspectFill", to_hstring(std::to_string((int)Stretch::Fill)));
+  };
+}
+
+// IViewManagerWithNativeProperties
+IMapView<hstring, ViewManagerPropertyType> ReactVideoViewManager::NativeProps() noexcept {
+  auto nativeProps = winrt::single_threaded_map<hstring, ViewManagerPropertyType>();
+  nativeProps.Insert(L"src", ViewManagerPropertyType::Map);
+  nativeProps.Insert(L"resizeMode", ViewManagerPropertyType::String);
+  nativeProps.Insert(L"repeat", ViewManagerPropertyType::Boolean);
+  nativeProps.Insert(L"paused", ViewManagerPropertyType::Boolean);
+  nativeProps.Insert(L"muted", ViewManagerPropertyType::Boolean);
+  nativeProps.Insert(L"volume", ViewManagerPropertyType::Number);
+  nativeProps.Insert(L"seek", ViewManagerPropertyType::Map);
+  nativeProps.Insert(L"controls", ViewManagerPropertyType::Boolean);
+  nativeProps.Insert(L"fullscreen", ViewManagerPropertyType::Boolean);
+  nativeProps.Insert(L"progressUpdateInterval", ViewManagerPropertyType::Number);
+  nativeProps.Insert(L"rate", ViewManagerPropertyType::Number);
+  nativeProps.Insert(L"reportBandwidth", ViewManagerPropertyType::Boolean);
+  nativeProps.Insert(L"maxBitRate", ViewManagerPropertyType::Number);
+  nativeProps.Insert(L"bufferConfig", ViewManagerPropertyType::Map);
+  nativeProps.Insert(L"viewportOversampling", ViewManagerPropertyType::Number);
+  nativeProps.Insert(L"adTagUrl", ViewManagerPropertyType::String);
+  nativeProps.Insert(L"reportAdCues", ViewManagerPropertyType::Boolean);
+
+  return nativeProps.GetView();
+}
+
+namespace {
+
+struct PropertyContext {
+  winrt::ReactNativeVideoCPP::ReactVideoView const &view;
+  bool &paused;
+};
+
+using PropertySetter = void (*)(PropertyContext &, IJSValueReader const &);
+
+// Scalars are read through JSValue so they coerce like the AsDouble/AsBoolean of a JSValueObject did: JS
+// numbers arrive as Int64 or Double depending on their value (`volume: 1` is an Int64), and the typed
+// getters of the reader do not convert between the two.
+double ReadDouble(IJSValueReader const &reader) {
+  return JSValue::ReadFrom(reader).AsDouble();
+}
+
+bool ReadBoolean(IJSValueReader const &reader) {
+  return JSValue::ReadFrom(reader).AsBoolean();
+}
+
+int64_t ReadInt64(IJSValueReader const &reader) {
+  return JSValue::ReadFrom(reader).AsInt64();
+}
+
+hstring ReadString(IJSValueReader const &reader) {
+  return reader.ValueType() == JSValueType::String ? reader.GetString()
+                                                   : to_hstring(JSValue::ReadFrom(reader).AsString());
+}
+
+void SetSrc(PropertyContext &context, IJSValueReader const &reader) {
+  if (reader.ValueType() != JSValueType::Object) {
+    JSValue::ReadFrom(reader);
+    return;
+  }
+  hstring name;
+  hstring uri;
+  bool hasUri = false;
+  bool shouldCache = false;
+  while (reader.GetNextObjectProperty(name)) {
+    if (name == L"uri" && reader.ValueType() == JSValueType::String) {
+      uri = reader.GetString();
+      hasUri = true;
+    } else if (name == L"shouldCache") {
+      shouldCache = ReadBoolean(reader);
+    } else {
+      JSValue::ReadFrom(reader); // skip
+    }
+  }
+  // the source is created as soon as the uri is set, so it must already know whether to cache
+  context.view.Set_ShouldCache(shouldCache);
+  if (hasUri) {
+    context.view.Set_UriString(uri);
+  }
+}
+
+// seek is either a plain number of seconds or {time, tolerance} with the tolerance in milliseconds
+void SetSeek(PropertyContext &context, IJSValueReader const &reader) {
+  if (reader.ValueType() != JSValueType::Object) {
+    context.view.Set_Position(ReadDouble(reader));
+    return;
+  }
+  double time = 0;
+  double tolerance = 0;
+  hstring name;
+  while (reader.GetNextObjectProperty(name)) {
+    if (name == L"time") {
+      time = ReadDouble(reader);
+    } else if (name == L"tolerance") {
+      tolerance = ReadDouble(reader);
+    } else {
+      JSValue::ReadFrom(reader); // skip
+    }
+  }
+  context.view.Set_Seek(time, tolerance);
+}
+
+// bufferConfig may set any subset of its thresholds, the rest keep their defaults
+void SetBufferConfig(PropertyContext &context, IJSValueReader const &reader) {
+  if (reader.ValueType() != JSValueType::Object) {
+    JSValue::ReadFrom(reader);
+    return;
+  }
+  ::ReactNativeVideoCPP::AbrBufferConfig config;
+  hstring name;
+  while (reader.GetNextObjectProperty(name)) {
+    if (reader.ValueType() != JSValueType::Double && reader.ValueType() != JSValueType::Int64) {
+      JSValue::ReadFrom(reader); // skip
+    } else if (name == L"minBufferMs") {
+      config.minBufferMs = ReadDouble(reader);
+    } else if (name == L"maxBufferMs") {
+      config.maxBufferMs = ReadDouble(reader);
+    } else if (name == L"bufferForPlaybackMs") {
+      config.bufferForPlaybackMs = ReadDouble(reader);
+    } else if (name == L"bufferForPlaybackAfterRebufferMs") {
+      config.bufferForPlaybackAfterRebufferMs = ReadDouble(reader);
+    } else {
+      JSValue::ReadFrom(reader); // skip
+    }
+  }
+  context.view.Set_BufferConfig(
+      config.minBufferMs, config.maxBufferMs, config.bufferForPlaybackMs, config.bufferForPlaybackAfterRebufferMs);
+}
+
+// resizeMode is one of the exported Scale* constants, a number in a string; anything else is ignored rather
+// than thrown out of the noexcept UpdateProperties
+void SetResizeMode(PropertyContext &context, IJSValueReader const &reader) {
+  auto value = JSValue::ReadFrom(reader);
+  uint32_t stretch = 0;
+  if (value.Type() == JSValueType::String) {
+    auto text = value.AsString();
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), stretch);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+      return;
+    }
+  } else {
+    stretch = value.AsUInt32();
+  }
+  if (stretch > static_cast<uint32_t>(Stretch::UniformToFill)) {
+    return;
+  }
+  context.view.Stretch(static_cast<Stretch>(stretch));
+}
+
+constexpr PropertyEntry<PropertySetter> c_propertySetters[] = {
+    {"src", &SetSrc},
+    {"resizeMode", &SetResizeMode},
+    {"repeat",
+     [](PropertyContext &context, IJSValueReader const &reader) {
+       context.view.Set_IsLoopingEnabled(ReadBoolean(reader));
+     }},
+    {"paused",
+     [](PropertyContext &context, IJSValueReader const &reader) {
+       context.paused = ReadBoolean(reader);
+       context.view.Set_Paused(context.paused);
+     }},
+    {"muted",
+     [](PropertyContext &context, IJSValueReader const &reader) { context.view.Set_Muted(ReadBoolean(reader)); }},
+    {"volume",
+     [](PropertyContext &context, IJSValueReader const &reader) { context.view.Set_Volume(ReadDouble(reader)); }},
+    {"seek", &SetSeek},
+    {"controls",
+     [](PropertyContext &context, IJSValueReader const &reader) { context.view.Set_Controls(ReadBoolean(reader)); }},
+    {"fullscreen",
+     [](PropertyContext &context, IJSValueReader const &reader) {
+       context.view.Set_FullScreen(ReadBoolean(reader));
+     }},
+    {"progressUpdateInterval",
+     [](PropertyContext &context, IJSValueReader const &reader) {
+       context.view.Set_ProgressUpdateInterval(ReadInt64(reader));
+     }},
+    {"rate",
+     [](PropertyContext &context, IJSValueReader const &reader) {
+       context.view.Set_PlaybackRate(ReadDouble(reader));
+     }},
+    {"reportBandwidth",
+     [](PropertyContext &context, IJSValueReader const &reader) {
+       context.view.Set_ReportBandwidth(ReadBoolean(reader));
+     }},
+    {"maxBitRate",
+     [](PropertyContext &context, IJSValueReader const &reader) { context.view.Set_MaxBitRate(ReadDouble(reader)); }},
+    {"bufferConfig", &SetBufferConfig},
+    {"viewportOversampling",
+     [](PropertyContext &context, IJSValueReader const &reader) {
+       context.view.Set_ViewportOversampling(ReadDouble(reader));
+     }},
+    {"adTagUrl",
+     [](PropertyContext &context, IJSValueReader const &reader) { context.view.Set_AdTagUrl(ReadString(reader)); }},
+    {"reportAdCues",
+     [](PropertyContext &context, IJSValueReader const &reader) {
+       context.view.Set_ReportAdCues(ReadBoolean(reader));
+     }},
+};
+
+constexpr auto c_propertyDispatcher = MakePropertyDispatcher(c_propertySetters);
+
+} // namespace
+
+void ReactVideoViewManager::UpdateProperties(
+    FrameworkElement const &view,
+    IJSValueReader const &propertyMapReader) noexcept {
+  if (auto reactVideoView = view.try_as<winrt::ReactNativeVideoCPP::ReactVideoView>()) {
+    PropertyContext context{reactVideoView, m_paused};
+
+    // Values are read straight off the reader and routed through the perfect-hash table above, so no
+    // intermediate JSValueObject is built for the update.
+    if (propertyMapReader.ValueType() == JSValueType::Object) {
+      hstring propertyName;
+      while (propertyMapReader.GetNextObjectProperty(propertyName)) {
+        auto setter = c_propertyDispatcher.Find(std::wstring_view{propertyName});
+        if (setter != nullptr && propertyMapReader.ValueType() != JSValueType::Null) {
+          setter(context, propertyMapReader);
+        } else {
+          JSValue::ReadFrom(propertyMapReader); // skip
+        }
+      }
+    }
+    reactVideoView.Set_AutoPlay(!m_paused); // auto play on pause false or not set.
+  }
+}
+
+// IViewManagerWithExportedEventTypeConstants
+ConstantProviderDelegate ReactVideoViewManager::ExportedCustomBubblingEventTypeConstants() noexcept {
+  return nullptr;
+}
+
+ConstantProviderDelegate ReactVideoViewManager::ExportedCustomDirectEventTypeConstants() noexcept {
+  return [](winrt::Microsoft::ReactNative::IJSValueWriter const &constantWriter) {
+    WriteCustomDirectEventTypeConstant(constantWriter, "Load");
+    WriteCustomDirectEventTypeConstant(constantWriter, "End");
+    WriteCustomDirectEventTypeConstant(constantWriter, "Seek");
+    WriteCustomDirectEventTypeConstant(constantWriter, "Progress");
+    WriteCustomDirectEventTypeConstant(constantWriter, "VideoBandwidthUpdate");
+    WriteCustomDirectEventTypeConstant(constantWriter, "ReceiveAdEvent");
+    WriteCustomDirectEventTypeConstant(constantWriter, "AdCue");
+  };
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
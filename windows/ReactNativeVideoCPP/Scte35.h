@@ -0,0 +1,347 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Portable (WinRT-free) decoder of SCTE-35 splice_info_section payloads, as HLS playlists carry them: hex
+// ("0xFC30...") in the SCTE35-OUT / SCTE35-IN / SCTE35-CMD attributes of EXT-X-DATERANGE, base64 in the
+// EXT-OATCLS-SCTE35 tag next to EXT-X-CUE-OUT. Only what places an ad break on the timeline is kept: the
+// splice_insert flags, splice time and break duration, and the type and duration of each segmentation
+// descriptor. Sections that are encrypted, truncated or fail their CRC are rejected.
+namespace ReactNativeVideoCPP {
+
+constexpr double c_spliceTicksPerSecond = 90000;
+
+enum class SpliceCommandType : uint8_t {
+  Null = 0x00,
+  Schedule = 0x04,
+  Insert = 0x05,
+  TimeSignal = 0x06,
+  BandwidthReservation = 0x07,
+  Private = 0xff,
+};
+
+struct SegmentationDescriptor {
+  uint32_t eventId = 0;
+  bool cancelled = false;
+  uint8_t typeId = 0; // segmentation_type_id, e.g. 0x34 provider placement opportunity start
+  bool hasDuration = false;
+  uint64_t durationTicks = 0; // 90 kHz
+  uint8_t segmentNum = 0;
+  uint8_t segmentsExpected = 0;
+};
+
+struct SpliceInfo {
+  SpliceCommandType command = SpliceCommandType::Null;
+  uint64_t ptsAdjustment = 0;
+  // splice_insert
+  uint32_t eventId = 0;
+  bool cancelled = false;
+  bool outOfNetwork = false; // true at the start of a break, false at the return to the network
+  bool immediate = false;
+  bool autoReturn = false;
+  // splice_insert and time_signal
+  bool hasTime = false;
+  uint64_t ptsTime = 0; // 90 kHz, pts_adjustment applied, wrapped to 33 bits
+  bool hasDuration = false;
+  uint64_t durationTicks = 0; // 90 kHz
+  std::vector<SegmentationDescriptor> segmentations;
+
+  // Whether this section opens or closes an ad break: a splice_insert out of / back into the network, or a
+  // time_signal with a break, ad or placement opportunity start / end segmentation.
+  bool IsBreakStart() const {
+    return Signals(true);
+  }
+
+  bool IsBreakEnd() const {
+    return Signals(false);
+  }
+
+  // The planned break length in seconds, 0 when the section does not give one.
+  double DurationSeconds() const {
+    if (hasDuration) {
+      return static_cast<double>(durationTicks) / c_spliceTicksPerSecond;
+    }
+    for (auto const &segmentation : segmentations) {
+      if (!segmentation.cancelled && segmentation.hasDuration && IsStartSegmentation(segmentation.typeId)) {
+        return static_cast<double>(segmentation.durationTicks) / c_spliceTicksPerSecond;
+      }
+    }
+    return 0;
+  }
+
+  static bool IsStartSegmentation(uint8_t typeId) {
+    // break, provider / distributor advertisement and placement opportunity starts
+    return typeId == 0x22 || typeId == 0x30 || typeId == 0x32 || typeId == 0x34 || typeId == 0x36;
+  }
+
+  static bool IsEndSegmentation(uint8_t typeId) {
+    return typeId == 0x23 || typeId == 0x31 || typeId == 0x33 || typeId == 0x35 || typeId == 0x37;
+  }
+
+ private:
+  bool Signals(bool start) const {
+    if (command == SpliceCommandType::Insert) {
+      return !cancelled && outOfNetwork == start;
+    }
+    for (auto const &segmentation : segmentations) {
+      if (!segmentation.cancelled &&
+          (start ? IsStartSegmentation(segmentation.typeId) : IsEndSegmentation(segmentation.typeId))) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+// MSB-first reader over a byte span. Reads past the end yield zeros and set |overrun|.
+class SpliceBitReader {
+ public:
+  SpliceBitReader(uint8_t const *data, size_t size) : m_data(data), m_size(size) {}
+
+  uint64_t Read(uint32_t bits) {
+    uint64_t value = 0;
+    for (uint32_t i = 0; i < bits; ++i) {
+      auto byte = m_bit / 8;
+      if (byte >= m_size) {
+        overrun = true;
+        return 0;
+      }
+      value = (value << 1) | ((m_data[byte] >> (7 - m_bit % 8)) & 1);
+      ++m_bit;
+    }
+    return value;
+  }
+
+  // Byte offset of the next read; only meaningful on a byte boundary.
+  size_t Offset() const {
+    return m_bit / 8;
+  }
+
+  void Seek(size_t offset) {
+    m_bit = offset * 8;
+  }
+
+  bool overrun = false;
+
+ private:
+  uint8_t const *m_data;
+  size_t m_size;
+  size_t m_bit = 0;
+};
+
+// CRC-32/MPEG-2, which the section's own CRC_32 makes zero.
+inline uint32_t SpliceCrc32(uint8_t const *data, size_t size) {
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= static_cast<uint32_t>(data[i]) << 24;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+namespace detail {
+
+constexpr uint64_t c_ptsMask = (uint64_t{1} << 33) - 1;
+
+// splice_time(); |hasTime| stays false for a time left unspecified (splice immediately).
+inline void ReadSpliceTime(SpliceBitReader &reader, SpliceInfo &info) {
+  info.hasTime = reader.Read(1) != 0;
+  if (info.hasTime) {
+    reader.Read(6);
+    info.ptsTime = (reader.Read(33) + info.ptsAdjustment) & c_ptsMask;
+  } else {
+    reader.Read(7);
+  }
+}
+
+inline void ReadSpliceInsert(SpliceBitReader &reader, SpliceInfo &info) {
+  info.eventId = static_cast<uint32_t>(reader.Read(32));
+  info.cancelled = reader.Read(1) != 0;
+  reader.Read(7);
+  if (info.cancelled) {
+    return;
+  }
+  info.outOfNetwork = reader.Read(1) != 0;
+  bool programSplice = reader.Read(1) != 0;
+  bool hasDuration = reader.Read(1) != 0;
+  info.immediate = reader.Read(1) != 0;
+  reader.Read(4);
+  if (programSplice && !info.immediate) {
+    ReadSpliceTime(reader, info);
+  }
+  if (!programSplice) {
+    // component splices; the first component's time stands for the program
+    auto components = reader.Read(8);
+    for (uint64_t i = 0; i < components; ++i) {
+      reader.Read(8);
+      if (!info.immediate) {
+        bool hadTime = info.hasTime;
+        auto ptsTime = info.ptsTime;
+        ReadSpliceTime(reader, info);
+        if (hadTime) {
+          info.hasTime = true;
+          info.ptsTime = ptsTime;
+        }
+      }
+    }
+  }
+  if (hasDuration) {
+    info.autoReturn = reader.Read(1) != 0;
+    reader.Read(6);
+    info.hasDuration = true;
+    info.durationTicks = reader.Read(33);
+  }
+  // unique_program_id, avail_num and avails_expected are not needed
+}
+
+// The rest of a segmentation_descriptor() after its tag, length and "CUEI" identifier.
+inline void ReadSegmentation(SpliceBitReader &reader, SegmentationDescriptor &segmentation) {
+  segmentation.eventId = static_cast<uint32_t>(reader.Read(32));
+  segmentation.cancelled = reader.Read(1) != 0;
+  reader.Read(7);
+  if (segmentation.cancelled) {
+    return;
+  }
+  bool programSegmentation = reader.Read(1) != 0;
+  segmentation.hasDuration = reader.Read(1) != 0;
+  reader.Read(6); // delivery_not_restricted and its restriction flags
+  if (!programSegmentation) {
+    auto components = reader.Read(8);
+    for (uint64_t i = 0; i < components; ++i) {
+      reader.Read(48); // component_tag, reserved and pts_offset
+    }
+  }
+  if (segmentation.hasDuration) {
+    segmentation.durationTicks = reader.Read(40);
+  }
+  reader.Read(8); // segmentation_upid_type
+  auto upidLength = reader.Read(8);
+  reader.Read(static_cast<uint32_t>(upidLength * 8));
+  segmentation.typeId = static_cast<uint8_t>(reader.Read(8));
+  segmentation.segmentNum = static_cast<uint8_t>(reader.Read(8));
+  segmentation.segmentsExpected = static_cast<uint8_t>(reader.Read(8));
+}
+
+} // namespace detail
+
+// Decodes one splice_info_section. Returns false when it is malformed, encrypted or fails its CRC.
+inline bool DecodeSpliceInfo(uint8_t const *data, size_t size, SpliceInfo &info) {
+  constexpr uint32_t c_cueIdentifier = 0x43554549; // "CUEI"
+  constexpr uint64_t c_legacyCommandLength = 0xfff; // length not given, the command is parsed to find its end
+
+  info = SpliceInfo{};
+  SpliceBitReader reader(data, size);
+  if (reader.Read(8) != 0xfc) {
+    return false;
+  }
+  reader.Read(4); // section_syntax_indicator, private_indicator, sap_type
+  auto sectionLength = reader.Read(12);
+  if (sectionLength + 3 > size || sectionLength < 17 || SpliceCrc32(data, sectionLength + 3) != 0) {
+    return false;
+  }
+  reader.Read(8); // protocol_version
+  if (reader.Read(1) != 0) {
+    return false; // encrypted_packet
+  }
+  reader.Read(6); // encryption_algorithm
+  info.ptsAdjustment = reader.Read(33);
+  reader.Read(8 + 12); // cw_index, tier
+  auto commandLength = reader.Read(12);
+  info.command = static_cast<SpliceCommandType>(reader.Read(8));
+  auto commandStart = reader.Offset();
+  if (info.command == SpliceCommandType::Insert) {
+    detail::ReadSpliceInsert(reader, info);
+  } else if (info.command == SpliceCommandType::TimeSignal) {
+    detail::ReadSpliceTime(reader, info);
+  } else if (commandLength == c_legacyCommandLength && info.command != SpliceCommandType::Null &&
+             info.command != SpliceCommandType::BandwidthReservation) {
+    return false; // a schedule or private command of unknown length hides where the descriptors start
+  }
+  if (commandLength != c_legacyCommandLength) {
+    reader.Seek(commandStart + static_cast<size_t>(commandLength));
+  }
+
+  auto loopLength = reader.Read(16);
+  auto loopEnd = reader.Offset() + static_cast<size_t>(loopLength);
+  while (!reader.overrun && reader.Offset() + 2 <= loopEnd) {
+    auto tag = reader.Read(8);
+    auto length = reader.Read(8);
+    auto descriptorEnd = reader.Offset() + static_cast<size_t>(length);
+    if (tag == 0x02 && length >= 9 && reader.Read(32) == c_cueIdentifier) {
+      SegmentationDescriptor segmentation;
+      detail::ReadSegmentation(reader, segmentation);
+      info.segmentations.push_back(segmentation);
+    }
+    reader.Seek(descriptorEnd);
+  }
+  return !reader.overrun && loopEnd + 4 <= sectionLength + 3;
+}
+
+// Decodes a section written as hex ("0xFC30..." or "FC30...") or base64. Returns false when the text is
+// neither, or the section does not decode.
+inline bool DecodeSpliceInfoText(std::string_view text, SpliceInfo &info) {
+  auto hexDigit = [](char c) {
+    return c >= '0' && c <= '9' ? c - '0'
+        : c >= 'a' && c <= 'f'  ? c - 'a' + 10
+        : c >= 'A' && c <= 'F'  ? c - 'A' + 10
+                                : -1;
+  };
+  auto base64Digit = [](char c) {
+    return c >= 'A' && c <= 'Z' ? c - 'A'
+        : c >= 'a' && c <= 'z'  ? c - 'a' + 26
+        : c >= '0' && c <= '9'  ? c - '0' + 52
+        : c == '+' || c == '-'  ? 62
+        : c == '/' || c == '_'  ? 63
+                                : -1;
+  };
+
+  std::vector<uint8_t> bytes;
+  bool isHex = text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X');
+  if (isHex) {
+    text.remove_prefix(2);
+  } else {
+    // a section always starts with table_id 0xFC, which base64 spells "/"
+    isHex = text.size() >= 2 && hexDigit(text[0]) == 0xf && hexDigit(text[1]) == 0xc;
+  }
+  if (isHex) {
+    if (text.size() % 2 != 0) {
+      return false;
+    }
+    bytes.reserve(text.size() / 2);
+    for (size_t i = 0; i < text.size(); i += 2) {
+      auto high = hexDigit(text[i]);
+      auto low = hexDigit(text[i + 1]);
+      if (high < 0 || low < 0) {
+        return false;
+      }
+      bytes.push_back(static_cast<uint8_t>(high << 4 | low));
+    }
+  } else {
+    bytes.reserve(text.size() * 3 / 4);
+    uint32_t accumulator = 0;
+    int bits = 0;
+    for (auto c : text) {
+      if (c == '=') {
+        break;
+      }
+      auto digit = base64Digit(c);
+      if (digit < 0) {
+        return false;
+      }
+      accumulator = (accumulator << 6) | static_cast<uint32_t>(digit);
+      bits += 6;
+      if (bits >= 8) {
+        bits -= 8;
+        bytes.push_back(static_cast<uint8_t>(accumulator >> bits));
+      }
+    }
+  }
+  return DecodeSpliceInfo(bytes.data(), bytes.size(), info);
+}
+
+} // namespace ReactNativeVideoCPP
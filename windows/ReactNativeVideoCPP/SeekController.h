@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Portable (WinRT-free) seek coalescing. At most one seek is handed to the player at a time; requests
+// arriving while it is in flight replace each other, so dragging a scrub bar ends in a single trailing
+// seek to the latest position instead of a queue of stale ones.
+//
+// The player reports one completion per seek, so while a seek is in flight the next completion is its own,
+// even when the player clamped it (past the end of the media) or landed it elsewhere; only completions
+// with nothing in flight are seeks the player made on its own (e.g. from the transport controls). A seek
+// whose completion never arrives is given up by Expire() so the pending seek behind it still gets issued;
+// should that completion turn up late after all, it is recognised by its landing and swallowed.
+namespace ReactNativeVideoCPP {
+
+struct SeekRequest {
+  double requested = 0; // seconds, as asked for by JS
+  double target = 0; // seconds, after optional keyframe snapping
+  uint64_t id = 0; // set when the seek is issued
+};
+
+struct SeekStats {
+  uint64_t requested = 0;
+  uint64_t issued = 0;
+  uint64_t coalesced = 0;
+  uint64_t snapped = 0;
+  uint64_t unattributed = 0; // completions of seeks the controller did not issue
+  uint64_t offTarget = 0; // completions of issued seeks that landed further than c_landingSlack from the target
+  uint64_t expired = 0;
+};
+
+class SeekController {
+ public:
+  // Returns the seek to issue now, or nullopt when one is already in flight (the request is then kept as
+  // the pending seek, replacing any earlier pending one). |toleranceSeconds| > 0 lets the target snap to
+  // the nearest known keyframe within that distance, which makes the seek cheaper for the decoder.
+  std::optional<SeekRequest> Request(double seconds, double toleranceSeconds = 0) {
+    ++m_stats.requested;
+    SeekRequest seek{seconds, Clamp(Snap(seconds, toleranceSeconds))};
+    if (m_inFlight) {
+      if (m_pending) {
+        ++m_stats.coalesced;
+      }
+      m_pending = seek;
+      return std::nullopt;
+    }
+    return Issue(seek);
+  }
+
+  struct Completion {
+    std::optional<SeekRequest> completed; // the seek that finished, if it was issued by this controller
+    std::optional<SeekRequest> next; // pending seek to issue now
+    bool playerSeek = false; // nothing was in flight: a seek the player made on its own
+  };
+
+  // How far from its (clamped) target a seek may land and still count as on target, in seconds.
+  static constexpr double c_landingSlack = 1;
+
+  // Called when the player reports a finished seek that landed at |landedSeconds|.
+  Completion OnSeekCompleted(double landedSeconds) {
+    // the completion of an expired seek arriving after all belongs to neither side
+    if (m_expired && std::abs(landedSeconds - Clamp(m_expired->target)) <= c_landingSlack &&
+        !(m_inFlight && std::abs(landedSeconds - Clamp(m_inFlight->target)) <= c_landingSlack)) {
+      m_expired.reset();
+      return {};
+    }
+    if (!m_inFlight) {
+      ++m_stats.unattributed;
+      Completion completion;
+      completion.playerSeek = true;
+      return completion;
+    }
+    // the range may only have become known after the seek was issued
+    if (std::abs(landedSeconds - Clamp(m_inFlight->target)) > c_landingSlack) {
+      ++m_stats.offTarget;
+    }
+    m_expired.reset(); // the player completes seeks in order, so its completion is not coming any more
+    return Complete();
+  }
+
+  // Gives up on seek |id| if it is still in flight, as if it had completed, so the pending seek goes next.
+  // Returns an empty completion when the seek already completed.
+  Completion Expire(uint64_t id) {
+    if (!m_inFlight || m_inFlight->id != id) {
+      return {};
+    }
+    ++m_stats.expired;
+    m_expired = m_inFlight;
+    return Complete();
+  }
+
+  // Forgets in-flight and pending seeks and the seekable range, e.g. when the source changes.
+  void Reset() {
+    m_inFlight.reset();
+    m_pending.reset();
+    m_expired.reset();
+    m_seekableStart = 0;
+    m_seekableEnd = std::numeric_limits<double>::infinity();
+  }
+
+  // Seconds the player can seek within, e.g. its seekable ranges or [0, NaturalDuration]. Targets outside
+  // are clamped into it, as the player would.
+  void SetSeekableRange(double start, double end) {
+    if (end >= start) {
+      m_seekableStart = start;
+      m_seekableEnd = end;
+    }
+  }
+
+  // Sorted presentation times (seconds) of seekable keyframes, e.g. segment starts. Empty disables
+  // snapping.
+  void SetKeyframes(std::vector<double> keyframes) {
+    m_keyframes = std::move(keyframes);
+  }
+
+  bool IsSeeking() const {
+    return m_inFlight.has_value();
+  }
+
+  SeekStats const &Stats() const {
+    return m_stats;
+  }
+
+ private:
+  SeekRequest Issue(SeekRequest seek) {
+    ++m_stats.issued;
+    seek.id = m_stats.issued;
+    m_inFlight = seek;
+    return seek;
+  }
+
+  Completion Complete() {
+    Completion completion;
+    completion.completed = std::exchange(m_inFlight, std::nullopt);
+    if (m_pending) {
+      completion.next = Issue(*std::exchange(m_pending, std::nullopt));
+    }
+    return completion;
+  }
+
+  double Clamp(double seconds) const {
+    return std::min(std::max(seconds, m_seekableStart), m_seekableEnd);
+  }
+
+  double Snap(double seconds, double toleranceSeconds) {
+    if (toleranceSeconds <= 0 || m_keyframes.empty()) {
+      return seconds;
+    }
+    auto it = std::lower_bound(m_keyframes.begin(), m_keyframes.end(), seconds);
+    double nearest = it != m_keyframes.end() ? *it : m_keyframes.back();
+    if (it != m_keyframes.begin() && (it == m_keyframes.end() || seconds - *(it - 1) < *it - seconds)) {
+      nearest = *(it - 1);
+    }
+    if (std::abs(nearest - seconds) > toleranceSeconds) {
+      return seconds;
+    }
+    ++m_stats.snapped;
+    return nearest;
+  }
+
+  std::optional<SeekRequest> m_inFlight;
+  std::optional<SeekRequest> m_pending;
+  std::optional<SeekRequest> m_expired; // the last seek given up on, until its late completion shows up
+  std::vector<double> m_keyframes;
+  double m_seekableStart = 0;
+  double m_seekableEnd = std::numeric_limits<double>::infinity();
+  SeekStats m_stats;
+};
+
+} // namespace ReactNativeVideoCPP
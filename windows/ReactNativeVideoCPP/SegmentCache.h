@@ -0,0 +1,573 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "CacheJournal.h"
+#include "MappedFile.h"
+
+// Portable (WinRT-free) on-disk media segment cache under a byte budget. Each entry is one file named after
+// the hash of its key (resource URI plus byte range) and a version, holding the key and the payload; reads
+// map the file so concurrent readers share one mapping and never copy. Every Put writes a new version
+// instead of replacing the file in place, because Windows can neither delete nor rename over a file that
+// is mapped: a version that is replaced or evicted while mapped is deleted by its last reader instead.
+// Eviction is least recently used, or least frequently used with recency breaking ties, both in O(1)
+// through per-frequency recency lists (LRU is simply LFU that never bumps a frequency). The index of
+// entries is kept in a CacheJournal, so opening a large cache reads no entry file and a crash loses at
+// most the last change, plus the recency of the last few reads: a hit only reorders memory and is
+// journaled in a batch, never under the lock. The folder is only listed, to sweep files no entry owns
+// (left behind by a process that died first), and a damaged journal is rebuilt from that listing. The
+// journal is compacted by writers, with the snapshot written outside the lock.
+namespace ReactNativeVideoCPP {
+
+enum class SegmentCachePolicy { Lru, Lfu };
+
+struct SegmentCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t insertions = 0;
+  uint64_t evictions = 0;
+  uint64_t evictedBytes = 0;
+  uint64_t rejected = 0; // entries larger than the whole budget, or failed writes
+  uint64_t entries = 0;
+  uint64_t bytes = 0;
+  uint64_t capacityBytes = 0;
+};
+
+class SegmentCache {
+  struct Mapping;
+
+ public:
+  // A cached payload; the bytes stay valid while the item lives, even if the entry is evicted or replaced
+  // meanwhile: its file is then deleted once the last item mapping it is gone.
+  class Item {
+   public:
+    Item() = default;
+
+    std::string_view Data() const {
+      return m_data;
+    }
+
+    explicit operator bool() const {
+      return m_mapping != nullptr;
+    }
+
+   private:
+    friend class SegmentCache;
+    Item(std::shared_ptr<Mapping const> mapping, std::string_view data)
+        : m_mapping(std::move(mapping)), m_data(data) {}
+
+    std::shared_ptr<Mapping const> m_mapping;
+    std::string_view m_data;
+  };
+
+  // Opens the cache in |folder| (creating it if needed) from its journal, in the order entries were used.
+  SegmentCache(
+      std::filesystem::path folder,
+      uint64_t capacityBytes,
+      SegmentCachePolicy policy = SegmentCachePolicy::Lru)
+      : m_folder(std::move(folder)),
+        m_policy(policy),
+        m_capacityBytes(capacityBytes),
+        m_journal(m_folder) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto entries = m_journal.Open()) {
+      m_entries.reserve(entries->size());
+      for (auto const &entry : *entries) {
+        auto frequency = m_policy == SegmentCachePolicy::Lfu ? std::min(entry.frequency, c_maxFrequency) : 1u;
+        Insert(entry.hash, entry.size, entry.version, frequency);
+      }
+      if (m_journal.ShouldCompact(m_entries.size())) {
+        m_journal.Compact(EntriesLocked());
+      }
+    } else {
+      AdoptFilesLocked();
+    }
+    SweepLocked();
+    EvictLocked(0);
+  }
+
+  ~SegmentCache() {
+    m_journal.Append(CacheJournal::Op::Touch, m_touches);
+  }
+
+  SegmentCache(SegmentCache const &) = delete;
+  SegmentCache &operator=(SegmentCache const &) = delete;
+
+  // The cache key of a resource or a byte range of it; |length| 0 means the whole resource.
+  static std::string Key(std::string_view uri, uint64_t offset = 0, uint64_t length = 0) {
+    std::string key(uri);
+    if (length != 0) {
+      key.append("#").append(std::to_string(offset)).append("-").append(std::to_string(offset + length - 1));
+    }
+    return key;
+  }
+
+  Item Get(std::string_view key) {
+    auto hash = Hash(key);
+    std::vector<uint64_t> touches;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end()) {
+      ++m_stats.misses;
+      return {};
+    }
+    auto mapping = it->second.mapping.lock();
+    if (mapping == nullptr) {
+      auto mapped = std::make_shared<Mapping>(PathOf(hash, it->second.version));
+      if (!mapped->file.Open(mapped->path)) {
+        // deleted behind our back, or journaled by a Put the process did not live to finish
+        RemoveLocked(it);
+        ++m_stats.misses;
+        return {};
+      }
+      mapping = std::move(mapped);
+      it->second.mapping = mapping;
+    }
+    auto payload = Payload(mapping->file, key);
+    if (payload.data() == nullptr) {
+      ++m_stats.misses; // a hash collision with another key
+      return {};
+    }
+    Touch(it->second);
+    ++m_stats.hits;
+    // the use is journaled with a batch of others, written after unlocking; a compaction meanwhile takes
+    // the order from memory instead
+    m_touches.push_back(hash);
+    if (m_touches.size() >= c_touchBatch) {
+      touches = std::exchange(m_touches, {});
+    }
+    lock.unlock();
+    if (!touches.empty()) {
+      m_journal.Append(CacheJournal::Op::Touch, touches);
+    }
+    return Item(std::move(mapping), payload);
+  }
+
+  bool Contains(std::string_view key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.count(Hash(key)) != 0;
+  }
+
+  // Stores |bytes| under |key|, evicting as needed. Safe to call concurrently with readers of the same key,
+  // which keep seeing the previous payload, and with other writers of it: each writes its own version and
+  // the last one to start wins.
+  bool Put(std::string_view key, std::string_view bytes) {
+    auto hash = Hash(key);
+    uint64_t size = sizeof(FileHeader) + key.size() + bytes.size();
+    uint64_t version = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (size > m_capacityBytes) {
+        ++m_stats.rejected;
+        return false;
+      }
+      // journaled before the file appears, so a crash can leave an entry without a file (dropped on its
+      // first Get) but never a file the index does not know about. Until the file is written the entry is
+      // pending, and a compaction meanwhile keeps it in the snapshot rather than losing the Insert with the
+      // journal it folds in.
+      version = m_nextVersion++;
+      m_journal.Append(CacheJournal::Op::Insert, hash, size, version);
+      m_pending.emplace(version, CacheJournalEntry{hash, size, 1, version});
+    }
+    std::string file;
+    file.reserve(static_cast<size_t>(size));
+    FileHeader header{};
+    std::memcpy(header.magic, c_magic, sizeof(header.magic));
+    header.keyLength = static_cast<uint32_t>(key.size());
+    file.append(reinterpret_cast<char const *>(&header), sizeof(header)).append(key).append(bytes);
+    // the write happens outside the lock, readers and other writers carry on meanwhile; the file name is
+    // this Put's own, and so is the temporary file it is staged in
+    bool written = WriteFileAtomically(PathOf(hash, version), file);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_pending.erase(version);
+      auto it = m_entries.find(hash);
+      // a later Put of the key was journaled after this one, and so supersedes it
+      bool superseded = (it != m_entries.end() && it->second.version > version) ||
+          std::any_of(m_pending.begin(), m_pending.end(), [hash, version](auto const &pending) {
+                          return pending.second.hash == hash && pending.first > version;
+                        });
+      if (!written) {
+        // the journal goes back to the entry that stays, unless a later Put journaled its own meanwhile
+        if (!superseded && it != m_entries.end()) {
+          m_journal.Append(CacheJournal::Op::Insert, hash, it->second.size, it->second.version);
+        } else if (!superseded) {
+          m_journal.Append(CacheJournal::Op::Remove, hash);
+        }
+        ++m_stats.rejected;
+        return false;
+      }
+      if (superseded) {
+        std::error_code error;
+        std::filesystem::remove(PathOf(hash, version), error); // never mapped, nothing holds it open
+        return true;
+      }
+      if (it != m_entries.end()) {
+        RemoveLocked(it, false);
+      }
+      Insert(hash, size, version);
+      ++m_stats.insertions;
+      EvictLocked(hash);
+    }
+    CompactIfNeeded();
+    return true;
+  }
+
+  void Remove(std::string_view key) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_entries.find(Hash(key));
+      if (it == m_entries.end()) {
+        return;
+      }
+      RemoveLocked(it);
+    }
+    CompactIfNeeded();
+  }
+
+  void SetCapacity(uint64_t capacityBytes) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_capacityBytes = capacityBytes;
+      EvictLocked(0);
+    }
+    CompactIfNeeded();
+  }
+
+  SegmentCacheStats Stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto stats = m_stats;
+    stats.entries = m_entries.size();
+    stats.bytes = m_bytes;
+    stats.capacityBytes = m_capacityBytes;
+    return stats;
+  }
+
+ private:
+  struct FileHeader {
+    char magic[4];
+    uint32_t keyLength;
+  };
+
+  // An entry file mapped for the Items reading it. Windows refuses to delete a mapped file, so an entry
+  // removed while mapped only flags its mapping, and the last Item to go deletes the file after unmapping.
+  struct Mapping {
+    explicit Mapping(std::filesystem::path path) : path(std::move(path)) {}
+
+    ~Mapping() {
+      if (removed) {
+        file.Close();
+        std::error_code error;
+        std::filesystem::remove(path, error);
+      }
+    }
+
+    MappedFile file;
+    std::filesystem::path const path;
+    std::atomic<bool> removed{false};
+  };
+
+  struct Entry {
+    uint64_t size;
+    uint64_t version; // names the entry's file, see PathOf
+    uint32_t frequency;
+    std::list<uint64_t>::iterator position; // in m_buckets[frequency]
+    std::weak_ptr<Mapping> mapping;
+  };
+
+  using EntryMap = std::unordered_map<uint64_t, Entry>;
+
+  static constexpr char c_magic[4] = {'R', 'N', 'V', 'C'};
+  static constexpr char c_extension[] = ".seg";
+  static constexpr uint32_t c_maxFrequency = 1u << 16; // bounds the number of frequency buckets
+  static constexpr size_t c_touchBatch = 64; // uses a killed process may forget, at most
+
+  // FNV-1a; the key stored in the file resolves the rare collision.
+  static uint64_t Hash(std::string_view key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (auto c : key) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  // Splits a file stem "<16 hex digits of the hash>.<decimal version>".
+  static bool ParseFileName(std::string const &stem, uint64_t &hash, uint64_t &version) {
+    if (stem.size() < 18 || stem[16] != '.') {
+      return false;
+    }
+    hash = 0;
+    for (auto c : stem.substr(0, 16)) {
+      int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+      if (digit < 0) {
+        return false;
+      }
+      hash = hash << 4 | static_cast<uint64_t>(digit);
+    }
+    version = 0;
+    for (auto c : stem.substr(17)) {
+      if (c < '0' || c > '9') {
+        return false;
+      }
+      version = version * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+  }
+
+  std::filesystem::path PathOf(uint64_t hash, uint64_t version) const {
+    char name[17];
+    for (int i = 15; i >= 0; --i, hash >>= 4) {
+      name[i] = "0123456789abcdef"[hash & 15];
+    }
+    name[16] = 0;
+    return m_folder / (std::string(name) + "." + std::to_string(version) + c_extension);
+  }
+
+  // A folder without a journal (or with a damaged one) has its files adopted, oldest first, and the first
+  // snapshot written from them. Of several versions of an entry the newest is kept, the sweep deletes the
+  // others.
+  void AdoptFilesLocked() {
+    std::error_code error;
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::directory_entry>> files;
+    for (auto const &file : std::filesystem::directory_iterator(m_folder, error)) {
+      if (file.path().extension() == c_extension) {
+        files.emplace_back(file.last_write_time(error), file);
+      }
+    }
+    std::sort(files.begin(), files.end(), [](auto const &a, auto const &b) { return a.first < b.first; });
+    for (auto const &[time, file] : files) {
+      uint64_t hash = 0;
+      uint64_t version = 0;
+      if (!ParseFileName(file.path().stem().string(), hash, version)) {
+        continue;
+      }
+      auto it = m_entries.find(hash);
+      if (it != m_entries.end() && it->second.version > version) {
+        continue;
+      }
+      if (it != m_entries.end()) {
+        RemoveLocked(it, false);
+      }
+      Insert(hash, file.file_size(error), version);
+    }
+    m_journal.Compact(EntriesLocked());
+  }
+
+  // Deletes the files no entry owns: versions that were replaced or evicted while still mapped, or whose
+  // Put did not finish, when the process died before deleting them. Versions continue past every one
+  // seen, so a new file never takes the name of one that is still about.
+  void SweepLocked() {
+    std::error_code error;
+    for (auto const &[hash, entry] : m_entries) {
+      m_nextVersion = std::max(m_nextVersion, entry.version + 1);
+    }
+    for (auto const &file : std::filesystem::directory_iterator(m_folder, error)) {
+      auto const &path = file.path();
+      uint64_t hash = 0;
+      uint64_t version = 0;
+      if (path.extension() == ".tmp") {
+        std::filesystem::remove(path, error); // an interrupted write
+      } else if (path.extension() == c_extension && ParseFileName(path.stem().string(), hash, version)) {
+        m_nextVersion = std::max(m_nextVersion, version + 1);
+        auto it = m_entries.find(hash);
+        if (it == m_entries.end() || it->second.version != version) {
+          std::filesystem::remove(path, error);
+        }
+      }
+    }
+  }
+
+  // Every entry in eviction order: lowest frequency first, least recently used first within one, then
+  // the pending ones.
+  std::vector<CacheJournalEntry> EntriesLocked() const {
+    std::vector<uint32_t> frequencies;
+    frequencies.reserve(m_buckets.size());
+    for (auto const &[frequency, bucket] : m_buckets) {
+      frequencies.push_back(frequency);
+    }
+    std::sort(frequencies.begin(), frequencies.end());
+    std::vector<CacheJournalEntry> entries;
+    entries.reserve(m_entries.size());
+    for (auto frequency : frequencies) {
+      for (auto hash : m_buckets.at(frequency)) {
+        auto const &entry = m_entries.at(hash);
+        entries.push_back(CacheJournalEntry{hash, entry.size, frequency, entry.version});
+      }
+    }
+    // in the order they were journaled, so the last Put of a key still wins
+    std::vector<CacheJournalEntry> pending;
+    pending.reserve(m_pending.size());
+    for (auto const &[version, entry] : m_pending) {
+      pending.push_back(entry);
+    }
+    std::sort(pending.begin(), pending.end(), [](auto const &a, auto const &b) { return a.version < b.version; });
+    entries.insert(entries.end(), pending.begin(), pending.end());
+    return entries;
+  }
+
+  // Folds the journal into a new snapshot once it has grown enough. The entries are taken and the journal
+  // rotated under the lock; the snapshot is written after releasing it, so readers and other writers
+  // carry on meanwhile.
+  void CompactIfNeeded() {
+    std::vector<CacheJournalEntry> entries;
+    uint64_t generation = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      RetryOrphansLocked();
+      if (m_compacting || !m_journal.ShouldCompact(m_entries.size())) {
+        return;
+      }
+      m_compacting = true;
+      entries = EntriesLocked();
+      generation = m_journal.Rotate();
+      m_touches.clear(); // already in the order of |entries|
+    }
+    m_journal.WriteSnapshot(generation, entries);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_compacting = false;
+  }
+
+  // The payload of a mapped entry file, or a null view if it doesn't belong to |key|.
+  static std::string_view Payload(MappedFile const &file, std::string_view key) {
+    FileHeader header;
+    if (file.Size() < sizeof(header)) {
+      return {};
+    }
+    std::memcpy(&header, file.Data(), sizeof(header));
+    std::string_view contents(reinterpret_cast<char const *>(file.Data()), file.Size());
+    if (std::memcmp(header.magic, c_magic, sizeof(c_magic)) != 0 || header.keyLength != key.size() ||
+        contents.substr(sizeof(header), key.size()) != key) {
+      return {};
+    }
+    return contents.substr(sizeof(header) + key.size());
+  }
+
+  void Insert(uint64_t hash, uint64_t size, uint64_t version, uint32_t frequency = 1) {
+    auto &bucket = m_buckets[frequency];
+    bucket.push_back(hash);
+    m_entries[hash] = Entry{size, version, frequency, std::prev(bucket.end()), {}};
+    m_minFrequency = std::min(m_minFrequency, frequency);
+    m_bytes += size;
+  }
+
+  void Touch(Entry &entry) {
+    auto from = m_buckets.find(entry.frequency);
+    if (m_policy == SegmentCachePolicy::Lru || entry.frequency >= c_maxFrequency) {
+      from->second.splice(from->second.end(), from->second, entry.position);
+      return;
+    }
+    auto &to = m_buckets[entry.frequency + 1];
+    to.splice(to.end(), from->second, entry.position);
+    if (from->second.empty()) {
+      m_buckets.erase(from);
+      if (m_minFrequency == entry.frequency) {
+        ++m_minFrequency;
+      }
+    }
+    ++entry.frequency;
+  }
+
+  // Drops the entry and its file. |journal| is false when the caller journals the change itself, e.g. a
+  // newer version replacing it.
+  void RemoveLocked(EntryMap::iterator it, bool journal = true) {
+    auto bucket = m_buckets.find(it->second.frequency);
+    bucket->second.erase(it->second.position);
+    if (bucket->second.empty()) {
+      m_buckets.erase(bucket);
+    }
+    m_bytes -= it->second.size;
+    // the file goes first, so a crash in between leaves an entry without a file rather than the reverse
+    if (auto mapping = it->second.mapping.lock()) {
+      mapping->removed = true; // deleted by the last Item, which may be this very reference
+    } else {
+      DeleteFileLocked(PathOf(it->first, it->second.version));
+    }
+    if (journal) {
+      m_journal.Append(CacheJournal::Op::Remove, it->first);
+    }
+    m_entries.erase(it);
+  }
+
+  // A file whose last Item is still being released on another thread can't be deleted yet on Windows; it
+  // is tried again by the next writer, and by the sweep of the next open at the latest.
+  void DeleteFileLocked(std::filesystem::path const &path) {
+    std::error_code error;
+    std::filesystem::remove(path, error);
+    if (error) {
+      m_orphans.push_back(path);
+    }
+  }
+
+  void RetryOrphansLocked() {
+    auto orphans = std::exchange(m_orphans, {});
+    for (auto const &path : orphans) {
+      DeleteFileLocked(path);
+    }
+  }
+
+  // Evicts until the entries fit the budget, sparing |keep| (the entry just stored).
+  void EvictLocked(uint64_t keep) {
+    while (m_bytes > m_capacityBytes && !m_entries.empty()) {
+      auto bucket = m_buckets.find(m_minFrequency);
+      if (bucket == m_buckets.end()) {
+        // the least frequent entries were removed explicitly, find the next level
+        m_minFrequency = std::min_element(m_buckets.begin(), m_buckets.end(), [](auto const &a, auto const &b) {
+                           return a.first < b.first;
+                         })->first;
+        continue;
+      }
+      auto victim = bucket->second.front();
+      if (victim == keep) {
+        if (m_entries.size() == 1) {
+          return;
+        }
+        // spare the newcomer by looking at the next oldest, or at the next frequency
+        victim = bucket->second.size() > 1 ? *std::next(bucket->second.begin()) : NextFrequencyVictim();
+      }
+      auto it = m_entries.find(victim);
+      ++m_stats.evictions;
+      m_stats.evictedBytes += it->second.size;
+      RemoveLocked(it);
+    }
+  }
+
+  uint64_t NextFrequencyVictim() const {
+    uint32_t next = UINT32_MAX;
+    for (auto const &[frequency, bucket] : m_buckets) {
+      if (frequency > m_minFrequency && frequency < next) {
+        next = frequency;
+      }
+    }
+    return m_buckets.at(next).front();
+  }
+
+  std::filesystem::path const m_folder;
+  SegmentCachePolicy const m_policy;
+  mutable std::mutex m_mutex;
+  uint64_t m_capacityBytes;
+  CacheJournal m_journal;
+  uint64_t m_bytes = 0;
+  EntryMap m_entries;
+  std::unordered_map<uint64_t, CacheJournalEntry> m_pending; // version -> Put still writing its file
+  uint64_t m_nextVersion = 1;
+  std::vector<uint64_t> m_touches; // hashes of the Get hits not journaled yet, oldest first
+  std::vector<std::filesystem::path> m_orphans; // files that could not be deleted yet
+  bool m_compacting = false;
+  std::unordered_map<uint32_t, std::list<uint64_t>> m_buckets; // frequency -> hashes, least recent first
+  uint32_t m_minFrequency = 1;
+  SegmentCacheStats m_stats;
+};
+
+} // namespace ReactNativeVideoCPP
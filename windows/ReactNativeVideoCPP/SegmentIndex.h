@@ -0,0 +1,330 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "DashParser.h"
+#include "HlsParser.h"
+#include "MappedFile.h"
+
+// Portable (WinRT-free) index answering "which segment covers time t" for long VOD and DVR windows. Start
+// times, durations, byte ranges and URI offsets live in separate packed arrays so a lookup only touches
+// the start times, and the in-memory layout is also the serialized one: an index saved to disk is mapped
+// back and used in place, without parsing or copying. Each index records a fingerprint of the manifest it
+// was built from, so a saved one can be checked against the manifest the server serves now.
+namespace ReactNativeVideoCPP {
+
+class SegmentIndex {
+ public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  SegmentIndex() = default;
+  SegmentIndex(SegmentIndex const &) = delete;
+  SegmentIndex &operator=(SegmentIndex const &) = delete;
+
+  // Adopts serialized bytes (see Bytes). Returns null if they are not a valid index.
+  static std::unique_ptr<SegmentIndex> FromBytes(std::string_view bytes) {
+    auto index = std::unique_ptr<SegmentIndex>(new SegmentIndex());
+    index->m_storage.resize((bytes.size() + 7) / 8);
+    std::memcpy(index->m_storage.data(), bytes.data(), bytes.size());
+    if (!index->Bind(reinterpret_cast<uint8_t const *>(index->m_storage.data()), bytes.size())) {
+      return nullptr;
+    }
+    return index;
+  }
+
+  // Maps a saved index. Returns null if the file is missing or not a valid index.
+  static std::unique_ptr<SegmentIndex> Map(std::filesystem::path const &path) {
+    auto index = std::unique_ptr<SegmentIndex>(new SegmentIndex());
+    if (!index->m_file.Open(path) || !index->Bind(index->m_file.Data(), index->m_file.Size())) {
+      return nullptr;
+    }
+    return index;
+  }
+
+  bool Save(std::filesystem::path const &path) const {
+    return WriteFileAtomically(path, Bytes());
+  }
+
+  // The serialized form.
+  std::string_view Bytes() const {
+    return std::string_view(reinterpret_cast<char const *>(m_base), m_size);
+  }
+
+  size_t Size() const {
+    return m_count;
+  }
+
+  bool Empty() const {
+    return m_count == 0;
+  }
+
+  double Start(size_t i) const {
+    return m_starts[i];
+  }
+
+  double Duration(size_t i) const {
+    return m_durations[i];
+  }
+
+  double End() const {
+    return m_count == 0 ? 0 : m_starts[m_count - 1] + m_durations[m_count - 1];
+  }
+
+  uint64_t ByteOffset(size_t i) const {
+    return m_byteOffsets[i];
+  }
+
+  // 0 for the whole resource.
+  uint32_t ByteLength(size_t i) const {
+    return m_byteLengths[i];
+  }
+
+  std::string_view Uri(size_t i) const {
+    return std::string_view(m_uris + m_uriOffsets[i], m_uriOffsets[i + 1] - m_uriOffsets[i]);
+  }
+
+  // Fingerprint() of the manifest text the index was built from, 0 when not given.
+  uint64_t Source() const {
+    return m_source;
+  }
+
+  // FNV-1a of a manifest text, stable across launches unlike std::hash.
+  static uint64_t Fingerprint(std::string_view manifest) {
+    uint64_t hash = 14695981039346656037ull;
+    for (auto c : manifest) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  // Index of the segment covering |seconds|, npos outside the indexed window. The search is branchless,
+  // so its cost is a fixed log2(n) steps over the packed start times with no mispredictions.
+  size_t Find(double seconds) const {
+    if (m_count == 0 || !(seconds >= m_starts[0]) || seconds >= End()) {
+      return npos;
+    }
+    double const *base = m_starts;
+    size_t length = m_count;
+    while (length > 1) {
+      size_t half = length / 2;
+      base = base[half] <= seconds ? base + half : base;
+      length -= half;
+    }
+    return static_cast<size_t>(base - m_starts);
+  }
+
+  // Start times, e.g. for SeekController::SetKeyframes.
+  std::vector<double> Starts() const {
+    return std::vector<double>(m_starts, m_starts + m_count);
+  }
+
+ private:
+  friend class SegmentIndexBuilder;
+
+  // Serialized layout, native endianness, every array 8-byte aligned:
+  //   Header | double starts[n] | float durations[n] | uint64 byteOffsets[n] | uint32 byteLengths[n] |
+  //   uint32 uriOffsets[n + 1] | char uris[], padded to a multiple of 8 bytes
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t uriBytes;
+    uint64_t source;
+  };
+
+  static constexpr char c_magic[8] = {'R', 'N', 'V', 'S', 'E', 'G', 'I', 'X'};
+  static constexpr uint32_t c_version = 2;
+
+  static size_t Align(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+  }
+
+  static size_t LayoutSize(uint64_t count, uint64_t uriBytes) {
+    return sizeof(Header) + Align(count * sizeof(double)) + Align(count * sizeof(float)) +
+        Align(count * sizeof(uint64_t)) + Align(count * sizeof(uint32_t)) + Align((count + 1) * sizeof(uint32_t)) +
+        Align(static_cast<size_t>(uriBytes));
+  }
+
+  bool Bind(uint8_t const *base, size_t size) {
+    Header header;
+    if (size < sizeof(Header)) {
+      return false;
+    }
+    std::memcpy(&header, base, sizeof(Header));
+    if (std::memcmp(header.magic, c_magic, sizeof(c_magic)) != 0 || header.version != c_version ||
+        header.count > size / sizeof(double) || header.uriBytes > size ||
+        LayoutSize(header.count, header.uriBytes) != size) {
+      return false;
+    }
+    auto count = static_cast<size_t>(header.count);
+    auto cursor = base + sizeof(Header);
+    auto take = [&cursor](size_t bytes) {
+      auto at = cursor;
+      cursor += Align(bytes);
+      return at;
+    };
+    m_starts = reinterpret_cast<double const *>(take(count * sizeof(double)));
+    m_durations = reinterpret_cast<float const *>(take(count * sizeof(float)));
+    m_byteOffsets = reinterpret_cast<uint64_t const *>(take(count * sizeof(uint64_t)));
+    m_byteLengths = reinterpret_cast<uint32_t const *>(take(count * sizeof(uint32_t)));
+    m_uriOffsets = reinterpret_cast<uint32_t const *>(take((count + 1) * sizeof(uint32_t)));
+    m_uris = reinterpret_cast<char const *>(cursor);
+    // Uri() trusts the offsets, so a damaged file must not point it outside the URI bytes
+    if (m_uriOffsets[0] != 0 || m_uriOffsets[count] != header.uriBytes) {
+      return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (m_uriOffsets[i + 1] < m_uriOffsets[i]) {
+        return false;
+      }
+    }
+    m_source = header.source;
+    m_base = base;
+    m_size = size;
+    m_count = count;
+    return true;
+  }
+
+  std::vector<uint64_t> m_storage; // owned bytes when built in memory
+  MappedFile m_file; // or the mapping they come from
+  uint8_t const *m_base = nullptr;
+  size_t m_size = 0;
+  size_t m_count = 0;
+  uint64_t m_source = 0;
+  double const *m_starts = nullptr;
+  float const *m_durations = nullptr;
+  uint64_t const *m_byteOffsets = nullptr;
+  uint32_t const *m_byteLengths = nullptr;
+  uint32_t const *m_uriOffsets = nullptr;
+  char const *m_uris = nullptr;
+};
+
+class SegmentIndexBuilder {
+ public:
+  // The manifest text the segments come from, see SegmentIndex::Source.
+  void SetSource(std::string_view manifest) {
+    m_source = SegmentIndex::Fingerprint(manifest);
+  }
+
+  // Segments must be appended in presentation order.
+  void Append(double start, double duration, uint64_t byteOffset, uint32_t byteLength, std::string_view uri) {
+    m_starts.push_back(start);
+    m_durations.push_back(static_cast<float>(duration));
+    m_byteOffsets.push_back(byteOffset);
+    m_byteLengths.push_back(byteLength);
+    m_uriOffsets.push_back(static_cast<uint32_t>(m_uris.size()));
+    m_uris.append(uri);
+  }
+
+  // Every segment of a media playlist; times are relative to its first segment.
+  void AppendHls(HlsMediaPlaylist const &playlist) {
+    auto const &segments = playlist.Segments();
+    Reserve(segments.size());
+    double origin = segments.empty() ? 0 : segments.front().start;
+    for (auto const &segment : segments) {
+      Append(
+          segment.start - origin,
+          segment.duration,
+          segment.byteRange.offset,
+          static_cast<uint32_t>(segment.byteRange.length),
+          playlist.Uri(segment));
+    }
+  }
+
+  // Every segment of one representation of |period|; times are relative to the presentation start.
+  // Representations without a SegmentTemplate are indexed as a single segment spanning the period.
+  //
+  // A live period is open-ended, so a $Number$ template without a SegmentTimeline has no count of its own:
+  // |liveEdge| (seconds since the presentation start, i.e. now - availabilityStartTime) then limits it to
+  // the segments already complete, from |timeShiftBufferDepth| behind the edge (0 for the whole period).
+  // Without a known edge (NaN, or 0 for a static MPD) the period has no segments to index and is skipped.
+  void AppendDash(
+      DashPeriod const &period,
+      DashRepresentation const &representation,
+      double liveEdge = 0,
+      double timeShiftBufferDepth = 0) {
+    auto const &segmentTemplate = representation.segmentTemplate;
+    if (!segmentTemplate) {
+      Append(period.start, period.duration, 0, 0, representation.baseUrl);
+      return;
+    }
+    uint64_t first = 0;
+    auto count = segmentTemplate->SegmentCount(period.duration);
+    if (period.duration <= 0 && !segmentTemplate->timeline) {
+      auto elapsed = liveEdge - period.start;
+      if (!(elapsed > 0)) {
+        return;
+      }
+      count = segmentTemplate->IndexAt(elapsed);
+      if (timeShiftBufferDepth > 0) {
+        first = std::min(segmentTemplate->IndexAt(elapsed - timeShiftBufferDepth), count);
+      }
+    }
+    Reserve(static_cast<size_t>(count - first));
+    for (uint64_t i = first; i < count; ++i) {
+      auto segment = segmentTemplate->Segment(i);
+      Append(period.start + segment.start, segment.durationSeconds, 0, 0, representation.MediaUrl(segment));
+    }
+  }
+
+  std::unique_ptr<SegmentIndex> Build() {
+    auto count = m_starts.size();
+    auto size = SegmentIndex::LayoutSize(count, m_uris.size());
+    auto index = std::unique_ptr<SegmentIndex>(new SegmentIndex());
+    index->m_storage.assign(size / 8, 0);
+    auto base = reinterpret_cast<uint8_t *>(index->m_storage.data());
+
+    SegmentIndex::Header header{};
+    std::memcpy(header.magic, SegmentIndex::c_magic, sizeof(header.magic));
+    header.version = SegmentIndex::c_version;
+    header.count = count;
+    header.uriBytes = m_uris.size();
+    header.source = m_source;
+    std::memcpy(base, &header, sizeof(header));
+    auto cursor = base + sizeof(header);
+    auto put = [&cursor](void const *data, size_t bytes) {
+      if (bytes != 0) {
+        std::memcpy(cursor, data, bytes);
+      }
+      cursor += SegmentIndex::Align(bytes);
+    };
+    m_uriOffsets.push_back(static_cast<uint32_t>(m_uris.size()));
+    put(m_starts.data(), count * sizeof(double));
+    put(m_durations.data(), count * sizeof(float));
+    put(m_byteOffsets.data(), count * sizeof(uint64_t));
+    put(m_byteLengths.data(), count * sizeof(uint32_t));
+    put(m_uriOffsets.data(), (count + 1) * sizeof(uint32_t));
+    put(m_uris.data(), m_uris.size());
+
+    *this = SegmentIndexBuilder();
+    index->Bind(base, size);
+    return index;
+  }
+
+ private:
+  void Reserve(size_t additional) {
+    m_starts.reserve(m_starts.size() + additional);
+    m_durations.reserve(m_durations.size() + additional);
+    m_byteOffsets.reserve(m_byteOffsets.size() + additional);
+    m_byteLengths.reserve(m_byteLengths.size() + additional);
+    m_uriOffsets.reserve(m_uriOffsets.size() + additional + 1);
+  }
+
+  std::vector<double> m_starts;
+  std::vector<float> m_durations;
+  std::vector<uint64_t> m_byteOffsets;
+  std::vector<uint32_t> m_byteLengths;
+  std::vector<uint32_t> m_uriOffsets;
+  std::string m_uris;
+  uint64_t m_source = 0;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,185 @@
+#include "pch.h"
+#include "SegmentIndexStore.h"
+#include <chrono>
+#include <cwctype>
+#include <system_error>
+#include "MediaCache.h"
+
+using ::ReactNativeVideoCPP::DashManifest;
+using ::ReactNativeVideoCPP::DashMpdParser;
+using ::ReactNativeVideoCPP::HlsMasterPlaylist;
+using ::ReactNativeVideoCPP::HlsMediaPlaylist;
+using ::ReactNativeVideoCPP::SegmentIndex;
+using ::ReactNativeVideoCPP::SegmentIndexBuilder;
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+namespace {
+
+enum class ManifestKind { None, Hls, Dash };
+
+ManifestKind ManifestKindOf(Windows::Foundation::Uri const &uri) {
+  auto scheme = uri.SchemeName();
+  if (scheme != L"http" && scheme != L"https") {
+    return ManifestKind::None;
+  }
+  std::wstring path{uri.Path()};
+  for (auto &c : path) {
+    c = static_cast<wchar_t>(std::towlower(c));
+  }
+  auto endsWith = [&path](std::wstring_view suffix) {
+    return path.size() >= suffix.size() && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+  };
+  if (endsWith(L".m3u8")) {
+    return ManifestKind::Hls;
+  }
+  if (endsWith(L".mpd")) {
+    return ManifestKind::Dash;
+  }
+  return ManifestKind::None;
+}
+
+// FNV-1a, stable across launches unlike std::hash.
+uint64_t HashUri(hstring const &uri) {
+  uint64_t hash = 14695981039346656037ull;
+  for (auto c : uri) {
+    hash = (hash ^ static_cast<uint16_t>(c)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+} // namespace
+
+SegmentIndexStore &SegmentIndexStore::Instance() {
+  // intentionally leaked, loads may still be running on the thread pool during shutdown
+  static auto *store = new SegmentIndexStore();
+  return *store;
+}
+
+SegmentIndexStore::SegmentIndexStore() {
+  try {
+    auto root = Windows::Storage::ApplicationData::Current().LocalCacheFolder().Path();
+    auto folder = std::filesystem::path{std::wstring_view{root}} / L"SegmentIndex";
+    std::error_code error;
+    std::filesystem::create_directories(folder, error);
+    if (!error) {
+      m_cacheFolder = std::move(folder);
+    }
+  } catch (winrt::hresult_error const &) {
+    // no app data (e.g. unpackaged host), indexes are built but not kept
+  }
+}
+
+std::shared_ptr<SegmentIndex const> SegmentIndexStore::Load(hstring const &uriString) {
+  try {
+    Windows::Foundation::Uri uri{uriString};
+    auto kind = ManifestKindOf(uri);
+    if (kind == ManifestKind::None) {
+      return nullptr;
+    }
+    Windows::Foundation::Uri playlistUri{nullptr};
+    auto manifest = kind == ManifestKind::Hls ? FetchHlsMediaPlaylist(uri, playlistUri) : Fetch(uri);
+    // a saved index is only used while the server still serves the manifest it was built from
+    auto cachePath = CachePath(uriString);
+    if (!cachePath.empty()) {
+      auto saved = SegmentIndex::Map(cachePath);
+      if (saved != nullptr && saved->Source() == SegmentIndex::Fingerprint(manifest)) {
+        return saved;
+      }
+    }
+    bool isVod = false;
+    auto index = kind == ManifestKind::Hls ? BuildHls(manifest, isVod) : BuildDash(manifest, isVod);
+    if (index == nullptr || index->Empty()) {
+      return nullptr;
+    }
+    // a live window moves on, only a VOD index is worth keeping
+    if (isVod && !cachePath.empty()) {
+      index->Save(cachePath);
+    }
+    return index;
+  } catch (winrt::hresult_error const &) {
+    // malformed URI or a failed download, the view just plays without an index
+    return nullptr;
+  }
+}
+
+std::string SegmentIndexStore::Fetch(Windows::Foundation::Uri const &uri) {
+  // views opening the same source together share the manifest download
+  auto bytes = MediaCache::Instance().Flights().Run(to_string(uri.AbsoluteUri()), [&]() {
+    auto buffer = m_client.GetBufferAsync(uri).get();
+    return std::make_shared<std::string const>(reinterpret_cast<char const *>(buffer.data()), buffer.Length());
+  });
+  if (bytes == nullptr) {
+    throw hresult_error(E_FAIL); // the shared download failed
+  }
+  return *bytes;
+}
+
+std::string SegmentIndexStore::FetchHlsMediaPlaylist(
+    Windows::Foundation::Uri const &uri,
+    Windows::Foundation::Uri &playlistUri) {
+  playlistUri = uri;
+  if (ManifestKindOf(uri) != ManifestKind::Hls) {
+    return {};
+  }
+  auto text = Fetch(uri);
+  HlsMasterPlaylist master;
+  if (::ReactNativeVideoCPP::ParseHlsMasterPlaylist(text, master) && !master.variants.empty()) {
+    // variants are segment-aligned, so any of them gives the same timeline
+    playlistUri = uri.CombineUri(to_hstring(master.variants.front().uri));
+    text = Fetch(playlistUri);
+  }
+  return text;
+}
+
+std::unique_ptr<SegmentIndex> SegmentIndexStore::BuildHls(std::string_view manifest, bool &isVod) {
+  HlsMediaPlaylist playlist;
+  if (!playlist.Update(manifest).valid) {
+    return nullptr;
+  }
+  isVod = playlist.EndList();
+  SegmentIndexBuilder builder;
+  builder.SetSource(manifest);
+  builder.AppendHls(playlist);
+  return builder.Build();
+}
+
+std::unique_ptr<SegmentIndex> SegmentIndexStore::BuildDash(std::string_view manifest, bool &isVod) {
+  DashMpdParser parser;
+  parser.Feed(manifest);
+  DashManifest mpd;
+  // a live MPD's open timeline runs up to the live edge as of now
+  auto now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+  if (!parser.Finish(mpd, now)) {
+    return nullptr;
+  }
+  isVod = !mpd.dynamic;
+  SegmentIndexBuilder builder;
+  builder.SetSource(manifest);
+  for (auto const &period : mpd.periods) {
+    auto const *best = period.adaptationSets.empty() ? nullptr : &period.adaptationSets.front();
+    for (auto const &set : period.adaptationSets) {
+      if (set.contentType == "video") {
+        best = &set;
+        break;
+      }
+    }
+    if (best != nullptr && !best->representations.empty()) {
+      // a live period whose template has no timeline runs up to the same edge
+      auto liveEdge = mpd.dynamic ? now - mpd.availabilityStart : 0;
+      builder.AppendDash(period, best->representations.front(), liveEdge, mpd.timeShiftBufferDepth);
+    }
+  }
+  return builder.Build();
+}
+
+std::filesystem::path SegmentIndexStore::CachePath(hstring const &uri) const {
+  if (m_cacheFolder.empty()) {
+    return {};
+  }
+  wchar_t name[32];
+  swprintf_s(name, L"%016llx.idx", static_cast<unsigned long long>(HashUri(uri)));
+  return m_cacheFolder / name;
+}
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
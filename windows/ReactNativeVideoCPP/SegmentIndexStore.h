@@ -0,0 +1,41 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include "SegmentIndex.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// Builds the SegmentIndex of an HLS or DASH source from its manifest. VOD indexes are saved to the app's
+// local cache folder, so opening the same source again maps the saved index instead of parsing the
+// manifest; the manifest is still downloaded to check that it did not change since the index was saved.
+class SegmentIndexStore {
+ public:
+  static SegmentIndexStore &Instance();
+
+  // Blocks on the network, call it off the UI thread. Null for progressive sources and on any failure.
+  // HLS sources are indexed from their first variant, DASH ones from the first video representation of
+  // each period; segment URIs are kept as the manifest lists them.
+  std::shared_ptr<::ReactNativeVideoCPP::SegmentIndex const> Load(hstring const &uri);
+
+  // Blocks on the network and throws on failure. The media playlist of an HLS source, from its first
+  // variant like the index, and in |playlistUri| where it came from for live refreshes. Empty for sources
+  // that are not HLS.
+  std::string FetchHlsMediaPlaylist(Windows::Foundation::Uri const &uri, Windows::Foundation::Uri &playlistUri);
+
+  // Blocks on the network and throws on failure. Views fetching the same manifest together share it.
+  std::string Fetch(Windows::Foundation::Uri const &uri);
+
+ private:
+  SegmentIndexStore();
+
+  std::unique_ptr<::ReactNativeVideoCPP::SegmentIndex> BuildHls(std::string_view manifest, bool &isVod);
+  std::unique_ptr<::ReactNativeVideoCPP::SegmentIndex> BuildDash(std::string_view manifest, bool &isVod);
+  std::filesystem::path CachePath(hstring const &uri) const;
+
+  Windows::Web::Http::HttpClient m_client;
+  std::filesystem::path m_cacheFolder; // empty without app data
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
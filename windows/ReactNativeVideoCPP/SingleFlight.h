@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Portable (WinRT-free) merging of concurrent fetches of the same resource. The first request for a key
+// starts a flight and does the transfer; requests for the key that arrive while it is under way join the
+// flight instead of going to the network and all get the same bytes when it lands. Keys are the URL plus
+// byte range (SegmentCache::Key), so only requests for identical bytes are merged.
+namespace ReactNativeVideoCPP {
+
+struct SingleFlightStats {
+  uint64_t flights = 0; // transfers actually made
+  uint64_t joined = 0; // requests served by another request's transfer
+  uint64_t dedupedBytes = 0; // bytes those requests did not have to transfer
+};
+
+class SingleFlight {
+ public:
+  using Bytes = std::shared_ptr<std::string const>; // null when the fetch failed
+  using Waiter = std::function<void(Bytes const &)>;
+
+  // Returns true when no flight for |key| is under way: the caller then fetches and must call Complete.
+  // Otherwise |waiter| is called with the result of the flight, on the thread that completes it.
+  bool Join(std::string const &key, Waiter waiter) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [it, inserted] = m_flights.try_emplace(key);
+    if (inserted) {
+      ++m_stats.flights;
+      return true;
+    }
+    it->second.push_back(std::move(waiter));
+    return false;
+  }
+
+  // Ends the flight for |key| and hands |bytes| to everyone who joined it.
+  void Complete(std::string const &key, Bytes const &bytes) {
+    std::vector<Waiter> waiters;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_flights.find(key);
+      if (it == m_flights.end()) {
+        return;
+      }
+      waiters = std::move(it->second);
+      m_flights.erase(it);
+      m_stats.joined += waiters.size();
+      if (bytes != nullptr) {
+        m_stats.dedupedBytes += bytes->size() * waiters.size();
+      }
+    }
+    for (auto const &waiter : waiters) {
+      waiter(bytes);
+    }
+  }
+
+  // Blocking form: runs |fetch() -> Bytes| unless a flight for |key| is under way, in which case it waits
+  // for that one instead.
+  template <typename Fetch>
+  Bytes Run(std::string const &key, Fetch &&fetch) {
+    auto joined = std::make_shared<std::promise<Bytes>>();
+    auto result = joined->get_future();
+    if (!Join(key, [joined](Bytes const &bytes) { joined->set_value(bytes); })) {
+      return result.get();
+    }
+    Bytes bytes;
+    try {
+      bytes = fetch();
+    } catch (...) {
+      Complete(key, nullptr);
+      throw;
+    }
+    Complete(key, bytes);
+    return bytes;
+  }
+
+  SingleFlightStats Stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+
+ private:
+  mutable std::mutex m_mutex;
+  std::unordered_map<std::string, std::vector<Waiter>> m_flights;
+  SingleFlightStats m_stats;
+};
+
+} // namespace ReactNativeVideoCPP
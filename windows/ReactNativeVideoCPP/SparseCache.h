@@ -0,0 +1,514 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "ByteRangeSet.h"
+#include "MappedFile.h"
+
+// Portable (WinRT-free) sparse cache of byte ranges of large resources such as progressive MP4s. Each
+// resource is stored as fixed-size chunk files holding the bytes that were fetched, plus a sidecar with
+// its key, what the server said about it (length, validator, content type) and the ByteRangeSet of what
+// is present. Chunks keep a read far into a clip from allocating, and on file systems without sparse
+// files zero-filling, everything before it: a write only ever extends its own chunk. Reads are served
+// from the present ranges and only the gaps are fetched, so resuming or re-seeking a partially watched
+// clip downloads just the missing bytes. Whole resources are evicted least recently used first when the
+// budget is exceeded.
+//
+// The mutex only guards the bookkeeping; chunk and sidecar I/O run outside it, so one resource's disk
+// writes don't hold up another's reads.
+namespace ReactNativeVideoCPP {
+
+struct SparseCacheStats {
+  uint64_t cachedBytes = 0; // bytes read served from disk
+  uint64_t fetchedBytes = 0; // bytes that had to be fetched
+  uint64_t evictions = 0; // resources evicted
+  uint64_t resources = 0;
+  uint64_t bytes = 0; // present bytes over all resources
+  uint64_t capacityBytes = 0;
+};
+
+// What the server reported for a resource.
+struct SparseResource {
+  uint64_t length = 0; // 0 when unknown
+  std::string validator; // see HttpRangeValidator; empty when the server gave none
+  std::string contentType;
+};
+
+class SparseCache {
+ public:
+  static constexpr uint64_t c_chunkBytes = 1024 * 1024;
+
+  // Adopts the resources already in |folder| (creating it if needed), oldest first, and deletes chunks no
+  // sidecar accounts for.
+  SparseCache(std::filesystem::path folder, uint64_t capacityBytes)
+      : m_folder(std::move(folder)), m_capacityBytes(capacityBytes) {
+    std::error_code error;
+    std::filesystem::create_directories(m_folder, error);
+    std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> sidecars;
+    std::vector<std::filesystem::path> chunks;
+    for (auto const &file : std::filesystem::directory_iterator(m_folder, error)) {
+      if (file.path().extension() == ".ranges") {
+        sidecars.emplace_back(file.last_write_time(error), file.path());
+      } else {
+        chunks.push_back(file.path());
+      }
+    }
+    std::sort(sidecars.begin(), sidecars.end(), [](auto const &a, auto const &b) { return a.first < b.first; });
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto const &[time, path] : sidecars) {
+      Entry entry;
+      if (!LoadSidecar(path, entry)) {
+        std::filesystem::remove(path, error);
+        continue;
+      }
+      auto hash = Hash(entry.key);
+      entry.generation = ++m_generation;
+      m_bytes += entry.present.Size();
+      m_recency.push_back(hash);
+      entry.position = std::prev(m_recency.end());
+      m_entries.emplace(hash, std::move(entry));
+    }
+    // chunks whose sidecar was lost, and data files of the older single-file layout
+    for (auto const &path : chunks) {
+      auto name = path.filename().string();
+      if (path.extension() != ".chunk" || name.size() < 16 ||
+          m_entries.count(std::strtoull(name.substr(0, 16).c_str(), nullptr, 16)) == 0) {
+        std::filesystem::remove(path, error);
+      }
+    }
+    EvictLocked(0);
+  }
+
+  SparseCache(SparseCache const &) = delete;
+  SparseCache &operator=(SparseCache const &) = delete;
+
+  // Total length of the resource, 0 when unknown.
+  uint64_t Length(std::string_view key) const {
+    return Resource(key).length;
+  }
+
+  SparseResource Resource(std::string_view key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(Hash(key));
+    return it != m_entries.end() && it->second.key == key ? it->second.resource : SparseResource();
+  }
+
+  // Records what the server reports for the resource now. Bytes kept for a different length or validator
+  // belong to an older version of it and are dropped.
+  void Adopt(std::string_view key, SparseResource const &resource) {
+    auto hash = Hash(key);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_entries.find(hash);
+      if (it != m_entries.end() && it->second.key == key &&
+          (it->second.resource.length != resource.length || it->second.resource.validator != resource.validator)) {
+        RemoveLocked(it);
+      }
+      auto &entry = EntryLocked(key);
+      if (entry.resource.length == resource.length && entry.resource.validator == resource.validator &&
+          entry.resource.contentType == resource.contentType) {
+        return;
+      }
+      entry.resource = resource;
+    }
+    Persist(hash);
+  }
+
+  ByteRangeSet Present(std::string_view key) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(Hash(key));
+    return it != m_entries.end() && it->second.key == key ? it->second.present : ByteRangeSet();
+  }
+
+  // Fills |out| with [offset, offset + length) of the resource. Present bytes are read from disk; each gap
+  // is fetched with |fetch(offset, length) -> std::string|, widened to |minimumFetch| bytes (without
+  // running into present bytes or past the known length) so sequential reads don't turn into many small
+  // requests, and stored. Returns false, with |out| holding what was read, if a fetch came back short.
+  template <typename Fetch>
+  bool Read(
+      std::string_view key,
+      uint64_t offset,
+      uint64_t length,
+      std::string &out,
+      Fetch &&fetch,
+      uint64_t minimumFetch = 0) {
+    auto hash = Hash(key);
+    ByteRangeSet present;
+    uint64_t knownLength = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto &entry = EntryLocked(key);
+      m_recency.splice(m_recency.end(), m_recency, entry.position);
+      present = entry.present;
+      knownLength = entry.resource.length;
+    }
+    if (knownLength != 0) {
+      length = offset < knownLength ? std::min(length, knownLength - offset) : 0;
+    }
+    out.assign(static_cast<size_t>(length), '\0');
+    auto end = offset + length;
+    auto gaps = present.Gaps(offset, end);
+
+    // present parts first; if a chunk vanished (evicted meanwhile), fetch the whole request instead
+    uint64_t cursor = offset;
+    uint64_t fromDisk = 0;
+    bool readFailed = false;
+    for (size_t i = 0; i <= gaps.size() && !readFailed; ++i) {
+      auto partEnd = i < gaps.size() ? gaps[i].start : end;
+      if (partEnd > cursor) {
+        readFailed = !ReadChunks(hash, cursor, &out[static_cast<size_t>(cursor - offset)], partEnd - cursor);
+        fromDisk += partEnd - cursor;
+      }
+      cursor = i < gaps.size() ? gaps[i].end : end;
+    }
+    if (readFailed) {
+      present.Clear();
+      gaps.assign(1, ByteRange{offset, end});
+      fromDisk = 0;
+    }
+
+    uint64_t fetched = 0;
+    bool complete = true;
+    bool stored = false;
+    for (auto const &gap : gaps) {
+      auto fetchEnd = std::max(gap.end, gap.start + minimumFetch);
+      auto next = present.Gaps(gap.start, fetchEnd);
+      fetchEnd = next.empty() ? gap.end : std::max(gap.end, next.front().end);
+      if (knownLength != 0) {
+        fetchEnd = std::min(fetchEnd, knownLength);
+      }
+      auto bytes = fetch(gap.start, fetchEnd - gap.start);
+      if (bytes.size() > fetchEnd - gap.start) {
+        bytes.resize(static_cast<size_t>(fetchEnd - gap.start));
+      }
+      fetched += bytes.size();
+      auto usable = std::min<uint64_t>(bytes.size(), gap.end - gap.start);
+      std::memcpy(&out[static_cast<size_t>(gap.start - offset)], bytes.data(), static_cast<size_t>(usable));
+      stored = (!bytes.empty() && Store(key, gap.start, bytes)) || stored;
+      if (usable < gap.end - gap.start) {
+        out.resize(static_cast<size_t>(gap.start + usable - offset));
+        complete = false;
+        break;
+      }
+    }
+    // one sidecar rewrite for everything the read stored
+    if (stored) {
+      Persist(hash);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.cachedBytes += fromDisk;
+    m_stats.fetchedBytes += fetched;
+    return complete;
+  }
+
+  // Stores |bytes| at |offset| of the resource and marks them present. Returns false when they were not
+  // kept, e.g. because the resource alone would outgrow the budget.
+  bool Write(std::string_view key, uint64_t offset, std::string_view bytes) {
+    if (bytes.empty()) {
+      return true;
+    }
+    if (!Store(key, offset, bytes)) {
+      return false;
+    }
+    Persist(Hash(key));
+    return true;
+  }
+
+  void Remove(std::string_view key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(Hash(key));
+    if (it != m_entries.end()) {
+      RemoveLocked(it);
+    }
+  }
+
+  SparseCacheStats Stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto stats = m_stats;
+    stats.resources = m_entries.size();
+    stats.bytes = m_bytes;
+    stats.capacityBytes = m_capacityBytes;
+    return stats;
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    SparseResource resource;
+    ByteRangeSet present;
+    uint64_t generation = 0; // tells a re-created entry apart from the one an unlocked write started on
+    std::list<uint64_t>::iterator position; // in m_recency
+  };
+
+  using EntryMap = std::unordered_map<uint64_t, Entry>;
+
+  static constexpr char c_magic[4] = {'R', 'N', 'V', 'C'};
+
+  // FNV-1a; a colliding key simply replaces the older resource.
+  static uint64_t Hash(std::string_view key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (auto c : key) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  std::filesystem::path PathOf(uint64_t hash, std::string const &suffix) const {
+    char name[17];
+    for (int i = 15; i >= 0; --i, hash >>= 4) {
+      name[i] = "0123456789abcdef"[hash & 15];
+    }
+    name[16] = 0;
+    return m_folder / (name + suffix);
+  }
+
+  std::filesystem::path SidecarPath(uint64_t hash) const {
+    return PathOf(hash, ".ranges");
+  }
+
+  std::filesystem::path ChunkPath(uint64_t hash, uint64_t chunk) const {
+    return PathOf(hash, "-" + std::to_string(chunk) + ".chunk");
+  }
+
+  bool ReadChunks(uint64_t hash, uint64_t offset, char *out, uint64_t length) const {
+    while (length > 0) {
+      auto within = offset % c_chunkBytes;
+      auto size = std::min(length, c_chunkBytes - within);
+      std::ifstream data(ChunkPath(hash, offset / c_chunkBytes), std::ios::binary);
+      if (!data.seekg(static_cast<std::streamoff>(within)) || !data.read(out, static_cast<std::streamsize>(size))) {
+        return false;
+      }
+      offset += size;
+      out += size;
+      length -= size;
+    }
+    return true;
+  }
+
+  // True once every byte reached the OS; a chunk that failed part way may hold some of them, but none is
+  // marked present.
+  bool WriteChunks(uint64_t hash, uint64_t offset, std::string_view bytes) const {
+    while (!bytes.empty()) {
+      auto within = offset % c_chunkBytes;
+      auto size = static_cast<size_t>(std::min<uint64_t>(bytes.size(), c_chunkBytes - within));
+      auto path = ChunkPath(hash, offset / c_chunkBytes);
+      std::fstream data(path, std::ios::binary | std::ios::in | std::ios::out);
+      if (!data.is_open()) {
+        // created in append mode, which never truncates: another Store may have created the chunk and
+        // written into it since the open above failed
+        std::ofstream(path, std::ios::binary | std::ios::app);
+        data.open(path, std::ios::binary | std::ios::in | std::ios::out);
+      }
+      if (!data.seekp(static_cast<std::streamoff>(within)) ||
+          !data.write(bytes.data(), static_cast<std::streamsize>(size)) || !data.flush()) {
+        return false;
+      }
+      data.close();
+      if (data.fail()) {
+        return false;
+      }
+      offset += size;
+      bytes.remove_prefix(size);
+    }
+    return true;
+  }
+
+  void RemoveChunks(uint64_t hash, uint64_t start, uint64_t end) const {
+    std::error_code error;
+    for (auto chunk = start / c_chunkBytes; chunk * c_chunkBytes < end; ++chunk) {
+      std::filesystem::remove(ChunkPath(hash, chunk), error);
+    }
+  }
+
+  // Writes the chunks outside the lock and then, only if every write was flushed, marks the bytes present;
+  // the sidecar is left to Persist.
+  bool Store(std::string_view key, uint64_t offset, std::string_view bytes) {
+    auto hash = Hash(key);
+    uint64_t generation = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto &entry = EntryLocked(key);
+      // a resource never evicts itself; past the budget its further bytes are simply not kept
+      if (entry.present.Size() + bytes.size() > m_capacityBytes) {
+        return false;
+      }
+      generation = entry.generation;
+    }
+    bool written = WriteChunks(hash, offset, bytes);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end()) {
+      // evicted while the chunks were written, so they belong to nothing now
+      RemoveChunks(hash, offset, offset + bytes.size());
+      return false;
+    }
+    if (!written || it->second.generation != generation) {
+      return false;
+    }
+    auto &entry = it->second;
+    auto before = entry.present.Size();
+    entry.present.Add(offset, offset + bytes.size());
+    m_bytes += entry.present.Size() - before;
+    EvictLocked(hash);
+    return true;
+  }
+
+  Entry &EntryLocked(std::string_view key) {
+    auto hash = Hash(key);
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end() && it->second.key != key) {
+      RemoveLocked(it);
+      it = m_entries.end();
+    }
+    if (it == m_entries.end()) {
+      Entry entry;
+      entry.key = std::string(key);
+      entry.generation = ++m_generation;
+      m_recency.push_back(hash);
+      entry.position = std::prev(m_recency.end());
+      it = m_entries.emplace(hash, std::move(entry)).first;
+    }
+    return it->second;
+  }
+
+  void RemoveLocked(EntryMap::iterator it) {
+    std::error_code error;
+    std::filesystem::remove(SidecarPath(it->first), error);
+    for (auto const &range : it->second.present.Ranges()) {
+      RemoveChunks(it->first, range.start, range.end);
+    }
+    m_bytes -= it->second.present.Size();
+    m_recency.erase(it->second.position);
+    m_entries.erase(it);
+  }
+
+  // Evicts least recently used resources until the budget holds. |keep|, the resource just written, is
+  // never evicted.
+  void EvictLocked(uint64_t keep) {
+    auto victim = m_recency.begin();
+    while (m_bytes > m_capacityBytes && victim != m_recency.end()) {
+      if (*victim == keep) {
+        ++victim;
+        continue;
+      }
+      auto it = m_entries.find(*victim);
+      ++victim;
+      ++m_stats.evictions;
+      RemoveLocked(it);
+    }
+  }
+
+  // Rewrites the sidecar of |hash| from its current state. Sidecar writes are serialized among themselves
+  // and each snapshots the entry once it holds m_persistMutex, so the last one to land is never stale; a
+  // sidecar written for an entry removed meanwhile is deleted again.
+  void Persist(uint64_t hash) {
+    std::lock_guard<std::mutex> persist(m_persistMutex);
+    std::string bytes;
+    uint64_t generation = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_entries.find(hash);
+      if (it == m_entries.end()) {
+        return;
+      }
+      bytes = SerializeSidecar(it->second);
+      generation = it->second.generation;
+    }
+    WriteFileAtomically(SidecarPath(hash), bytes);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end() || it->second.generation != generation) {
+      std::error_code error;
+      std::filesystem::remove(SidecarPath(hash), error);
+    }
+  }
+
+  // Sidecar: magic | key | uint64 length | validator | content type | uint64 range count |
+  //   {uint64 start, end}..., each string as uint32 length | bytes
+  static std::string SerializeSidecar(Entry const &entry) {
+    std::string bytes(c_magic, sizeof(c_magic));
+    auto append = [&bytes](auto value) { bytes.append(reinterpret_cast<char const *>(&value), sizeof(value)); };
+    auto appendText = [&](std::string const &text) {
+      append(static_cast<uint32_t>(text.size()));
+      bytes.append(text);
+    };
+    appendText(entry.key);
+    append(entry.resource.length);
+    appendText(entry.resource.validator);
+    appendText(entry.resource.contentType);
+    append(static_cast<uint64_t>(entry.present.Ranges().size()));
+    for (auto const &range : entry.present.Ranges()) {
+      append(range.start);
+      append(range.end);
+    }
+    return bytes;
+  }
+
+  static bool LoadSidecar(std::filesystem::path const &path, Entry &entry) {
+    MappedFile file;
+    if (!file.Open(path)) {
+      return false;
+    }
+    std::string_view bytes(reinterpret_cast<char const *>(file.Data()), file.Size());
+    auto take = [&bytes](auto &value) {
+      if (bytes.size() < sizeof(value)) {
+        return false;
+      }
+      std::memcpy(&value, bytes.data(), sizeof(value));
+      bytes.remove_prefix(sizeof(value));
+      return true;
+    };
+    auto takeText = [&](std::string &text) {
+      uint32_t size = 0;
+      if (!take(size) || bytes.size() < size) {
+        return false;
+      }
+      text = std::string(bytes.substr(0, size));
+      bytes.remove_prefix(size);
+      return true;
+    };
+    uint64_t count = 0;
+    if (bytes.substr(0, sizeof(c_magic)) != std::string_view(c_magic, sizeof(c_magic))) {
+      return false;
+    }
+    bytes.remove_prefix(sizeof(c_magic));
+    if (!takeText(entry.key) || !take(entry.resource.length) || !takeText(entry.resource.validator) ||
+        !takeText(entry.resource.contentType) || !take(count) || bytes.size() != count * 2 * sizeof(uint64_t)) {
+      return false;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+      ByteRange range;
+      take(range.start);
+      take(range.end);
+      entry.present.Add(range.start, range.end);
+    }
+    return true;
+  }
+
+  std::filesystem::path const m_folder;
+  mutable std::mutex m_mutex;
+  std::mutex m_persistMutex; // taken before m_mutex, never while holding it
+  uint64_t m_capacityBytes;
+  uint64_t m_bytes = 0;
+  uint64_t m_generation = 0;
+  EntryMap m_entries;
+  std::list<uint64_t> m_recency; // least recently used first
+  SparseCacheStats m_stats;
+};
+
+} // namespace ReactNativeVideoCPP
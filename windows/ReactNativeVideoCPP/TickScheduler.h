@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// Portable (WinRT-free) bookkeeping for many periodic subscribers driven from one timer. Subscribers
+// sharing an interval are kept in one bucket with one deadline, so the owning timer only has to wake
+// up for the earliest bucket and never while there are no subscribers. Times are caller-supplied
+// milliseconds so the schedule can be driven by any clock. Each subscriber's bucket and slot are indexed,
+// so subscribing and unsubscribing stay O(1) however many views play at once.
+namespace ReactNativeVideoCPP {
+
+template <typename Subscriber>
+class TickScheduler {
+ public:
+  void Subscribe(Subscriber subscriber, int64_t intervalMs, int64_t nowMs) {
+    auto slot = m_slots.find(subscriber);
+    if (slot != m_slots.end() && slot->second.intervalMs == intervalMs) {
+      return;
+    }
+    Unsubscribe(subscriber);
+    auto &bucket = m_buckets[intervalMs];
+    if (bucket.subscribers.empty()) {
+      bucket.nextDueMs = nowMs + intervalMs;
+    }
+    m_slots[subscriber] = Slot{intervalMs, bucket.subscribers.size()};
+    bucket.subscribers.push_back(subscriber);
+  }
+
+  bool Unsubscribe(Subscriber subscriber) {
+    auto slot = m_slots.find(subscriber);
+    if (slot == m_slots.end()) {
+      return false;
+    }
+    auto bucket = m_buckets.find(slot->second.intervalMs);
+    auto &subscribers = bucket->second.subscribers;
+    // the last subscriber of the bucket takes the freed place
+    auto index = slot->second.index;
+    if (index + 1 != subscribers.size()) {
+      subscribers[index] = subscribers.back();
+      m_slots[subscribers[index]].index = index;
+    }
+    subscribers.pop_back();
+    if (subscribers.empty()) {
+      m_buckets.erase(bucket);
+    }
+    m_slots.erase(slot);
+    return true;
+  }
+
+  bool IsSubscribed(Subscriber subscriber) const {
+    return m_slots.count(subscriber) != 0;
+  }
+
+  bool Empty() const {
+    return m_buckets.empty();
+  }
+
+  // Earliest deadline over all buckets, or nullopt when nothing is subscribed.
+  std::optional<int64_t> NextDueMs() const {
+    std::optional<int64_t> next;
+    for (auto const &entry : m_buckets) {
+      if (!next || entry.second.nextDueMs < *next) {
+        next = entry.second.nextDueMs;
+      }
+    }
+    return next;
+  }
+
+  // Invokes |onDue| for every subscriber whose bucket deadline has passed and schedules the bucket's
+  // next deadline. A bucket that fell more than one interval behind skips the missed ticks rather than
+  // firing them in a burst. |onDue| may subscribe or unsubscribe.
+  template <typename OnDue>
+  void Advance(int64_t nowMs, OnDue &&onDue) {
+    m_due.clear();
+    for (auto &entry : m_buckets) {
+      auto &bucket = entry.second;
+      if (nowMs < bucket.nextDueMs) {
+        continue;
+      }
+      bucket.nextDueMs += entry.first;
+      if (bucket.nextDueMs <= nowMs) {
+        bucket.nextDueMs = nowMs + entry.first;
+      }
+      m_due.insert(m_due.end(), bucket.subscribers.begin(), bucket.subscribers.end());
+    }
+    for (auto const &subscriber : m_due) {
+      if (IsSubscribed(subscriber)) {
+        onDue(subscriber);
+      }
+    }
+  }
+
+ private:
+  struct Bucket {
+    int64_t nextDueMs = 0;
+    std::vector<Subscriber> subscribers;
+  };
+
+  struct Slot {
+    int64_t intervalMs = 0;
+    size_t index = 0; // in the bucket's subscribers
+  };
+
+  std::map<int64_t, Bucket> m_buckets;
+  std::unordered_map<Subscriber, Slot> m_slots;
+  std::vector<Subscriber> m_due;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+// Portable (WinRT-free) sorted set of disjoint [start, end) time ranges in seconds, kept as the cached
+// copy of a player's buffered or seekable ranges. It is refreshed when the player reports a change and
+// queried in O(log n) from the progress tick.
+namespace ReactNativeVideoCPP {
+
+struct TimeRange {
+  double start = 0;
+  double end = 0;
+};
+
+class TimeRangeSet {
+ public:
+  // Adds [start, end), merging it with any range it overlaps or touches.
+  void Add(double start, double end) {
+    if (!(end > start)) {
+      return;
+    }
+    auto first = std::lower_bound(
+        m_ranges.begin(), m_ranges.end(), start, [](TimeRange const &range, double t) { return range.end < t; });
+    auto last = first;
+    while (last != m_ranges.end() && last->start <= end) {
+      start = std::min(start, last->start);
+      end = std::max(end, last->end);
+      ++last;
+    }
+    first = m_ranges.erase(first, last);
+    m_ranges.insert(first, TimeRange{start, end});
+  }
+
+  void Clear() {
+    m_ranges.clear();
+  }
+
+  bool Empty() const {
+    return m_ranges.empty();
+  }
+
+  std::vector<TimeRange> const &Ranges() const {
+    return m_ranges;
+  }
+
+  // End of the range containing |t| (within |slack| seconds of its edges), or 0 when |t| is not in a
+  // range. This matches what iOS reports as playableDuration.
+  double EndOfRangeContaining(double t, double slack = 0.001) const {
+    auto it = std::lower_bound(
+        m_ranges.begin(), m_ranges.end(), t - slack, [](TimeRange const &range, double value) {
+          return range.end < value;
+        });
+    if (it != m_ranges.end() && it->start <= t + slack) {
+      return it->end;
+    }
+    return 0;
+  }
+
+  // Length of the first range, 0 when empty. This matches what iOS reports as seekableDuration.
+  double FirstRangeDuration() const {
+    return m_ranges.empty() ? 0 : m_ranges.front().end - m_ranges.front().start;
+  }
+
+ private:
+  std::vector<TimeRange> m_ranges;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,463 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "ManifestText.h"
+#include "XmlScanner.h"
+
+// Portable (WinRT-free) streaming parser for VAST 3 / 4 ad responses and the VMAP playlists that schedule
+// them. Only what linear video ads need is kept: the media files to choose from, the tracking and click
+// URLs, and for wrappers the URI of the next response in the chain. A VMAP document keeps its breaks
+// with either the ad tag to load or the VAST ads it embeds.
+namespace ReactNativeVideoCPP {
+
+struct VastMediaFile {
+  std::string url;
+  std::string type; // MIME type
+  std::string delivery; // progressive or streaming
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t bitrate = 0; // kbps, 0 when not given
+};
+
+struct VastTracking {
+  std::string event; // start, firstQuartile, midpoint, thirdQuartile, complete, progress, skip, ...
+  double offset = -1; // seconds into the ad for progress events
+  std::string url;
+};
+
+struct VastLinear {
+  double duration = 0; // seconds
+  double skipOffset = -1; // seconds, -1 when the ad cannot be skipped
+  std::vector<VastMediaFile> mediaFiles;
+  std::vector<VastTracking> tracking;
+  std::string clickThrough;
+  std::vector<std::string> clickTracking;
+};
+
+struct VastAd {
+  std::string id;
+  uint32_t sequence = 0; // position in an ad pod, 0 for a standalone ad
+  bool isWrapper = false;
+  std::string adTagUri; // the next response in the chain, for wrappers
+  std::string adSystem;
+  std::string title;
+  std::vector<std::string> impressions;
+  std::vector<std::string> errors;
+  bool hasLinear = false;
+  VastLinear linear; // for wrappers only tracking and click tracking, merged into the inline ad
+};
+
+// When a VMAP break is due. Percentages and "end" can only be placed once the content duration is known.
+struct VmapTimeOffset {
+  enum class Kind { Start, End, Seconds, Percent, Position };
+  Kind kind = Kind::Start;
+  double value = 0; // seconds, percent or 1-based position
+};
+
+struct VmapAdBreak {
+  std::string id;
+  std::string breakType; // linear, nonlinear, display
+  VmapTimeOffset timeOffset;
+  std::string adTagUri; // empty when the ads are embedded
+  std::vector<VastAd> ads; // embedded VASTAdData
+};
+
+struct VastDocument {
+  bool isVmap = false;
+  std::vector<VastAd> ads; // VAST
+  std::vector<VmapAdBreak> breaks; // VMAP
+  std::vector<std::string> errors; // the response's root Error URLs, e.g. for an empty (no fill) VAST
+};
+
+// Element text is usually indented CDATA, so line breaks are trimmed too.
+inline std::string_view TrimVastText(std::string_view text) {
+  auto begin = text.find_first_not_of(" \t\r\n");
+  auto end = text.find_last_not_of(" \t\r\n");
+  return begin == std::string_view::npos ? std::string_view() : text.substr(begin, end - begin + 1);
+}
+
+// "HH:MM:SS" or "HH:MM:SS.mmm".
+inline bool ParseVastTime(std::string_view text, double &seconds) {
+  text = TrimManifestText(text);
+  double parts[3] = {};
+  for (int i = 0; i < 3; ++i) {
+    auto colon = i < 2 ? text.find(':') : text.size();
+    if (colon == std::string_view::npos || !ParseManifestDecimal(text.substr(0, colon), parts[i])) {
+      return false;
+    }
+    text.remove_prefix(i < 2 ? colon + 1 : colon);
+  }
+  seconds = parts[0] * 3600 + parts[1] * 60 + parts[2];
+  return true;
+}
+
+// An offset into an ad: a time, or a percentage of |duration|.
+inline bool ParseVastOffset(std::string_view text, double duration, double &seconds) {
+  text = TrimManifestText(text);
+  if (!text.empty() && text.back() == '%') {
+    double percent = 0;
+    if (!ParseManifestDecimal(text.substr(0, text.size() - 1), percent)) {
+      return false;
+    }
+    seconds = duration * percent / 100;
+    return true;
+  }
+  return ParseVastTime(text, seconds);
+}
+
+inline bool ParseVmapTimeOffset(std::string_view text, VmapTimeOffset &offset) {
+  text = TrimManifestText(text);
+  if (text == "start") {
+    offset = {VmapTimeOffset::Kind::Start, 0};
+    return true;
+  }
+  if (text == "end") {
+    offset = {VmapTimeOffset::Kind::End, 0};
+    return true;
+  }
+  if (!text.empty() && text.front() == '#') {
+    offset.kind = VmapTimeOffset::Kind::Position;
+    return ParseManifestDecimal(text.substr(1), offset.value);
+  }
+  if (!text.empty() && text.back() == '%') {
+    offset.kind = VmapTimeOffset::Kind::Percent;
+    return ParseManifestDecimal(text.substr(0, text.size() - 1), offset.value);
+  }
+  offset.kind = VmapTimeOffset::Kind::Seconds;
+  return ParseVastTime(text, offset.value);
+}
+
+// The media file to play on a link of |bandwidth| bits per second (0 when unknown): the best one whose
+// bitrate fits in 80% of the link, else the lightest. Only files MediaPlayer can play are considered, so
+// VPAID and Flash creatives are never picked. Null when there is none.
+inline VastMediaFile const *SelectVastMediaFile(std::vector<VastMediaFile> const &files, uint64_t bandwidth) {
+  constexpr uint64_t c_unknownBandwidth = 1500000;
+  auto budget = (bandwidth != 0 ? bandwidth : c_unknownBandwidth) * 8 / 10;
+  auto playable = [](VastMediaFile const &file) {
+    auto const &type = file.type;
+    return type.compare(0, 6, "video/") == 0 || type == "application/x-mpegURL" ||
+        type == "application/vnd.apple.mpegurl" || type == "application/dash+xml";
+  };
+  VastMediaFile const *best = nullptr;
+  VastMediaFile const *lightest = nullptr;
+  for (auto const &file : files) {
+    if (!playable(file)) {
+      continue;
+    }
+    if (lightest == nullptr || file.bitrate < lightest->bitrate) {
+      lightest = &file;
+    }
+    // a file without a bitrate is assumed to fit; among equal bitrates the larger picture wins
+    if (uint64_t{file.bitrate} * 1000 <= budget &&
+        (best == nullptr || file.bitrate > best->bitrate ||
+         (file.bitrate == best->bitrate && file.height > best->height))) {
+      best = &file;
+    }
+  }
+  return best != nullptr ? best : lightest;
+}
+
+class VastParser {
+ public:
+  // Feeds the next chunk of the response, which may end anywhere.
+  void Feed(std::string_view chunk) {
+    m_scanner.Feed(chunk, [this](XmlEvent const &event) { OnEvent(event); });
+  }
+
+  // Completes the document. Returns false if the text was not a complete VAST or VMAP response; the parser
+  // is reset either way.
+  bool Finish(VastDocument &document) {
+    bool complete = m_scanner.Finish([this](XmlEvent const &event) { OnEvent(event); });
+    complete = complete && m_sawRoot && m_stack.empty();
+    if (complete) {
+      document = std::move(m_document);
+    }
+    *this = VastParser();
+    return complete;
+  }
+
+ private:
+  enum class Element {
+    Vast,
+    Ad,
+    InLine,
+    Wrapper,
+    AdSystem,
+    AdTitle,
+    Impression,
+    Error,
+    AdTagUri, // VASTAdTagURI of a wrapper, AdTagURI of a VMAP break
+    Linear,
+    Duration,
+    Tracking,
+    ClickThrough,
+    ClickTracking,
+    MediaFile,
+    Vmap,
+    AdBreak,
+    VastAdData,
+    Other
+  };
+
+  static Element Classify(std::string_view name) {
+    name = XmlLocalName(name);
+    constexpr std::pair<std::string_view, Element> c_elements[] = {
+        {"VAST", Element::Vast},
+        {"Ad", Element::Ad},
+        {"InLine", Element::InLine},
+        {"Wrapper", Element::Wrapper},
+        {"AdSystem", Element::AdSystem},
+        {"AdTitle", Element::AdTitle},
+        {"Impression", Element::Impression},
+        {"Error", Element::Error},
+        {"VASTAdTagURI", Element::AdTagUri},
+        {"AdTagURI", Element::AdTagUri},
+        {"Linear", Element::Linear},
+        {"Duration", Element::Duration},
+        {"Tracking", Element::Tracking},
+        {"ClickThrough", Element::ClickThrough},
+        {"ClickTracking", Element::ClickTracking},
+        {"MediaFile", Element::MediaFile},
+        {"VMAP", Element::Vmap},
+        {"AdBreak", Element::AdBreak},
+        {"VASTAdData", Element::VastAdData},
+    };
+    for (auto const &[elementName, element] : c_elements) {
+      if (name == elementName) {
+        return element;
+      }
+    }
+    return Element::Other;
+  }
+
+  bool Inside(Element element) const {
+    for (auto e : m_stack) {
+      if (e == element) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Ads go to the embedding break inside a VMAP document.
+  std::vector<VastAd> &Ads() {
+    return Inside(Element::VastAdData) && !m_document.breaks.empty() ? m_document.breaks.back().ads
+                                                                     : m_document.ads;
+  }
+
+  VastAd *CurrentAd() {
+    return Inside(Element::Ad) && !Ads().empty() ? &Ads().back() : nullptr;
+  }
+
+  void OnEvent(XmlEvent const &event) {
+    switch (event.type) {
+      case XmlEventType::StartElement:
+        m_stack.push_back(Classify(event.name));
+        m_text.clear();
+        OnStart(event.attributes);
+        break;
+      case XmlEventType::EndElement:
+        if (!m_stack.empty()) {
+          OnEnd();
+          m_stack.pop_back();
+        }
+        break;
+      case XmlEventType::Text:
+        m_text.append(event.text);
+        break;
+    }
+  }
+
+  void OnStart(std::string_view attributes) {
+    switch (m_stack.back()) {
+      case Element::Vast:
+        m_sawRoot = true;
+        break;
+      case Element::Vmap:
+        m_sawRoot = true;
+        m_document.isVmap = true;
+        break;
+      case Element::AdBreak: {
+        auto &adBreak = m_document.breaks.emplace_back();
+        ForEachXmlAttribute(attributes, [&adBreak](std::string_view name, std::string_view value) {
+          if (name == "breakId") {
+            adBreak.id = DecodeXmlText(value);
+          } else if (name == "breakType") {
+            adBreak.breakType = DecodeXmlText(value);
+          } else if (name == "timeOffset") {
+            ParseVmapTimeOffset(value, adBreak.timeOffset);
+          }
+        });
+        break;
+      }
+      case Element::Ad: {
+        auto &ad = Ads().emplace_back();
+        ForEachXmlAttribute(attributes, [&ad](std::string_view name, std::string_view value) {
+          uint64_t number = 0;
+          if (name == "id") {
+            ad.id = DecodeXmlText(value);
+          } else if (name == "sequence" && ParseManifestUnsigned(value, number)) {
+            ad.sequence = static_cast<uint32_t>(number);
+          }
+        });
+        break;
+      }
+      case Element::Wrapper:
+        if (auto *ad = CurrentAd()) {
+          ad->isWrapper = true;
+        }
+        break;
+      case Element::Linear:
+        if (auto *ad = CurrentAd()) {
+          ad->hasLinear = true;
+          ForEachXmlAttribute(attributes, [this](std::string_view name, std::string_view value) {
+            if (name == "skipoffset") {
+              m_skipOffset = std::string(value);
+            }
+          });
+        }
+        break;
+      case Element::Tracking:
+        m_tracking = VastTracking();
+        ForEachXmlAttribute(attributes, [this](std::string_view name, std::string_view value) {
+          if (name == "event") {
+            m_tracking.event = DecodeXmlText(value);
+          } else if (name == "offset") {
+            m_trackingOffset = std::string(value);
+          }
+        });
+        break;
+      case Element::MediaFile:
+        m_mediaFile = VastMediaFile();
+        ForEachXmlAttribute(attributes, [this](std::string_view name, std::string_view value) {
+          uint64_t number = 0;
+          if (name == "type") {
+            m_mediaFile.type = DecodeXmlText(value);
+          } else if (name == "delivery") {
+            m_mediaFile.delivery = DecodeXmlText(value);
+          } else if (name == "width" && ParseManifestUnsigned(value, number)) {
+            m_mediaFile.width = static_cast<uint32_t>(number);
+          } else if (name == "height" && ParseManifestUnsigned(value, number)) {
+            m_mediaFile.height = static_cast<uint32_t>(number);
+          } else if (name == "bitrate" && ParseManifestUnsigned(value, number)) {
+            m_mediaFile.bitrate = static_cast<uint32_t>(number);
+          }
+        });
+        break;
+      default:
+        break;
+    }
+  }
+
+  void OnEnd() {
+    auto text = DecodeXmlText(TrimVastText(m_text));
+    m_text.clear();
+    auto *ad = CurrentAd();
+    bool inLinear = Inside(Element::Linear);
+    switch (m_stack.back()) {
+      case Element::AdSystem:
+        if (ad != nullptr) {
+          ad->adSystem = std::move(text);
+        }
+        break;
+      case Element::AdTitle:
+        if (ad != nullptr) {
+          ad->title = std::move(text);
+        }
+        break;
+      case Element::Impression:
+        if (ad != nullptr && !text.empty()) {
+          ad->impressions.push_back(std::move(text));
+        }
+        break;
+      case Element::Error:
+        if (!text.empty()) {
+          (ad != nullptr ? ad->errors : m_document.errors).push_back(std::move(text));
+        }
+        break;
+      case Element::AdTagUri:
+        if (ad != nullptr) {
+          ad->adTagUri = std::move(text);
+        } else if (Inside(Element::AdBreak) && !m_document.breaks.empty()) {
+          m_document.breaks.back().adTagUri = std::move(text);
+        }
+        break;
+      case Element::Duration:
+        if (ad != nullptr && inLinear) {
+          ParseVastTime(text, ad->linear.duration);
+        }
+        break;
+      case Element::Linear:
+        // offsets may be percentages, so they wait for the duration
+        if (ad != nullptr && !m_skipOffset.empty()) {
+          ParseVastOffset(m_skipOffset, ad->linear.duration, ad->linear.skipOffset);
+        }
+        if (ad != nullptr) {
+          for (auto &tracking : ad->linear.tracking) {
+            if (tracking.offset == c_pendingPercent) {
+              tracking.offset = ad->linear.duration * m_pendingPercents.front() / 100;
+              m_pendingPercents.erase(m_pendingPercents.begin());
+            }
+          }
+        }
+        m_skipOffset.clear();
+        m_pendingPercents.clear();
+        break;
+      case Element::Tracking:
+        if (ad != nullptr && inLinear && !text.empty()) {
+          m_tracking.url = std::move(text);
+          if (!m_trackingOffset.empty()) {
+            auto offset = TrimManifestText(m_trackingOffset);
+            double percent = 0;
+            if (!offset.empty() && offset.back() == '%' &&
+                ParseManifestDecimal(offset.substr(0, offset.size() - 1), percent)) {
+              m_tracking.offset = c_pendingPercent;
+              m_pendingPercents.push_back(percent);
+            } else {
+              ParseVastTime(offset, m_tracking.offset);
+            }
+          }
+          ad->linear.tracking.push_back(std::move(m_tracking));
+        }
+        m_trackingOffset.clear();
+        break;
+      case Element::ClickThrough:
+        if (ad != nullptr && inLinear) {
+          ad->linear.clickThrough = std::move(text);
+        }
+        break;
+      case Element::ClickTracking:
+        if (ad != nullptr && inLinear && !text.empty()) {
+          ad->linear.clickTracking.push_back(std::move(text));
+        }
+        break;
+      case Element::MediaFile:
+        if (ad != nullptr && inLinear && !text.empty()) {
+          m_mediaFile.url = std::move(text);
+          ad->linear.mediaFiles.push_back(std::move(m_mediaFile));
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  static constexpr double c_pendingPercent = -2; // a progress offset still waiting for the ad's duration
+
+  XmlScanner m_scanner;
+  std::vector<Element> m_stack;
+  std::string m_text;
+  VastDocument m_document;
+  bool m_sawRoot = false;
+  VastTracking m_tracking;
+  std::string m_trackingOffset;
+  std::vector<double> m_pendingPercents;
+  std::string m_skipOffset;
+  VastMediaFile m_mediaFile;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "AdSchedule.h"
+#include "VastParser.h"
+
+// Portable (WinRT-free) loading of an ad tag into an ad schedule. Wrappers are followed until an inline ad
+// is reached, with the wrappers of a pod (and the ad tags of a VMAP playlist) fetched in parallel, so a
+// chain costs its depth in round trips rather than the number of ads in it. Every wrapper's impressions,
+// errors and tracking are carried into the inline ads it resolves to, since all of them must be fired.
+// When a chain yields no ad, the Error URLs along it are reported with the VAST error code of the failure.
+namespace ReactNativeVideoCPP {
+
+// VAST error codes the resolver and the player report.
+enum class VastError {
+  XmlParsing = 100,
+  UnexpectedLinearity = 201, // no linear creative
+  WrapperTimeout = 301, // the next response of a wrapper could not be fetched
+  WrapperLimit = 302,
+  NoAdsAfterWrapper = 303, // also sent for an empty (no fill) response
+  MediaFileNotSupported = 403,
+  MediaFileDisplay = 405,
+};
+
+// |url| with its [ERRORCODE] macro replaced by |error|.
+inline std::string VastErrorUrl(std::string url, VastError error) {
+  constexpr std::string_view c_macro = "[ERRORCODE]";
+  auto code = std::to_string(static_cast<int>(error));
+  for (auto at = url.find(c_macro); at != std::string::npos; at = url.find(c_macro, at + code.size())) {
+    url.replace(at, c_macro.size(), code);
+  }
+  return url;
+}
+
+class VastResolver {
+ public:
+  // |fetch(url, onChunk)| downloads |url| and hands its body to |onChunk(std::string_view)| as it arrives.
+  // Returns false on any failure. Called concurrently from several threads.
+  using OnChunk = std::function<void(std::string_view)>;
+  using Fetch = std::function<bool(std::string const &url, OnChunk const &onChunk)>;
+  // |report(url)| sends an Error URL, its macro already replaced. Also called concurrently.
+  using Report = std::function<void(std::string const &url)>;
+
+  static constexpr int c_maxWrapperDepth = 5; // the VAST recommendation
+
+  explicit VastResolver(Fetch fetch, Report report = nullptr, int maxWrapperDepth = c_maxWrapperDepth)
+      : m_fetch(std::move(fetch)), m_report(std::move(report)), m_maxWrapperDepth(maxWrapperDepth) {}
+
+  // The breaks of the ad tag at |url|: those of a VMAP playlist, or a single pre-roll for a VAST response.
+  // Breaks that end up without an ad (no fill, a broken chain) are left out. Blocks on the network.
+  std::vector<AdBreak> Load(std::string const &url) const {
+    std::vector<AdBreak> breaks;
+    VastDocument document;
+    VastError error;
+    if (!FetchDocument(url, document, error)) {
+      return breaks;
+    }
+    if (!document.isVmap) {
+      AdBreak preRoll;
+      preRoll.id = "preroll";
+      preRoll.ads = ResolveResponse(document);
+      if (!preRoll.ads.empty()) {
+        breaks.push_back(std::move(preRoll));
+      }
+      return breaks;
+    }
+
+    std::vector<std::future<std::vector<VastAd>>> pending;
+    for (auto &vmapBreak : document.breaks) {
+      if (!vmapBreak.ads.empty()) {
+        pending.push_back(std::async(std::launch::async, [this, ads = std::move(vmapBreak.ads)]() mutable {
+          return Resolve(std::move(ads), 0);
+        }));
+      } else {
+        pending.push_back(std::async(std::launch::async, [this, tag = vmapBreak.adTagUri]() {
+          VastDocument response;
+          VastError error;
+          return !tag.empty() && FetchDocument(tag, response, error) && !response.isVmap
+              ? ResolveResponse(response)
+              : std::vector<VastAd>();
+        }));
+      }
+    }
+    for (size_t i = 0; i < pending.size(); ++i) {
+      AdBreak adBreak;
+      adBreak.id = document.breaks[i].id;
+      adBreak.timeOffset = document.breaks[i].timeOffset;
+      adBreak.ads = pending[i].get();
+      if (!adBreak.ads.empty()) {
+        breaks.push_back(std::move(adBreak));
+      }
+    }
+    return breaks;
+  }
+
+  // The inline ads to play for the ads of one VAST response: its pod in sequence order, or else its first
+  // ad that resolves. Only ads with a linear creative and at least one media file are kept.
+  std::vector<VastAd> Resolve(std::vector<VastAd> ads, int depth) const {
+    return ResolveAds(std::move(ads), depth).ads;
+  }
+
+ private:
+  // Resolved ads, or why there are none.
+  struct Resolution {
+    std::vector<VastAd> ads;
+    VastError error = VastError::NoAdsAfterWrapper;
+  };
+
+  bool FetchDocument(std::string const &url, VastDocument &document, VastError &error) const {
+    VastParser parser;
+    if (!m_fetch(url, [&parser](std::string_view chunk) { parser.Feed(chunk); })) {
+      error = VastError::WrapperTimeout;
+      return false;
+    }
+    error = VastError::XmlParsing;
+    return parser.Finish(document);
+  }
+
+  void ReportErrors(std::vector<std::string> const &urls, VastError error) const {
+    if (m_report == nullptr) {
+      return;
+    }
+    for (auto const &url : urls) {
+      m_report(VastErrorUrl(url, error));
+    }
+  }
+
+  // The ads of a top-level response; an empty one is a no fill, reported to its root Error URLs.
+  std::vector<VastAd> ResolveResponse(VastDocument &document) const {
+    auto resolution = ResolveAds(std::move(document.ads), 0);
+    if (resolution.ads.empty()) {
+      ReportErrors(document.errors, VastError::NoAdsAfterWrapper);
+    }
+    return std::move(resolution.ads);
+  }
+
+  Resolution ResolveAds(std::vector<VastAd> ads, int depth) const {
+    bool isPod = std::any_of(ads.begin(), ads.end(), [](VastAd const &ad) { return ad.sequence != 0; });
+    Resolution resolution;
+    if (!isPod) {
+      // fallbacks are tried one after the other: started in parallel, the ones not needed would still
+      // have to be waited for
+      for (auto &ad : ads) {
+        auto one = ResolveAd(std::move(ad), depth);
+        if (!one.ads.empty()) {
+          return one;
+        }
+        resolution.error = one.error;
+      }
+      return resolution;
+    }
+
+    ads.erase(std::remove_if(ads.begin(), ads.end(), [](VastAd const &ad) { return ad.sequence == 0; }), ads.end());
+    std::stable_sort(
+        ads.begin(), ads.end(), [](VastAd const &a, VastAd const &b) { return a.sequence < b.sequence; });
+    std::vector<std::future<Resolution>> pending;
+    for (auto &ad : ads) {
+      if (ad.isWrapper) {
+        pending.push_back(std::async(std::launch::async, [this, wrapper = std::move(ad), depth]() mutable {
+          return ResolveAd(std::move(wrapper), depth);
+        }));
+      } else {
+        std::promise<Resolution> ready;
+        ready.set_value(ResolveAd(std::move(ad), depth));
+        pending.push_back(ready.get_future());
+      }
+    }
+    for (auto &future : pending) {
+      auto one = future.get();
+      if (one.ads.empty()) {
+        resolution.error = one.error;
+      }
+      for (auto &ad : one.ads) {
+        resolution.ads.push_back(std::move(ad));
+      }
+    }
+    return resolution;
+  }
+
+  Resolution ResolveAd(VastAd ad, int depth) const {
+    Resolution resolution;
+    if (!ad.isWrapper) {
+      if (!ad.hasLinear || ad.linear.mediaFiles.empty()) {
+        resolution.error = ad.hasLinear ? VastError::MediaFileNotSupported : VastError::UnexpectedLinearity;
+        ReportErrors(ad.errors, resolution.error);
+        return resolution;
+      }
+      resolution.ads.push_back(std::move(ad));
+      return resolution;
+    }
+    if (depth >= m_maxWrapperDepth || ad.adTagUri.empty()) {
+      resolution.error = ad.adTagUri.empty() ? VastError::NoAdsAfterWrapper : VastError::WrapperLimit;
+      ReportErrors(ad.errors, resolution.error);
+      return resolution;
+    }
+    resolution = Unwrap(ad, depth + 1);
+    if (resolution.ads.empty()) {
+      ReportErrors(ad.errors, resolution.error); // every wrapper of a failed chain reports its failure
+    }
+    return resolution;
+  }
+
+  Resolution Unwrap(VastAd const &wrapper, int depth) const {
+    Resolution resolution;
+    VastDocument document;
+    if (!FetchDocument(wrapper.adTagUri, document, resolution.error)) {
+      return resolution;
+    }
+    if (document.isVmap) {
+      resolution.error = VastError::NoAdsAfterWrapper;
+      return resolution;
+    }
+    resolution = ResolveAds(std::move(document.ads), depth);
+    if (resolution.ads.empty()) {
+      ReportErrors(document.errors, VastError::NoAdsAfterWrapper);
+    }
+    for (auto &ad : resolution.ads) {
+      Merge(wrapper, ad);
+    }
+    return resolution;
+  }
+
+  static void Merge(VastAd const &wrapper, VastAd &ad) {
+    auto append = [](auto &to, auto const &from) { to.insert(to.end(), from.begin(), from.end()); };
+    append(ad.impressions, wrapper.impressions);
+    append(ad.errors, wrapper.errors);
+    append(ad.linear.tracking, wrapper.linear.tracking);
+    append(ad.linear.clickTracking, wrapper.linear.clickTracking);
+    if (ad.sequence == 0) {
+      ad.sequence = wrapper.sequence;
+    }
+  }
+
+  Fetch m_fetch;
+  Report m_report;
+  int m_maxWrapperDepth;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include "EventSchema.h"
+
+// Payloads of the events ReactVideoView sends to JS, and their schemas (key names and field order).
+namespace ReactNativeVideoCPP {
+
+struct NaturalSizePayload {
+  int64_t width = 0;
+  int64_t height = 0;
+  std::wstring_view orientation;
+};
+
+struct LoadEventPayload {
+  double duration = 0;
+  double currentTime = 0;
+  NaturalSizePayload naturalSize;
+  bool canPlayFastForward = false;
+  bool canPlaySlowForward = false;
+  bool canPlaySlow = false;
+  bool canStepBackward = false;
+  bool canStepForward = false;
+};
+
+struct ProgressEventPayload {
+  double currentTime = 0;
+  double playableDuration = 0;
+  double seekableDuration = 0;
+};
+
+struct SeekEventPayload {
+  double currentTime = 0;
+  double seekTime = 0;
+};
+
+struct BandwidthEventPayload {
+  double bitrate = 0;
+  int64_t width = 0;
+  int64_t height = 0;
+  std::wstring_view trackId;
+};
+
+// Same event names as the IMA based iOS and Android players (AD_BREAK_STARTED, STARTED, COMPLETE, ...).
+struct AdEventPayload {
+  std::wstring_view event;
+  int64_t target = -1; // the view's React tag
+};
+
+// A server-side inserted ad break found in the stream's playlist, entered or left by playback.
+struct AdCueEventPayload {
+  std::wstring_view event; // AD_BREAK_STARTED or AD_BREAK_ENDED
+  std::wstring_view id;
+  double startTime = 0;
+  double endTime = -1; // -1 while the break's end is not known yet
+  double duration = 0; // the planned length, 0 when not given
+  int64_t spliceEventId = 0; // 0 without an SCTE-35 payload
+  int64_t target = -1;
+};
+
+template <>
+struct EventSchemaOf<NaturalSizePayload> {
+  static constexpr auto Fields = std::make_tuple(
+      Field(L"width", &NaturalSizePayload::width),
+      Field(L"height", &NaturalSizePayload::height),
+      Field(L"orientation", &NaturalSizePayload::orientation));
+};
+
+template <>
+struct EventSchemaOf<LoadEventPayload> {
+  static constexpr auto Fields = std::make_tuple(
+      Field(L"duration", &LoadEventPayload::duration),
+      Field(L"currentTime", &LoadEventPayload::currentTime),
+      Field(L"naturalSize", &LoadEventPayload::naturalSize),
+      Field(L"canPlayFastForward", &LoadEventPayload::canPlayFastForward),
+      Field(L"canPlaySlowForward", &LoadEventPayload::canPlaySlowForward),
+      Field(L"canPlaySlow", &LoadEventPayload::canPlaySlow),
+      Field(L"canStepBackward", &LoadEventPayload::canStepBackward),
+      Field(L"canStepForward", &LoadEventPayload::canStepForward));
+};
+
+template <>
+struct EventSchemaOf<ProgressEventPayload> {
+  static constexpr auto Fields = std::make_tuple(
+      Field(L"currentTime", &ProgressEventPayload::currentTime),
+      Field(L"playableDuration", &ProgressEventPayload::playableDuration),
+      Field(L"seekableDuration", &ProgressEventPayload::seekableDuration));
+};
+
+template <>
+struct EventSchemaOf<SeekEventPayload> {
+  static constexpr auto Fields = std::make_tuple(
+      Field(L"currentTime", &SeekEventPayload::currentTime),
+      Field(L"seekTime", &SeekEventPayload::seekTime));
+};
+
+template <>
+struct EventSchemaOf<BandwidthEventPayload> {
+  static constexpr auto Fields = std::make_tuple(
+      Field(L"bitrate", &BandwidthEventPayload::bitrate),
+      Field(L"width", &BandwidthEventPayload::width),
+      Field(L"height", &BandwidthEventPayload::height),
+      Field(L"trackId", &BandwidthEventPayload::trackId));
+};
+
+template <>
+struct EventSchemaOf<AdEventPayload> {
+  static constexpr auto Fields =
+      std::make_tuple(Field(L"event", &AdEventPayload::event), Field(L"target", &AdEventPayload::target));
+};
+
+template <>
+struct EventSchemaOf<AdCueEventPayload> {
+  static constexpr auto Fields = std::make_tuple(
+      Field(L"event", &AdCueEventPayload::event),
+      Field(L"id", &AdCueEventPayload::id),
+      Field(L"startTime", &AdCueEventPayload::startTime),
+      Field(L"endTime", &AdCueEventPayload::endTime),
+      Field(L"duration", &AdCueEventPayload::duration),
+      Field(L"spliceEventId", &AdCueEventPayload::spliceEventId),
+      Field(L"target", &AdCueEventPayload::target));
+};
+
+} // namespace ReactNativeVideoCPP
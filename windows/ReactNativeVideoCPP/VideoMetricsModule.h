@@ -0,0 +1,106 @@
+#pragma once
+
+#include "NativeModules.h"
+#include "AdLoader.h"
+#include "BeaconDispatcher.h"
+#include "MediaCache.h"
+#include "PlaybackStateBlock.h"
+#include "QoeCollector.h"
+#include "VideoPropSnapshot.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// Exposes a Video's quality-of-experience counters (startup time, stalls, seeks, errors), its prop update
+// counters and the segment cache counters to JS on demand.
+REACT_MODULE(VideoMetricsModule, L"VideoMetrics")
+struct VideoMetricsModule {
+  REACT_SYNC_METHOD(GetQoeSnapshot, L"getQoeSnapshot")
+  Microsoft::ReactNative::JSValue GetQoeSnapshot(int64_t viewTag) noexcept {
+    auto collector = ::ReactNativeVideoCPP::QoeRegistry::Instance().Find(viewTag);
+    if (!collector) {
+      return nullptr;
+    }
+
+    auto snapshot = collector->Snapshot(::ReactNativeVideoCPP::PlaybackStateBlock::NowMs());
+    Microsoft::ReactNative::JSValueArray stallHistogram;
+    for (auto count : snapshot.stallHistogram) {
+      stallHistogram.push_back(static_cast<int64_t>(count));
+    }
+    Microsoft::ReactNative::JSValueArray stallBucketBounds;
+    for (auto bound : ::ReactNativeVideoCPP::c_stallBucketBoundsMs) {
+      stallBucketBounds.push_back(bound);
+    }
+
+    return Microsoft::ReactNative::JSValueObject{
+        {"timeToFirstFrame", snapshot.timeToFirstFrameMs},
+        {"rebufferCount", static_cast<int64_t>(snapshot.rebufferCount)},
+        {"rebufferDuration", snapshot.rebufferMs},
+        {"playDuration", snapshot.playMs},
+        {"rebufferRatio", snapshot.rebufferRatio},
+        {"seekCount", static_cast<int64_t>(snapshot.seekCount)},
+        {"seekLatencyAvg", snapshot.seekLatencyAvgMs},
+        {"seekLatencyMax", snapshot.seekLatencyMaxMs},
+        {"errorCount", static_cast<int64_t>(snapshot.errorCount)},
+        {"stallHistogram", std::move(stallHistogram)},
+        {"stallBucketBounds", std::move(stallBucketBounds)},
+        {"droppedFrameSamples", static_cast<int64_t>(snapshot.droppedFrameSamples)},
+        {"droppedFramesP50", snapshot.droppedFramesP50},
+        {"droppedFramesP95", snapshot.droppedFramesP95},
+        {"droppedFramesP99", snapshot.droppedFramesP99},
+    };
+  }
+
+  REACT_SYNC_METHOD(GetPropUpdateStats, L"getPropUpdateStats")
+  Microsoft::ReactNative::JSValue GetPropUpdateStats(int64_t viewTag) noexcept {
+    auto counters = ::ReactNativeVideoCPP::PropUpdateRegistry::Instance().Find(viewTag);
+    if (!counters) {
+      return nullptr;
+    }
+
+    auto stats = counters->Read();
+    return Microsoft::ReactNative::JSValueObject{
+        {"applied", static_cast<int64_t>(stats.applied)},
+        {"skipped", static_cast<int64_t>(stats.skipped)},
+    };
+  }
+
+  REACT_SYNC_METHOD(GetCacheStats, L"getCacheStats")
+  Microsoft::ReactNative::JSValue GetCacheStats() noexcept {
+    auto stats = MediaCache::Instance().Stats();
+    auto progressive = MediaCache::Instance().ProgressiveStats();
+    auto creatives = MediaCache::Instance().ProgressiveStats(RangeCache::AdCreatives);
+    auto flights = MediaCache::Instance().Flights().Stats();
+    auto adPrefetch = AdLoader::Instance().Prefetches().Stats();
+    auto beacons = BeaconDispatcher::Instance().Stats();
+    return Microsoft::ReactNative::JSValueObject{
+        {"hits", static_cast<int64_t>(stats.hits)},
+        {"misses", static_cast<int64_t>(stats.misses)},
+        {"insertions", static_cast<int64_t>(stats.insertions)},
+        {"evictions", static_cast<int64_t>(stats.evictions)},
+        {"evictedBytes", static_cast<int64_t>(stats.evictedBytes)},
+        {"rejected", static_cast<int64_t>(stats.rejected)},
+        {"entries", static_cast<int64_t>(stats.entries)},
+        {"bytes", static_cast<int64_t>(stats.bytes)},
+        {"capacityBytes", static_cast<int64_t>(stats.capacityBytes)},
+        {"progressiveResources", static_cast<int64_t>(progressive.resources)},
+        {"progressiveBytes", static_cast<int64_t>(progressive.bytes)},
+        {"progressiveCachedBytes", static_cast<int64_t>(progressive.cachedBytes)},
+        {"progressiveFetchedBytes", static_cast<int64_t>(progressive.fetchedBytes)},
+        {"dedupedRequests", static_cast<int64_t>(flights.joined)},
+        {"dedupedBytes", static_cast<int64_t>(flights.dedupedBytes)},
+        {"adPrefetches", static_cast<int64_t>(adPrefetch.prefetches)},
+        {"adPrefetchedBytes", static_cast<int64_t>(adPrefetch.prefetchedBytes)},
+        {"adPrefetchHits", static_cast<int64_t>(adPrefetch.hits)},
+        {"adPrefetchMisses", static_cast<int64_t>(adPrefetch.misses)},
+        {"adPrefetchWastedBytes", static_cast<int64_t>(adPrefetch.wastedBytes)},
+        {"adCreativeBytes", static_cast<int64_t>(creatives.bytes)},
+        {"adBeaconsQueued", static_cast<int64_t>(beacons.queued)},
+        {"adBeaconsDelivered", static_cast<int64_t>(beacons.delivered)},
+        {"adBeaconRetries", static_cast<int64_t>(beacons.retries)},
+        {"adBeaconsDropped", static_cast<int64_t>(beacons.dropped)},
+        {"adBeaconsPending", static_cast<int64_t>(beacons.pending)},
+    };
+  }
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "NativeModules.h"
+#include "PlaybackStateBlock.h"
+
+namespace winrt::ReactNativeVideoCPP::implementation {
+
+// Lets JS poll a Video's playback state synchronously, e.g. from an animation frame callback, instead
+// of relying on the topProgress event stream.
+REACT_MODULE(VideoPlaybackStateModule, L"VideoPlaybackState")
+struct VideoPlaybackStateModule {
+  REACT_SYNC_METHOD(GetPlaybackState, L"getPlaybackState")
+  Microsoft::ReactNative::JSValue GetPlaybackState(int64_t viewTag) noexcept {
+    auto block = ::ReactNativeVideoCPP::PlaybackStateRegistry::Instance().Find(viewTag);
+    if (!block) {
+      return nullptr;
+    }
+
+    auto state = block->Read();
+    return Microsoft::ReactNative::JSValueObject{
+        {"currentTime", state.PositionAt(::ReactNativeVideoCPP::PlaybackStateBlock::NowMs())},
+        {"bufferedEnd", state.bufferedEnd},
+        {"rate", state.rate},
+        {"state", ::ReactNativeVideoCPP::PlaybackStatusName(state.status)},
+        {"bitrate", static_cast<int64_t>(state.bitrate)},
+    };
+  }
+};
+
+} // namespace winrt::ReactNativeVideoCPP::implementation
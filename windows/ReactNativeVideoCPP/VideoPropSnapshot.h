@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "ViewRegistry.h"
+
+// Portable (WinRT-free) per-view record of which prop values have already reached the native player.
+// Setters route through Assign() and only touch the player when it reports a change, so re-sent props
+// (every render of a list item re-sends its whole prop set) don't rebuild sources or poke MediaPlayer.
+namespace ReactNativeVideoCPP {
+
+enum class VideoProp : uint32_t {
+  Uri,
+  ShouldCache,
+  IsLoopingEnabled,
+  Paused,
+  Muted,
+  Volume,
+  Controls,
+  FullScreen,
+  ProgressUpdateInterval,
+  AutoPlay,
+  PlaybackRate,
+  ReportBandwidth,
+  MaxBitRate,
+  BufferConfig,
+  ViewportOversampling,
+  AdTagUrl,
+  ReportAdCues,
+  Count
+};
+
+struct PropUpdateStats {
+  uint64_t applied = 0;
+  uint64_t skipped = 0;
+};
+
+// The counters behind PropUpdateStats, written on the UI thread and read by the metrics module from the JS
+// thread.
+struct PropUpdateCounters {
+  std::atomic<uint64_t> applied{0};
+  std::atomic<uint64_t> skipped{0};
+
+  PropUpdateStats Read() const {
+    return PropUpdateStats{applied.load(std::memory_order_relaxed), skipped.load(std::memory_order_relaxed)};
+  }
+};
+
+class VideoPropSnapshot {
+ public:
+  // Stores |value| into |field| and returns true when the prop has never been applied or its value
+  // differs from the last applied one. Returns false (and counts a skipped setter) otherwise.
+  template <typename T, typename U>
+  bool Assign(VideoProp prop, T &field, U const &value) {
+    bool changed = Store(prop, field, value);
+    (changed ? m_counters->applied : m_counters->skipped).fetch_add(1, std::memory_order_relaxed);
+    return changed;
+  }
+
+  // Assign() for a value the view sets on itself (e.g. controls forced on by full screen), which is not a
+  // prop update from JS and so is left out of the stats.
+  template <typename T, typename U>
+  bool AssignInternal(VideoProp prop, T &field, U const &value) {
+    return Store(prop, field, value);
+  }
+
+  // Forgets the last applied value so the next Assign() always goes through, e.g. after the player
+  // state was changed behind the snapshot's back.
+  void Invalidate(VideoProp prop) {
+    m_known.reset(static_cast<size_t>(prop));
+  }
+
+  bool IsApplied(VideoProp prop) const {
+    return m_known.test(static_cast<size_t>(prop));
+  }
+
+  PropUpdateStats Stats() const {
+    return m_counters->Read();
+  }
+
+  // Shared so the counters can be registered under the view's React tag.
+  std::shared_ptr<PropUpdateCounters> const &Counters() const {
+    return m_counters;
+  }
+
+ private:
+  template <typename T, typename U>
+  bool Store(VideoProp prop, T &field, U const &value) {
+    auto const index = static_cast<size_t>(prop);
+    if (m_known.test(index) && field == value) {
+      return false;
+    }
+    field = value;
+    m_known.set(index);
+    return true;
+  }
+
+  static constexpr size_t PropCount = static_cast<size_t>(VideoProp::Count);
+
+  std::bitset<PropCount> m_known;
+  std::shared_ptr<PropUpdateCounters> m_counters = std::make_shared<PropUpdateCounters>();
+};
+
+using PropUpdateRegistry = ViewRegistry<PropUpdateCounters>;
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+// Portable (WinRT-free) process-wide lookup of per-view shared objects by React view tag, so native
+// modules can reach state owned by a view from any thread.
+namespace ReactNativeVideoCPP {
+
+template <typename T>
+class ViewRegistry {
+ public:
+  static ViewRegistry &Instance() {
+    static auto *registry = new ViewRegistry();
+    return *registry;
+  }
+
+  void Register(int64_t tag, std::shared_ptr<T> value) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_values[tag] = std::move(value);
+  }
+
+  // Removes |tag| only if it still maps to |value|, so a late unregister can't drop a newer view.
+  void Unregister(int64_t tag, T const *value) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_values.find(tag);
+    if (it != m_values.end() && it->second.get() == value) {
+      m_values.erase(it);
+    }
+  }
+
+  std::shared_ptr<T> Find(int64_t tag) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_values.find(tag);
+    return it != m_values.end() ? it->second : nullptr;
+  }
+
+ private:
+  mutable std::shared_mutex m_mutex;
+  std::unordered_map<int64_t, std::shared_ptr<T>> m_values;
+};
+
+} // namespace ReactNativeVideoCPP
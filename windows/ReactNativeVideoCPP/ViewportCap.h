@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+// Portable (WinRT-free) cap on the rendition a view plays, derived from the view's on-screen size. The
+// adaptive source only lists bitrates, so the cap learns the frame size of each rendition as it plays and
+// estimates the others from the nearest known one, assuming pixels scale with bitrate. Like ExoPlayer's
+// viewport constraint it keeps the smallest rendition that covers the viewport, plus everything below.
+namespace ReactNativeVideoCPP {
+
+class ViewportCap {
+ public:
+  // On-screen size in physical pixels; 0 disables the cap until the view has been laid out.
+  void SetViewport(double widthPx, double heightPx) {
+    m_viewportPixels = std::max(widthPx, 0.0) * std::max(heightPx, 0.0);
+  }
+
+  // Multiplier on each viewport dimension; 0 disables the cap.
+  void SetOversampling(double oversampling) {
+    m_oversampling = oversampling;
+  }
+
+  // Lifts the cap, e.g. while the view is fullscreen.
+  void SetLifted(bool lifted) {
+    m_lifted = lifted;
+  }
+
+  void ObserveRendition(uint32_t bitrate, uint32_t width, uint32_t height) {
+    if (bitrate != 0 && width != 0 && height != 0) {
+      m_pixelsByBitrate[bitrate] = static_cast<double>(width) * height;
+    }
+  }
+
+  // Forgets observed renditions, e.g. when the source changes.
+  void Reset() {
+    m_pixelsByBitrate.clear();
+  }
+
+  // Highest bitrate of the ascending |bitrates| the view may play, 0 for no cap.
+  uint32_t MaxBitrate(std::vector<uint32_t> const &bitrates) const {
+    if (m_lifted || m_oversampling <= 0 || m_viewportPixels <= 0 || m_pixelsByBitrate.empty()) {
+      return 0;
+    }
+    auto target = m_viewportPixels * m_oversampling * m_oversampling;
+    for (auto bitrate : bitrates) {
+      if (EstimatePixels(bitrate) >= target) {
+        return bitrate;
+      }
+    }
+    return 0; // no rendition covers the viewport, all of them are fair game
+  }
+
+ private:
+  double EstimatePixels(uint32_t bitrate) const {
+    auto above = m_pixelsByBitrate.lower_bound(bitrate);
+    if (above != m_pixelsByBitrate.end() && above->first == bitrate) {
+      return above->second;
+    }
+    // scale from the nearest known rendition on either side
+    auto nearest = above;
+    if (above == m_pixelsByBitrate.end() ||
+        (above != m_pixelsByBitrate.begin() && bitrate - std::prev(above)->first < above->first - bitrate)) {
+      nearest = std::prev(above);
+    }
+    return nearest->second * bitrate / nearest->first;
+  }
+
+  double m_viewportPixels = 0;
+  double m_oversampling = 1;
+  bool m_lifted = false;
+  std::map<uint32_t, double> m_pixelsByBitrate;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+// Portable (WinRT-free) SAX-style XML scanner for manifests (MPD, VAST). Text is fed in arbitrary chunks and
+// reported as start tag / end tag / text events whose views point into the chunk, so nothing is copied
+// unless a tag straddles two chunks. No DTD, namespace or entity processing is done: names keep their
+// prefix and values are raw, see DecodeXmlText.
+namespace ReactNativeVideoCPP {
+
+enum class XmlEventType { StartElement, EndElement, Text };
+
+// Views are only valid for the duration of the callback.
+struct XmlEvent {
+  XmlEventType type;
+  std::string_view name; // element name with any namespace prefix, empty for text
+  std::string_view attributes; // raw attribute list of a start tag, see ForEachXmlAttribute
+  std::string_view text; // character data, CDATA sections are reported as text too
+};
+
+// Strips the namespace prefix from an element or attribute name.
+inline std::string_view XmlLocalName(std::string_view name) {
+  auto colon = name.find(':');
+  return colon == std::string_view::npos ? name : name.substr(colon + 1);
+}
+
+// Calls |onAttribute(localName, rawValue)| for each attribute of a start tag.
+template <typename OnAttribute>
+void ForEachXmlAttribute(std::string_view attributes, OnAttribute &&onAttribute) {
+  while (true) {
+    auto equals = attributes.find('=');
+    if (equals == std::string_view::npos) {
+      return;
+    }
+    auto name = attributes.substr(0, equals);
+    auto begin = name.find_first_not_of(" \t\r\n");
+    auto end = name.find_last_not_of(" \t\r\n");
+    name = begin == std::string_view::npos ? std::string_view() : name.substr(begin, end - begin + 1);
+    attributes.remove_prefix(equals + 1);
+    auto quote = attributes.find_first_of("\"'");
+    if (quote == std::string_view::npos) {
+      return;
+    }
+    auto close = attributes.find(attributes[quote], quote + 1);
+    if (close == std::string_view::npos) {
+      return;
+    }
+    onAttribute(XmlLocalName(name), attributes.substr(quote + 1, close - quote - 1));
+    attributes.remove_prefix(close + 1);
+  }
+}
+
+// Resolves the predefined entities and numeric character references of a raw value or text.
+inline std::string DecodeXmlText(std::string_view raw) {
+  std::string decoded;
+  decoded.reserve(raw.size());
+  while (!raw.empty()) {
+    auto amp = raw.find('&');
+    decoded.append(raw.substr(0, amp));
+    if (amp == std::string_view::npos) {
+      break;
+    }
+    raw.remove_prefix(amp);
+    auto semicolon = raw.find(';');
+    auto entity = raw.substr(1, semicolon == std::string_view::npos ? 0 : semicolon - 1);
+    char32_t code = 0;
+    if (entity == "amp") {
+      code = '&';
+    } else if (entity == "lt") {
+      code = '<';
+    } else if (entity == "gt") {
+      code = '>';
+    } else if (entity == "quot") {
+      code = '"';
+    } else if (entity == "apos") {
+      code = '\'';
+    } else if (entity.size() > 1 && entity[0] == '#') {
+      bool hex = entity[1] == 'x' || entity[1] == 'X';
+      for (auto c : entity.substr(hex ? 2 : 1)) {
+        auto lower = c | 0x20;
+        auto digit = c >= '0' && c <= '9' ? c - '0' : hex && lower >= 'a' && lower <= 'f' ? lower - 'a' + 10 : -1;
+        if (digit < 0) {
+          code = 0;
+          break;
+        }
+        code = code * (hex ? 16 : 10) + static_cast<char32_t>(digit);
+      }
+    }
+    if (code == 0 || code > 0x10FFFF) {
+      // not an entity we know, keep it verbatim
+      decoded.push_back('&');
+      raw.remove_prefix(1);
+      continue;
+    }
+    // UTF-8 encode
+    if (code < 0x80) {
+      decoded.push_back(static_cast<char>(code));
+    } else if (code < 0x800) {
+      decoded.push_back(static_cast<char>(0xC0 | (code >> 6)));
+      decoded.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else if (code < 0x10000) {
+      decoded.push_back(static_cast<char>(0xE0 | (code >> 12)));
+      decoded.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      decoded.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+      decoded.push_back(static_cast<char>(0xF0 | (code >> 18)));
+      decoded.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      decoded.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      decoded.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+    }
+    raw.remove_prefix(semicolon + 1);
+  }
+  return decoded;
+}
+
+class XmlScanner {
+ public:
+  // Scans |chunk| and calls |onEvent(XmlEvent const &)| for every complete piece of markup. An incomplete
+  // tag or text run at the end of the chunk is kept until the next Feed.
+  template <typename OnEvent>
+  void Feed(std::string_view chunk, OnEvent &&onEvent) {
+    if (m_pending.empty()) {
+      auto consumed = Scan(chunk, onEvent);
+      m_pending.assign(chunk.substr(consumed));
+    } else {
+      m_pending.append(chunk);
+      auto consumed = Scan(m_pending, onEvent);
+      m_pending.erase(0, consumed);
+    }
+  }
+
+  // Flushes trailing text. Returns false if the input ended inside a tag.
+  template <typename OnEvent>
+  bool Finish(OnEvent &&onEvent) {
+    bool complete = m_pending.find('<') == std::string::npos;
+    if (complete && !m_pending.empty()) {
+      onEvent(XmlEvent{XmlEventType::Text, {}, {}, m_pending});
+    }
+    m_pending.clear();
+    return complete;
+  }
+
+  void Reset() {
+    m_pending.clear();
+  }
+
+ private:
+  // Returns the number of bytes of |text| fully consumed.
+  template <typename OnEvent>
+  static size_t Scan(std::string_view text, OnEvent &onEvent) {
+    size_t position = 0;
+    while (position < text.size()) {
+      auto open = text.find('<', position);
+      if (open == std::string_view::npos) {
+        return position; // the text run may continue in the next chunk
+      }
+      if (open > position) {
+        onEvent(XmlEvent{XmlEventType::Text, {}, {}, text.substr(position, open - position)});
+        position = open;
+      }
+      auto markup = text.substr(open);
+      size_t end = std::string_view::npos;
+      if (markup.substr(0, 4) == "<!--") {
+        end = Skip(markup, "-->", 4);
+      } else if (markup.substr(0, 9) == "<![CDATA[") {
+        end = Skip(markup, "]]>", 9);
+        if (end != std::string_view::npos) {
+          onEvent(XmlEvent{XmlEventType::Text, {}, {}, markup.substr(9, end - 12)});
+        }
+      } else if (markup.substr(0, 2) == "<?") {
+        end = Skip(markup, "?>", 2);
+      } else if (markup.size() < 9 && (markup == std::string_view("<![CDATA[").substr(0, markup.size()) ||
+                                       markup == std::string_view("<!--").substr(0, markup.size()))) {
+        return position; // can't tell the markup apart yet
+      } else if (markup.substr(0, 2) == "<!") {
+        end = Skip(markup, ">", 2); // DOCTYPE, internal subsets are not supported
+      } else {
+        end = TagEnd(markup);
+        if (end != std::string_view::npos) {
+          EmitTag(markup.substr(1, end - 2), onEvent);
+        }
+      }
+      if (end == std::string_view::npos) {
+        return position;
+      }
+      position = open + end;
+    }
+    return position;
+  }
+
+  static size_t Skip(std::string_view markup, std::string_view terminator, size_t from) {
+    auto found = markup.find(terminator, from);
+    return found == std::string_view::npos ? found : found + terminator.size();
+  }
+
+  // Length of the tag at the start of |markup| including its '>', npos if incomplete. Quoted values may
+  // contain '>'.
+  static size_t TagEnd(std::string_view markup) {
+    char quote = 0;
+    for (size_t i = 1; i < markup.size(); ++i) {
+      auto c = markup[i];
+      if (quote != 0) {
+        quote = c == quote ? 0 : quote;
+      } else if (c == '"' || c == '\'') {
+        quote = c;
+      } else if (c == '>') {
+        return i + 1;
+      }
+    }
+    return std::string_view::npos;
+  }
+
+  // |tag| is the text between '<' and '>'.
+  template <typename OnEvent>
+  static void EmitTag(std::string_view tag, OnEvent &onEvent) {
+    if (!tag.empty() && tag.front() == '/') {
+      auto name = tag.substr(1, tag.find_first_of(" \t\r\n", 1) - 1);
+      onEvent(XmlEvent{XmlEventType::EndElement, name, {}, {}});
+      return;
+    }
+    bool selfClosing = !tag.empty() && tag.back() == '/';
+    if (selfClosing) {
+      tag.remove_suffix(1);
+    }
+    auto nameEnd = std::min(tag.find_first_of(" \t\r\n"), tag.size());
+    auto name = tag.substr(0, nameEnd);
+    onEvent(XmlEvent{XmlEventType::StartElement, name, tag.substr(nameEnd), {}});
+    if (selfClosing) {
+      onEvent(XmlEvent{XmlEventType::EndElement, name, {}, {}});
+    }
+  }
+
+  std::string m_pending;
+};
+
+} // namespace ReactNativeVideoCPP
@@ -1 +1 @@
-﻿#include "pch.h"
+﻿#include "pch.h"
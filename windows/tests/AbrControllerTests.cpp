@@ -0,0 +1,66 @@
+#include "AbrController.h"
+#include "AbrSimulation.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+using ReactNativeVideoCPP::Tests::AbrSimulationConfig;
+using ReactNativeVideoCPP::Tests::NetworkTrace;
+using ReactNativeVideoCPP::Tests::Simulate;
+
+namespace {
+
+std::vector<uint32_t> const c_ladder = {400000, 800000, 1500000, 3000000, 6000000};
+
+} // namespace
+
+TEST(WithoutAnEstimateTheInitialRenditionIsKept) {
+  AbrController controller;
+  controller.SetBitrates(c_ladder, 1500000);
+  CHECK_EQ(controller.Select(0, 0), 1500000u);
+  CHECK_EQ(controller.Select(20, 0), 1500000u); // a full buffer alone doesn't move it either
+  CHECK_EQ(controller.Select(0, 4000000), 3000000u);
+}
+
+TEST(InitialRenditionFitsTheEstimateAndTheCap) {
+  AbrConfig config;
+  CHECK_EQ(AbrController::SelectInitial(c_ladder, 0, config), 400000u);
+  CHECK_EQ(AbrController::SelectInitial(c_ladder, 2000000, config), 1500000u);
+  config.maxBitRate = 1000000;
+  CHECK_EQ(AbrController::SelectInitial(c_ladder, 10000000, config), 800000u);
+  config.maxBitRate = 100000; // below the ladder keeps the lowest
+  CHECK_EQ(AbrController::SelectInitial(c_ladder, 10000000, config), 400000u);
+}
+
+TEST(BolaTakesOverOnceTheBufferIsStable) {
+  AbrController controller;
+  controller.SetBitrates(c_ladder, 800000);
+  CHECK_EQ(controller.Select(2, 1000000), 800000u);
+  // past minBufferMs BOLA keeps a rendition through a throughput dip the throughput rule would follow down
+  CHECK_EQ(controller.Select(16, 1000000), 800000u);
+  CHECK_EQ(controller.Select(30, 500000), 800000u);
+  CHECK_EQ(controller.Select(4, 500000), 400000u);
+}
+
+TEST(SteadyLinkPlaysWithoutStalls) {
+  AbrSimulationConfig config;
+  config.bitrates = c_ladder;
+  auto result = Simulate(NetworkTrace::Parse("60000 5000\n"), config);
+  CHECK_EQ(result.rebufferCount, 0u);
+  CHECK(result.averageBitrate >= 3000000 * 0.9);
+  CHECK(result.startupMs < 3000);
+}
+
+// an 8 Mbps link collapsing to 700 kbps strands a high rendition segment mid-download; the player may stall
+// once while it drops down the ladder, but not again
+TEST(ABandwidthCollapseStallsOnceAndBriefly) {
+  AbrSimulationConfig config;
+  config.bitrates = c_ladder;
+  auto trace = NetworkTrace::Parse(
+      "40000 8000\n"
+      "30000 700\n"
+      "20000 3000\n");
+  auto result = Simulate(trace, config);
+  CHECK(result.rebufferCount <= 1u);
+  CHECK(result.rebufferMs <= 6000);
+  CHECK(result.averageBitrate >= 1500000);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "AbrController.h"
+#include "BandwidthEstimator.h"
+#include "NetworkTrace.h"
+
+// Portable (WinRT-free) playback simulation for the ABR policies: segments of a fixed duration are fetched
+// one after another through a network trace, the controller picks each segment's rendition from the
+// buffer level and the estimator's throughput, and the playhead drains the buffer in between. The player
+// waits for bufferForPlaybackMs before starting, for bufferForPlaybackAfterRebufferMs after running dry,
+// and stops fetching while maxBufferMs is buffered.
+namespace ReactNativeVideoCPP::Tests {
+
+struct AbrSimulationConfig {
+  std::vector<uint32_t> bitrates; // the ladder, bits per second
+  AbrConfig abr;
+  int64_t segmentMs = 4000;
+  int64_t mediaMs = 600000; // length of the content
+  int64_t latencyMs = 50; // request round trip
+  uint64_t prior = 0; // throughput estimate carried over from an earlier session
+};
+
+struct AbrSimulationResult {
+  int64_t startupMs = 0; // until playback first started
+  int64_t rebufferMs = 0; // stalled after playback started
+  uint64_t rebufferCount = 0;
+  uint64_t switches = 0;
+  double averageBitrate = 0; // bits per second, over the segments played
+  int64_t wallMs = 0;
+};
+
+inline AbrSimulationResult Simulate(
+    NetworkTrace const &trace,
+    AbrSimulationConfig const &config,
+    std::unique_ptr<AbrPolicy> policy = nullptr) {
+  AbrController controller;
+  if (policy != nullptr) {
+    controller.SetPolicy(std::move(policy));
+  }
+  controller.SetConfig(config.abr);
+  BandwidthEstimator estimator;
+  estimator.SetPrior(config.prior);
+  controller.SetBitrates(
+      config.bitrates, AbrController::SelectInitial(config.bitrates, estimator.Estimate(), config.abr));
+
+  auto const &buffer = config.abr.buffer;
+  AbrSimulationResult result;
+  int64_t nowMs = 0;
+  int64_t bufferedMs = 0; // ahead of the playhead
+  int64_t fetchedMs = 0; // media downloaded so far
+  bool playing = false;
+  bool started = false;
+  double startThresholdMs = buffer.bufferForPlaybackMs;
+  double bitrateTotal = 0;
+  uint64_t segments = 0;
+  uint32_t previous = 0;
+
+  // advances the clock by |elapsedMs|, draining the buffer while playing and counting stalls
+  auto advance = [&](int64_t elapsedMs) {
+    if (playing) {
+      auto playedMs = std::min(elapsedMs, bufferedMs);
+      bufferedMs -= playedMs;
+      if (playedMs < elapsedMs && fetchedMs < config.mediaMs) {
+        playing = false;
+        ++result.rebufferCount;
+        result.rebufferMs += elapsedMs - playedMs;
+        startThresholdMs = buffer.bufferForPlaybackAfterRebufferMs;
+      }
+    } else if (started) {
+      result.rebufferMs += elapsedMs;
+    } else {
+      result.startupMs += elapsedMs;
+    }
+    nowMs += elapsedMs;
+  };
+
+  while (fetchedMs < config.mediaMs) {
+    if (bufferedMs + config.segmentMs > buffer.maxBufferMs && playing) {
+      advance(bufferedMs + config.segmentMs - static_cast<int64_t>(buffer.maxBufferMs));
+      continue;
+    }
+    auto bitrate = controller.Select(bufferedMs / 1000.0, estimator.Estimate());
+    if (previous != 0 && bitrate != previous) {
+      ++result.switches;
+    }
+    previous = bitrate;
+    auto bytes = static_cast<uint64_t>(bitrate) * config.segmentMs / 8000;
+    auto elapsedMs = trace.Download(bytes, nowMs, config.latencyMs);
+    advance(elapsedMs);
+    estimator.AddSample(bytes, elapsedMs);
+    bufferedMs += config.segmentMs;
+    fetchedMs += config.segmentMs;
+    bitrateTotal += bitrate;
+    ++segments;
+    if (!playing && (bufferedMs >= startThresholdMs || fetchedMs >= config.mediaMs)) {
+      playing = true;
+      started = true;
+    }
+  }
+  advance(bufferedMs); // play out what is left
+  result.averageBitrate = segments > 0 ? bitrateTotal / segments : 0;
+  result.wallMs = nowMs;
+  return result;
+}
+
+} // namespace ReactNativeVideoCPP::Tests
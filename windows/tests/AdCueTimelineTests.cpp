@@ -0,0 +1,184 @@
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "AdCueTimeline.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+
+namespace {
+
+// SCTE 35 (2019) section 14 samples: a placement opportunity start of 307 s and its end, both time_signal,
+// and a splice_insert out of the network for 5426421 ticks.
+constexpr char const *c_placementStart =
+    "0xFC3034000000000000FFFFF00506FE72BD0050001E021C435545494800008E7FCF0001A599B00808000000002CA0A18A3402009AC9D17E";
+constexpr char const *c_placementEnd =
+    "0xFC302F000000000000FFFFF00506FE746290A000190217435545494800008E7F9F0808000000002CA0A18A350200A9CC6758";
+constexpr char const *c_spliceInsert = "/DAvAAAAAAAA///wFAVIAACPf+/+c2nALv4AUsz1AAAAAAAKAAhDVUVJAAABNWLbowo=";
+
+// A live playlist of 6 s segments from |mediaSequence|, with |tags| placed before the segment they name.
+std::string Playlist(uint64_t mediaSequence, size_t segments, std::vector<std::pair<size_t, std::string>> tags = {}) {
+  std::string text = "#EXTM3U\n#EXT-X-VERSION:6\n#EXT-X-TARGETDURATION:6\n#EXT-X-MEDIA-SEQUENCE:" +
+      std::to_string(mediaSequence) + "\n";
+  for (size_t i = 0; i < segments; ++i) {
+    for (auto const &[before, tag] : tags) {
+      if (before == i) {
+        text += tag + "\n";
+      }
+    }
+    text += "#EXTINF:6.0,\nsegment" + std::to_string(mediaSequence + i) + ".ts\n";
+  }
+  return text;
+}
+
+std::vector<AdCueBreak> BreaksOf(std::string const &text) {
+  HlsMediaPlaylist playlist;
+  CHECK(playlist.Update(text).valid);
+  AdCueTimeline timeline;
+  timeline.Add(playlist.Cues());
+  return timeline.Breaks();
+}
+
+} // namespace
+
+TEST(CueOutAndInArePairedIntoABreak) {
+  auto breaks = BreaksOf(Playlist(0, 4, {{1, "#EXT-X-CUE-OUT:12"}, {3, "#EXT-X-CUE-IN"}}));
+  CHECK_EQ(breaks.size(), 1u);
+  CHECK_EQ(breaks[0].start, 6.0);
+  CHECK_EQ(breaks[0].end, 18.0);
+  CHECK_EQ(breaks[0].duration, 12.0);
+  CHECK_EQ(breaks[0].End(), 18.0);
+}
+
+TEST(BreakWithoutAnInCueRunsItsPlannedLength) {
+  auto breaks = BreaksOf(Playlist(0, 3, {{1, "#EXT-X-CUE-OUT:DURATION=30"}}));
+  CHECK_EQ(breaks.size(), 1u);
+  CHECK(std::isnan(breaks[0].end));
+  CHECK_EQ(breaks[0].End(), 36.0);
+
+  // a bare out cue takes its length from the SCTE-35 payload before it
+  breaks = BreaksOf(
+      Playlist(0, 3, {{1, std::string("#EXT-OATCLS-SCTE35:") + c_spliceInsert}, {1, "#EXT-X-CUE-OUT"}}));
+  CHECK_EQ(breaks.size(), 1u);
+  CHECK_EQ(breaks[0].id, "splice-1207959695");
+  CHECK_EQ(breaks[0].spliceEventId, 1207959695u);
+  CHECK_NEAR(breaks[0].End(), 6 + 5426421 / 90000.0, 1e-9);
+
+  // without either it stays open
+  breaks = BreaksOf(Playlist(0, 3, {{1, "#EXT-X-CUE-OUT"}}));
+  CHECK_EQ(breaks[0].End(), std::numeric_limits<double>::infinity());
+}
+
+TEST(DateRangeClosesTheBreakWithItsId) {
+  auto breaks = BreaksOf(Playlist(
+      0,
+      6,
+      {{0, "#EXT-X-PROGRAM-DATE-TIME:2024-01-01T00:00:00Z"},
+       {1,
+        "#EXT-X-DATERANGE:ID=\"ad-1\",START-DATE=\"2024-01-01T00:00:10Z\",PLANNED-DURATION=20,"
+        "SCTE35-OUT=0xFC30"},
+       {4, "#EXT-X-DATERANGE:ID=\"ad-1\",START-DATE=\"2024-01-01T00:00:10Z\",DURATION=15,SCTE35-IN=0xFC30"}}));
+  CHECK_EQ(breaks.size(), 1u);
+  CHECK_EQ(breaks[0].id, "ad-1");
+  CHECK_EQ(breaks[0].start, 10.0); // its START-DATE, not the segment the tag precedes
+  CHECK_EQ(breaks[0].duration, 20.0);
+  CHECK_EQ(breaks[0].end, 25.0);
+}
+
+TEST(SpliceCommandSaysWhetherItOpensOrCloses) {
+  auto breaks = BreaksOf(Playlist(
+      0,
+      4,
+      {{0, "#EXT-X-PROGRAM-DATE-TIME:2024-01-01T00:00:00Z"},
+       {1,
+        std::string("#EXT-X-DATERANGE:ID=\"po\",START-DATE=\"2024-01-01T00:00:06Z\",SCTE35-CMD=") +
+            c_placementStart},
+       {3, std::string("#EXT-X-DATERANGE:ID=\"po-end\",START-DATE=\"2024-01-01T00:00:20Z\",SCTE35-CMD=") +
+            c_placementEnd}}));
+  CHECK_EQ(breaks.size(), 1u);
+  CHECK_EQ(breaks[0].start, 6.0);
+  CHECK_EQ(breaks[0].duration, 307.0); // from the segmentation descriptor
+  CHECK_EQ(breaks[0].spliceEventId, 1207959694u);
+  CHECK_EQ(breaks[0].end, 20.0); // the end cue names the same segmentation event
+}
+
+TEST(CuesSeenAgainDoNotAddBreaks) {
+  auto text = Playlist(0, 4, {{1, "#EXT-X-CUE-OUT:12"}, {3, "#EXT-X-CUE-IN"}});
+  HlsMediaPlaylist playlist;
+  playlist.Update(text);
+  AdCueTimeline timeline;
+  CHECK(timeline.Add(playlist.Cues()));
+  CHECK(!timeline.Add(playlist.Cues()));
+  playlist.Clear();
+  playlist.Update(text);
+  CHECK(!timeline.Add(playlist.Cues()));
+  CHECK_EQ(timeline.Breaks().size(), 1u);
+}
+
+TEST(AdvanceReportsLeavingBeforeEntering) {
+  HlsMediaPlaylist playlist;
+  playlist.Update(Playlist(
+      0, 8, {{1, "#EXT-X-CUE-OUT:6"}, {2, "#EXT-X-CUE-IN"}, {4, "#EXT-X-CUE-OUT:6"}, {5, "#EXT-X-CUE-IN"}}));
+  AdCueTimeline timeline;
+  timeline.Add(playlist.Cues());
+  CHECK_EQ(timeline.Breaks().size(), 2u);
+
+  std::vector<std::pair<AdCueEvent, double>> events;
+  auto record = [&events](AdCueEvent event, AdCueBreak const &adBreak) { events.emplace_back(event, adBreak.start); };
+  timeline.Advance(3, record);
+  CHECK(events.empty());
+  timeline.Advance(7, record);
+  timeline.Advance(9, record);
+  CHECK_EQ(events.size(), 1u);
+  CHECK(events[0].first == AdCueEvent::BreakStart);
+  CHECK_EQ(events[0].second, 6.0);
+  timeline.Advance(25, record); // out of the first break and straight into the second
+  CHECK_EQ(events.size(), 3u);
+  CHECK(events[1].first == AdCueEvent::BreakEnd);
+  CHECK_EQ(events[1].second, 6.0);
+  CHECK(events[2].first == AdCueEvent::BreakStart);
+  CHECK_EQ(events[2].second, 24.0);
+  timeline.Advance(40, record);
+  timeline.Advance(2, record); // a seek back over the first break reports nothing for it
+  CHECK_EQ(events.size(), 4u);
+  CHECK(events[3].first == AdCueEvent::BreakEnd);
+}
+
+TEST(WindowJumpKeepsTheTimelineGoing) {
+  HlsMediaPlaylist playlist;
+  playlist.Update(Playlist(0, 3));
+  auto result = playlist.Update(Playlist(10, 2, {{1, "#EXT-X-CUE-OUT:6"}}));
+  CHECK(result.reset);
+  // the seven segments skipped are counted at the average length of those seen
+  CHECK_EQ(playlist.Segments().front().sequence, uint64_t{10});
+  CHECK_EQ(playlist.Segments().front().start, 60.0);
+  CHECK_EQ(playlist.Cues().size(), 1u);
+  CHECK_EQ(playlist.Cues()[0].time, 66.0);
+}
+
+TEST(ProgramDateTimePlacesAWindowJumpExactly) {
+  HlsMediaPlaylist playlist;
+  playlist.Update(Playlist(0, 3, {{0, "#EXT-X-PROGRAM-DATE-TIME:2024-01-01T00:00:00Z"}}));
+  double midnight = 0;
+  CHECK(ParseManifestDateTime("2024-01-01T00:00:00Z", midnight));
+  CHECK_EQ(playlist.TimeOfDate(midnight + 5), 5.0);
+
+  // the segments skipped ran longer than 6 s each, the new window's date says by how much
+  playlist.Update(Playlist(
+      10,
+      3,
+      {{0, "#EXT-X-PROGRAM-DATE-TIME:2024-01-01T00:01:10Z"},
+       {2, "#EXT-X-DATERANGE:ID=\"ad\",START-DATE=\"2024-01-01T00:01:20Z\",DURATION=30,SCTE35-OUT=0xFC30"}}));
+  CHECK_EQ(playlist.Segments().front().start, 70.0);
+  CHECK_EQ(playlist.Segments().back().start, 82.0);
+  CHECK_EQ(playlist.TimeOfDate(midnight + 100), 100.0);
+  CHECK_EQ(playlist.Cues().size(), 1u);
+  CHECK_EQ(playlist.Cues()[0].time, 80.0);
+
+  // a playlist without dates has nothing to place them by
+  HlsMediaPlaylist undated;
+  undated.Update(Playlist(0, 3));
+  CHECK(std::isnan(undated.TimeOfDate(midnight)));
+}
@@ -0,0 +1,115 @@
+#include <string>
+#include <vector>
+#include "AdPrefetch.h"
+#include "AdSchedule.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+
+namespace {
+
+// Two players, only ever compared by address.
+int const c_first = 0;
+int const c_second = 0;
+
+constexpr char const *c_creative = "https://ads.example.com/creative.mp4";
+
+AdBreak Break(VmapTimeOffset::Kind kind, double value = 0) {
+  AdBreak adBreak;
+  adBreak.timeOffset.kind = kind;
+  adBreak.timeOffset.value = value;
+  return adBreak;
+}
+
+} // namespace
+
+TEST(EachPlayerHasItsOwnLedger) {
+  AdPrefetchLedger ledger;
+  CHECK(ledger.Begin(&c_first, c_creative));
+  CHECK(!ledger.Begin(&c_first, c_creative)); // already on its way
+  CHECK(ledger.Begin(&c_second, c_creative)); // the same creative for another player
+  ledger.Completed(&c_first, c_creative, 1000, true);
+  ledger.Completed(&c_second, c_creative, 1000, true);
+
+  ledger.Played(&c_first, c_creative);
+  ledger.Played(&c_second, c_creative);
+  ledger.Played(&c_second, c_creative); // a second play has nothing prefetched left
+  auto stats = ledger.Stats();
+  CHECK_EQ(stats.prefetches, 2u);
+  CHECK_EQ(stats.prefetchedBytes, 2000u);
+  CHECK_EQ(stats.hits, 2u);
+  CHECK_EQ(stats.misses, 1u);
+  CHECK_EQ(stats.wastedBytes, 0u);
+}
+
+TEST(AbandoningOnePlayerLeavesTheOtherAlone) {
+  AdPrefetchLedger ledger;
+  CHECK(ledger.Begin(&c_first, c_creative));
+  CHECK(ledger.Begin(&c_second, c_creative));
+  ledger.Completed(&c_first, c_creative, 1000, true);
+  ledger.Completed(&c_second, c_creative, 1000, true);
+
+  ledger.Abandon(&c_first, c_creative); // seeked past the break
+  CHECK_EQ(ledger.Stats().wastedBytes, 1000u);
+  ledger.Played(&c_second, c_creative);
+  CHECK_EQ(ledger.Stats().hits, 1u);
+  CHECK_EQ(ledger.Stats().wastedBytes, 1000u);
+
+  // abandoned while still downloading, the waste is counted once the bytes are known
+  CHECK(ledger.Begin(&c_first, c_creative));
+  CHECK(ledger.Begin(&c_second, c_creative));
+  ledger.Abandon(&c_first, c_creative);
+  CHECK_EQ(ledger.Stats().wastedBytes, 1000u);
+  ledger.Completed(&c_first, c_creative, 500, true);
+  ledger.Completed(&c_second, c_creative, 500, true);
+  CHECK_EQ(ledger.Stats().wastedBytes, 1500u);
+  ledger.Played(&c_second, c_creative);
+  CHECK_EQ(ledger.Stats().hits, 2u);
+}
+
+TEST(AFailedPrefetchCanBeRetried) {
+  AdPrefetchLedger ledger;
+  CHECK(ledger.Begin(&c_first, c_creative));
+  ledger.Completed(&c_first, c_creative, 300, false);
+  CHECK(ledger.Begin(&c_first, c_creative));
+  CHECK_EQ(ledger.Stats().prefetches, 0u);
+  ledger.Played(&c_first, c_creative); // still downloading: a cold start
+  CHECK_EQ(ledger.Stats().misses, 1u);
+}
+
+TEST(APostRollIsPrefetchedAtItsLeadTime) {
+  AdSchedule schedule;
+  schedule.Assign({Break(VmapTimeOffset::Kind::Seconds, 30), Break(VmapTimeOffset::Kind::End)});
+  constexpr double c_lead = 60;
+  CHECK_EQ(schedule.PrefetchDue(0, c_lead), 0u); // the midroll first
+  schedule.MarkPlayed(0);
+  // with the midroll played the post-roll is next, but it can't be placed before the duration is known
+  CHECK_EQ(schedule.PrefetchDue(100, c_lead), AdSchedule::c_none);
+  schedule.SetContentDuration(600);
+  CHECK_EQ(schedule.PrefetchDue(100, c_lead), AdSchedule::c_none);
+  CHECK_EQ(schedule.PrefetchDue(539, c_lead), AdSchedule::c_none);
+  CHECK_EQ(schedule.PrefetchDue(540, c_lead), 1u);
+  CHECK_EQ(schedule.PrefetchDue(599, c_lead), 1u);
+  CHECK(schedule.Due(539, 600).empty()); // it plays when the content ends, not at the duration
+  schedule.MarkPlayed(1);
+  CHECK_EQ(schedule.PrefetchDue(590, c_lead), AdSchedule::c_none);
+}
+
+TEST(ThePacerKeepsTheTransferToItsShare) {
+  TransferPacer pacer(0.25);
+  // 1 MB in 1 s on an 8 Mbit/s link: at a quarter of it the megabyte takes 4 s, so 3 s of pause
+  auto delay = pacer.DelayMs(1000000, 1000, 8000000);
+  CHECK_EQ(delay, 3000);
+  CHECK_NEAR(1000000 * 8.0 / ((1000 + delay) / 1000.0), 0.25 * 8000000, 1);
+  // an unknown bandwidth is taken as a slow 1 Mbit/s link
+  CHECK_EQ(pacer.DelayMs(125000, 0, 0), 4000);
+}
+
+TEST(AStalledTransferResumesRightAway) {
+  TransferPacer pacer(0.25);
+  // the transfer already took longer than its share allows, so no pause is added
+  CHECK_EQ(pacer.DelayMs(1000000, 4000, 8000000), 0);
+  CHECK_EQ(pacer.DelayMs(1000000, 60000, 8000000), 0);
+  // a partial stall only shortens the pause
+  CHECK_EQ(pacer.DelayMs(1000000, 3500, 8000000), 500);
+}
@@ -0,0 +1,85 @@
+#include "BandwidthEstimator.h"
+#include "NetworkTrace.h"
+#include "TestHarness.h"
+
+using ReactNativeVideoCPP::BandwidthEstimator;
+using ReactNativeVideoCPP::Tests::NetworkTrace;
+using ReactNativeVideoCPP::Tests::Replay;
+
+namespace {
+
+constexpr uint64_t c_chunkBytes = 256 * 1024;
+
+// |kbps| to bits per second with a relative tolerance
+bool Within(uint64_t bitsPerSecond, double kbps, double tolerance) {
+  return std::abs(bitsPerSecond / 1000.0 - kbps) <= kbps * tolerance;
+}
+
+} // namespace
+
+TEST(TraceDownloadsSpanPeriodsAndLoop) {
+  auto trace = NetworkTrace::Parse(
+      "# ms kbps\n"
+      "1000 8000\n"
+      "\n"
+      "1000 0\n"
+      "1000 800\n");
+  CHECK_EQ(trace.DurationMs(), 3000);
+  CHECK_EQ(trace.Download(500 * 1000, 0), 500); // 4 Mbit at 8 Mbps
+  CHECK_EQ(trace.Download(550 * 1000, 500), 2000); // through the outage into the slow period
+  CHECK_EQ(trace.Download(500 * 1000, 3000), 500); // looped back to the start
+  CHECK_EQ(trace.Download(500 * 1000, 0, 100), 600);
+  CHECK_EQ(trace.BitsPerSecondAt(1500), 0u);
+}
+
+TEST(SteadyLinkConvergesOnItsBandwidth) {
+  BandwidthEstimator estimator;
+  auto trace = NetworkTrace::Parse("10000 5000\n");
+  auto samples = Replay(estimator, trace, c_chunkBytes, 20000);
+  CHECK(Within(samples.back().estimateBitsPerSecond, 5000, 0.02));
+}
+
+TEST(EstimateFollowsABandwidthDropWithinSeconds) {
+  BandwidthEstimator estimator;
+  auto trace = NetworkTrace::Parse(
+      "20000 10000\n"
+      "20000 1000\n");
+  auto samples = Replay(estimator, trace, c_chunkBytes, 40000);
+  int64_t recoveredMs = -1;
+  for (auto const &sample : samples) {
+    if (sample.timeMs > 20000 && sample.estimateBitsPerSecond < 2000 * 1000) {
+      recoveredMs = sample.timeMs - 20000;
+      break;
+    }
+  }
+  CHECK(recoveredMs >= 0 && recoveredMs <= 8000);
+  CHECK(Within(samples.back().estimateBitsPerSecond, 1000, 0.05));
+}
+
+TEST(ASingleFastTransferDoesNotInflateTheEstimate) {
+  BandwidthEstimator estimator;
+  auto trace = NetworkTrace::Parse("10000 2000\n");
+  Replay(estimator, trace, c_chunkBytes, 10000);
+  auto before = estimator.Estimate();
+  estimator.AddSample(c_chunkBytes, 10); // served from a proxy cache
+  CHECK(estimator.Estimate() <= before * 11 / 10);
+}
+
+TEST(PriorHoldsUntilEnoughWasObserved) {
+  BandwidthEstimator estimator;
+  estimator.SetPrior(3000 * 1000);
+  CHECK_EQ(estimator.Estimate(), 3000u * 1000);
+  estimator.AddSample(64 * 1024, 500);
+  CHECK_EQ(estimator.Estimate(), 3000u * 1000);
+  auto trace = NetworkTrace::Parse("10000 1000\n");
+  auto samples = Replay(estimator, trace, c_chunkBytes, 10000);
+  CHECK(Within(samples.back().estimateBitsPerSecond, 1000, 0.05));
+  estimator.Reset();
+  CHECK_EQ(estimator.Estimate(), 3000u * 1000);
+}
+
+TEST(TransfersWithoutDurationAreIgnored) {
+  BandwidthEstimator estimator;
+  CHECK_EQ(estimator.AddSample(c_chunkBytes, 0), 0u);
+  CHECK_EQ(estimator.AddSample(0, 100), 0u);
+}
@@ -0,0 +1,138 @@
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include "BeaconQueue.h"
+#include "HttpStandIn.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+using namespace ReactNativeVideoCPP::Tests;
+
+namespace {
+
+std::filesystem::path Folder(char const *name) {
+  auto folder = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(folder);
+  return folder;
+}
+
+BeaconQueuePolicy Policy(uint32_t maxAttempts) {
+  BeaconQueuePolicy policy;
+  policy.maxAttempts = maxAttempts;
+  return policy;
+}
+
+// What BeaconDispatcher does with a burst: a GET per beacon, answered 5xx or not at all counting as a
+// failure. Returns the beacons sent.
+size_t SendBurst(BeaconQueue &queue, int64_t nowMs) {
+  auto burst = queue.TakeBurst(nowMs);
+  for (auto const &beacon : burst) {
+    auto response = HttpSend("GET", beacon.url);
+    if (response.status != 0 && response.status < 500) {
+      queue.Delivered(beacon.id);
+    } else {
+      queue.Failed(beacon.id, nowMs);
+    }
+  }
+  return burst.size();
+}
+
+} // namespace
+
+TEST(FailedBeaconIsRetriedUntilTheServerRecovers) {
+  std::atomic<int> requests{0};
+  HttpStandIn server([&requests](HttpRequest const &) {
+    HttpResponse response;
+    response.status = ++requests <= 2 ? 503 : 204;
+    return response;
+  });
+  BeaconQueue queue({}, Policy(8));
+  CHECK(queue.Enqueue(server.Url("/impression?id=1"), 0));
+  CHECK_EQ(SendBurst(queue, 0), 0u); // held back for the burst delay
+  for (int i = 0; i < 10 && queue.Stats().pending != 0; ++i) {
+    SendBurst(queue, queue.NextWakeMs());
+  }
+  auto stats = queue.Stats();
+  CHECK_EQ(requests.load(), 3);
+  CHECK_EQ(stats.delivered, 1u);
+  CHECK_EQ(stats.retries, 2u);
+  CHECK_EQ(stats.pending, 0u);
+  CHECK_EQ(queue.NextWakeMs(), BeaconQueue::c_never);
+}
+
+TEST(AttemptsSurviveARestart) {
+  HttpStandIn server([](HttpRequest const &) {
+    HttpResponse response;
+    response.status = 503;
+    return response;
+  });
+  auto folder = Folder("BeaconQueueTests-attempts");
+  int64_t nowMs = 0;
+  {
+    BeaconQueue queue(folder, Policy(3));
+    queue.Enqueue(server.Url("/impression"), nowMs);
+    nowMs = queue.NextWakeMs();
+    CHECK_EQ(SendBurst(queue, nowMs), 1u);
+    nowMs = queue.NextWakeMs();
+    CHECK_EQ(SendBurst(queue, nowMs), 1u);
+    CHECK_EQ(queue.Stats().retries, 2u);
+  }
+  {
+    // a relaunch sends it right away, but only the one attempt it has left
+    BeaconQueue queue(folder, Policy(3));
+    CHECK_EQ(queue.Stats().pending, 1u);
+    CHECK_EQ(SendBurst(queue, 0), 1u);
+    CHECK_EQ(queue.Stats().dropped, 1u);
+    CHECK_EQ(queue.Stats().pending, 0u);
+  }
+  {
+    BeaconQueue queue(folder, Policy(3));
+    CHECK_EQ(queue.Stats().pending, 0u);
+  }
+  CHECK_EQ(server.Requests(), 3u);
+}
+
+TEST(DeliveredBeaconsAreNotRecovered) {
+  HttpStandIn server([](HttpRequest const &) {
+    HttpResponse response;
+    response.status = 200;
+    return response;
+  });
+  auto folder = Folder("BeaconQueueTests-delivered");
+  {
+    BeaconQueue queue(folder);
+    queue.Enqueue(server.Url("/a"), 0);
+    queue.Enqueue(server.Url("/b"), 0);
+    CHECK_EQ(SendBurst(queue, queue.NextWakeMs()), 2u);
+    queue.Enqueue(server.Url("/c"), 0);
+  }
+  BeaconQueue queue(folder);
+  CHECK_EQ(queue.Stats().pending, 1u);
+  auto burst = queue.TakeBurst(0);
+  CHECK_EQ(burst.size(), 1u);
+  CHECK_EQ(burst[0].url, server.Url("/c"));
+}
+
+TEST(UrlWithoutAHostIsDroppedRightAway) {
+  BeaconQueue queue({});
+  CHECK(!queue.Enqueue("not a url", 0));
+  CHECK(!queue.Enqueue("https:///path", 0));
+  CHECK_EQ(queue.Stats().dropped, 2u);
+  CHECK_EQ(queue.Stats().pending, 0u);
+  CHECK_EQ(queue.NextWakeMs(), BeaconQueue::c_never);
+}
+
+TEST(DiscardedBeaconIsNotRetried) {
+  auto folder = Folder("BeaconQueueTests-discard");
+  {
+    BeaconQueue queue(folder);
+    queue.Enqueue("https://t.example/a b", 0);
+    auto burst = queue.TakeBurst(queue.NextWakeMs());
+    CHECK_EQ(burst.size(), 1u);
+    queue.Discard(burst[0].id);
+    CHECK_EQ(queue.Stats().dropped, 1u);
+    CHECK_EQ(queue.Stats().retries, 0u);
+  }
+  BeaconQueue queue(folder);
+  CHECK_EQ(queue.Stats().pending, 0u);
+}
@@ -0,0 +1,79 @@
+#include "DashParser.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+
+namespace {
+
+DashManifest Parse(std::string_view text, double wallClock = NAN) {
+  DashMpdParser parser;
+  parser.Feed(text);
+  DashManifest manifest;
+  CHECK(parser.Finish(manifest, wallClock));
+  return manifest;
+}
+
+// A live MPD that started at 2024-05-01T00:00:00Z, one period whose 2-second segments repeat until the
+// live edge.
+constexpr std::string_view c_liveMpd = R"(<MPD type="dynamic" availabilityStartTime="2024-05-01T00:00:00Z">
+  <Period id="p0" start="PT0S">
+    <AdaptationSet mimeType="video/mp4">
+      <SegmentTemplate timescale="1000" media="$Number$.m4s" startNumber="1">
+        <SegmentTimeline>
+          <S t="0" d="2000" r="2"/>
+          <S d="2000" r="-1"/>
+        </SegmentTimeline>
+      </SegmentTemplate>
+      <Representation id="v" bandwidth="1000000"/>
+    </AdaptationSet>
+  </Period>
+</MPD>)";
+
+constexpr double c_availabilityStart = 1714521600;
+
+DashSegmentTemplate const &Template(DashManifest const &manifest) {
+  return *manifest.periods.front().adaptationSets.front().representations.front().segmentTemplate;
+}
+
+} // namespace
+
+TEST(LiveTimelineRunsUpToTheLiveEdge) {
+  auto manifest = Parse(c_liveMpd, c_availabilityStart + 61);
+  CHECK(manifest.dynamic);
+  CHECK_EQ(manifest.availabilityStart, c_availabilityStart);
+  CHECK_EQ(manifest.periods.front().duration, 0.0); // still open-ended
+  auto const &segmentTemplate = Template(manifest);
+  CHECK(!segmentTemplate.timeline->Open());
+  CHECK_EQ(segmentTemplate.SegmentCount(0), 31u); // 0..62 s, the last one starting at 60
+  CHECK_EQ(segmentTemplate.Segment(30).start, 60.0);
+}
+
+TEST(LiveTimelineWithoutAClockStaysOpen) {
+  auto manifest = Parse(c_liveMpd);
+  auto const &segmentTemplate = Template(manifest);
+  CHECK(segmentTemplate.timeline->Open());
+  CHECK_EQ(segmentTemplate.SegmentCount(0), 4u);
+  // the caller resolves it against its own elapsed time
+  CHECK_EQ(segmentTemplate.SegmentCount(120), 60u);
+  CHECK_EQ(segmentTemplate.IndexAt(100), 50u);
+  CHECK_EQ(segmentTemplate.Segment(50).number, 51u);
+}
+
+TEST(StaticTimelineIsClosedAtThePeriodEnd) {
+  auto manifest = Parse(R"(<MPD type="static" mediaPresentationDuration="PT10S">
+  <Period>
+    <AdaptationSet mimeType="audio/mp4">
+      <SegmentTemplate timescale="48000" media="a/$Time$.m4s">
+        <SegmentTimeline><S t="0" d="96000" r="-1"/></SegmentTimeline>
+      </SegmentTemplate>
+      <Representation id="a" bandwidth="128000"/>
+    </AdaptationSet>
+  </Period>
+</MPD>)");
+  auto const &period = manifest.periods.front();
+  CHECK_EQ(period.duration, 10.0);
+  CHECK_EQ(period.adaptationSets.front().contentType, std::string("audio"));
+  auto const &representation = period.adaptationSets.front().representations.front();
+  CHECK_EQ(representation.segmentTemplate->SegmentCount(period.duration), 5u);
+  CHECK_EQ(representation.MediaUrl(representation.segmentTemplate->Segment(4)), std::string("a/384000.m4s"));
+}
@@ -0,0 +1,110 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "EventBatchQueue.h"
+#include "TestHarness.h"
+
+using ReactNativeVideoCPP::EventBatchQueue;
+
+namespace {
+
+struct TestEvent {
+  int source = 0;
+  int kind = 0;
+  bool collapsible = false;
+  int sequence = 0;
+};
+
+std::vector<TestEvent> DrainAll(EventBatchQueue<TestEvent> &queue) {
+  std::vector<TestEvent> events;
+  queue.Drain([&](TestEvent const &event) { events.push_back(event); });
+  return events;
+}
+
+} // namespace
+
+TEST(DeliversInArrivalOrder) {
+  EventBatchQueue<TestEvent> queue(4);
+  CHECK(queue.Push({1, 0, false, 0}));
+  CHECK(!queue.Push({1, 1, false, 1})); // a drain is already pending
+  CHECK(!queue.Push({2, 0, false, 2}));
+  auto events = DrainAll(queue);
+  CHECK_EQ(events.size(), 3u);
+  for (int i = 0; i < static_cast<int>(events.size()); ++i) {
+    CHECK_EQ(events[i].sequence, i);
+  }
+  CHECK(queue.Push({1, 0, false, 3})); // the drain cleared the pending flag
+}
+
+TEST(CollapsibleEventsKeepOnlyTheLatestPerSourceAndKind) {
+  EventBatchQueue<TestEvent> queue;
+  queue.Push({1, 7, true, 0});
+  queue.Push({1, 8, false, 1});
+  queue.Push({2, 7, true, 2});
+  queue.Push({1, 8, false, 3});
+  queue.Push({1, 7, true, 4});
+  auto events = DrainAll(queue);
+  CHECK_EQ(events.size(), 4u);
+  CHECK_EQ(events[0].sequence, 1);
+  CHECK_EQ(events[1].sequence, 2);
+  CHECK_EQ(events[2].sequence, 3);
+  CHECK_EQ(events[3].sequence, 4);
+}
+
+TEST(PooledNodesAreReusedAcrossDrains) {
+  EventBatchQueue<TestEvent> queue(8);
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 8; ++i) {
+      queue.Push({i, 0, false, i});
+    }
+    CHECK_EQ(DrainAll(queue).size(), 8u);
+  }
+  CHECK_EQ(queue.HeapNodes(), 0u);
+}
+
+TEST(ABurstLargerThanThePoolFallsBackToTheHeap) {
+  EventBatchQueue<TestEvent> queue(2);
+  for (int i = 0; i < 5; ++i) {
+    queue.Push({0, 0, false, i});
+  }
+  auto events = DrainAll(queue);
+  CHECK_EQ(events.size(), 5u);
+  CHECK_EQ(events.back().sequence, 4);
+  CHECK_EQ(queue.HeapNodes(), 3u);
+  queue.Push({0, 0, false, 5}); // a heap node is freed, not pooled
+  CHECK_EQ(DrainAll(queue).size(), 1u);
+  CHECK_EQ(queue.HeapNodes(), 3u);
+}
+
+TEST(ConcurrentProducersKeepTheirOwnOrder) {
+  constexpr int c_producers = 4;
+  constexpr int c_eventsPerProducer = 50000;
+  EventBatchQueue<TestEvent> queue(64);
+  std::atomic<int> running{c_producers};
+  std::vector<std::thread> producers;
+  for (int p = 0; p < c_producers; ++p) {
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < c_eventsPerProducer; ++i) {
+        queue.Push({p, 0, false, i});
+      }
+      running.fetch_sub(1);
+    });
+  }
+  std::vector<int> next(c_producers, 0);
+  bool ordered = true;
+  auto consume = [&](TestEvent const &event) {
+    ordered = ordered && event.sequence == next[event.source];
+    ++next[event.source];
+  };
+  while (running.load() > 0) {
+    queue.Drain(consume);
+  }
+  queue.Drain(consume);
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  CHECK(ordered);
+  for (int p = 0; p < c_producers; ++p) {
+    CHECK_EQ(next[p], c_eventsPerProducer);
+  }
+}
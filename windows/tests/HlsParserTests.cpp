@@ -0,0 +1,238 @@
+#include <string>
+#include <vector>
+#include "HlsParser.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+
+namespace {
+
+constexpr std::string_view c_master = R"(#EXTM3U
+#EXT-X-VERSION:6
+#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID="aac",NAME="English",LANGUAGE="en",DEFAULT=YES,URI="audio/en.m3u8"
+#EXT-X-MEDIA:TYPE=AUDIO,GROUP-ID="aac",NAME="Deutsch",LANGUAGE="de",DEFAULT=NO,URI="audio/de.m3u8"
+#EXT-X-MEDIA:TYPE=CLOSED-CAPTIONS,GROUP-ID="cc",NAME="CC1",INSTREAM-ID="CC1"
+#EXT-X-STREAM-INF:BANDWIDTH=2200000,RESOLUTION=1280x720,FRAME-RATE=29.970,CODECS="avc1.4d401f,mp4a.40.2"
+video/720p.m3u8
+
+#EXT-X-STREAM-INF:BANDWIDTH=800000,AVERAGE-BANDWIDTH=700000,RESOLUTION=640x360,AUDIO="aac",SUBTITLES="subs"
+video/360p.m3u8
+)";
+
+// The window of a live playlist of 6 s segments at |mediaSequence|, |segments| long, with |tags| placed
+// before the segment they name; an index of |segments| puts the tag after the last URI.
+struct Tag {
+  uint64_t sequence;
+  std::string line;
+};
+
+std::string Window(uint64_t mediaSequence, uint64_t segments, std::vector<Tag> const &tags) {
+  std::string text = "#EXTM3U\n#EXT-X-TARGETDURATION:6\n#EXT-X-MEDIA-SEQUENCE:" + std::to_string(mediaSequence) + "\n";
+  for (auto sequence = mediaSequence; sequence <= mediaSequence + segments; ++sequence) {
+    for (auto const &tag : tags) {
+      if (tag.sequence == sequence) {
+        text += tag.line + "\n";
+      }
+    }
+    if (sequence < mediaSequence + segments) {
+      text += "#EXTINF:6.000,\nseg" + std::to_string(sequence) + ".ts\n";
+    }
+  }
+  return text;
+}
+
+// The listing of |playlist| relative to its first segment, which is what a full parse and an incremental
+// refresh of the same text have to agree on.
+std::string Describe(HlsMediaPlaylist const &playlist) {
+  auto origin = playlist.Segments().empty() ? 0 : playlist.Segments().front().start;
+  std::string text;
+  for (auto const &segment : playlist.Segments()) {
+    text += std::to_string(segment.sequence) + " " + std::to_string(segment.start - origin) + " " +
+        std::to_string(segment.duration) + " " + std::to_string(segment.discontinuitySequence) +
+        (segment.discontinuity ? " D " : " ") + std::string(playlist.Uri(segment)) + "\n";
+  }
+  for (auto const &cue : playlist.Cues()) {
+    text += "cue " + std::to_string(static_cast<int>(cue.kind)) + " " + std::to_string(cue.sequence) + " " +
+        std::to_string(cue.time - origin) + " " + std::to_string(cue.duration) + " " + cue.id + "\n";
+  }
+  return text;
+}
+
+} // namespace
+
+TEST(MasterPlaylistListsVariantsAndRenditions) {
+  HlsMasterPlaylist master;
+  CHECK(ParseHlsMasterPlaylist(c_master, master));
+  CHECK_EQ(master.variants.size(), 2u);
+  auto const &hd = master.variants[0];
+  CHECK_EQ(hd.bandwidth, 2200000u);
+  CHECK_EQ(hd.averageBandwidth, 0u);
+  CHECK_EQ(hd.width, 1280u);
+  CHECK_EQ(hd.height, 720u);
+  CHECK_NEAR(hd.frameRate, 29.97, 1e-9);
+  CHECK(hd.codecs == "avc1.4d401f,mp4a.40.2"); // the comma inside the quotes does not split it
+  CHECK(hd.uri == "video/720p.m3u8");
+  CHECK_EQ(master.variants[1].averageBandwidth, 700000u);
+  CHECK(master.variants[1].audioGroup == "aac");
+  CHECK(master.variants[1].subtitlesGroup == "subs");
+  CHECK(master.variants[1].uri == "video/360p.m3u8"); // past the blank line
+
+  CHECK_EQ(master.renditions.size(), 3u);
+  CHECK(master.renditions[0].type == "AUDIO");
+  CHECK(master.renditions[0].groupId == "aac");
+  CHECK(master.renditions[0].language == "en");
+  CHECK(master.renditions[0].isDefault);
+  CHECK(!master.renditions[1].isDefault);
+  CHECK(master.renditions[1].uri == "audio/de.m3u8");
+  CHECK(master.renditions[2].uri.empty()); // muxed into the variant
+
+  CHECK(!ParseHlsMasterPlaylist("<MPD/>", master));
+}
+
+TEST(ByteRangesContinueFromThePreviousOne) {
+  HlsMediaPlaylist playlist;
+  CHECK(playlist.Update(R"(#EXTM3U
+#EXT-X-TARGETDURATION:4
+#EXT-X-VERSION:4
+#EXT-X-PLAYLIST-TYPE:VOD
+#EXTINF:4,
+#EXT-X-BYTERANGE:1000@200
+media.ts
+#EXTINF:4,
+#EXT-X-BYTERANGE:1500
+media.ts
+#EXTINF:2.5,
+#EXT-X-BYTERANGE:700@0
+other.ts
+#EXTINF:4,
+#EXT-X-BYTERANGE:300
+other.ts
+#EXT-X-ENDLIST
+)")
+            .valid);
+  auto const &segments = playlist.Segments();
+  CHECK_EQ(segments.size(), 4u);
+  CHECK_EQ(segments[0].byteRange.offset, 200u);
+  CHECK_EQ(segments[0].byteRange.length, 1000u);
+  CHECK_EQ(segments[1].byteRange.offset, 1200u);
+  CHECK_EQ(segments[1].byteRange.length, 1500u);
+  CHECK_EQ(segments[2].byteRange.offset, 0u);
+  CHECK_EQ(segments[3].byteRange.offset, 700u);
+  CHECK_EQ(segments[2].start, 8.0);
+  CHECK_EQ(playlist.Duration(), 14.5);
+  CHECK(playlist.Type() == HlsPlaylistType::Vod);
+  CHECK(playlist.EndList());
+  CHECK_EQ(playlist.Version(), 4u);
+  CHECK_EQ(playlist.TargetDuration(), 4.0);
+}
+
+TEST(DiscontinuitiesAdvanceTheDiscontinuitySequence) {
+  HlsMediaPlaylist playlist;
+  CHECK(playlist.Update(R"(#EXTM3U
+#EXT-X-TARGETDURATION:6
+#EXT-X-MEDIA-SEQUENCE:20
+#EXT-X-DISCONTINUITY-SEQUENCE:3
+#EXTINF:6,
+a.ts
+#EXT-X-DISCONTINUITY
+#EXTINF:6,
+b.ts
+#EXTINF:6,
+c.ts
+#EXT-X-DISCONTINUITY
+#EXTINF:6,
+d.ts
+)")
+            .valid);
+  auto const &segments = playlist.Segments();
+  CHECK_EQ(segments.size(), 4u);
+  CHECK_EQ(segments[0].sequence, uint64_t{20});
+  CHECK_EQ(segments[0].discontinuitySequence, 3u);
+  CHECK(!segments[0].discontinuity);
+  CHECK(segments[1].discontinuity);
+  CHECK_EQ(segments[1].discontinuitySequence, 4u);
+  CHECK_EQ(segments[2].discontinuitySequence, 4u);
+  CHECK(segments[3].discontinuity);
+  CHECK_EQ(segments[3].discontinuitySequence, 5u);
+}
+
+TEST(NotAMediaPlaylistLeavesTheTableAlone) {
+  HlsMediaPlaylist playlist;
+  CHECK(playlist.Update(Window(0, 3, {})).valid);
+  CHECK(!playlist.Update(c_master).valid);
+  CHECK(!playlist.Update("<html>502 Bad Gateway</html>").valid);
+  CHECK_EQ(playlist.Segments().size(), 3u);
+}
+
+TEST(IncrementalRefreshesMatchAFullParse) {
+  // a break announced after the last URI, before the segment it starts at is published, then closed
+  std::vector<Tag> tags = {
+      {1, "#EXT-X-PROGRAM-DATE-TIME:2024-01-01T00:00:06Z"},
+      {4, "#EXT-X-CUE-OUT:12"},
+      {4, "#EXT-X-DATERANGE:ID=\"ad\",START-DATE=\"2024-01-01T00:00:24Z\",PLANNED-DURATION=12,SCTE35-OUT=0xFC"},
+      {6, "#EXT-X-CUE-IN"},
+      {6, "#EXT-X-DISCONTINUITY"},
+      {8, "#EXT-X-CUE-OUT:6"},
+  };
+  HlsMediaPlaylist incremental;
+  std::vector<size_t> added;
+  // a sliding window of four segments, refreshed as each new segment is published
+  for (uint64_t first = 0; first <= 6; ++first) {
+    auto text = Window(first, 4, tags);
+    auto result = incremental.Update(text);
+    CHECK(result.valid);
+    CHECK(!result.reset || first == 0);
+    added.push_back(result.cues);
+
+    HlsMediaPlaylist full;
+    full.Update(text);
+    CHECK_EQ(Describe(incremental), Describe(full));
+  }
+  // the cues are reported once each, when their tags first appear: the two at 4 while 0-3 are listed, the in
+  // cue at 6 with 2-5 and the last out cue with 4-7
+  std::vector<size_t> expected = {2, 0, 1, 0, 1, 0, 0};
+  CHECK(added == expected);
+}
+
+TEST(RepeatedRefreshesDoNotRepeatTrailingCues) {
+  auto text = Window(0, 2, {{2, "#EXT-X-CUE-OUT:30"}});
+  HlsMediaPlaylist playlist;
+  CHECK_EQ(playlist.Update(text).cues, 1u);
+  CHECK_EQ(playlist.Update(text).cues, 0u);
+  CHECK_EQ(playlist.Update(text).cues, 0u);
+  CHECK_EQ(playlist.Cues().size(), 1u);
+  CHECK_EQ(playlist.Cues()[0].sequence, uint64_t{2});
+  CHECK_EQ(playlist.Cues()[0].time, 12.0);
+
+  // once the segment is published the cue stays with it
+  auto result = playlist.Update(Window(0, 3, {{2, "#EXT-X-CUE-OUT:30"}}));
+  CHECK_EQ(result.appended, 1u);
+  CHECK_EQ(result.cues, 0u);
+  CHECK_EQ(playlist.Cues().size(), 1u);
+}
+
+TEST(ABadRefreshKeepsThePlaylistForTheNextGoodOne) {
+  std::vector<Tag> tags = {{3, "#EXT-X-CUE-OUT:12"}, {5, "#EXT-X-CUE-IN"}};
+  HlsMediaPlaylist playlist;
+  CHECK_EQ(playlist.Update(Window(0, 4, tags)).cues, 1u);
+  auto before = Describe(playlist);
+
+  // an error page, and a refresh cut short before the segments already known
+  CHECK(!playlist.Update("<html>504 Gateway Timeout</html>").valid);
+  auto next = Window(1, 4, tags);
+  auto cut = next.substr(0, next.find("seg3.ts"));
+  CHECK(!playlist.Update(cut).valid);
+  CHECK_EQ(Describe(playlist), before);
+
+  // the next good refresh picks up from the kept table, as if the bad ones never happened
+  auto text = Window(2, 4, tags);
+  auto result = playlist.Update(text);
+  CHECK(result.valid);
+  CHECK(!result.reset);
+  CHECK_EQ(result.removed, 2u);
+  CHECK_EQ(result.appended, 2u);
+  CHECK_EQ(result.cues, 1u); // the in cue; the out cue was reported by the first load
+  HlsMediaPlaylist full;
+  full.Update(text);
+  CHECK_EQ(Describe(playlist), Describe(full));
+}
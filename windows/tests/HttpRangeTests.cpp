@@ -0,0 +1,118 @@
+#include <filesystem>
+#include <string>
+#include "HttpRange.h"
+#include "HttpStandIn.h"
+#include "SparseCache.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+using namespace ReactNativeVideoCPP::Tests;
+
+namespace {
+
+std::string Resource() {
+  std::string bytes(64 * 1024, '\0');
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<char>(i * 7);
+  }
+  return bytes;
+}
+
+// Serves Resource(), honoring "bytes=a-b" Range headers when |honorRanges|; otherwise answers every GET
+// with the whole resource, as a server or proxy without range support does.
+HttpResponse Serve(HttpRequest const &request, bool honorRanges) {
+  static auto const resource = Resource();
+  HttpResponse response;
+  auto range = request.Header("range");
+  if (!honorRanges || range.empty()) {
+    response.status = 200;
+    response.body = resource;
+    return response;
+  }
+  auto dash = range.find('-');
+  auto first = std::stoull(range.substr(6, dash - 6));
+  auto last = std::min<uint64_t>(std::stoull(range.substr(dash + 1)), resource.size() - 1);
+  response.status = c_httpPartialContent;
+  response.headers["Content-Range"] =
+      "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(resource.size());
+  response.body = resource.substr(first, last - first + 1);
+  return response;
+}
+
+// The fetch MediaCache::FetchRange hands the sparse cache: a ranged GET whose body only counts when the
+// status is the expected one.
+std::string FetchRange(HttpStandIn const &server, uint64_t offset, uint64_t length) {
+  auto response = HttpSend("GET", server.Url("/clip.mp4"), {{"Range", HttpRangeValue(offset, length)}});
+  return IsExpectedHttpStatus(response.status, true) ? response.body : std::string();
+}
+
+std::filesystem::path Folder(char const *name) {
+  auto folder = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(folder);
+  return folder;
+}
+
+} // namespace
+
+TEST(RangeHeaderIsInclusive) {
+  CHECK_EQ(HttpRangeValue(0, 1), std::string("bytes=0-0"));
+  CHECK_EQ(HttpRangeValue(1000, 500), std::string("bytes=1000-1499"));
+}
+
+TEST(IfRangeValidatorPrefersAStrongETag) {
+  CHECK_EQ(HttpRangeValidator("\"abc\"", "Wed, 01 May 2024 12:00:00 GMT"), std::string("\"abc\""));
+  CHECK_EQ(HttpRangeValidator("W/\"abc\"", "Wed, 01 May 2024 12:00:00 GMT"),
+      std::string("Wed, 01 May 2024 12:00:00 GMT"));
+  CHECK(HttpRangeValidator("W/\"abc\"", "").empty());
+}
+
+TEST(OnlyPartialContentAnswersARangedRequest) {
+  HttpStandIn honoring([](HttpRequest const &request) { return Serve(request, true); });
+  HttpStandIn ignoring([](HttpRequest const &request) { return Serve(request, false); });
+
+  auto ranged = HttpSend("GET", honoring.Url("/clip.mp4"), {{"Range", HttpRangeValue(100, 50)}});
+  CHECK_EQ(ranged.status, 206);
+  CHECK(IsExpectedHttpStatus(ranged.status, true));
+  CHECK_EQ(ranged.body, Resource().substr(100, 50));
+
+  auto whole = HttpSend("GET", ignoring.Url("/clip.mp4"), {{"Range", HttpRangeValue(100, 50)}});
+  CHECK_EQ(whole.status, 200);
+  CHECK(!IsExpectedHttpStatus(whole.status, true)); // bytes from 0, not from 100
+
+  auto plain = HttpSend("GET", ignoring.Url("/clip.mp4"));
+  CHECK(IsExpectedHttpStatus(plain.status, false));
+  CHECK(!IsExpectedHttpStatus(404, false));
+}
+
+TEST(SparseCacheStoresOnlyTheRangesAskedFor) {
+  auto folder = Folder("HttpRangeTests-honoring");
+  {
+    HttpStandIn server([](HttpRequest const &request) { return Serve(request, true); });
+    SparseCache cache(folder, 1 << 20);
+    cache.Adopt("clip", {Resource().size(), "\"v1\"", "video/mp4"});
+    std::string out;
+    auto fetch = [&server](uint64_t offset, uint64_t length) { return FetchRange(server, offset, length); };
+    CHECK(cache.Read("clip", 4096, 1000, out, fetch, 8192));
+    CHECK_EQ(out, Resource().substr(4096, 1000));
+    auto requests = server.Requests();
+    CHECK(cache.Read("clip", 5000, 3000, out, fetch)); // inside the widened first fetch
+    CHECK_EQ(out, Resource().substr(5000, 3000));
+    CHECK_EQ(server.Requests(), requests);
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(SparseCacheRejectsAServerIgnoringRanges) {
+  auto folder = Folder("HttpRangeTests-ignoring");
+  {
+    HttpStandIn server([](HttpRequest const &request) { return Serve(request, false); });
+    SparseCache cache(folder, 1 << 20);
+    cache.Adopt("clip", {Resource().size(), "\"v1\"", "video/mp4"});
+    std::string out;
+    auto fetch = [&server](uint64_t offset, uint64_t length) { return FetchRange(server, offset, length); };
+    CHECK(!cache.Read("clip", 4096, 1000, out, fetch));
+    CHECK(out.empty());
+    CHECK(cache.Present("clip").Empty());
+  }
+  std::filesystem::remove_all(folder);
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Local HTTP/1.1 stand-in for the tests of code that talks to servers (segment and range fetches, ad
+// servers, beacon endpoints): a server on a loopback port that answers every request through a handler,
+// and a matching blocking client. One request per connection (Connection: close), each connection on its
+// own thread so concurrent fetches really overlap. POSIX sockets only, like the rest of the Linux build.
+namespace ReactNativeVideoCPP::Tests {
+
+struct HttpRequest {
+  std::string method;
+  std::string path; // with the query string
+  std::map<std::string, std::string> headers; // names lowercased
+  std::string body;
+
+  std::string Header(std::string const &name) const {
+    auto it = headers.find(name);
+    return it == headers.end() ? std::string() : it->second;
+  }
+};
+
+struct HttpResponse {
+  int status = 0; // 0 when the request failed
+  std::map<std::string, std::string> headers; // names lowercased
+  std::string body;
+};
+
+namespace Detail {
+
+inline std::string Lowercase(std::string text) {
+  for (auto &c : text) {
+    c = static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+  }
+  return text;
+}
+
+inline bool SendAll(int socket, std::string_view bytes) {
+  while (!bytes.empty()) {
+    auto sent = send(socket, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+    if (sent <= 0) {
+      return false;
+    }
+    bytes.remove_prefix(static_cast<size_t>(sent));
+  }
+  return true;
+}
+
+// Reads one message: the start line, the headers and, unless it is the response to a HEAD, a
+// Content-Length body (or, with |untilClose| and no Content-Length, everything up to the close).
+inline bool ReadMessage(
+    int socket,
+    std::string &startLine,
+    std::map<std::string, std::string> &headers,
+    std::string &body,
+    bool head,
+    bool untilClose) {
+  std::string data;
+  char chunk[4096];
+  size_t headerEnd = std::string::npos;
+  while ((headerEnd = data.find("\r\n\r\n")) == std::string::npos) {
+    auto received = recv(socket, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      return false;
+    }
+    data.append(chunk, static_cast<size_t>(received));
+  }
+  size_t lineEnd = data.find("\r\n");
+  startLine = data.substr(0, lineEnd);
+  for (size_t at = lineEnd + 2; at < headerEnd;) {
+    auto end = data.find("\r\n", at);
+    auto line = data.substr(at, end - at);
+    auto colon = line.find(':');
+    if (colon != std::string::npos) {
+      auto value = line.substr(colon + 1);
+      value.erase(0, value.find_first_not_of(' '));
+      headers[Lowercase(line.substr(0, colon))] = value;
+    }
+    at = end + 2;
+  }
+  body = data.substr(headerEnd + 4);
+  if (head) {
+    body.clear();
+    return true;
+  }
+  auto length = headers.find("content-length");
+  if (length == headers.end() && !untilClose) {
+    return true;
+  }
+  auto expected = length == headers.end() ? SIZE_MAX : std::strtoull(length->second.c_str(), nullptr, 10);
+  while (body.size() < expected) {
+    auto received = recv(socket, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      return length == headers.end();
+    }
+    body.append(chunk, static_cast<size_t>(received));
+  }
+  return true;
+}
+
+} // namespace Detail
+
+class HttpStandIn {
+ public:
+  using Handler = std::function<HttpResponse(HttpRequest const &)>;
+
+  explicit HttpStandIn(Handler handler) : m_handler(std::move(handler)) {
+    m_listener = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0; // any free port
+    socklen_t size = sizeof(address);
+    if (bind(m_listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(m_listener, 64) != 0 || getsockname(m_listener, reinterpret_cast<sockaddr *>(&address), &size) != 0) {
+      std::abort();
+    }
+    m_port = ntohs(address.sin_port);
+    m_acceptor = std::thread([this] { Accept(); });
+  }
+
+  HttpStandIn(HttpStandIn const &) = delete;
+  HttpStandIn &operator=(HttpStandIn const &) = delete;
+
+  ~HttpStandIn() {
+    m_stopping = true;
+    shutdown(m_listener, SHUT_RDWR);
+    close(m_listener);
+    m_acceptor.join();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto &connection : m_connections) {
+      connection.join();
+    }
+  }
+
+  uint16_t Port() const {
+    return m_port;
+  }
+
+  // "http://127.0.0.1:<port><path>"
+  std::string Url(std::string_view path) const {
+    return "http://127.0.0.1:" + std::to_string(m_port) + std::string(path);
+  }
+
+  // Requests served so far.
+  size_t Requests() const {
+    return m_requests.load();
+  }
+
+ private:
+  void Accept() {
+    while (!m_stopping) {
+      int connection = accept(m_listener, nullptr, nullptr);
+      if (connection < 0) {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_connections.emplace_back([this, connection] { Serve(connection); });
+    }
+  }
+
+  void Serve(int connection) {
+    HttpRequest request;
+    std::string startLine;
+    if (Detail::ReadMessage(connection, startLine, request.headers, request.body, false, false)) {
+      auto space = startLine.find(' ');
+      request.method = startLine.substr(0, space);
+      request.path = startLine.substr(space + 1, startLine.find(' ', space + 1) - space - 1);
+      ++m_requests;
+      auto response = m_handler(request);
+      std::string text = "HTTP/1.1 " + std::to_string(response.status) + " Stand-in\r\n";
+      for (auto const &[name, value] : response.headers) {
+        text += name + ": " + value + "\r\n";
+      }
+      text += "Content-Length: " + std::to_string(response.body.size()) + "\r\nConnection: close\r\n\r\n";
+      if (request.method != "HEAD") {
+        text += response.body;
+      }
+      Detail::SendAll(connection, text);
+    }
+    close(connection);
+  }
+
+  Handler m_handler;
+  int m_listener = -1;
+  uint16_t m_port = 0;
+  std::atomic<bool> m_stopping{false};
+  std::atomic<size_t> m_requests{0};
+  std::thread m_acceptor;
+  std::mutex m_mutex;
+  std::vector<std::thread> m_connections;
+};
+
+// Sends one request to a stand-in (or any loopback HTTP server) and waits for the whole response.
+// |url| must be "http://127.0.0.1:<port>/...".
+inline HttpResponse HttpSend(
+    std::string const &method,
+    std::string const &url,
+    std::map<std::string, std::string> const &headers = {},
+    std::string const &body = {}) {
+  HttpResponse response;
+  constexpr std::string_view c_prefix = "http://127.0.0.1:";
+  if (url.compare(0, c_prefix.size(), c_prefix) != 0) {
+    return response;
+  }
+  auto pathStart = url.find('/', c_prefix.size());
+  auto port = std::strtoul(url.c_str() + c_prefix.size(), nullptr, 10);
+  auto path = pathStart == std::string::npos ? std::string("/") : url.substr(pathStart);
+
+  int connection = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(static_cast<uint16_t>(port));
+  if (connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+    close(connection);
+    return response;
+  }
+  std::string text = method + " " + path + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n";
+  for (auto const &[name, value] : headers) {
+    text += name + ": " + value + "\r\n";
+  }
+  text += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+  std::string statusLine;
+  if (Detail::SendAll(connection, text) &&
+      Detail::ReadMessage(connection, statusLine, response.headers, response.body, method == "HEAD", true)) {
+    auto space = statusLine.find(' ');
+    response.status = space == std::string::npos ? 0 : std::atoi(statusLine.c_str() + space + 1);
+  }
+  close(connection);
+  return response;
+}
+
+} // namespace ReactNativeVideoCPP::Tests
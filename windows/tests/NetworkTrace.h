@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Portable (WinRT-free) replay of recorded network traces for the throughput tests and the ABR simulator.
+// A trace is a sequence of periods of constant bandwidth, looped when a replay runs past its end; a
+// download takes as long as the trace needs to carry its bytes from the time it starts.
+namespace ReactNativeVideoCPP::Tests {
+
+struct TracePeriod {
+  int64_t durationMs = 0;
+  uint64_t bitsPerSecond = 0; // 0 for an outage
+};
+
+class NetworkTrace {
+ public:
+  explicit NetworkTrace(std::vector<TracePeriod> periods) : m_periods(std::move(periods)) {
+    double bits = 0;
+    for (auto const &period : m_periods) {
+      if (period.durationMs <= 0) {
+        throw std::invalid_argument("trace periods must have a duration");
+      }
+      m_durationMs += period.durationMs;
+      bits += period.bitsPerSecond * static_cast<double>(period.durationMs) / 1000;
+    }
+    if (bits <= 0) {
+      throw std::invalid_argument("trace carries no data");
+    }
+  }
+
+  // One period per line, "<duration ms> <kilobits per second>"; blank lines and lines starting with '#'
+  // are skipped.
+  static NetworkTrace Parse(std::string_view text) {
+    std::vector<TracePeriod> periods;
+    while (!text.empty()) {
+      auto end = text.find('\n');
+      std::string line(text.substr(0, end));
+      text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+      auto first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos || line[first] == '#') {
+        continue;
+      }
+      size_t used = 0;
+      auto durationMs = std::stoll(line, &used);
+      auto kbps = std::stod(line.substr(used));
+      periods.push_back(TracePeriod{durationMs, static_cast<uint64_t>(kbps * 1000)});
+    }
+    return NetworkTrace(std::move(periods));
+  }
+
+  int64_t DurationMs() const {
+    return m_durationMs;
+  }
+
+  uint64_t BitsPerSecondAt(int64_t timeMs) const {
+    return m_periods[Locate(timeMs).first].bitsPerSecond;
+  }
+
+  // Milliseconds it takes to download |bytes| starting at |startMs|, plus a fixed |latencyMs| for the
+  // request round trip during which no data arrives. At least 1 ms.
+  int64_t Download(uint64_t bytes, int64_t startMs, int64_t latencyMs = 0) const {
+    double nowMs = static_cast<double>(startMs + latencyMs);
+    double remainingBits = bytes * 8.0;
+    auto [index, offsetMs] = Locate(startMs + latencyMs);
+    double intoPeriodMs = static_cast<double>(offsetMs);
+    while (remainingBits > 0) {
+      auto const &period = m_periods[index];
+      double leftMs = period.durationMs - intoPeriodMs;
+      double periodBits = period.bitsPerSecond * leftMs / 1000;
+      if (periodBits >= remainingBits) {
+        nowMs += remainingBits * 1000 / period.bitsPerSecond;
+        break;
+      }
+      remainingBits -= periodBits;
+      nowMs += leftMs;
+      index = (index + 1) % m_periods.size();
+      intoPeriodMs = 0;
+    }
+    auto elapsedMs = static_cast<int64_t>(std::ceil(nowMs)) - startMs;
+    return elapsedMs > 0 ? elapsedMs : 1;
+  }
+
+ private:
+  // period index and offset into it of |timeMs|, looping the trace
+  std::pair<size_t, int64_t> Locate(int64_t timeMs) const {
+    auto offsetMs = timeMs % m_durationMs;
+    for (size_t i = 0; i < m_periods.size(); ++i) {
+      if (offsetMs < m_periods[i].durationMs) {
+        return {i, offsetMs};
+      }
+      offsetMs -= m_periods[i].durationMs;
+    }
+    return {0, 0};
+  }
+
+  std::vector<TracePeriod> m_periods;
+  int64_t m_durationMs = 0;
+};
+
+struct ReplaySample {
+  int64_t timeMs = 0; // when the download finished
+  uint64_t actualBitsPerSecond = 0; // the trace bandwidth at that time
+  uint64_t estimateBitsPerSecond = 0; // the estimator's answer after the sample
+};
+
+// Downloads |chunkBytes| back to back through |trace| for |durationMs|, feeding every transfer to
+// |estimator| (anything with AddSample(bytes, elapsedMs)), and records the estimate after each one.
+template <typename Estimator>
+std::vector<ReplaySample> Replay(
+    Estimator &estimator,
+    NetworkTrace const &trace,
+    uint64_t chunkBytes,
+    int64_t durationMs,
+    int64_t latencyMs = 0) {
+  std::vector<ReplaySample> samples;
+  for (int64_t nowMs = 0; nowMs < durationMs;) {
+    auto elapsedMs = trace.Download(chunkBytes, nowMs, latencyMs);
+    nowMs += elapsedMs;
+    samples.push_back(
+        ReplaySample{nowMs, trace.BitsPerSecondAt(nowMs), estimator.AddSample(chunkBytes, elapsedMs)});
+  }
+  return samples;
+}
+
+} // namespace ReactNativeVideoCPP::Tests
@@ -0,0 +1,60 @@
+#include <string>
+#include <string_view>
+#include "PropertyDispatcher.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+
+namespace {
+
+using Handler = int (*)();
+
+constexpr PropertyEntry<Handler> c_entries[] = {
+    {"src", [] { return 1; }},
+    {"resizeMode", [] { return 2; }},
+    {"repeat", [] { return 3; }},
+    {"paused", [] { return 4; }},
+    {"muted", [] { return 5; }},
+    {"volume", [] { return 6; }},
+    {"seek", [] { return 7; }},
+    {"controls", [] { return 8; }},
+    {"fullscreen", [] { return 9; }},
+    {"progressUpdateInterval", [] { return 10; }},
+    {"rate", [] { return 11; }},
+};
+
+constexpr auto c_dispatcher = MakePropertyDispatcher(c_entries);
+
+} // namespace
+
+TEST(EveryRegisteredNameFindsItsHandler) {
+  for (size_t i = 0; i < std::size(c_entries); ++i) {
+    auto handler = c_dispatcher.Find(c_entries[i].name);
+    CHECK(handler != nullptr) && CHECK_EQ(handler(), static_cast<int>(i + 1));
+  }
+}
+
+TEST(WideNamesHashLikeNarrowOnes) {
+  auto handler = c_dispatcher.Find(std::wstring_view{L"progressUpdateInterval"});
+  CHECK(handler != nullptr) && CHECK_EQ(handler(), 10);
+  CHECK_EQ(c_dispatcher.Slot(std::wstring_view{L"volume"}), c_dispatcher.Slot(std::string_view{"volume"}));
+}
+
+TEST(UnknownNamesAreRejected) {
+  CHECK(c_dispatcher.Find(std::string_view{"poster"}) == nullptr);
+  CHECK(c_dispatcher.Find(std::string_view{""}) == nullptr);
+  CHECK(c_dispatcher.Find(std::string_view{"Paused"}) == nullptr);
+  CHECK(c_dispatcher.Find(std::string_view{"pausedx"}) == nullptr);
+  CHECK(c_dispatcher.Find(std::wstring_view{L"volum"}) == nullptr);
+}
+
+TEST(SlotsAreCollisionFree) {
+  // the table is built at compile time, so this also holds in a constant expression
+  static_assert(c_dispatcher.Find(std::string_view{"rate"}) != nullptr, "lookup works at compile time");
+  bool used[decltype(c_dispatcher)::TableSize] = {};
+  for (auto const &entry : c_entries) {
+    auto slot = c_dispatcher.Slot(entry.name);
+    CHECK(!used[slot]);
+    used[slot] = true;
+  }
+}
@@ -0,0 +1,128 @@
+#include "QoeCollector.h"
+#include "TestHarness.h"
+
+using ReactNativeVideoCPP::PlaybackStatus;
+using ReactNativeVideoCPP::QoeCollector;
+
+// Every case drives the collector from a simulated clock: the timestamps are the times the player raised
+// each transition.
+
+TEST(TimeToFirstFrameRunsFromLoadStartToPlaying) {
+  QoeCollector qoe;
+  qoe.OnLoadStart(1000);
+  qoe.OnStatus(PlaybackStatus::Opening, 1010);
+  qoe.OnStatus(PlaybackStatus::Buffering, 1200);
+  CHECK_EQ(qoe.Snapshot(1300).timeToFirstFrameMs, -1);
+  qoe.OnStatus(PlaybackStatus::Playing, 1450);
+  CHECK_EQ(qoe.Snapshot(2000).timeToFirstFrameMs, 450);
+}
+
+TEST(TimeToFirstFrameExcludesAPausedWaitForTheUser) {
+  QoeCollector qoe;
+  qoe.OnLoadStart(0);
+  qoe.OnStatus(PlaybackStatus::Opening, 0);
+  qoe.OnStatus(PlaybackStatus::Paused, 300); // opened with autoplay off
+  qoe.OnStatus(PlaybackStatus::Buffering, 60000); // the user pressed play a minute later
+  qoe.OnStatus(PlaybackStatus::Playing, 60200);
+  CHECK_EQ(qoe.Snapshot(60200).timeToFirstFrameMs, 500);
+}
+
+TEST(NoTimeToFirstFrameWithoutALoad) {
+  QoeCollector qoe;
+  qoe.OnStatus(PlaybackStatus::Playing, 100);
+  CHECK_EQ(qoe.Snapshot(200).timeToFirstFrameMs, -1);
+}
+
+TEST(PlayTimeAccumulatesAcrossEveryTransition) {
+  QoeCollector qoe;
+  qoe.OnLoadStart(0);
+  qoe.OnStatus(PlaybackStatus::Playing, 100);
+  qoe.OnStatus(PlaybackStatus::Paused, 1100);
+  qoe.OnStatus(PlaybackStatus::Playing, 5000);
+  qoe.OnStatus(PlaybackStatus::Buffering, 5500);
+  qoe.OnStatus(PlaybackStatus::Playing, 5600);
+  CHECK_EQ(qoe.Snapshot(5600).playMs, 1500);
+  CHECK_EQ(qoe.Snapshot(6600).playMs, 2500); // the running period counts up to the snapshot
+}
+
+TEST(StallsAfterTheFirstFrameAreCountedAndBucketed) {
+  QoeCollector qoe;
+  qoe.OnLoadStart(0);
+  qoe.OnBufferingStarted(10); // startup buffering is not a stall
+  qoe.OnBufferingEnded(400);
+  qoe.OnStatus(PlaybackStatus::Playing, 400);
+  qoe.OnBufferingStarted(1400);
+  qoe.OnStatus(PlaybackStatus::Buffering, 1400);
+  qoe.OnBufferingEnded(1700);
+  qoe.OnStatus(PlaybackStatus::Playing, 1700);
+  auto snapshot = qoe.Snapshot(2700);
+  CHECK_EQ(snapshot.rebufferCount, 1u);
+  CHECK_EQ(snapshot.rebufferMs, 300);
+  CHECK_EQ(snapshot.playMs, 2000);
+  CHECK_NEAR(snapshot.rebufferRatio, 300.0 / 2300, 1e-9);
+  CHECK_EQ(snapshot.stallHistogram[2], 1u); // 250 < 300 <= 500
+}
+
+TEST(ARunningStallIsIncludedInTheSnapshot) {
+  QoeCollector qoe;
+  qoe.OnLoadStart(0);
+  qoe.OnStatus(PlaybackStatus::Playing, 0);
+  qoe.OnStatus(PlaybackStatus::Buffering, 1000);
+  qoe.OnBufferingStarted(1000);
+  auto snapshot = qoe.Snapshot(1600);
+  CHECK_EQ(snapshot.rebufferMs, 600);
+  CHECK_EQ(snapshot.rebufferCount, 0u); // counted once it ends
+  CHECK_NEAR(snapshot.rebufferRatio, 0.375, 1e-9);
+}
+
+TEST(BufferingDuringASeekIsSeekCost) {
+  QoeCollector qoe;
+  qoe.OnLoadStart(0);
+  qoe.OnStatus(PlaybackStatus::Playing, 0);
+  qoe.OnSeekStarted(1000);
+  qoe.OnBufferingStarted(1010);
+  qoe.OnBufferingEnded(1300);
+  qoe.OnSeekCompleted(1350);
+  qoe.OnSeekStarted(2000);
+  qoe.OnSeekStarted(2100); // coalesced into the first
+  qoe.OnSeekCompleted(2150);
+  auto snapshot = qoe.Snapshot(3000);
+  CHECK_EQ(snapshot.rebufferCount, 0u);
+  CHECK_EQ(snapshot.seekCount, 2u);
+  CHECK_EQ(snapshot.seekLatencyMaxMs, 350);
+  CHECK_EQ(snapshot.seekLatencyAvgMs, 250);
+}
+
+TEST(ANewSourceRestartsTimeToFirstFrameOnly) {
+  QoeCollector qoe;
+  qoe.OnLoadStart(0);
+  qoe.OnStatus(PlaybackStatus::Playing, 100);
+  qoe.OnError();
+  qoe.OnStatus(PlaybackStatus::None, 1100);
+  qoe.OnLoadStart(2000);
+  auto snapshot = qoe.Snapshot(2100);
+  CHECK_EQ(snapshot.timeToFirstFrameMs, -1);
+  CHECK_EQ(snapshot.playMs, 1000);
+  CHECK_EQ(snapshot.errorCount, 1u);
+  qoe.OnStatus(PlaybackStatus::Playing, 2250);
+  CHECK_EQ(qoe.Snapshot(2250).timeToFirstFrameMs, 250);
+}
+
+TEST(DroppedFramePercentilesComeFromFrameSamples) {
+  QoeCollector qoe;
+  CHECK_EQ(qoe.Snapshot(0).droppedFrameSamples, 0u); // a platform without frame statistics reports none
+  for (int i = 0; i < 90; ++i) {
+    qoe.OnFrameSample(30, 0);
+  }
+  for (int i = 0; i < 8; ++i) {
+    qoe.OnFrameSample(27, 3); // 10% dropped
+  }
+  qoe.OnFrameSample(15, 15);
+  qoe.OnFrameSample(0, 30);
+  qoe.OnFrameSample(0, 0); // nothing to show, not a sample
+  auto snapshot = qoe.Snapshot(0);
+  CHECK_EQ(snapshot.droppedFrameSamples, 100u);
+  CHECK_EQ(snapshot.droppedFramesP50, 0.0);
+  CHECK_EQ(snapshot.droppedFramesP95, 10.0);
+  CHECK_EQ(snapshot.droppedFramesP99, 50.0);
+}
@@ -0,0 +1,87 @@
+#include <string>
+#include "Scte35.h"
+#include "TestHarness.h"
+
+using namespace ReactNativeVideoCPP;
+
+namespace {
+
+// The sample splice_info_sections of SCTE 35 (2019), section 14.
+constexpr char const *c_timeSignalPlacementStart =
+    "/DA0AAAAAAAA///wBQb+cr0AUAAeAhxDVUVJSAAAjn/PAAGlmbAICAAAAAAsoKGKNAIAmsnRfg==";
+constexpr char const *c_spliceInsert = "/DAvAAAAAAAA///wFAVIAACPf+/+c2nALv4AUsz1AAAAAAAKAAhDVUVJAAABNWLbowo=";
+constexpr char const *c_spliceInsertHex =
+    "0xFC302F000000000000FFFFF014054800008F7FEFFE7369C02EFE0052CCF500000000000A0008435545490000013562DBA30A";
+constexpr char const *c_timeSignalPlacementEnd =
+    "/DAvAAAAAAAA///wBQb+dGKQoAAZAhdDVUVJSAAAjn+fCAgAAAAALKChijUCAKnMZ1g=";
+
+} // namespace
+
+TEST(TimeSignalWithPlacementOpportunityStart) {
+  SpliceInfo info;
+  CHECK(DecodeSpliceInfoText(c_timeSignalPlacementStart, info));
+  CHECK(info.command == SpliceCommandType::TimeSignal);
+  CHECK(info.hasTime);
+  CHECK_EQ(info.ptsTime, uint64_t{1924989008});
+  CHECK_EQ(info.segmentations.size(), 1u);
+  auto const &segmentation = info.segmentations[0];
+  CHECK_EQ(segmentation.eventId, 0x4800008eu);
+  CHECK_EQ(static_cast<int>(segmentation.typeId), 0x34);
+  CHECK(segmentation.hasDuration);
+  CHECK_EQ(segmentation.durationTicks, uint64_t{27630000});
+  CHECK_EQ(static_cast<int>(segmentation.segmentNum), 2);
+  CHECK(info.IsBreakStart());
+  CHECK(!info.IsBreakEnd());
+  CHECK_NEAR(info.DurationSeconds(), 307.0, 1e-9);
+}
+
+TEST(SpliceInsertOutOfNetwork) {
+  SpliceInfo info;
+  CHECK(DecodeSpliceInfoText(c_spliceInsert, info));
+  CHECK(info.command == SpliceCommandType::Insert);
+  CHECK_EQ(info.eventId, 0x4800008fu);
+  CHECK(info.outOfNetwork);
+  CHECK(!info.immediate);
+  CHECK(info.autoReturn);
+  CHECK(info.hasTime);
+  CHECK_EQ(info.ptsTime, uint64_t{1936310318});
+  CHECK(info.hasDuration);
+  CHECK_EQ(info.durationTicks, uint64_t{5426421});
+  CHECK(info.segmentations.empty()); // its avail_descriptor is not a segmentation
+  CHECK(info.IsBreakStart());
+  CHECK_NEAR(info.DurationSeconds(), 5426421 / 90000.0, 1e-9);
+}
+
+TEST(HexAndBase64SpellTheSameSection) {
+  SpliceInfo fromHex;
+  SpliceInfo fromBase64;
+  CHECK(DecodeSpliceInfoText(c_spliceInsertHex, fromHex));
+  CHECK(DecodeSpliceInfoText(c_spliceInsert, fromBase64));
+  CHECK_EQ(fromHex.eventId, fromBase64.eventId);
+  CHECK_EQ(fromHex.ptsTime, fromBase64.ptsTime);
+  CHECK_EQ(fromHex.durationTicks, fromBase64.durationTicks);
+  // without the 0x prefix too
+  CHECK(DecodeSpliceInfoText(std::string(c_spliceInsertHex).substr(2), fromHex));
+}
+
+TEST(TimeSignalWithPlacementOpportunityEnd) {
+  SpliceInfo info;
+  CHECK(DecodeSpliceInfoText(c_timeSignalPlacementEnd, info));
+  CHECK_EQ(info.ptsTime, uint64_t{1952616608});
+  CHECK_EQ(info.segmentations.size(), 1u);
+  CHECK_EQ(static_cast<int>(info.segmentations[0].typeId), 0x35);
+  CHECK(info.IsBreakEnd());
+  CHECK(!info.IsBreakStart());
+  CHECK_EQ(info.DurationSeconds(), 0.0);
+}
+
+TEST(DamagedSectionsAreRejected) {
+  SpliceInfo info;
+  auto hex = std::string(c_spliceInsertHex);
+  auto flipped = hex;
+  flipped[30] = flipped[30] == '0' ? '1' : '0'; // inside the command, caught by the CRC
+  CHECK(!DecodeSpliceInfoText(flipped, info));
+  CHECK(!DecodeSpliceInfoText(hex.substr(0, hex.size() - 8), info)); // cut short
+  CHECK(!DecodeSpliceInfoText("0xFC30", info));
+  CHECK(!DecodeSpliceInfoText("not a section", info));
+}
@@ -0,0 +1,87 @@
+#include "SeekController.h"
+#include "TestHarness.h"
+
+using ReactNativeVideoCPP::SeekController;
+
+TEST(SeeksWhileOneIsInFlightCoalesceIntoTheLatest) {
+  SeekController seeks;
+  auto first = seeks.Request(10);
+  CHECK(first.has_value());
+  CHECK(!seeks.Request(20));
+  CHECK(!seeks.Request(30));
+  auto completion = seeks.OnSeekCompleted(10);
+  CHECK(completion.completed && completion.completed->id == first->id);
+  CHECK(completion.next && completion.next->target == 30);
+  completion = seeks.OnSeekCompleted(30);
+  CHECK(completion.completed && completion.completed->requested == 30 && !completion.next);
+  CHECK(!seeks.IsSeeking());
+  CHECK_EQ(seeks.Stats().coalesced, 1u);
+}
+
+TEST(TheNextCompletionBelongsToTheSeekInFlight) {
+  SeekController seeks;
+  auto seek = seeks.Request(100);
+  CHECK(!seeks.Request(120));
+  // the player landed elsewhere (e.g. a seek made inside it superseded ours), it is still our completion
+  auto completion = seeks.OnSeekCompleted(42);
+  CHECK(completion.completed && completion.completed->id == seek->id);
+  CHECK(completion.next && completion.next->target == 120);
+  CHECK_EQ(seeks.Stats().offTarget, 1u);
+  CHECK_EQ(seeks.Stats().unattributed, 0u);
+}
+
+TEST(ASeekPastTheEndIsClampedToTheSeekableRange) {
+  SeekController seeks;
+  seeks.SetSeekableRange(0, 60);
+  auto seek = seeks.Request(500);
+  CHECK_EQ(seek->requested, 500.0);
+  CHECK_EQ(seek->target, 60.0);
+  CHECK(!seeks.Request(10));
+  auto completion = seeks.OnSeekCompleted(59.8);
+  CHECK(completion.completed && completion.completed->id == seek->id);
+  CHECK(completion.next && completion.next->target == 10); // issued right away, not after the timeout
+  CHECK(seeks.OnSeekCompleted(10).completed);
+  CHECK_EQ(seeks.Stats().offTarget, 0u);
+  CHECK_EQ(seeks.Stats().unattributed, 0u);
+  CHECK_EQ(seeks.Stats().expired, 0u);
+
+  // a range learned only after the seek was issued still places its landing
+  SeekController late;
+  auto early = late.Request(-5);
+  CHECK_EQ(early->target, 0.0);
+  CHECK(!late.Request(1000));
+  late.OnSeekCompleted(0);
+  late.SetSeekableRange(0, 30);
+  late.OnSeekCompleted(30);
+  CHECK_EQ(late.Stats().offTarget, 0u);
+}
+
+TEST(CompletionsWithNothingInFlightAreUnattributed) {
+  SeekController seeks;
+  auto completion = seeks.OnSeekCompleted(5);
+  CHECK(!completion.completed && !completion.next && completion.playerSeek);
+  CHECK(seeks.Request(5).has_value()); // and don't block the next request
+}
+
+TEST(ExpireFlushesThePendingSeek) {
+  SeekController seeks;
+  auto lost = seeks.Request(10);
+  CHECK(!seeks.Request(50));
+  auto completion = seeks.Expire(lost->id);
+  CHECK(completion.completed && completion.completed->id == lost->id);
+  CHECK(completion.next && completion.next->target == 50);
+  CHECK_EQ(seeks.Stats().expired, 1u);
+  // the lost seek's watchdog firing again, or the original completion arriving late, changes nothing
+  CHECK(!seeks.Expire(lost->id).completed);
+  auto late = seeks.OnSeekCompleted(10);
+  CHECK(!late.completed && !late.playerSeek);
+  CHECK(seeks.OnSeekCompleted(50).completed);
+}
+
+TEST(ToleranceSnapsToTheNearestKeyframe) {
+  SeekController seeks;
+  seeks.SetKeyframes({0, 4, 8, 12});
+  CHECK_EQ(seeks.Request(9.5, 2)->target, 8.0);
+  seeks.OnSeekCompleted(8);
+  CHECK_EQ(seeks.Request(9.5, 1)->target, 9.5); // no keyframe within a second
+}
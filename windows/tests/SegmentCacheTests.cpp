@@ -0,0 +1,309 @@
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CacheJournal.h"
+#include "SegmentCache.h"
+#include "TestHarness.h"
+
+using ReactNativeVideoCPP::CacheJournal;
+using ReactNativeVideoCPP::CacheJournalEntry;
+using ReactNativeVideoCPP::SegmentCache;
+
+namespace {
+
+std::filesystem::path Folder(char const *name) {
+  auto folder = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(folder);
+  return folder;
+}
+
+std::string Key(int i) {
+  return SegmentCache::Key("https://example.com/seg" + std::to_string(i) + ".ts");
+}
+
+// The bytes an entry of a one-digit Key() and a 100-byte payload takes: file header, key and payload.
+constexpr uint64_t c_entryBytes = 8 + 27 + 100;
+
+std::string Payload(char c) {
+  return std::string(100, c);
+}
+
+size_t EntryFiles(std::filesystem::path const &folder) {
+  size_t count = 0;
+  for (auto const &file : std::filesystem::directory_iterator(folder)) {
+    count += file.path().extension() == ".seg" ? 1 : 0;
+  }
+  return count;
+}
+
+} // namespace
+
+TEST(EntriesSurviveAReopen) {
+  auto folder = Folder("SegmentCacheTests-reopen");
+  {
+    SegmentCache cache(folder, 1 << 20);
+    CHECK(cache.Put(Key(1), "one"));
+    CHECK(cache.Put(Key(2), "two"));
+    cache.Remove(Key(1));
+  }
+  {
+    SegmentCache cache(folder, 1 << 20);
+    CHECK(!cache.Contains(Key(1)));
+    auto item = cache.Get(Key(2));
+    CHECK(item);
+    CHECK(item.Data() == "two");
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(ADamagedSnapshotIsRebuiltFromTheFiles) {
+  auto folder = Folder("SegmentCacheTests-damaged");
+  {
+    SegmentCache cache(folder, 1 << 20);
+    for (int i = 0; i < 3; ++i) {
+      CHECK(cache.Put(Key(i), "payload" + std::to_string(i)));
+    }
+  }
+  {
+    std::ofstream snapshot(folder / "journal.snap", std::ios::binary | std::ios::trunc);
+    snapshot << "garbage";
+  }
+  {
+    SegmentCache cache(folder, 1 << 20);
+    CHECK_EQ(cache.Stats().entries, 3u);
+    for (int i = 0; i < 3; ++i) {
+      auto item = cache.Get(Key(i));
+      CHECK(item);
+      CHECK(item.Data() == "payload" + std::to_string(i));
+    }
+  }
+  {
+    SegmentCache cache(folder, 1 << 20); // and the rebuilt snapshot is a valid one
+    CHECK_EQ(cache.Stats().entries, 3u);
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(ACompactionCutShortReplaysBothJournals) {
+  auto folder = Folder("SegmentCacheTests-rotate");
+  {
+    CacheJournal journal(folder);
+    CHECK(!journal.Open());
+    CHECK(journal.Compact({CacheJournalEntry{1, 10, 1}}));
+    journal.Append(CacheJournal::Op::Insert, 2, 20);
+    journal.Rotate(); // killed before WriteSnapshot
+    journal.Append(CacheJournal::Op::Insert, 3, 30);
+    journal.Append(CacheJournal::Op::Remove, 1);
+  }
+  CacheJournal journal(folder);
+  auto entries = journal.Open();
+  CHECK(entries);
+  CHECK_EQ(entries->size(), 2u);
+  CHECK_EQ(entries->at(0).hash, 2u);
+  CHECK_EQ(entries->at(1).hash, 3u);
+  CHECK(journal.ShouldCompact(entries->size()));
+  std::filesystem::remove_all(folder);
+}
+
+TEST(CompactionKeepsEveryEntry) {
+  auto folder = Folder("SegmentCacheTests-compact");
+  {
+    SegmentCache cache(folder, 1 << 20);
+    for (int i = 0; i < 8; ++i) {
+      CHECK(cache.Put(Key(i), std::string(100, static_cast<char>('a' + i))));
+    }
+    for (int round = 0; round < 1000; ++round) {
+      for (int i = 0; i < 8; ++i) {
+        cache.Get(Key(i));
+      }
+    }
+    CHECK(cache.Put(Key(8), "last")); // compacts the journal the reads grew
+  }
+  uint64_t journalBytes = 0;
+  for (auto const *name : {"journal.0.log", "journal.1.log"}) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(folder / name, error);
+    journalBytes += error ? 0 : size;
+  }
+  CHECK(journalBytes < 4096);
+  {
+    SegmentCache cache(folder, 1 << 20);
+    CHECK_EQ(cache.Stats().entries, 9u);
+    CHECK(cache.Get(Key(8)).Data() == "last");
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(TheLeastRecentlyUsedEntryIsEvictedFirst) {
+  auto folder = Folder("SegmentCacheTests-lru");
+  SegmentCache cache(folder, 3 * c_entryBytes);
+  for (int i = 0; i < 3; ++i) {
+    CHECK(cache.Put(Key(i), Payload('a')));
+  }
+  CHECK(cache.Get(Key(0))); // 1 is now the least recently used
+  CHECK(cache.Put(Key(3), Payload('b')));
+  CHECK(cache.Contains(Key(0)));
+  CHECK(!cache.Contains(Key(1)));
+  CHECK(cache.Contains(Key(2)));
+  CHECK(cache.Put(Key(4), Payload('c')));
+  CHECK(!cache.Contains(Key(2)));
+  CHECK(cache.Contains(Key(0)));
+  CHECK_EQ(cache.Stats().evictions, 2u);
+  std::filesystem::remove_all(folder);
+}
+
+TEST(TheByteBudgetIsKept) {
+  auto folder = Folder("SegmentCacheTests-budget");
+  SegmentCache cache(folder, 4 * c_entryBytes + 50);
+  for (int i = 0; i < 10; ++i) {
+    CHECK(cache.Put(Key(i), Payload('a')));
+    CHECK(cache.Stats().bytes <= cache.Stats().capacityBytes);
+  }
+  auto stats = cache.Stats();
+  CHECK_EQ(stats.entries, 4u);
+  CHECK_EQ(stats.bytes, 4 * c_entryBytes);
+  CHECK_EQ(stats.evictedBytes, 6 * c_entryBytes);
+  CHECK(!cache.Put(Key(10), std::string(5 * c_entryBytes, 'x'))); // larger than the whole budget
+  CHECK_EQ(cache.Stats().rejected, 1u);
+  CHECK_EQ(EntryFiles(folder), 4u);
+
+  cache.SetCapacity(2 * c_entryBytes);
+  CHECK_EQ(cache.Stats().entries, 2u);
+  CHECK_EQ(EntryFiles(folder), 2u);
+  std::filesystem::remove_all(folder);
+}
+
+TEST(AnEvictedEntryStaysReadableWhileHeld) {
+  auto folder = Folder("SegmentCacheTests-held");
+  SegmentCache cache(folder, 2 * c_entryBytes);
+  CHECK(cache.Put(Key(0), Payload('a')));
+  auto item = cache.Get(Key(0));
+  CHECK(cache.Put(Key(1), Payload('b')));
+  CHECK(cache.Put(Key(2), Payload('c'))); // evicts 0
+  CHECK(!cache.Contains(Key(0)));
+  CHECK(!cache.Get(Key(0)));
+  CHECK(item.Data() == Payload('a'));
+  CHECK_EQ(EntryFiles(folder), 3u); // still mapped, so still there
+  item = {};
+  CHECK_EQ(EntryFiles(folder), 2u); // and deleted by the last reader
+  std::filesystem::remove_all(folder);
+}
+
+TEST(AHeldEntryCanBeReplaced) {
+  auto folder = Folder("SegmentCacheTests-replace");
+  {
+    SegmentCache cache(folder, 1 << 20);
+    CHECK(cache.Put(Key(0), Payload('a')));
+    auto old = cache.Get(Key(0));
+    CHECK(cache.Put(Key(0), Payload('b')));
+    CHECK(old.Data() == Payload('a'));
+    CHECK(cache.Get(Key(0)).Data() == Payload('b'));
+    CHECK_EQ(cache.Stats().entries, 1u);
+    CHECK_EQ(cache.Stats().bytes, c_entryBytes);
+  }
+  SegmentCache cache(folder, 1 << 20);
+  CHECK(cache.Get(Key(0)).Data() == Payload('b'));
+  CHECK_EQ(EntryFiles(folder), 1u);
+  std::filesystem::remove_all(folder);
+}
+
+TEST(FilesNoEntryOwnsAreSweptOnOpen) {
+  auto folder = Folder("SegmentCacheTests-sweep");
+  std::filesystem::path entryFile;
+  {
+    SegmentCache cache(folder, 1 << 20);
+    CHECK(cache.Put(Key(0), Payload('a')));
+    for (auto const &file : std::filesystem::directory_iterator(folder)) {
+      if (file.path().extension() == ".seg") {
+        entryFile = file.path();
+      }
+    }
+  }
+  // a version replaced while mapped by a process that died before deleting it, and an interrupted write
+  auto stem = entryFile.stem().string();
+  auto stale = folder / (stem.substr(0, 16) + ".90.seg");
+  std::filesystem::copy_file(entryFile, stale);
+  std::ofstream(folder / (stem.substr(0, 16) + ".91.seg.tmp")) << "torn";
+  {
+    SegmentCache cache(folder, 1 << 20);
+    CHECK(!std::filesystem::exists(stale));
+    CHECK(!std::filesystem::exists(folder / (stem.substr(0, 16) + ".91.seg.tmp")));
+    CHECK(std::filesystem::exists(entryFile));
+    CHECK(cache.Get(Key(0)).Data() == Payload('a'));
+    CHECK(cache.Put(Key(0), Payload('b'))); // takes a version past the swept ones
+    CHECK_EQ(EntryFiles(folder), 1u);
+    CHECK(!std::filesystem::exists(entryFile));
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(ConcurrentReadersAndWritersOfOneKey) {
+  auto folder = Folder("SegmentCacheTests-concurrent");
+  {
+    SegmentCache cache(folder, 1 << 20);
+    std::atomic<int> torn{0};
+    std::vector<std::thread> threads;
+    for (char c : {'a', 'b'}) {
+      threads.emplace_back([&cache, c] {
+        for (int i = 0; i < 200; ++i) {
+          cache.Put(Key(0), Payload(c));
+        }
+      });
+    }
+    for (int reader = 0; reader < 2; ++reader) {
+      threads.emplace_back([&cache, &torn] {
+        for (int i = 0; i < 2000; ++i) {
+          if (auto item = cache.Get(Key(0))) {
+            auto data = item.Data();
+            torn += data != Payload('a') && data != Payload('b') ? 1 : 0;
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    CHECK_EQ(torn.load(), 0);
+    CHECK_EQ(cache.Stats().entries, 1u);
+    CHECK_EQ(cache.Stats().bytes, c_entryBytes);
+    CHECK_EQ(cache.Stats().rejected, 0u);
+    CHECK_EQ(EntryFiles(folder), 1u);
+  }
+  SegmentCache cache(folder, 1 << 20);
+  auto item = cache.Get(Key(0));
+  CHECK(item.Data() == Payload('a') || item.Data() == Payload('b'));
+  std::filesystem::remove_all(folder);
+}
+
+TEST(ReadsAreJournaledInBatchesAndKeepTheirOrder) {
+  auto folder = Folder("SegmentCacheTests-touches");
+  auto journalBytes = [&folder] {
+    uint64_t bytes = 0;
+    for (auto const *name : {"journal.0.log", "journal.1.log"}) {
+      std::error_code error;
+      auto size = std::filesystem::file_size(folder / name, error);
+      bytes += error ? 0 : size;
+    }
+    return bytes;
+  };
+  {
+    SegmentCache cache(folder, 3 * c_entryBytes);
+    for (int i = 0; i < 3; ++i) {
+      CHECK(cache.Put(Key(i), Payload('a')));
+    }
+    auto before = journalBytes();
+    for (int round = 0; round < 10; ++round) {
+      CHECK(cache.Get(Key(0)));
+    }
+    CHECK_EQ(journalBytes(), before); // nothing written per hit
+  }
+  // the hits were journaled when the cache closed, so 1 is still the least recently used
+  SegmentCache cache(folder, 3 * c_entryBytes);
+  CHECK(cache.Put(Key(3), Payload('b')));
+  CHECK(cache.Contains(Key(0)));
+  CHECK(!cache.Contains(Key(1)));
+  std::filesystem::remove_all(folder);
+}
@@ -0,0 +1,127 @@
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include "SegmentIndex.h"
+#include "TestHarness.h"
+
+using ReactNativeVideoCPP::DashManifest;
+using ReactNativeVideoCPP::DashMpdParser;
+using ReactNativeVideoCPP::SegmentIndex;
+using ReactNativeVideoCPP::SegmentIndexBuilder;
+
+namespace {
+
+std::unique_ptr<SegmentIndex> Build(std::string_view manifest) {
+  SegmentIndexBuilder builder;
+  builder.SetSource(manifest);
+  builder.Append(0, 4, 0, 0, "a.ts");
+  builder.Append(4, 4, 0, 0, "bb.ts");
+  builder.Append(8, 2, 0, 0, "ccc.ts");
+  return builder.Build();
+}
+
+// byte offset of the uriOffsets array of a 3-segment index: header, starts, durations, byteOffsets,
+// byteLengths
+constexpr size_t c_uriOffsets = 40 + 24 + 16 + 24 + 16;
+
+void PutOffset(std::string &bytes, size_t i, uint32_t value) {
+  std::memcpy(&bytes[c_uriOffsets + i * sizeof(uint32_t)], &value, sizeof(value));
+}
+
+// A live MPD with 4-second $Number$ segments and no SegmentTimeline, keeping a 20-second DVR window.
+constexpr std::string_view c_liveNumberMpd = R"(<MPD type="dynamic" availabilityStartTime="2024-05-01T00:00:00Z"
+    timeShiftBufferDepth="PT20S">
+  <Period id="p0" start="PT10S">
+    <AdaptationSet mimeType="video/mp4">
+      <SegmentTemplate timescale="1000" duration="4000" media="$Number$.m4s" startNumber="1"/>
+      <Representation id="v" bandwidth="1000000"/>
+    </AdaptationSet>
+  </Period>
+</MPD>)";
+
+DashManifest ParseDash(std::string_view text) {
+  DashMpdParser parser;
+  parser.Feed(text);
+  DashManifest manifest;
+  CHECK(parser.Finish(manifest));
+  return manifest;
+}
+
+} // namespace
+
+TEST(FindsTheSegmentCoveringATime) {
+  auto index = Build("#EXTM3U");
+  CHECK_EQ(index->Size(), 3u);
+  CHECK_EQ(index->Find(0), 0u);
+  CHECK_EQ(index->Find(5), 1u);
+  CHECK_EQ(index->Find(9.99), 2u);
+  CHECK_EQ(index->Find(10), SegmentIndex::npos);
+  CHECK_EQ(index->Find(-1), SegmentIndex::npos);
+  CHECK(index->Uri(1) == "bb.ts");
+}
+
+TEST(SerializedBytesRoundTrip) {
+  auto index = Build("#EXTM3U");
+  auto copy = SegmentIndex::FromBytes(index->Bytes());
+  CHECK(copy != nullptr);
+  CHECK(copy->Uri(2) == "ccc.ts");
+  CHECK_EQ(copy->Source(), SegmentIndex::Fingerprint("#EXTM3U"));
+  CHECK(copy->Source() != SegmentIndex::Fingerprint("#EXTM3U\n#EXT-X-ENDLIST"));
+}
+
+TEST(UriOffsetsOutsideTheUriBytesAreRejected) {
+  auto index = Build("#EXTM3U");
+  std::string bytes(index->Bytes());
+  auto damaged = bytes;
+  PutOffset(damaged, 1, 1000); // past the URI bytes, and then decreasing
+  CHECK(SegmentIndex::FromBytes(damaged) == nullptr);
+  damaged = bytes;
+  PutOffset(damaged, 0, 2);
+  CHECK(SegmentIndex::FromBytes(damaged) == nullptr);
+  damaged = bytes;
+  PutOffset(damaged, 3, 14); // the end no longer matches uriBytes
+  CHECK(SegmentIndex::FromBytes(damaged) == nullptr);
+  CHECK(SegmentIndex::FromBytes(bytes.substr(0, bytes.size() - 8)) == nullptr);
+}
+
+TEST(SavedIndexMapsBack) {
+  auto path = std::filesystem::temp_directory_path() / "SegmentIndexTests.idx";
+  auto index = Build("#EXTM3U");
+  CHECK(index->Save(path));
+  CHECK(!std::filesystem::exists(path.string() + ".tmp"));
+  auto mapped = SegmentIndex::Map(path);
+  CHECK(mapped != nullptr && mapped->Size() == 3 && mapped->Uri(0) == "a.ts");
+  CHECK(mapped != nullptr && mapped->Source() == index->Source());
+  mapped.reset();
+  std::filesystem::remove(path);
+}
+
+TEST(LiveNumberTemplateIsIndexedOverTheTimeShiftWindow) {
+  auto manifest = ParseDash(c_liveNumberMpd);
+  auto const &period = manifest.periods.front();
+  auto const &representation = period.adaptationSets.front().representations.front();
+  CHECK_EQ(period.duration, 0.0);
+
+  // 10 s into the period at 20 s: segments 1-2 are complete, the third is still being written
+  SegmentIndexBuilder builder;
+  builder.AppendDash(period, representation, 20, manifest.timeShiftBufferDepth);
+  auto index = builder.Build();
+  CHECK_EQ(index->Size(), 2u);
+  CHECK_EQ(index->Start(0), 10.0);
+  CHECK(index->Uri(1) == "2.m4s");
+
+  // 100 s into the period, only the segments of the last 20 s are still available
+  builder.AppendDash(period, representation, 110, manifest.timeShiftBufferDepth);
+  index = builder.Build();
+  CHECK_EQ(index->Size(), 5u);
+  CHECK_EQ(index->Start(0), 90.0);
+  CHECK(index->Uri(0) == "21.m4s");
+  CHECK_EQ(index->End(), 110.0);
+
+  // without an edge there is nothing to index
+  builder.AppendDash(period, representation, NAN, manifest.timeShiftBufferDepth);
+  CHECK(builder.Build()->Empty());
+  builder.AppendDash(period, representation);
+  CHECK(builder.Build()->Empty());
+}
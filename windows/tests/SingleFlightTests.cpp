@@ -0,0 +1,139 @@
+#include <atomic>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SingleFlight.h"
+#include "TestHarness.h"
+
+using ReactNativeVideoCPP::SingleFlight;
+
+namespace {
+
+SingleFlight::Bytes MakeBytes(size_t size) {
+  return std::make_shared<std::string const>(size, 'x');
+}
+
+void Ignore(SingleFlight::Bytes const &) {}
+
+} // namespace
+
+TEST(ASecondCallerJoinsTheFirstFlight) {
+  SingleFlight flights;
+  CHECK(flights.Join("a", Ignore));
+  SingleFlight::Bytes received;
+  CHECK(!flights.Join("a", [&received](SingleFlight::Bytes const &bytes) { received = bytes; }));
+  CHECK(flights.Join("b", Ignore)); // another key is another flight
+  CHECK(received == nullptr);
+
+  auto bytes = MakeBytes(10);
+  flights.Complete("a", bytes);
+  CHECK(received == bytes);
+  CHECK_EQ(flights.Stats().flights, 2u);
+  CHECK_EQ(flights.Stats().joined, 1u);
+
+  // the landed flight is over, the next request starts a new one
+  CHECK(flights.Join("a", Ignore));
+  CHECK_EQ(flights.Stats().flights, 3u);
+}
+
+TEST(EveryWaiterSeesTheResult) {
+  SingleFlight flights;
+  CHECK(flights.Join("a", Ignore));
+  // waiters on other threads, each blocking on what its callback hands over as Run does
+  std::atomic<int> joined{0};
+  std::atomic<int> led{0};
+  std::vector<SingleFlight::Bytes> results(4);
+  std::vector<std::thread> waiters;
+  for (auto &result : results) {
+    waiters.emplace_back([&flights, &joined, &led, &result] {
+      auto promise = std::make_shared<std::promise<SingleFlight::Bytes>>();
+      auto future = promise->get_future();
+      if (flights.Join("a", [promise](SingleFlight::Bytes const &bytes) { promise->set_value(bytes); })) {
+        ++led;
+        return;
+      }
+      ++joined;
+      result = future.get();
+    });
+  }
+  while (joined + led < static_cast<int>(results.size())) {
+    std::this_thread::yield();
+  }
+  auto bytes = MakeBytes(100);
+  flights.Complete("a", bytes);
+  for (auto &waiter : waiters) {
+    waiter.join();
+  }
+  CHECK_EQ(led.load(), 0);
+  for (auto const &result : results) {
+    CHECK(result == bytes);
+  }
+  CHECK_EQ(flights.Stats().joined, results.size());
+}
+
+TEST(AFailedLeaderFailsItsJoinersAndReleasesTheKey) {
+  SingleFlight flights;
+  int calls = 0;
+  SingleFlight::Bytes received = MakeBytes(1);
+  bool threw = false;
+  try {
+    flights.Run("a", [&]() -> SingleFlight::Bytes {
+      // a request arriving while the transfer is under way
+      CHECK(!flights.Join("a", [&](SingleFlight::Bytes const &bytes) {
+        ++calls;
+        received = bytes;
+      }));
+      throw std::runtime_error("connection reset");
+    });
+  } catch (std::runtime_error const &) {
+    threw = true;
+  }
+  CHECK(threw);
+  CHECK_EQ(calls, 1);
+  CHECK(received == nullptr);
+
+  // a retry starts a flight of its own
+  auto bytes = flights.Run("a", [] { return MakeBytes(5); });
+  CHECK(bytes != nullptr && bytes->size() == 5);
+  CHECK_EQ(flights.Stats().flights, 2u);
+
+  // a fetch that fails by returning null fails its joiners the same way
+  calls = 0;
+  received = MakeBytes(1);
+  flights.Run("a", [&]() -> SingleFlight::Bytes {
+    flights.Join("a", [&](SingleFlight::Bytes const &result) {
+      ++calls;
+      received = result;
+    });
+    return nullptr;
+  });
+  CHECK_EQ(calls, 1);
+  CHECK(received == nullptr);
+  CHECK(flights.Join("a", Ignore));
+}
+
+TEST(DedupedBytesCountOnlyTheJoinedRequests) {
+  SingleFlight flights;
+  // a flight nobody joined saves nothing
+  flights.Run("a", [] { return MakeBytes(1000); });
+  CHECK_EQ(flights.Stats().dedupedBytes, 0u);
+
+  // two joiners of a 100-byte flight save 200 bytes, the leader's own 100 were transferred
+  CHECK(flights.Join("b", Ignore));
+  CHECK(!flights.Join("b", Ignore));
+  CHECK(!flights.Join("b", Ignore));
+  flights.Complete("b", MakeBytes(100));
+  CHECK_EQ(flights.Stats().dedupedBytes, 200u);
+
+  // a failed flight saves nothing either
+  CHECK(flights.Join("c", Ignore));
+  CHECK(!flights.Join("c", Ignore));
+  flights.Complete("c", nullptr);
+  auto stats = flights.Stats();
+  CHECK_EQ(stats.dedupedBytes, 200u);
+  CHECK_EQ(stats.joined, 3u);
+  CHECK_EQ(stats.flights, 3u);
+}
@@ -0,0 +1,152 @@
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SparseCache.h"
+#include "TestHarness.h"
+
+using ReactNativeVideoCPP::SparseCache;
+using ReactNativeVideoCPP::SparseResource;
+
+namespace {
+
+std::string Bytes(uint64_t offset, uint64_t length) {
+  std::string bytes(static_cast<size_t>(length), '\0');
+  for (uint64_t i = 0; i < length; ++i) {
+    bytes[static_cast<size_t>(i)] = static_cast<char>((offset + i) * 7);
+  }
+  return bytes;
+}
+
+std::filesystem::path Folder(char const *name) {
+  auto folder = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(folder);
+  return folder;
+}
+
+uint64_t FolderBytes(std::filesystem::path const &folder) {
+  uint64_t bytes = 0;
+  for (auto const &file : std::filesystem::directory_iterator(folder)) {
+    if (file.path().extension() == ".chunk") {
+      bytes += file.file_size();
+    }
+  }
+  return bytes;
+}
+
+} // namespace
+
+TEST(AReadFarIntoAResourceOnlyAllocatesItsOwnChunk) {
+  auto folder = Folder("SparseCacheTests-chunks");
+  {
+    SparseCache cache(folder, 1ull << 30);
+    cache.Adopt("clip", SparseResource{500 * SparseCache::c_chunkBytes, "\"v1\"", "video/mp4"});
+    auto offset = 400 * SparseCache::c_chunkBytes - 100; // straddles two chunks
+    CHECK(cache.Write("clip", offset, Bytes(offset, 200)));
+    CHECK(FolderBytes(folder) <= SparseCache::c_chunkBytes + 100);
+
+    std::string out;
+    auto fetch = [](uint64_t, uint64_t) { return std::string(); };
+    CHECK(cache.Read("clip", offset, 200, out, fetch));
+    CHECK_EQ(out, Bytes(offset, 200));
+    CHECK_EQ(cache.Stats().cachedBytes, 200u);
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(EvictionNeverDropsTheResourceBeingWritten) {
+  auto folder = Folder("SparseCacheTests-evict");
+  {
+    SparseCache cache(folder, 1000);
+    CHECK(cache.Write("old", 0, Bytes(0, 600)));
+    CHECK(cache.Write("new", 0, Bytes(0, 600)));
+    CHECK(cache.Present("old").Empty());
+    CHECK_EQ(cache.Present("new").Size(), 600u);
+
+    // past the budget on its own, the rest of "new" is not kept rather than evicting "new" itself
+    CHECK(!cache.Write("new", 600, Bytes(600, 600)));
+    CHECK_EQ(cache.Present("new").Size(), 600u);
+    std::string out;
+    auto fetch = [](uint64_t offset, uint64_t length) { return Bytes(offset, length); };
+    CHECK(cache.Read("new", 0, 1200, out, fetch));
+    CHECK_EQ(out, Bytes(0, 1200));
+    CHECK_EQ(cache.Present("new").Size(), 600u);
+    CHECK(cache.Stats().bytes <= 1000u);
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(ANewValidatorDropsTheKeptRanges) {
+  auto folder = Folder("SparseCacheTests-validator");
+  {
+    SparseCache cache(folder, 1 << 20);
+    cache.Adopt("clip", SparseResource{1000, "\"v1\"", "video/mp4"});
+    CHECK(cache.Write("clip", 0, Bytes(0, 500)));
+    cache.Adopt("clip", SparseResource{1000, "\"v1\"", "video/mp4"});
+    CHECK_EQ(cache.Present("clip").Size(), 500u);
+    cache.Adopt("clip", SparseResource{1000, "\"v2\"", "video/mp4"});
+    CHECK(cache.Present("clip").Empty());
+    CHECK_EQ(cache.Resource("clip").validator, std::string("\"v2\""));
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(ResourcesSurviveARestart) {
+  auto folder = Folder("SparseCacheTests-restart");
+  {
+    SparseCache cache(folder, 1 << 20);
+    cache.Adopt("clip", SparseResource{1000, "\"v1\"", "video/mp4"});
+    CHECK(cache.Write("clip", 100, Bytes(100, 300)));
+  }
+  std::filesystem::create_directories(folder);
+  {
+    std::ofstream orphan(folder / "0123456789abcdef-0.chunk", std::ios::binary);
+    orphan << "stale";
+  }
+  {
+    SparseCache cache(folder, 1 << 20);
+    auto resource = cache.Resource("clip");
+    CHECK_EQ(resource.length, 1000u);
+    CHECK_EQ(resource.validator, std::string("\"v1\""));
+    CHECK_EQ(resource.contentType, std::string("video/mp4"));
+    CHECK_EQ(cache.Present("clip").Size(), 300u);
+    std::string out;
+    auto fetch = [](uint64_t, uint64_t) { return std::string(); };
+    CHECK(cache.Read("clip", 100, 300, out, fetch));
+    CHECK_EQ(out, Bytes(100, 300));
+    CHECK(!std::filesystem::exists(folder / "0123456789abcdef-0.chunk"));
+  }
+  std::filesystem::remove_all(folder);
+}
+
+TEST(ConcurrentWritesIntoANewChunkAllSurvive) {
+  auto folder = Folder("SparseCacheTests-concurrent");
+  {
+    SparseCache cache(folder, 1ull << 30);
+    constexpr uint64_t c_part = 4096;
+    constexpr uint64_t c_parts = 16;
+    for (int round = 0; round < 50; ++round) {
+      // every writer finds the chunk missing and creates it, none may truncate what another wrote
+      auto key = "clip" + std::to_string(round);
+      std::atomic<int> failed{0};
+      std::vector<std::thread> writers;
+      for (uint64_t part = 0; part < c_parts; ++part) {
+        writers.emplace_back([&cache, &key, &failed, part] {
+          failed += cache.Write(key, part * c_part, Bytes(part * c_part, c_part)) ? 0 : 1;
+        });
+      }
+      for (auto &writer : writers) {
+        writer.join();
+      }
+      CHECK_EQ(failed.load(), 0);
+      CHECK_EQ(cache.Present(key).Size(), c_parts * c_part);
+      std::string out;
+      auto fetch = [](uint64_t, uint64_t) { return std::string(); };
+      CHECK(cache.Read(key, 0, c_parts * c_part, out, fetch));
+      CHECK(out == Bytes(0, c_parts * c_part));
+    }
+  }
+  std::filesystem::remove_all(folder);
+}
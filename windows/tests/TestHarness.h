@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Minimal test runner for the portable headers: TEST(Name) { ... } registers a case, CHECK* report a
+// failure with its location and keep going, and TestMain.cpp runs every case and fails the process if
+// any check failed.
+namespace ReactNativeVideoCPP::Tests {
+
+struct TestCase {
+  char const *name;
+  void (*run)();
+};
+
+inline std::vector<TestCase> &Registry() {
+  static std::vector<TestCase> tests;
+  return tests;
+}
+
+inline int &Failures() {
+  static int failures = 0;
+  return failures;
+}
+
+struct Registration {
+  Registration(char const *name, void (*run)()) {
+    Registry().push_back(TestCase{name, run});
+  }
+};
+
+inline bool Check(bool passed, char const *expression, char const *file, int line) {
+  if (!passed) {
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+    ++Failures();
+  }
+  return passed;
+}
+
+} // namespace ReactNativeVideoCPP::Tests
+
+#define TEST(name)                                                                                  \
+  static void name();                                                                               \
+  static ::ReactNativeVideoCPP::Tests::Registration name##Registration(#name, &name);               \
+  static void name()
+
+#define CHECK(condition) \
+  ::ReactNativeVideoCPP::Tests::Check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+#define CHECK_NEAR(a, b, tolerance) CHECK(std::abs((a) - (b)) <= (tolerance))
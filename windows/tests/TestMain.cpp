@@ -0,0 +1,13 @@
+#include <cstdio>
+#include "TestHarness.h"
+
+int main() {
+  using namespace ReactNativeVideoCPP::Tests;
+  for (auto const &test : Registry()) {
+    auto failuresBefore = Failures();
+    test.run();
+    std::printf("%s %s\n", Failures() == failuresBefore ? "[ OK ]" : "[FAIL]", test.name);
+  }
+  std::printf("%zu tests, %d failed checks\n", Registry().size(), Failures());
+  return Failures() == 0 ? 0 : 1;
+}
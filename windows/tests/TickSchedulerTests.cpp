@@ -0,0 +1,71 @@
+#include <vector>
+#include "TestHarness.h"
+#include "TickScheduler.h"
+
+using ReactNativeVideoCPP::TickScheduler;
+
+namespace {
+
+std::vector<int> Advance(TickScheduler<int> &scheduler, int64_t nowMs) {
+  std::vector<int> due;
+  scheduler.Advance(nowMs, [&](int subscriber) { due.push_back(subscriber); });
+  return due;
+}
+
+} // namespace
+
+TEST(SubscribersShareTheDeadlineOfTheirInterval) {
+  TickScheduler<int> scheduler;
+  scheduler.Subscribe(1, 250, 0);
+  scheduler.Subscribe(2, 250, 100); // joins the running bucket
+  scheduler.Subscribe(3, 1000, 0);
+  CHECK(scheduler.NextDueMs() == 250);
+  CHECK_EQ(Advance(scheduler, 250).size(), 2u);
+  CHECK(scheduler.NextDueMs() == 500);
+  CHECK_EQ(Advance(scheduler, 1000).size(), 3u);
+}
+
+TEST(UnsubscribeFromTheMiddleOfABucketKeepsTheOthers) {
+  TickScheduler<int> scheduler;
+  for (int i = 0; i < 5; ++i) {
+    scheduler.Subscribe(i, 100, 0);
+  }
+  CHECK(scheduler.Unsubscribe(1));
+  CHECK(!scheduler.Unsubscribe(1));
+  CHECK(scheduler.Unsubscribe(4)); // the subscriber that took 1's place
+  CHECK(!scheduler.IsSubscribed(4));
+  CHECK(scheduler.IsSubscribed(0) && scheduler.IsSubscribed(2) && scheduler.IsSubscribed(3));
+  CHECK_EQ(Advance(scheduler, 100).size(), 3u);
+  for (int i : {0, 2, 3}) {
+    CHECK(scheduler.Unsubscribe(i));
+  }
+  CHECK(scheduler.Empty());
+  CHECK(!scheduler.NextDueMs());
+}
+
+TEST(ChangingTheIntervalMovesTheSubscriber) {
+  TickScheduler<int> scheduler;
+  scheduler.Subscribe(1, 100, 0);
+  scheduler.Subscribe(1, 500, 0);
+  CHECK(scheduler.NextDueMs() == 500);
+  CHECK(Advance(scheduler, 100).empty());
+}
+
+TEST(SubscribersMayUnsubscribeWhileTicked) {
+  TickScheduler<int> scheduler;
+  scheduler.Subscribe(1, 100, 0);
+  scheduler.Subscribe(2, 100, 0);
+  std::vector<int> ticked;
+  scheduler.Advance(100, [&](int subscriber) {
+    ticked.push_back(subscriber);
+    scheduler.Unsubscribe(subscriber == 1 ? 2 : 1);
+  });
+  CHECK_EQ(ticked.size(), 1u);
+}
+
+TEST(ALateBucketSkipsMissedTicks) {
+  TickScheduler<int> scheduler;
+  scheduler.Subscribe(1, 100, 0);
+  CHECK_EQ(Advance(scheduler, 950).size(), 1u);
+  CHECK(scheduler.NextDueMs() == 1050);
+}
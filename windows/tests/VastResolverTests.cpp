@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "HttpStandIn.h"
+#include "TestHarness.h"
+#include "VastResolver.h"
+
+using namespace ReactNativeVideoCPP;
+using namespace ReactNativeVideoCPP::Tests;
+
+namespace {
+
+std::string Inline(char const *id, char const *attributes = "") {
+  return std::string("<Ad id=\"") + id + "\"" + attributes + "><InLine><Impression>https://t.example/imp/" + id +
+      "</Impression><Error>https://t.example/err/" + id + "?code=[ERRORCODE]</Error><Creatives><Creative><Linear>" +
+      "<Duration>00:00:10</Duration><MediaFiles><MediaFile type=\"video/mp4\" delivery=\"progressive\">" +
+      "https://cdn.example/" + id + ".mp4</MediaFile></MediaFiles></Linear></Creative></Creatives></InLine></Ad>";
+}
+
+std::string Wrapper(char const *id, std::string const &next, char const *attributes = "") {
+  return std::string("<Ad id=\"") + id + "\"" + attributes + "><Wrapper><Impression>https://t.example/imp/" + id +
+      "</Impression><Error>https://t.example/err/" + id + "?code=[ERRORCODE]</Error><VASTAdTagURI>" + next +
+      "</VASTAdTagURI></Wrapper></Ad>";
+}
+
+std::string Vast(std::string const &ads, char const *rootError = "") {
+  return std::string("<VAST version=\"4.0\">") + rootError + ads + "</VAST>";
+}
+
+// Serves the documents of |responses| by path, 404 for any other. "{origin}" in a document stands for the
+// server's own origin, so chains can point at it.
+class AdServer {
+ public:
+  explicit AdServer(std::map<std::string, std::string> responses)
+      : m_responses(std::move(responses)), m_server([this](HttpRequest const &request) {
+          HttpResponse response;
+          auto found = m_responses.find(request.path);
+          if (found == m_responses.end()) {
+            response.status = 404;
+            return response;
+          }
+          response.status = 200;
+          response.body = found->second;
+          auto origin = m_server.Url("");
+          for (auto at = response.body.find("{origin}"); at != std::string::npos;
+               at = response.body.find("{origin}", at)) {
+            response.body.replace(at, 8, origin);
+          }
+          return response;
+        }) {}
+
+  std::string Url(std::string const &path) const {
+    return m_server.Url(path);
+  }
+
+ private:
+  std::map<std::string, std::string> m_responses;
+  HttpStandIn m_server;
+};
+
+// The resolver AdLoader builds, with its fetch done by HttpSend and the Error URLs it sends recorded.
+class Resolver {
+ public:
+  explicit Resolver(int maxWrapperDepth = VastResolver::c_maxWrapperDepth)
+      : m_resolver(
+            [](std::string const &url, VastResolver::OnChunk const &onChunk) {
+              auto response = HttpSend("GET", url);
+              if (response.status != 200) {
+                return false;
+              }
+              onChunk(response.body);
+              return true;
+            },
+            [this](std::string const &url) {
+              std::lock_guard lock(m_mutex);
+              m_reported.push_back(url);
+            },
+            maxWrapperDepth) {}
+
+  std::vector<AdBreak> Load(std::string const &url) {
+    return m_resolver.Load(url);
+  }
+
+  std::vector<std::string> Reported() {
+    std::lock_guard lock(m_mutex);
+    auto reported = m_reported;
+    std::sort(reported.begin(), reported.end());
+    return reported;
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::vector<std::string> m_reported;
+  VastResolver m_resolver;
+};
+
+} // namespace
+
+TEST(ErrorUrlMacroIsReplaced) {
+  CHECK_EQ(VastErrorUrl("https://t.example/e?c=[ERRORCODE]&d=[ERRORCODE]", VastError::WrapperLimit),
+      std::string("https://t.example/e?c=302&d=302"));
+  CHECK_EQ(VastErrorUrl("https://t.example/e", VastError::XmlParsing), std::string("https://t.example/e"));
+}
+
+TEST(WrapperChainCarriesItsBeaconsIntoTheInlineAd) {
+  AdServer server({
+      {"/tag.xml", Vast(Wrapper("w1", "{origin}/wrapper.xml"))},
+      {"/wrapper.xml", Vast(Wrapper("w2", "{origin}/inline.xml"))},
+      {"/inline.xml", Vast(Inline("a"))},
+  });
+  Resolver resolver;
+  auto breaks = resolver.Load(server.Url("/tag.xml"));
+  CHECK_EQ(breaks.size(), 1u);
+  CHECK_EQ(breaks[0].ads.size(), 1u);
+  auto const &ad = breaks[0].ads[0];
+  CHECK_EQ(ad.id, std::string("a"));
+  CHECK_EQ(ad.impressions.size(), 3u);
+  CHECK_EQ(ad.errors.size(), 3u);
+  CHECK(resolver.Reported().empty());
+}
+
+TEST(NoFillReportsTheRootErrorUrls) {
+  AdServer server({{"/tag.xml", Vast("", "<Error>https://t.example/nofill?code=[ERRORCODE]</Error>")}});
+  Resolver resolver;
+  CHECK(resolver.Load(server.Url("/tag.xml")).empty());
+  CHECK(resolver.Reported() == std::vector<std::string>{"https://t.example/nofill?code=303"});
+}
+
+TEST(BrokenChainReportsEveryWrapper) {
+  AdServer server({
+      {"/tag.xml", Vast(Wrapper("w1", "{origin}/wrapper.xml"))},
+      {"/wrapper.xml", Vast(Wrapper("w2", "{origin}/missing.xml"))},
+  });
+  Resolver resolver;
+  CHECK(resolver.Load(server.Url("/tag.xml")).empty());
+  CHECK(resolver.Reported() ==
+      std::vector<std::string>({"https://t.example/err/w1?code=301", "https://t.example/err/w2?code=301"}));
+}
+
+TEST(UnparsableResponseReportsXmlParsing) {
+  AdServer server({
+      {"/tag.xml", Vast(Wrapper("w1", "{origin}/broken.xml"))},
+      {"/broken.xml", "<html>not an ad"},
+  });
+  Resolver resolver;
+  CHECK(resolver.Load(server.Url("/tag.xml")).empty());
+  CHECK(resolver.Reported() == std::vector<std::string>{"https://t.example/err/w1?code=100"});
+}
+
+TEST(WrapperDepthLimitReportsEveryWrapper) {
+  AdServer server({
+      {"/tag.xml", Vast(Wrapper("w1", "{origin}/wrapper.xml"))},
+      {"/wrapper.xml", Vast(Wrapper("w2", "{origin}/inline.xml"))},
+      {"/inline.xml", Vast(Inline("a"))},
+  });
+  Resolver resolver(1);
+  CHECK(resolver.Load(server.Url("/tag.xml")).empty());
+  CHECK(resolver.Reported() ==
+      std::vector<std::string>({"https://t.example/err/w1?code=302", "https://t.example/err/w2?code=302"}));
+}
+
+TEST(FailedFallbackGivesWayToTheNextAd) {
+  AdServer server({
+      {"/tag.xml", Vast(Wrapper("w1", "{origin}/missing.xml") + Inline("b") + Inline("c"))},
+  });
+  Resolver resolver;
+  auto breaks = resolver.Load(server.Url("/tag.xml"));
+  CHECK_EQ(breaks.size(), 1u);
+  CHECK_EQ(breaks[0].ads.size(), 1u);
+  CHECK_EQ(breaks[0].ads[0].id, std::string("b"));
+  CHECK(resolver.Reported() == std::vector<std::string>{"https://t.example/err/w1?code=301"});
+}
+
+TEST(PodPlaysInSequenceOrderWithoutItsFailedAds) {
+  AdServer server({
+      {"/tag.xml",
+       Vast(Wrapper("w3", "{origin}/three.xml", " sequence=\"3\"") + Inline("one", " sequence=\"1\"") +
+           Wrapper("w2", "{origin}/missing.xml", " sequence=\"2\"") + Inline("standalone"))},
+      {"/three.xml", Vast(Inline("three"))},
+  });
+  Resolver resolver;
+  auto breaks = resolver.Load(server.Url("/tag.xml"));
+  CHECK_EQ(breaks.size(), 1u);
+  CHECK_EQ(breaks[0].ads.size(), 2u);
+  CHECK_EQ(breaks[0].ads[0].id, std::string("one"));
+  CHECK_EQ(breaks[0].ads[1].id, std::string("three"));
+  CHECK_EQ(breaks[0].ads[1].sequence, 3u);
+  CHECK(resolver.Reported() == std::vector<std::string>{"https://t.example/err/w2?code=301"});
+}
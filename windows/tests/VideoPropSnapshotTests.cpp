@@ -0,0 +1,46 @@
+#include <string>
+#include "TestHarness.h"
+#include "VideoPropSnapshot.h"
+
+using namespace ReactNativeVideoCPP;
+
+TEST(RepeatedValuesAreSkipped) {
+  VideoPropSnapshot props;
+  bool paused = false;
+  CHECK(props.Assign(VideoProp::Paused, paused, false)); // never applied, so it goes through
+  CHECK(!props.Assign(VideoProp::Paused, paused, false));
+  CHECK(props.Assign(VideoProp::Paused, paused, true));
+  CHECK(paused);
+  CHECK_EQ(props.Stats().applied, 2u);
+  CHECK_EQ(props.Stats().skipped, 1u);
+}
+
+TEST(InternalAssignmentsAreNotCounted) {
+  VideoPropSnapshot props;
+  bool controls = false;
+  CHECK(props.Assign(VideoProp::Controls, controls, false));
+  CHECK(props.AssignInternal(VideoProp::Controls, controls, true));
+  CHECK(!props.AssignInternal(VideoProp::Controls, controls, true));
+  CHECK(controls);
+  CHECK_EQ(props.Stats().applied, 1u);
+  CHECK_EQ(props.Stats().skipped, 0u);
+  // JS sending what full screen already set is a skip like any other
+  CHECK(!props.Assign(VideoProp::Controls, controls, true));
+  CHECK_EQ(props.Stats().skipped, 1u);
+}
+
+TEST(InvalidatedPropIsAppliedAgain) {
+  // what ReactVideoView does for a source: a shouldCache change invalidates the uri, so the same uri
+  // rebuilds it
+  VideoPropSnapshot props;
+  bool shouldCache = false;
+  std::string uri;
+  CHECK(props.Assign(VideoProp::ShouldCache, shouldCache, false));
+  CHECK(props.Assign(VideoProp::Uri, uri, "https://example.com/a.m3u8"));
+  CHECK(!props.Assign(VideoProp::Uri, uri, "https://example.com/a.m3u8"));
+  if (props.Assign(VideoProp::ShouldCache, shouldCache, true)) {
+    props.Invalidate(VideoProp::Uri);
+  }
+  CHECK(!props.IsApplied(VideoProp::Uri));
+  CHECK(props.Assign(VideoProp::Uri, uri, "https://example.com/a.m3u8"));
+}
@@ -0,0 +1,80 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "AbrSimulation.h"
+
+// Replays network traces through each ABR policy and reports rebuffering against the average bitrate.
+// Pass trace files ("<duration ms> <kbps>" per line) as arguments; without any a few synthetic traces run.
+//
+//   ./build/benchmarks/AbrSimulator [trace...]
+
+using namespace ReactNativeVideoCPP;
+using namespace ReactNativeVideoCPP::Tests;
+
+namespace {
+
+struct NamedTrace {
+  std::string name;
+  std::string text;
+};
+
+std::vector<NamedTrace> SyntheticTraces() {
+  return {
+      {"steady-5M", "60000 5000\n"},
+      {"step-down", "40000 8000\n30000 700\n20000 3000\n"},
+      {"oscillating", "5000 6000\n5000 1200\n"},
+      {"outages", "15000 4000\n2000 0\n10000 2500\n3000 0\n"},
+      {"cellular", "3000 2100\n2000 900\n4000 3400\n1000 300\n5000 1800\n2000 4800\n3000 1100\n"},
+  };
+}
+
+void Run(NamedTrace const &named) {
+  AbrSimulationConfig config;
+  config.bitrates = {400000, 800000, 1500000, 3000000, 6000000};
+  auto trace = NetworkTrace::Parse(named.text);
+  struct Policy {
+    char const *name;
+    std::unique_ptr<AbrPolicy> (*make)();
+  };
+  Policy const policies[] = {
+      {"throughput", [] { return std::unique_ptr<AbrPolicy>(std::make_unique<ThroughputPolicy>()); }},
+      {"bola", [] { return std::unique_ptr<AbrPolicy>(std::make_unique<BolaPolicy>()); }},
+      {"dynamic", [] { return std::unique_ptr<AbrPolicy>(std::make_unique<DynamicPolicy>()); }},
+  };
+  for (auto const &policy : policies) {
+    auto result = Simulate(trace, config, policy.make());
+    std::printf(
+        "%-16s %-10s %8.0f kbps  rebuffer %6lld ms (%2llu)  startup %5lld ms  switches %3llu\n",
+        named.name.c_str(),
+        policy.name,
+        result.averageBitrate / 1000,
+        static_cast<long long>(result.rebufferMs),
+        static_cast<unsigned long long>(result.rebufferCount),
+        static_cast<long long>(result.startupMs),
+        static_cast<unsigned long long>(result.switches));
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    for (auto const &trace : SyntheticTraces()) {
+      Run(trace);
+    }
+    return 0;
+  }
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i]);
+    if (!file) {
+      std::fprintf(stderr, "can't read %s\n", argv[i]);
+      return 1;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    Run(NamedTrace{argv[i], text.str()});
+  }
+  return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Minimal timing helpers for the benchmarks: Measure runs |body| |iterations| times after a warm-up and
+// prints the mean time per iteration.
+namespace ReactNativeVideoCPP::Benchmarks {
+
+// Keeps the compiler from dropping a computation whose result is otherwise unused.
+inline char const volatile *volatile g_sink = nullptr;
+
+template <typename T>
+inline void DoNotOptimize(T const &value) {
+  g_sink = reinterpret_cast<char const volatile *>(&value);
+}
+
+template <typename Body>
+double Measure(char const *name, uint64_t iterations, Body &&body) {
+  for (uint64_t i = 0; i < iterations / 10 + 1; ++i) {
+    body();
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < iterations; ++i) {
+    body();
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  auto perIteration = elapsed / static_cast<double>(iterations);
+  std::printf(
+      "%-48s %12.1f ns/op  (%llu iterations)\n", name, perIteration, static_cast<unsigned long long>(iterations));
+  return perIteration;
+}
+
+} // namespace ReactNativeVideoCPP::Benchmarks
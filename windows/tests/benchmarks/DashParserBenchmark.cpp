@@ -0,0 +1,140 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include "BenchmarkHarness.h"
+#include "DashParser.h"
+
+// Parse time and heap footprint of the streaming MPD parser on two large manifests: a 4-hour VOD whose
+// SegmentTimeline lists every segment with its own duration (7k <S> elements, no runs to fold), and a
+// live MPD whose timeline folds into a handful of runs. The text is fed in 16 KiB chunks as it would
+// arrive from the network. Footprint is the heap the finished manifest holds, measured through a
+// counting operator new, against the segment table an eager parser would expand the timelines into.
+using namespace ReactNativeVideoCPP;
+using namespace ReactNativeVideoCPP::Benchmarks;
+
+namespace {
+
+size_t g_liveBytes = 0;
+constexpr size_t c_header = alignof(std::max_align_t); // keeps the returned block aligned
+
+} // namespace
+
+// each block carries its size in front so the counting delete knows how much is released
+void *operator new(size_t size) {
+  auto *block = static_cast<size_t *>(std::malloc(size + c_header));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  *block = size;
+  g_liveBytes += size;
+  return reinterpret_cast<char *>(block) + c_header;
+}
+
+void operator delete(void *pointer) noexcept {
+  if (pointer != nullptr) {
+    auto *block = reinterpret_cast<size_t *>(static_cast<char *>(pointer) - c_header);
+    g_liveBytes -= *block;
+    std::free(block);
+  }
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+  operator delete(pointer);
+}
+
+namespace {
+
+constexpr size_t c_chunkBytes = 16 * 1024;
+
+std::string Representations() {
+  std::string text;
+  uint64_t const bandwidths[] = {400000, 800000, 1500000, 3000000, 6000000};
+  for (auto bandwidth : bandwidths) {
+    text += "<Representation id=\"v" + std::to_string(bandwidth) + "\" bandwidth=\"" + std::to_string(bandwidth) +
+        "\" width=\"1920\" height=\"1080\" codecs=\"avc1.640028\"/>\n";
+  }
+  return text;
+}
+
+std::string Mpd(bool dynamic, std::string const &timeline) {
+  std::string text = "<?xml version=\"1.0\"?>\n<MPD xmlns=\"urn:mpeg:dash:schema:mpd:2011\" ";
+  text += dynamic ? "type=\"dynamic\" availabilityStartTime=\"2024-05-01T00:00:00Z\" minimumUpdatePeriod=\"PT2S\">\n"
+                  : "type=\"static\" mediaPresentationDuration=\"PT4H\">\n";
+  text += "<Period id=\"p0\" start=\"PT0S\">\n<AdaptationSet mimeType=\"video/mp4\" contentType=\"video\">\n";
+  text += "<SegmentTemplate timescale=\"90000\" media=\"$RepresentationID$/$Time$.m4s\" "
+          "initialization=\"$RepresentationID$/init.mp4\">\n<SegmentTimeline>\n";
+  text += timeline;
+  text += "</SegmentTimeline>\n</SegmentTemplate>\n";
+  text += Representations();
+  text += "</AdaptationSet>\n</Period>\n</MPD>\n";
+  return text;
+}
+
+// 4 hours of segments alternating between two durations, as an encoder with a fractional frame rate writes
+std::string VodTimeline() {
+  std::string text;
+  uint64_t time = 0;
+  for (size_t i = 0; time < 4ull * 3600 * 90000; ++i) {
+    uint64_t duration = i % 2 == 0 ? 180180 : 180000;
+    text += "<S t=\"" + std::to_string(time) + "\" d=\"" + std::to_string(duration) + "\"/>\n";
+    time += duration;
+  }
+  return text;
+}
+
+// a 4-hour window folded into runs, broken by an ad insertion every 30 minutes
+std::string LiveTimeline() {
+  std::string text;
+  for (int block = 0; block < 8; ++block) {
+    text += "<S d=\"180000\" r=\"448\"/>\n<S d=\"90000\"/>\n";
+  }
+  return text + "<S d=\"180000\" r=\"-1\"/>\n";
+}
+
+void Run(char const *name, std::string const &text, uint64_t iterations) {
+  double wallClock = 1714521600 + 4 * 3600; // four hours after availabilityStartTime
+  char label[64];
+  std::snprintf(label, sizeof(label), "parse %s (%zu KiB)", name, text.size() / 1024);
+  Measure(label, iterations, [&] {
+    DashMpdParser parser;
+    for (size_t offset = 0; offset < text.size(); offset += c_chunkBytes) {
+      parser.Feed(std::string_view(text).substr(offset, c_chunkBytes));
+    }
+    DashManifest manifest;
+    parser.Finish(manifest, wallClock);
+    DoNotOptimize(manifest);
+  });
+
+  auto before = g_liveBytes;
+  auto manifest = std::make_unique<DashManifest>();
+  {
+    DashMpdParser parser;
+    for (size_t offset = 0; offset < text.size(); offset += c_chunkBytes) {
+      parser.Feed(std::string_view(text).substr(offset, c_chunkBytes));
+    }
+    parser.Finish(*manifest, wallClock);
+  }
+  auto held = g_liveBytes - before;
+  auto const &representation = manifest->periods.front().adaptationSets.front().representations.front();
+  auto const &segmentTemplate = *representation.segmentTemplate;
+  auto segments = segmentTemplate.SegmentCount(manifest->periods.front().duration);
+  auto representations = manifest->periods.front().adaptationSets.front().representations.size();
+  std::printf(
+      "  %llu segments in %zu runs, manifest holds %zu KiB; expanded for %zu representations: %zu KiB\n",
+      static_cast<unsigned long long>(segments),
+      segmentTemplate.timeline->RunCount(),
+      held / 1024,
+      representations,
+      static_cast<size_t>(segments * sizeof(DashSegment) * representations / 1024));
+}
+
+} // namespace
+
+int main() {
+  Run("4h VOD, one <S> per segment", Mpd(false, VodTimeline()), 50);
+  Run("4h live window, folded runs", Mpd(true, LiveTimeline()), 20000);
+  return 0;
+}
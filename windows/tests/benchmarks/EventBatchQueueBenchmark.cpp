@@ -0,0 +1,83 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "BenchmarkHarness.h"
+#include "EventBatchQueue.h"
+
+// Producer contention on EventBatchQueue: several media threads post at once while the UI thread drains.
+// A pool size of 0 allocates every node, as the queue did before it had a pool. Producers hold back while
+// more than c_maxOutstanding events wait, as media callbacks never run far ahead of a live UI thread.
+using ReactNativeVideoCPP::EventBatchQueue;
+
+namespace {
+
+constexpr int c_maxOutstanding = 128;
+
+struct Event {
+  void const *source = nullptr;
+  int kind = 0;
+  bool collapsible = false;
+  int64_t timeMs = 0;
+};
+
+double Run(size_t poolSize, int producers, int eventsPerProducer) {
+  EventBatchQueue<Event> queue(poolSize);
+  std::atomic<int> running{producers};
+  std::atomic<int> outstanding{0};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      while (!go.load()) {
+        std::this_thread::yield();
+      }
+      for (int i = 0; i < eventsPerProducer; ++i) {
+        while (outstanding.load(std::memory_order_relaxed) > c_maxOutstanding) {
+          std::this_thread::yield();
+        }
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        queue.Push(Event{&threads, p, false, i});
+      }
+      running.fetch_sub(1);
+    });
+  }
+  uint64_t delivered = 0;
+  auto count = [&](Event const &) {
+    ++delivered;
+    outstanding.fetch_sub(1, std::memory_order_relaxed);
+  };
+  auto start = std::chrono::steady_clock::now();
+  go.store(true);
+  while (running.load() > 0) {
+    if (queue.Drain(count) == 0) {
+      std::this_thread::yield();
+    }
+  }
+  queue.Drain(count);
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ReactNativeVideoCPP::Benchmarks::DoNotOptimize(delivered);
+  auto perEvent = elapsed / (static_cast<double>(producers) * eventsPerProducer);
+  std::printf(
+      "pool %4zu, %d producers %30.1f ns/push  (%llu heap nodes)\n",
+      poolSize,
+      producers,
+      perEvent,
+      static_cast<unsigned long long>(queue.HeapNodes()));
+  return perEvent;
+}
+
+} // namespace
+
+int main() {
+  constexpr int c_eventsPerProducer = 50000;
+  for (int producers : {1, 2, 4, 8}) {
+    Run(0, producers, c_eventsPerProducer);
+    Run(EventBatchQueue<Event>::c_defaultPoolSize, producers, c_eventsPerProducer);
+  }
+  return 0;
+}
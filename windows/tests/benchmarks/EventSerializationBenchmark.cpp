@@ -0,0 +1,141 @@
+#include <cstdio>
+#include <map>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "BenchmarkHarness.h"
+#include "EventSchema.h"
+#include "VideoEvents.h"
+
+// Serialization of the hottest event payloads through EventWriter, whose keys are created once, against
+// the path it replaced: a JSValueObject-like map built per event, with every key allocated and sorted,
+// then written out. Both write into a recording writer standing in for IJSValueWriter.
+using namespace ReactNativeVideoCPP;
+using namespace ReactNativeVideoCPP::Benchmarks;
+
+namespace {
+
+// Records what it is handed, as IJSValueWriter does when it builds the event's value tree; keys are taken
+// by reference like the hstring keys of the real writer, whose copies only bump a reference count.
+struct RecordingWriter {
+  struct Token {
+    int depth = 0;
+    std::wstring const *key = nullptr;
+    std::variant<bool, int64_t, double, std::wstring_view> value;
+  };
+
+  std::vector<Token> tokens;
+  int depth = 0;
+  std::wstring const *key = nullptr;
+
+  void Reset() {
+    tokens.clear();
+    depth = 0;
+  }
+  void BeginObject() {
+    ++depth;
+  }
+  void EndObject() {
+    --depth;
+  }
+  void Key(std::wstring const &name) {
+    key = &name;
+  }
+  template <typename T>
+  void Value(T value) {
+    tokens.push_back(Token{depth, key, value});
+  }
+};
+
+// the dynamic object of the old path
+struct DynamicValue;
+using DynamicObject = std::map<std::wstring, DynamicValue>;
+struct DynamicValue {
+  std::variant<bool, int64_t, double, std::wstring, DynamicObject> value;
+};
+
+void WriteDynamic(RecordingWriter &writer, DynamicObject const &object) {
+  writer.BeginObject();
+  for (auto const &[key, entry] : object) {
+    writer.Key(key);
+    std::visit(
+        [&](auto const &value) {
+          using T = std::decay_t<decltype(value)>;
+          if constexpr (std::is_same_v<T, DynamicObject>) {
+            WriteDynamic(writer, value);
+          } else if constexpr (std::is_same_v<T, std::wstring>) {
+            writer.Value(std::wstring_view{value});
+          } else {
+            writer.Value(value);
+          }
+        },
+        entry.value);
+  }
+  writer.EndObject();
+}
+
+DynamicObject ToDynamic(ProgressEventPayload const &payload) {
+  return DynamicObject{
+      {L"currentTime", {payload.currentTime}},
+      {L"playableDuration", {payload.playableDuration}},
+      {L"seekableDuration", {payload.seekableDuration}},
+  };
+}
+
+DynamicObject ToDynamic(LoadEventPayload const &payload) {
+  return DynamicObject{
+      {L"duration", {payload.duration}},
+      {L"currentTime", {payload.currentTime}},
+      {L"naturalSize",
+       {DynamicObject{
+           {L"width", {payload.naturalSize.width}},
+           {L"height", {payload.naturalSize.height}},
+           {L"orientation", {std::wstring(payload.naturalSize.orientation)}},
+       }}},
+      {L"canPlayFastForward", {payload.canPlayFastForward}},
+      {L"canPlaySlowForward", {payload.canPlaySlowForward}},
+      {L"canPlaySlow", {payload.canPlaySlow}},
+      {L"canStepBackward", {payload.canStepBackward}},
+      {L"canStepForward", {payload.canStepForward}},
+  };
+}
+
+template <typename Payload>
+void Compare(char const *name, Payload const &payload, uint64_t iterations) {
+  static const EventWriter<Payload, std::wstring> s_writer{[](std::wstring_view key) { return std::wstring(key); }};
+  RecordingWriter writer;
+  writer.tokens.reserve(32);
+
+  std::printf("%s\n", name);
+  auto dynamic = Measure("  per-event map", iterations, [&] {
+    writer.Reset();
+    WriteDynamic(writer, ToDynamic(payload));
+    DoNotOptimize(writer.tokens);
+  });
+  auto schema = Measure("  EventWriter", iterations, [&] {
+    writer.Reset();
+    s_writer.Write(writer, payload);
+    DoNotOptimize(writer.tokens);
+  });
+  std::printf("  speedup: %.1fx, %zu values\n", dynamic / schema, writer.tokens.size());
+}
+
+} // namespace
+
+int main() {
+  ProgressEventPayload progress;
+  progress.currentTime = 12.5;
+  progress.playableDuration = 42.25;
+  progress.seekableDuration = 3600;
+  Compare("topProgress", progress, 1000000);
+
+  LoadEventPayload load;
+  load.duration = 3600;
+  load.currentTime = 0;
+  load.naturalSize.width = 1920;
+  load.naturalSize.height = 1080;
+  load.naturalSize.orientation = L"landscape";
+  Compare("topLoad", load, 300000);
+  return 0;
+}
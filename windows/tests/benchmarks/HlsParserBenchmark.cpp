@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BenchmarkHarness.h"
+#include "HlsParser.h"
+
+// Parsing of a 10k-segment VOD media playlist into the packed segment table, against a line-by-line parser
+// of the usual shape (getline into a std::string, one struct with its own URI string per segment), and
+// the refresh of a 10k-segment live window that slid by one segment, incremental against a full re-parse.
+using namespace ReactNativeVideoCPP;
+using namespace ReactNativeVideoCPP::Benchmarks;
+
+namespace {
+
+constexpr size_t c_segments = 10000;
+
+std::string MediaPlaylist(uint64_t firstSequence, size_t segments, bool endList) {
+  std::string text = "#EXTM3U\n#EXT-X-VERSION:6\n#EXT-X-TARGETDURATION:6\n";
+  text += "#EXT-X-MEDIA-SEQUENCE:" + std::to_string(firstSequence) + "\n";
+  if (endList) {
+    text += "#EXT-X-PLAYLIST-TYPE:VOD\n";
+  }
+  for (auto sequence = firstSequence; sequence < firstSequence + segments; ++sequence) {
+    text += "#EXTINF:5.005,\n";
+    text += "https://cdn.example.com/vod/title/1080p/segment_" + std::to_string(sequence) + ".ts\n";
+  }
+  if (endList) {
+    text += "#EXT-X-ENDLIST\n";
+  }
+  return text;
+}
+
+struct NaiveSegment {
+  std::string uri;
+  double start = 0;
+  double duration = 0;
+  uint64_t sequence = 0;
+};
+
+std::vector<NaiveSegment> NaiveParse(std::string const &text) {
+  std::vector<NaiveSegment> segments;
+  std::istringstream stream(text);
+  std::string line;
+  uint64_t sequence = 0;
+  double start = 0;
+  double duration = 0;
+  while (std::getline(stream, line)) {
+    if (line.rfind("#EXT-X-MEDIA-SEQUENCE:", 0) == 0) {
+      sequence = std::strtoull(line.c_str() + 22, nullptr, 10);
+    } else if (line.rfind("#EXTINF:", 0) == 0) {
+      duration = std::strtod(line.c_str() + 8, nullptr);
+    } else if (!line.empty() && line[0] != '#') {
+      segments.push_back(NaiveSegment{line, start, duration, sequence++});
+      start += duration;
+    }
+  }
+  return segments;
+}
+
+} // namespace
+
+int main() {
+  auto vod = MediaPlaylist(0, c_segments, true);
+  std::printf("VOD playlist: %zu segments, %zu bytes\n", c_segments, vod.size());
+
+  Measure("parse 10k VOD, HlsMediaPlaylist", 200, [&] {
+    HlsMediaPlaylist playlist;
+    playlist.Update(vod);
+    DoNotOptimize(playlist.Segments().back());
+  });
+  Measure("parse 10k VOD, getline + string per segment", 200, [&] {
+    auto segments = NaiveParse(vod);
+    DoNotOptimize(segments.back());
+  });
+
+  // the live window moves by one segment per refresh: each iteration steps a table holding the earlier
+  // window forward, and only that step is timed
+  auto before = MediaPlaylist(100000, c_segments, false);
+  auto after = MediaPlaylist(100001, c_segments, false);
+  constexpr int c_refreshes = 200;
+  double incrementalNs = 0;
+  for (int i = 0; i < c_refreshes; ++i) {
+    HlsMediaPlaylist live;
+    live.Update(before);
+    auto start = std::chrono::steady_clock::now();
+    auto result = live.Update(after);
+    incrementalNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    DoNotOptimize(result);
+  }
+  std::printf(
+      "%-48s %12.1f ns/op  (%d iterations)\n",
+      "refresh 10k live window, incremental",
+      incrementalNs / c_refreshes,
+      c_refreshes);
+  Measure("refresh 10k live window, full re-parse", c_refreshes, [&] {
+    HlsMediaPlaylist playlist;
+    playlist.Update(after);
+    DoNotOptimize(playlist.Segments().back());
+  });
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <map>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "BenchmarkHarness.h"
+#include "PropertyDispatcher.h"
+
+// Dispatch of a typical prop update (a handful of changed props) through the perfect-hash table, against
+// the path it replaced: copy the whole update into a map of values (JSValue::ReadObjectFrom), then walk
+// an if/else chain of name compares for each entry.
+using namespace ReactNativeVideoCPP;
+using namespace ReactNativeVideoCPP::Benchmarks;
+
+namespace {
+
+using Value = std::variant<bool, double, std::string>;
+
+struct View {
+  double volume = 0;
+  double rate = 0;
+  bool paused = false;
+  bool muted = false;
+  bool repeat = false;
+  double seek = 0;
+  std::string uri;
+};
+
+using Setter = void (*)(View &, Value const &);
+
+constexpr PropertyEntry<Setter> c_setters[] = {
+    {"src", [](View &view, Value const &value) { view.uri = std::get<std::string>(value); }},
+    {"resizeMode", [](View &, Value const &) {}},
+    {"repeat", [](View &view, Value const &value) { view.repeat = std::get<bool>(value); }},
+    {"paused", [](View &view, Value const &value) { view.paused = std::get<bool>(value); }},
+    {"muted", [](View &view, Value const &value) { view.muted = std::get<bool>(value); }},
+    {"volume", [](View &view, Value const &value) { view.volume = std::get<double>(value); }},
+    {"seek", [](View &view, Value const &value) { view.seek = std::get<double>(value); }},
+    {"controls", [](View &, Value const &) {}},
+    {"fullscreen", [](View &, Value const &) {}},
+    {"progressUpdateInterval", [](View &, Value const &) {}},
+    {"rate", [](View &view, Value const &value) { view.rate = std::get<double>(value); }},
+    {"reportBandwidth", [](View &, Value const &) {}},
+    {"maxBitRate", [](View &, Value const &) {}},
+    {"bufferConfig", [](View &, Value const &) {}},
+    {"viewportOversampling", [](View &, Value const &) {}},
+    {"adTagUrl", [](View &, Value const &) {}},
+    {"reportAdCues", [](View &, Value const &) {}},
+};
+
+constexpr auto c_dispatcher = MakePropertyDispatcher(c_setters);
+
+void DispatchByChain(View &view, std::map<std::string, Value> const &props) {
+  for (auto const &[name, value] : props) {
+    if (name == "src") {
+      view.uri = std::get<std::string>(value);
+    } else if (name == "resizeMode") {
+    } else if (name == "repeat") {
+      view.repeat = std::get<bool>(value);
+    } else if (name == "paused") {
+      view.paused = std::get<bool>(value);
+    } else if (name == "muted") {
+      view.muted = std::get<bool>(value);
+    } else if (name == "volume") {
+      view.volume = std::get<double>(value);
+    } else if (name == "seek") {
+      view.seek = std::get<double>(value);
+    } else if (name == "controls") {
+    } else if (name == "fullscreen") {
+    } else if (name == "progressUpdateInterval") {
+    } else if (name == "rate") {
+      view.rate = std::get<double>(value);
+    } else if (name == "reportBandwidth") {
+    } else if (name == "maxBitRate") {
+    } else if (name == "bufferConfig") {
+    } else if (name == "viewportOversampling") {
+    } else if (name == "adTagUrl") {
+    } else if (name == "reportAdCues") {
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  // the update as the reader hands it over: names and values in order
+  std::vector<std::pair<std::string, Value>> update = {
+      {"src", std::string("https://example.com/video/master.m3u8")},
+      {"paused", false},
+      {"muted", true},
+      {"volume", 0.5},
+      {"rate", 1.0},
+      {"repeat", false},
+      {"viewportOversampling", 1.0},
+      {"reportAdCues", false},
+  };
+  constexpr uint64_t c_iterations = 1000000;
+  View view;
+
+  auto chain = Measure("map copy + if/else chain", c_iterations, [&] {
+    std::map<std::string, Value> props(update.begin(), update.end());
+    DispatchByChain(view, props);
+    DoNotOptimize(view);
+  });
+  auto table = Measure("perfect-hash dispatch from the reader", c_iterations, [&] {
+    for (auto const &[name, value] : update) {
+      if (auto setter = c_dispatcher.Find(std::string_view{name})) {
+        setter(view, value);
+      }
+    }
+    DoNotOptimize(view);
+  });
+  std::printf("speedup: %.1fx\n", chain / table);
+  return 0;
+}